@@ -0,0 +1,608 @@
+#include "control_api.h"
+#include "../singleton/server_manager.h"
+#include <QDateTime>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QDebug>
+#include <memory>
+
+namespace {
+
+struct JobBatch {
+    QPointer<QIODevice> connection;
+    QJsonObject results;
+    int remaining = 0;
+    bool failed = false;
+    bool singleServer = false;
+};
+
+bool constantTimeEquals(const QByteArray& provided, const QByteArray& expected) {
+    unsigned char difference = provided.size() == expected.size() ? 0 : 1;
+    for (qsizetype i = 0; i < expected.size(); ++i) {
+        unsigned char byte = i < provided.size() ? static_cast<unsigned char>(provided.at(i)) : 0;
+        difference |= byte ^ static_cast<unsigned char>(expected.at(i));
+    }
+    return difference == 0;
+}
+
+// Host header without the port: "[::1]:9465" -> "::1", "localhost:9465" -> "localhost".
+QString hostName(const QByteArray& hostHeader) {
+    QString host = QString::fromLatin1(hostHeader).trimmed();
+    if (host.startsWith('[')) {
+        int end = host.indexOf(']');
+        return end > 0 ? host.mid(1, end - 1) : QString();
+    }
+    int colon = host.lastIndexOf(':');
+    return colon >= 0 ? host.left(colon) : host;
+}
+
+bool isLoopbackHost(const QString& host) {
+    return host.compare("localhost", Qt::CaseInsensitive) == 0 || QHostAddress(host).isLoopback();
+}
+
+}
+
+ControlApi::ControlApi(QObject *parent) : QObject(parent), httpServer(this), keepAliveTimer(this) {
+    keepAliveTimer.setInterval(keepAliveInterval);
+    connect(&keepAliveTimer, &QTimer::timeout, this, [this]() {
+        for (const QPointer<QIODevice>& stream : eventStreams) {
+            if (stream) {
+                stream->write(": keep-alive\n\n");
+            }
+        }
+    });
+    registerRoutes();
+}
+
+ControlApi::~ControlApi() {
+    stop();
+}
+
+void ControlApi::validateSettings(const QJsonObject &settings) {
+    if (!settings.value("enabled").isBool()) {
+        throw std::runtime_error("Failed to configure the control API: enabled must be true or false.");
+    }
+    int port = settings.value("port").toInt();
+    if (!settings.value("port").isDouble() || port <= 0 || port > 65535) {
+        QString errMsg = "Failed to configure the control API: invalid port " + settings.value("port").toVariant().toString() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (QHostAddress(settings.value("address").toString()).isNull()) {
+        QString errMsg = "Failed to configure the control API: invalid address " + settings.value("address").toString() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!settings.value("socket").isString() || !settings.value("token").isString()) {
+        throw std::runtime_error("Failed to configure the control API: socket and token must be strings.");
+    }
+    if (settings.value("enabled").toBool() && settings.value("socket").toString().isEmpty() && settings.value("token").toString().isEmpty()
+        && !QHostAddress(settings.value("address").toString()).isLoopback()) {
+        QString errMsg = "Failed to configure the control API: a token is required to listen on non-loopback address " + settings.value("address").toString() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
+
+void ControlApi::setSettings(const QJsonObject &settings) {
+    validateSettings(settings);
+    this->settings = settings;
+}
+
+QJsonObject ControlApi::getSettings() const {
+    return settings;
+}
+
+bool ControlApi::start() {
+    stop();
+    lastError.clear();
+    if (!settings.value("enabled").toBool()) {
+        return true;
+    }
+    QString socketPath = settings.value("socket").toString();
+    bool listening = socketPath.isEmpty()
+        ? httpServer.listen(QHostAddress(settings.value("address").toString()), quint16(settings.value("port").toInt()))
+        : httpServer.listenLocal(socketPath);
+    if (!listening) {
+        lastError = httpServer.errorString();
+        return false;
+    }
+    keepAliveTimer.start();
+    return true;
+}
+
+void ControlApi::stop() {
+    keepAliveTimer.stop();
+    for (const PendingPoll& poll : pendingPolls) {
+        poll.timer->deleteLater();
+        if (poll.connection) {
+            HttpServer::closeConnection(poll.connection);
+        }
+    }
+    pendingPolls.clear();
+    for (const QPointer<QIODevice>& stream : eventStreams) {
+        if (stream) {
+            HttpServer::closeConnection(stream);
+        }
+    }
+    eventStreams.clear();
+    httpServer.close();
+}
+
+bool ControlApi::isListening() const {
+    return httpServer.isListening();
+}
+
+QString ControlApi::errorString() const {
+    return lastError;
+}
+
+void ControlApi::publishState(const QString &serverName, bool isRunning) {
+    QJsonObject event;
+    event["type"] = "state";
+    event["server"] = serverName;
+    event["running"] = isRunning;
+    publish(event);
+}
+
+void ControlApi::publishWarning(const QString &serverName, const QString &message) {
+    QJsonObject event;
+    event["type"] = "warning";
+    event["server"] = serverName;
+    event["message"] = message;
+    publish(event);
+}
+
+void ControlApi::publishError(const QString &title, const QString &message) {
+    QJsonObject event;
+    event["type"] = "error";
+    event["title"] = title;
+    event["message"] = message;
+    publish(event);
+}
+
+void ControlApi::publish(QJsonObject event) {
+    event["id"] = ++sequence;
+    event["time"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    recentEvents.append(event);
+    while (recentEvents.size() > maxRecentEvents) {
+        recentEvents.removeFirst();
+    }
+
+    QByteArray frame = "id: " + QByteArray::number(sequence) + "\nevent: " + event.value("type").toString().toUtf8()
+                       + "\ndata: " + QJsonDocument(event).toJson(QJsonDocument::Compact) + "\n\n";
+    for (int i = eventStreams.size() - 1; i >= 0; --i) {
+        if (!eventStreams.at(i)) {
+            eventStreams.removeAt(i);
+            continue;
+        }
+        eventStreams.at(i)->write(frame);
+    }
+    flushPolls();
+}
+
+void ControlApi::flushPolls() {
+    for (int i = pendingPolls.size() - 1; i >= 0; --i) {
+        PendingPoll poll = pendingPolls.at(i);
+        QJsonArray events = eventsSince(poll.since);
+        if (!poll.connection || !events.isEmpty()) {
+            pendingPolls.removeAt(i);
+            poll.timer->deleteLater();
+            QJsonObject body;
+            body["events"] = events;
+            body["sequence"] = sequence;
+            reply(poll.connection, HttpResponse::json(body));
+        }
+    }
+}
+
+QJsonArray ControlApi::eventsSince(qint64 since) const {
+    QJsonArray events;
+    for (const QJsonObject& event : recentEvents) {
+        if (event.value("id").toInteger() > since) {
+            events.append(event);
+        }
+    }
+    return events;
+}
+
+void ControlApi::reply(QPointer<QIODevice> connection, const HttpResponse &response) {
+    if (!connection) {
+        return;
+    }
+    HttpServer::writeResponse(connection, response, false);
+    HttpServer::closeConnection(connection);
+}
+
+bool ControlApi::authorize(const HttpRequest &request, HttpResponse &rejection) const {
+    // A page on a rebound DNS name reaches a loopback listener with its own
+    // name in Host, so only loopback names pass there; IP literals are also
+    // accepted on other addresses, where a token is always configured.
+    if (settings.value("socket").toString().isEmpty()) {
+        QString host = hostName(request.headers.value("host"));
+        bool loopbackListener = QHostAddress(settings.value("address").toString()).isLoopback();
+        if (!isLoopbackHost(host) && (loopbackListener || QHostAddress(host).isNull())) {
+            rejection = HttpResponse::error(403, "Host " + host + " is not allowed.");
+            return false;
+        }
+    }
+    QString token = settings.value("token").toString();
+    if (!token.isEmpty() && !constantTimeEquals(request.headers.value("authorization"), "Bearer " + token.toUtf8())) {
+        rejection = HttpResponse::error(401, "Missing or invalid bearer token.");
+        rejection.headers.append(qMakePair(QByteArray("WWW-Authenticate"), QByteArray("Bearer")));
+        return false;
+    }
+    bool mutating = request.method == "POST" || request.method == "PUT" || request.method == "PATCH";
+    if (mutating && !request.headers.value("content-type").startsWith("application/json")) {
+        rejection = HttpResponse::error(415, "Requests that change state must use Content-Type: application/json.");
+        return false;
+    }
+    return true;
+}
+
+void ControlApi::registerRoutes() {
+    auto guarded = [this](std::function<HttpResponse(const HttpRequest&)> handler) {
+        return [this, handler](const HttpRequest& request) {
+            HttpResponse rejection;
+            if (!authorize(request, rejection)) {
+                return rejection;
+            }
+            return handler(request);
+        };
+    };
+    auto guardedStream = [this](void (ControlApi::*handler)(const HttpRequest&, QIODevice*)) {
+        return [this, handler](const HttpRequest& request, QIODevice* connection) {
+            HttpResponse rejection;
+            if (!authorize(request, rejection)) {
+                reply(connection, rejection);
+                return;
+            }
+            (this->*handler)(request, connection);
+        };
+    };
+
+    httpServer.route("GET", "/api/servers", guarded([this](const HttpRequest&) {
+        return listServers();
+    }));
+    httpServer.route("GET", "/api/servers/*", guarded([this](const HttpRequest& request) {
+        QStringList segments = pathSegments(request.path);
+        if (segments.size() == 3) {
+            return serverStatus(segments.at(2));
+        }
+        if (segments.size() == 4 && segments.at(3) == "config" && isKnownServer(segments.at(2))) {
+            return HttpResponse::json(ServerManager::getInstance().getFacade().getServerConfiguration(segments.at(2)));
+        }
+        return HttpResponse::error(404, "Not found");
+    }));
+    httpServer.route("GET", "/api/ports", guarded([](const HttpRequest&) {
+        return HttpResponse::json(ServerManager::getInstance().getFacade().getPortReservations());
+    }));
+    httpServer.routeStream("POST", "/api/servers/*", guardedStream(&ControlApi::handleServerAction));
+    httpServer.routeStream("PUT", "/api/servers/*", guardedStream(&ControlApi::handleServerConfig));
+    httpServer.routeStream("PATCH", "/api/servers/*", guardedStream(&ControlApi::handleServerConfig));
+    httpServer.routeStream("POST", "/api/bulk", guardedStream(&ControlApi::handleBulk));
+    httpServer.route("GET", "/api/profiles", guarded([](const HttpRequest&) {
+        ServerFacade& facade = ServerManager::getInstance().getFacade();
+        QJsonObject body;
+        body["profiles"] = facade.getWorkspaceProfiles();
+        body["active"] = facade.getActiveWorkspaceProfile();
+        return HttpResponse::json(body);
+    }));
+    httpServer.routeStream("POST", "/api/profiles/*", guardedStream(&ControlApi::handleWorkspaceProfile));
+    httpServer.routeStream("GET", "/api/events", guardedStream(&ControlApi::handleEventStream));
+    httpServer.routeStream("GET", "/api/events/poll", guardedStream(&ControlApi::handlePoll));
+}
+
+HttpResponse ControlApi::listServers() const {
+    ServerFacade& facade = ServerManager::getInstance().getFacade();
+    QJsonArray servers;
+    const QStringList serverNames = facade.getServerNames();
+    for (const QString& serverName : serverNames) {
+        QJsonObject status = facade.getServerStatus(serverName);
+        status["name"] = serverName;
+        servers.append(status);
+    }
+    QJsonObject body;
+    body["servers"] = servers;
+    body["sequence"] = sequence;
+    return HttpResponse::json(body);
+}
+
+HttpResponse ControlApi::serverStatus(const QString &serverName) const {
+    if (!isKnownServer(serverName)) {
+        return HttpResponse::error(404, "Server " + serverName + " not found.");
+    }
+    ServerFacade& facade = ServerManager::getInstance().getFacade();
+    QJsonObject status = facade.getServerStatus(serverName);
+    status["name"] = serverName;
+    status["config"] = facade.getServerConfiguration(serverName);
+    return HttpResponse::json(status);
+}
+
+void ControlApi::handleServerAction(const HttpRequest &request, QIODevice *connection) {
+    static const QStringList actions = QStringList() << "start" << "stop" << "restart" << "reload";
+    QStringList segments = pathSegments(request.path);
+    if (segments.size() != 4 || !isKnownServer(segments.at(2))) {
+        reply(connection, HttpResponse::error(404, "Not found"));
+        return;
+    }
+    if (!actions.contains(segments.at(3))) {
+        reply(connection, HttpResponse::error(404, "Unknown action " + segments.at(3) + "; expected one of " + actions.join(", ") + "."));
+        return;
+    }
+    ServerJob job;
+    job.serverName = segments.at(2);
+    job.action = segments.at(3);
+    runJobs(connection, QList<ServerJob>() << job, true);
+}
+
+void ControlApi::handleServerConfig(const HttpRequest &request, QIODevice *connection) {
+    QStringList segments = pathSegments(request.path);
+    if (segments.size() != 4 || segments.at(3) != "config" || !isKnownServer(segments.at(2))) {
+        reply(connection, HttpResponse::error(404, "Not found"));
+        return;
+    }
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(request.body, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        reply(connection, HttpResponse::error(400, "The request body must be a JSON object."));
+        return;
+    }
+    ServerJob job;
+    job.serverName = segments.at(2);
+    job.config = document.object();
+    job.hasConfig = true;
+    job.restartIfRunning = request.query.queryItemValue("restart") != "false";
+    runJobs(connection, QList<ServerJob>() << job, true);
+}
+
+void ControlApi::handleBulk(const HttpRequest &request, QIODevice *connection) {
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(request.body, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        reply(connection, HttpResponse::error(400, "The request body must be a JSON object."));
+        return;
+    }
+    QJsonObject body = document.object();
+    QJsonObject configs = body.value("config").toObject();
+    bool restart = body.value("restart").toBool(true);
+    QHash<QString, ServerJob> jobs;
+    for (auto it = configs.begin(); it != configs.end(); ++it) {
+        if (!isKnownServer(it.key()) || !it.value().isObject()) {
+            reply(connection, HttpResponse::error(400, "Invalid configuration for server " + it.key() + "."));
+            return;
+        }
+        ServerJob& job = jobs[it.key()];
+        job.serverName = it.key();
+        job.config = it.value().toObject();
+        job.hasConfig = true;
+        job.restartIfRunning = restart;
+    }
+    static const QStringList actions = QStringList() << "start" << "stop" << "restart" << "reload";
+    for (const QString& action : actions) {
+        const QJsonArray serverNames = body.value(action).toArray();
+        for (const QJsonValue& value : serverNames) {
+            QString serverName = value.toString();
+            if (!isKnownServer(serverName)) {
+                reply(connection, HttpResponse::error(400, "Server " + serverName + " not found."));
+                return;
+            }
+            if (!jobs.value(serverName).action.isEmpty()) {
+                reply(connection, HttpResponse::error(400, "Server " + serverName + " has more than one action."));
+                return;
+            }
+            jobs[serverName].serverName = serverName;
+            jobs[serverName].action = action;
+        }
+    }
+    if (jobs.isEmpty()) {
+        reply(connection, HttpResponse::error(400, "The bulk request does not contain any configuration or action."));
+        return;
+    }
+    runJobs(connection, jobs.values(), false);
+}
+
+void ControlApi::runJobs(QIODevice *connection, const QList<ServerJob> &jobs, bool singleServer) {
+    ServerFacade& facade = ServerManager::getInstance().getFacade();
+    auto batch = std::make_shared<JobBatch>();
+    batch->connection = connection;
+    batch->remaining = jobs.size();
+    batch->singleServer = singleServer;
+
+    for (const ServerJob& job : jobs) {
+        auto result = std::make_shared<QJsonObject>();
+        QFuture<void> future = facade.getTaskPool().submit(job.serverName, "control API " + (job.hasConfig ? QString("configure") : job.action), [job, result]() {
+            ServerFacade& facade = ServerManager::getInstance().getFacade();
+            QJsonArray performed;
+            bool running = facade.getServerState(job.serverName);
+            if (job.hasConfig) {
+                if (running) {
+                    if (!job.restartIfRunning) {
+                        throw std::runtime_error("The server is running; configuration can only be applied with restart enabled.");
+                    }
+                    facade.stopServer(job.serverName);
+                    if (!facade.waitForServerState(job.serverName, false, 5000)) {
+                        throw std::runtime_error("Timed out waiting for the server to stop.");
+                    }
+                }
+                QStringList validationErrors;
+                facade.runOnFacadeThread([&facade, &job, &validationErrors]() {
+                    validationErrors = facade.applyServerConfiguration(job.serverName, job.config);
+                });
+                (*result)["applied"] = true;
+                (*result)["validation_errors"] = QJsonArray::fromStringList(validationErrors);
+                if (running) {
+                    facade.startServer(job.serverName);
+                    performed.append("restart");
+                }
+            }
+            bool expectRunning = facade.getServerState(job.serverName);
+            if (job.action == "start" && !facade.getServerState(job.serverName)) {
+                facade.startServer(job.serverName);
+                performed.append("start");
+                expectRunning = true;
+            } else if (job.action == "stop" && facade.getServerState(job.serverName)) {
+                facade.stopServer(job.serverName);
+                performed.append("stop");
+                expectRunning = false;
+            } else if ((job.action == "restart" || (job.action == "reload" && running)) && !performed.contains("restart")) {
+                facade.restartServer(job.serverName);
+                performed.append("restart");
+                expectRunning = true;
+            } else if (job.hasConfig && running) {
+                expectRunning = true;
+            }
+            facade.waitForServerState(job.serverName, expectRunning, 2000);
+            (*result)["performed"] = performed;
+        });
+
+        QString serverName = job.serverName;
+        auto finish = [this, batch, result, serverName](const QString& error) {
+            ServerFacade& facade = ServerManager::getInstance().getFacade();
+            QJsonObject entry = *result;
+            if (entry.value("applied").toBool()) {
+                try {
+                    facade.saveServerConfiguration(serverName);
+                } catch (const std::runtime_error& e) {
+                    entry["save_error"] = QString::fromUtf8(e.what());
+                    batch->failed = true;
+                }
+            }
+            entry["ok"] = error.isEmpty();
+            if (!error.isEmpty()) {
+                entry["error"] = error;
+                batch->failed = true;
+            }
+            entry["status"] = facade.getServerStatus(serverName);
+            batch->results[serverName] = entry;
+            if (--batch->remaining > 0) {
+                return;
+            }
+            QJsonObject body;
+            if (batch->singleServer) {
+                body = batch->results.value(serverName).toObject();
+                body["server"] = serverName;
+            } else {
+                body["ok"] = !batch->failed;
+                body["servers"] = batch->results;
+            }
+            reply(batch->connection, HttpResponse::json(body, batch->failed ? 500 : 200));
+        };
+        future.then(this, [finish]() {
+            finish(QString());
+        }).onFailed(this, [finish](const std::exception& e) {
+            finish(QString::fromUtf8(e.what()));
+        }).onCanceled(this, [finish]() {
+            finish("The operation was cancelled.");
+        });
+    }
+}
+
+void ControlApi::handleWorkspaceProfile(const HttpRequest &request, QIODevice *connection) {
+    static const QStringList actions = QStringList() << "activate" << "deactivate";
+    QStringList segments = pathSegments(request.path);
+    if (segments.size() != 4 || !actions.contains(segments.at(3))) {
+        reply(connection, HttpResponse::error(404, "Not found"));
+        return;
+    }
+    QString name = segments.at(2);
+    QString action = segments.at(3);
+    auto result = std::make_shared<QJsonObject>();
+    ServerFacade& facade = ServerManager::getInstance().getFacade();
+    QFuture<void> future = facade.getTaskPool().submit("workspace", "control API " + action + " workspace profile " + name, [name, action, result]() {
+        ServerFacade& facade = ServerManager::getInstance().getFacade();
+        if (action == "activate") {
+            *result = facade.activateWorkspaceProfile(name);
+            return;
+        }
+        QString active;
+        facade.runOnFacadeThread([&facade, &active]() {
+            active = facade.getActiveWorkspaceProfile();
+        });
+        if (active != name) {
+            QString errMsg = "Failed to deactivate workspace profile: " + name + " is not active.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        *result = facade.deactivateWorkspaceProfile();
+    });
+
+    QPointer<QIODevice> target(connection);
+    future.then(this, [this, target, result]() {
+        QJsonObject body = *result;
+        body["ok"] = true;
+        reply(target, HttpResponse::json(body));
+    }).onFailed(this, [this, target](const std::exception& e) {
+        reply(target, HttpResponse::error(500, QString::fromUtf8(e.what())));
+    }).onCanceled(this, [this, target]() {
+        reply(target, HttpResponse::error(500, "The operation was cancelled."));
+    });
+}
+
+void ControlApi::handleEventStream(const HttpRequest &request, QIODevice *connection) {
+    QByteArray head = "HTTP/1.1 200 OK\r\n"
+                      "Content-Type: text/event-stream\r\n"
+                      "Cache-Control: no-cache\r\n"
+                      "Connection: keep-alive\r\n\r\n";
+    connection->write(head);
+    connection->write("retry: 2000\n\n");
+    bool ok = false;
+    qint64 lastEventId = request.headers.value("last-event-id").toLongLong(&ok);
+    if (ok) {
+        const QJsonArray missed = eventsSince(lastEventId);
+        for (const QJsonValue& event : missed) {
+            QJsonObject object = event.toObject();
+            connection->write("id: " + QByteArray::number(object.value("id").toInteger()) + "\nevent: " + object.value("type").toString().toUtf8()
+                              + "\ndata: " + QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n\n");
+        }
+    }
+    eventStreams.append(QPointer<QIODevice>(connection));
+}
+
+void ControlApi::handlePoll(const HttpRequest &request, QIODevice *connection) {
+    bool ok = false;
+    qint64 since = request.query.queryItemValue("since").toLongLong(&ok);
+    if (!ok) {
+        since = sequence;
+    }
+    int timeout = request.query.queryItemValue("timeout").toInt(&ok);
+    if (!ok || timeout <= 0) {
+        timeout = defaultPollTimeout;
+    }
+    timeout = qMin(timeout, maxPollTimeout);
+
+    QJsonArray events = eventsSince(since);
+    if (!events.isEmpty()) {
+        QJsonObject body;
+        body["events"] = events;
+        body["sequence"] = sequence;
+        reply(connection, HttpResponse::json(body));
+        return;
+    }
+
+    PendingPoll poll;
+    poll.connection = connection;
+    poll.since = since;
+    poll.timer = new QTimer(this);
+    poll.timer->setSingleShot(true);
+    QTimer* timer = poll.timer;
+    connect(timer, &QTimer::timeout, this, [this, timer]() {
+        for (int i = 0; i < pendingPolls.size(); ++i) {
+            if (pendingPolls.at(i).timer == timer) {
+                PendingPoll expired = pendingPolls.takeAt(i);
+                QJsonObject body;
+                body["events"] = QJsonArray();
+                body["sequence"] = sequence;
+                reply(expired.connection, HttpResponse::json(body));
+                break;
+            }
+        }
+        timer->deleteLater();
+    });
+    pendingPolls.append(poll);
+    timer->start(timeout);
+}
+
+QStringList ControlApi::pathSegments(const QString &path) {
+    return path.split('/', Qt::SkipEmptyParts);
+}
+
+bool ControlApi::isKnownServer(const QString &serverName) {
+    return ServerManager::getInstance().getFacade().getServerNames().contains(serverName);
+}
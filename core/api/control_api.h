@@ -0,0 +1,83 @@
+#ifndef CONTROL_API_H
+#define CONTROL_API_H
+
+#include "../../utility/http_server.h"
+#include <QObject>
+#include <QPointer>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTimer>
+#include <QFuture>
+#include <QList>
+#include <functional>
+
+class ControlApi : public QObject {
+    Q_OBJECT
+public:
+    static const int maxRecentEvents = 256;
+    static const int defaultPollTimeout = 25000;
+    static const int maxPollTimeout = 60000;
+    static const int keepAliveInterval = 15000;
+
+    explicit ControlApi(QObject *parent = nullptr);
+    ~ControlApi();
+
+    static void validateSettings(const QJsonObject& settings);
+    void setSettings(const QJsonObject& settings);
+    QJsonObject getSettings() const;
+    bool start();
+    void stop();
+    bool isListening() const;
+    QString errorString() const;
+
+public slots:
+    void publishState(const QString& serverName, bool isRunning);
+    void publishWarning(const QString& serverName, const QString& message);
+    void publishError(const QString& title, const QString& message);
+
+private:
+    struct PendingPoll {
+        QPointer<QIODevice> connection;
+        qint64 since;
+        QTimer* timer;
+    };
+
+    struct ServerJob {
+        QString serverName;
+        QJsonObject config;
+        bool hasConfig = false;
+        bool restartIfRunning = true;
+        QString action;
+    };
+
+    HttpServer httpServer;
+    QJsonObject settings{{"enabled", false}, {"address", "127.0.0.1"}, {"port", 9465}, {"socket", ""}, {"token", ""}};
+    QString lastError;
+    QList<QJsonObject> recentEvents;
+    qint64 sequence = 0;
+    QList<QPointer<QIODevice>> eventStreams;
+    QList<PendingPoll> pendingPolls;
+    QTimer keepAliveTimer;
+
+    void registerRoutes();
+    bool authorize(const HttpRequest& request, HttpResponse& rejection) const;
+    void publish(QJsonObject event);
+    void flushPolls();
+    QJsonArray eventsSince(qint64 since) const;
+    void reply(QPointer<QIODevice> connection, const HttpResponse& response);
+    void runJobs(QIODevice* connection, const QList<ServerJob>& jobs, bool singleServer);
+
+    HttpResponse listServers() const;
+    HttpResponse serverStatus(const QString& serverName) const;
+    void handleServerAction(const HttpRequest& request, QIODevice* connection);
+    void handleServerConfig(const HttpRequest& request, QIODevice* connection);
+    void handleBulk(const HttpRequest& request, QIODevice* connection);
+    void handleWorkspaceProfile(const HttpRequest& request, QIODevice* connection);
+    void handleEventStream(const HttpRequest& request, QIODevice* connection);
+    void handlePoll(const HttpRequest& request, QIODevice* connection);
+
+    static QStringList pathSegments(const QString& path);
+    static bool isKnownServer(const QString& serverName);
+};
+
+#endif // CONTROL_API_H
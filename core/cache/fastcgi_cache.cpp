@@ -0,0 +1,258 @@
+#include "fastcgi_cache.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QJsonArray>
+#include <QUrl>
+
+const QString FastCGICache::zoneName = "WEBDEVTOOLKIT";
+
+FastCGICache FastCGICache::fromJson(const QJsonObject &settings) {
+    FastCGICache cache;
+    cache.enabled = settings.value("enabled").toBool(false);
+    cache.zoneSizeMb = settings.value("zone_size_mb").toInt(cache.zoneSizeMb);
+    cache.maxSizeMb = settings.value("max_size_mb").toInt(cache.maxSizeMb);
+    cache.inactive = settings.value("inactive").toString(cache.inactive);
+    cache.ttl = settings.value("ttl").toInt(cache.ttl);
+    if (cache.zoneSizeMb <= 0 || cache.maxSizeMb <= 0 || cache.ttl < 0) {
+        throw std::runtime_error("Invalid FastCGI cache settings: zone size, maximum size and TTL must be positive.");
+    }
+    if (!QRegularExpression(R"(^\d+[smhd]?$)").match(cache.inactive).hasMatch()) {
+        QString errMsg = "Invalid FastCGI cache settings: invalid inactive time " + cache.inactive + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    const QJsonObject locations = settings.value("locations").toObject();
+    for (auto it = locations.begin(); it != locations.end(); ++it) {
+        if (!it.key().startsWith('/') || it.key().contains(QRegularExpression(R"([\s;{}"'])")) || it.value().toInt(-1) < 0) {
+            QString errMsg = "Invalid FastCGI cache settings: invalid location TTL for " + it.key() + ".";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        cache.locationTtls[it.key()] = it.value().toInt();
+    }
+
+    if (settings.contains("bypass_cookies")) {
+        cache.bypassCookies.clear();
+        const QJsonArray cookies = settings.value("bypass_cookies").toArray();
+        for (const QJsonValue& cookie : cookies) {
+            QString name = cookie.toString();
+            if (!QRegularExpression(R"(^[A-Za-z0-9_.-]+$)").match(name).hasMatch()) {
+                QString errMsg = "Invalid FastCGI cache settings: invalid bypass cookie name " + name + ".";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+            cache.bypassCookies.append(name);
+        }
+    }
+    return cache;
+}
+
+QJsonObject FastCGICache::toJson() const {
+    QJsonObject settings;
+    settings["enabled"] = enabled;
+    settings["zone_size_mb"] = zoneSizeMb;
+    settings["max_size_mb"] = maxSizeMb;
+    settings["inactive"] = inactive;
+    settings["ttl"] = ttl;
+    QJsonObject locations;
+    for (auto it = locationTtls.begin(); it != locationTtls.end(); ++it) {
+        locations[it.key()] = it.value();
+    }
+    settings["locations"] = locations;
+    settings["bypass_cookies"] = QJsonArray::fromStringList(bypassCookies);
+    return settings;
+}
+
+bool FastCGICache::isEnabled() const {
+    return enabled;
+}
+
+void FastCGICache::setEnabled(bool enabled) {
+    this->enabled = enabled;
+}
+
+QString FastCGICache::renderHttpConfig(const QString &cachePath) const {
+    QStringList lines;
+    lines << "fastcgi_cache_path \"" + QDir::fromNativeSeparators(cachePath) + "\" levels=1:2 keys_zone=" + zoneName + ":"
+             + QString::number(zoneSizeMb) + "m max_size=" + QString::number(maxSizeMb) + "m inactive=" + inactive + " use_temp_path=off;";
+    lines << "fastcgi_cache_key \"$scheme$host$request_uri\";";
+    lines << "fastcgi_cache " + zoneName + ";";
+    lines << "fastcgi_cache_valid 200 301 302 " + QString::number(ttl) + "s;";
+    lines << "fastcgi_cache_valid 404 1s;";
+    lines << "fastcgi_cache_lock on;";
+    lines << "fastcgi_cache_use_stale error timeout updating http_500 http_503;";
+    lines << "fastcgi_cache_background_update on;";
+    lines << "";
+    lines << "map $request_method $webdevtoolkit_cache_skip_method {";
+    lines << "    default 1;";
+    lines << "    GET 0;";
+    lines << "    HEAD 0;";
+    lines << "}";
+    lines << "map $http_cookie $webdevtoolkit_cache_skip_cookie {";
+    lines << "    default 0;";
+    if (!bypassCookies.isEmpty()) {
+        lines << "    \"~*(" + bypassCookies.join('|') + ")\" 1;";
+    }
+    lines << "}";
+    lines << "fastcgi_cache_bypass $webdevtoolkit_cache_skip_method $webdevtoolkit_cache_skip_cookie $arg_nocache;";
+    lines << "fastcgi_no_cache $webdevtoolkit_cache_skip_method $webdevtoolkit_cache_skip_cookie $arg_nocache;";
+    lines << "";
+    lines << "log_format webdevtoolkit_cache '$remote_addr - $remote_user [$time_local] \"$request\" $status $body_bytes_sent "
+             "\"$http_referer\" \"$http_user_agent\" cache=$upstream_cache_status';";
+    lines << "access_log logs/access.log webdevtoolkit_cache;";
+    return lines.join('\n') + '\n';
+}
+
+QString FastCGICache::renderLocations(const QString &root, const QString &fastcgiPass) const {
+    QStringList lines;
+    for (auto it = locationTtls.begin(); it != locationTtls.end(); ++it) {
+        lines << "location ~ ^" + QRegularExpression::escape(it.key()) + ".*\\.php$ {";
+        lines << "    root " + root + ";";
+        lines << "    fastcgi_pass " + fastcgiPass + ";";
+        lines << "    fastcgi_index index.php;";
+        lines << "    fastcgi_param SCRIPT_FILENAME $document_root$fastcgi_script_name;";
+        lines << "    include fastcgi_params;";
+        lines << "    add_header X-Cache-Status $upstream_cache_status;";
+        if (it.value() == 0) {
+            lines << "    fastcgi_cache off;";
+        } else {
+            lines << "    fastcgi_cache_valid 200 301 302 " + QString::number(it.value()) + "s;";
+        }
+        lines << "}";
+    }
+    return lines.join('\n') + '\n';
+}
+
+QString FastCGICache::setStatusHeader(const QString &phpLocation, bool enabled) {
+    // An add_header at http level is dropped by every block with its own
+    // add_header, so the header is emitted inside the PHP location itself.
+    QString result = phpLocation;
+    result.remove(QRegularExpression(R"(\n[ \t]*add_header\s+X-Cache-Status\s[^;]*;)"));
+    if (!enabled) {
+        return result;
+    }
+    QRegularExpressionMatch match = QRegularExpression(R"(\n([ \t]*)fastcgi_pass\s[^;]*;)").match(result);
+    if (match.hasMatch()) {
+        result.insert(match.capturedEnd(), "\n" + match.captured(1) + "add_header X-Cache-Status $upstream_cache_status;");
+    }
+    return result;
+}
+
+QString FastCGICache::cacheKey(const QString &url) {
+    QUrl parsed(url);
+    if (!parsed.isValid() || parsed.scheme().isEmpty() || parsed.host().isEmpty()) {
+        return url;
+    }
+    QString requestUri = QString::fromUtf8(parsed.toEncoded(QUrl::RemoveScheme | QUrl::RemoveAuthority | QUrl::RemoveFragment));
+    if (requestUri.isEmpty()) {
+        requestUri = "/";
+    }
+    return parsed.scheme() + parsed.host() + requestUri;
+}
+
+QString FastCGICache::cacheFilePath(const QDir &cacheDir, const QString &key) {
+    QString hash = QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex());
+    return cacheDir.filePath(hash.right(1) + "/" + hash.mid(hash.size() - 3, 2) + "/" + hash);
+}
+
+QString FastCGICache::readKey(const QString &filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    QByteArray header = file.read(4096);
+    int start = header.indexOf("\nKEY: ");
+    if (start < 0) {
+        return QString();
+    }
+    start += 6;
+    int end = header.indexOf('\n', start);
+    return QString::fromUtf8(header.mid(start, end < 0 ? -1 : end - start));
+}
+
+QJsonObject FastCGICache::purge(const QDir &cacheDir, const QString &target) {
+    int removed = 0;
+    qint64 bytes = 0;
+    if (cacheDir.exists()) {
+        if (target.isEmpty() || target == "*") {
+            QDirIterator it(cacheDir.absolutePath(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                qint64 size = it.fileInfo().size();
+                if (QFile::remove(it.filePath())) {
+                    removed++;
+                    bytes += size;
+                }
+            }
+        } else if (target.endsWith('*')) {
+            QString prefix = cacheKey(target.chopped(1));
+            QDirIterator it(cacheDir.absolutePath(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                qint64 size = it.fileInfo().size();
+                if (readKey(it.filePath()).startsWith(prefix) && QFile::remove(it.filePath())) {
+                    removed++;
+                    bytes += size;
+                }
+            }
+        } else {
+            QString filePath = cacheFilePath(cacheDir, cacheKey(target));
+            qint64 size = QFileInfo(filePath).size();
+            if (QFile::remove(filePath)) {
+                removed++;
+                bytes += size;
+            }
+        }
+    }
+    qDebug() << "FastCGI cache purge" << (target.isEmpty() ? "*" : target) << "removed" << removed << "entries.";
+    QJsonObject result;
+    result["target"] = target.isEmpty() ? "*" : target;
+    result["removed"] = removed;
+    result["bytes"] = bytes;
+    return result;
+}
+
+void FastCGICache::keepStats(const FastCGICache &previous) {
+    statsOffset = previous.statsOffset;
+    statusCounts = previous.statusCounts;
+}
+
+QJsonObject FastCGICache::readStats(const QString &accessLogPath) {
+    QFile log(accessLogPath);
+    if (log.open(QIODevice::ReadOnly)) {
+        if (log.size() < statsOffset) {
+            statsOffset = 0;
+            statusCounts.clear();
+        }
+        log.seek(statsOffset);
+        static const QRegularExpression statusRegex(R"(cache=([A-Z-]+)\s*$)");
+        while (!log.atEnd()) {
+            QByteArray line = log.readLine();
+            if (!line.endsWith('\n')) {
+                break;
+            }
+            statsOffset += line.size();
+            QRegularExpressionMatch match = statusRegex.match(QString::fromUtf8(line));
+            if (match.hasMatch() && match.captured(1) != "-") {
+                statusCounts[match.captured(1)]++;
+            }
+        }
+        log.close();
+    }
+
+    qint64 hits = statusCounts.value("HIT") + statusCounts.value("STALE") + statusCounts.value("UPDATING") + statusCounts.value("REVALIDATED");
+    qint64 misses = statusCounts.value("MISS") + statusCounts.value("EXPIRED");
+    QJsonObject counts;
+    for (auto it = statusCounts.begin(); it != statusCounts.end(); ++it) {
+        counts[it.key().toLower()] = it.value();
+    }
+    QJsonObject stats;
+    stats["counts"] = counts;
+    stats["hits"] = hits;
+    stats["misses"] = misses;
+    stats["bypassed"] = statusCounts.value("BYPASS");
+    stats["hit_ratio"] = hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0;
+    return stats;
+}
@@ -0,0 +1,46 @@
+#ifndef FASTCGI_CACHE_H
+#define FASTCGI_CACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QMap>
+#include <QDir>
+
+class FastCGICache {
+public:
+    static const QString zoneName;
+
+    static FastCGICache fromJson(const QJsonObject& settings);
+    QJsonObject toJson() const;
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+
+    QString renderHttpConfig(const QString& cachePath) const;
+    QString renderLocations(const QString& root, const QString& fastcgiPass) const;
+    static QString setStatusHeader(const QString& phpLocation, bool enabled);
+
+    static QString cacheKey(const QString& url);
+    static QString cacheFilePath(const QDir& cacheDir, const QString& key);
+    static QJsonObject purge(const QDir& cacheDir, const QString& target);
+
+    QJsonObject readStats(const QString& accessLogPath);
+    void keepStats(const FastCGICache& previous);
+
+private:
+    bool enabled = false;
+    int zoneSizeMb = 16;
+    int maxSizeMb = 256;
+    QString inactive = "10m";
+    int ttl = 10;
+    QMap<QString, int> locationTtls;
+    QStringList bypassCookies = QStringList() << "PHPSESSID" << "wordpress_logged_in" << "comment_author";
+
+    qint64 statsOffset = 0;
+    QMap<QString, qint64> statusCounts;
+
+    static QString readKey(const QString& filePath);
+};
+
+#endif // FASTCGI_CACHE_H
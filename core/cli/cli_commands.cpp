@@ -0,0 +1,372 @@
+#include "cli_commands.h"
+#include "../singleton/server_manager.h"
+#include "../config/configuration_manager.h"
+#include "../tuning/nginx_tuning_profile.h"
+#include "../tuning/apache_tuning_profile.h"
+#include "../mysql/slow_query_log.h"
+#include "../mysql/mysql_status_poller.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFile>
+#include <QTextStream>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTcpSocket>
+#include <QLocalSocket>
+#include <QHostAddress>
+#include <memory>
+#include <csignal>
+
+namespace {
+
+volatile std::sig_atomic_t interrupted = 0;
+
+void onInterrupt(int) {
+    interrupted = 1;
+}
+
+// Sends a POST request to the control API of a running instance so that it
+// repoints its own servers. Returns false when no instance is listening.
+bool requestRunningInstance(const QString& path, QJsonObject& response) {
+    QJsonObject settings = ConfigurationManager::getInstance().getConfiguration()["control_api"].toObject();
+    if (!settings["enabled"].toBool()) {
+        return false;
+    }
+    std::unique_ptr<QIODevice> connection;
+    QString socketPath = settings["socket"].toString();
+    if (socketPath.isEmpty()) {
+        auto socket = std::make_unique<QTcpSocket>();
+        socket->connectToHost(QHostAddress(settings["address"].toString()), quint16(settings["port"].toInt()));
+        if (!socket->waitForConnected(1000)) {
+            return false;
+        }
+        connection = std::move(socket);
+    } else {
+        auto socket = std::make_unique<QLocalSocket>();
+        socket->connectToServer(socketPath);
+        if (!socket->waitForConnected(1000)) {
+            return false;
+        }
+        connection = std::move(socket);
+    }
+
+    QByteArray request = "POST " + path.toUtf8() + " HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Content-Length: 0\r\n"
+        "Connection: close\r\n";
+    QString token = settings["token"].toString();
+    if (!token.isEmpty()) {
+        request += "Authorization: Bearer " + token.toUtf8() + "\r\n";
+    }
+    request += "\r\n";
+    connection->write(request);
+
+    QByteArray data;
+    while (connection->waitForReadyRead(120000)) {
+        data += connection->readAll();
+    }
+    data += connection->readAll();
+    int bodyStart = data.indexOf("\r\n\r\n");
+    if (bodyStart < 0) {
+        throw std::runtime_error("The running instance closed the control API connection without a response.");
+    }
+    QJsonDocument document = QJsonDocument::fromJson(data.mid(bodyStart + 4));
+    response = document.object();
+    int status = data.left(data.indexOf("\r\n")).split(' ').value(1).toInt();
+    if (status != 200) {
+        QString errMsg = "The running instance rejected the request (HTTP " + QString::number(status) + "): " + response["error"].toString();
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return true;
+}
+
+}
+
+void CliCommands::addOptions(QCommandLineParser &parser) {
+    parser.addOption(QCommandLineOption("mysql-snapshot-list", "List MySQL data directory snapshots."));
+    parser.addOption(QCommandLineOption("mysql-snapshot-create", "Create a named snapshot of the stopped MySQL data directory.", "name"));
+    parser.addOption(QCommandLineOption("mysql-snapshot-restore", "Restore the MySQL data directory from a named snapshot.", "name"));
+    parser.addOption(QCommandLineOption("mysql-snapshot-delete", "Delete a named MySQL snapshot.", "name"));
+    parser.addOption(QCommandLineOption("apache-profile", "Apply and validate an Apache MPM/mod_fcgid tuning profile for the active Apache version (" + ApacheTuningProfile::availableProfiles().join(", ") + ").", "profile"));
+    parser.addOption(QCommandLineOption("apache-concurrency", "Expected concurrent requests used to derive the Apache tuning profile.", "requests"));
+    parser.addOption(QCommandLineOption("opcache-preload", "Generate an OPcache preload script from the hottest files of a server's document root.", "server"));
+    parser.addOption(QCommandLineOption("opcache-status", "Print OPcache hit rate and memory usage of a running server.", "server"));
+    parser.addOption(QCommandLineOption("precompress", "Write .gz/.br siblings for changed static assets in a server's document root and enable serving them.", "server"));
+    parser.addOption(QCommandLineOption("nginx-profile", "Apply and validate an Nginx performance profile (" + NginxTuningProfile::availableProfiles().join(", ") + ").", "profile"));
+    parser.addOption(QCommandLineOption("fastcgi-cache", "Enable or disable the Nginx FastCGI micro-cache (on, off).", "state"));
+    parser.addOption(QCommandLineOption("fastcgi-cache-purge", "Purge a URL, a URL prefix ending with *, or the whole Nginx FastCGI cache zone (all).", "target"));
+    parser.addOption(QCommandLineOption("fastcgi-cache-stats", "Print Nginx FastCGI cache hit/miss ratios from the access log."));
+    parser.addOption(QCommandLineOption("tls-enable", "Issue local CA-signed certificates and enable the TLS/HTTP2 listener of a server (apache, nginx).", "server"));
+    parser.addOption(QCommandLineOption("tls-disable", "Disable the TLS/HTTP2 listener of a server (apache, nginx).", "server"));
+    parser.addOption(QCommandLineOption("ports", "Print port reservations, allocation ranges and conflicts."));
+    parser.addOption(QCommandLineOption("ports-auto-assign", "Move every port that is already in use to a free port from its configured range."));
+    parser.addOption(QCommandLineOption("mysql-slow-log", "Enable or disable the MySQL slow query log on the next start (on, off).", "state"));
+    parser.addOption(QCommandLineOption("mysql-long-query-time", "Seconds after which a MySQL query is written to the slow query log.", "seconds"));
+    parser.addOption(QCommandLineOption("mysql-slow-queries", "Print the top MySQL query fingerprints aggregated from the slow query log."));
+    parser.addOption(QCommandLineOption("mysql-slow-queries-limit", "Number of fingerprints printed by --mysql-slow-queries (default 20).", "count"));
+    parser.addOption(QCommandLineOption("mysql-slow-queries-order", "Ordering of --mysql-slow-queries (" + SlowQueryLog::orderings().join(", ") + ").", "order"));
+    parser.addOption(QCommandLineOption("mysql-slow-queries-follow", "Keep reading the slow query log and print the top fingerprints every two seconds."));
+    parser.addOption(QCommandLineOption("mysql-status", "Connect to the running MySQL server and print QPS, threads, buffer pool hit ratio, row lock waits and temporary table rates."));
+    parser.addOption(QCommandLineOption("workspace-list", "List stored workspace profiles."));
+    parser.addOption(QCommandLineOption("workspace-create", "Render the Apache, Nginx and MySQL configuration files of a named workspace profile once and store them content-addressed.", "name"));
+    parser.addOption(QCommandLineOption("workspace-settings", "JSON file with per-server settings (apache, nginx, mysql) used by --workspace-create.", "file"));
+    parser.addOption(QCommandLineOption("workspace-activate", "Point the servers at the pre-rendered configuration of a workspace profile.", "name"));
+    parser.addOption(QCommandLineOption("workspace-deactivate", "Return the servers to the configuration from config.json."));
+    parser.addOption(QCommandLineOption("workspace-delete", "Delete a stored workspace profile.", "name"));
+    parser.addOption(QCommandLineOption("versions", "Print the installed server and PHP versions found under ./bin."));
+    parser.addOption(QCommandLineOption("versions-prune", "Remove configured versions whose ./bin directory no longer exists from config.json."));
+    parser.addOption(QCommandLineOption("trace-out", "Record startup, configuration, server and probe spans and write them as a Chrome/Perfetto trace on exit.", "file"));
+}
+
+bool CliCommands::hasCommand(const QCommandLineParser &parser) {
+    return parser.isSet("mysql-snapshot-list")
+           || parser.isSet("mysql-snapshot-create")
+           || parser.isSet("mysql-snapshot-restore")
+           || parser.isSet("mysql-snapshot-delete")
+           || parser.isSet("workspace-list")
+           || parser.isSet("workspace-create")
+           || parser.isSet("workspace-activate")
+           || parser.isSet("workspace-deactivate")
+           || parser.isSet("workspace-delete")
+           || parser.isSet("nginx-profile")
+           || parser.isSet("fastcgi-cache")
+           || parser.isSet("fastcgi-cache-purge")
+           || parser.isSet("fastcgi-cache-stats")
+           || parser.isSet("tls-enable")
+           || parser.isSet("tls-disable")
+           || parser.isSet("ports")
+           || parser.isSet("ports-auto-assign")
+           || parser.isSet("versions")
+           || parser.isSet("versions-prune")
+           || parser.isSet("mysql-slow-log")
+           || parser.isSet("mysql-slow-queries")
+           || parser.isSet("mysql-status")
+           || parser.isSet("apache-profile")
+           || parser.isSet("opcache-preload")
+           || parser.isSet("opcache-status")
+           || parser.isSet("precompress");
+}
+
+int CliCommands::run(const QCommandLineParser &parser) {
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    ServerFacade& facade = ServerManager::getInstance().getFacade();
+    try {
+        if (parser.isSet("mysql-snapshot-create")) {
+            QJsonObject result = facade.createMySQLSnapshot(parser.value("mysql-snapshot-create"));
+            out << QJsonDocument(result).toJson();
+        }
+        if (parser.isSet("mysql-snapshot-restore")) {
+            QJsonObject result = facade.restoreMySQLSnapshot(parser.value("mysql-snapshot-restore"));
+            out << QJsonDocument(result).toJson();
+        }
+        if (parser.isSet("mysql-snapshot-delete")) {
+            facade.deleteMySQLSnapshot(parser.value("mysql-snapshot-delete"));
+        }
+        if (parser.isSet("workspace-create")) {
+            QJsonObject settings;
+            if (parser.isSet("workspace-settings")) {
+                QFile file(parser.value("workspace-settings"));
+                if (!file.open(QIODevice::ReadOnly)) {
+                    QString errMsg = "Failed to read workspace settings: cannot open " + file.fileName() + ".";
+                    throw std::runtime_error(errMsg.toStdString());
+                }
+                QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+                if (!document.isObject()) {
+                    throw std::runtime_error("Invalid workspace settings: expected a JSON object keyed by server name.");
+                }
+                settings = document.object();
+            }
+            out << QJsonDocument(facade.createWorkspaceProfile(parser.value("workspace-create"), settings)).toJson();
+        }
+        if (parser.isSet("workspace-deactivate")) {
+            QJsonObject result;
+            QString active = facade.getActiveWorkspaceProfile();
+            if (active.isEmpty() || !requestRunningInstance("/api/profiles/" + active + "/deactivate", result)) {
+                result = facade.deactivateWorkspaceProfile();
+            }
+            out << QJsonDocument(result).toJson();
+        }
+        if (parser.isSet("workspace-activate")) {
+            QJsonObject result;
+            QString name = parser.value("workspace-activate");
+            if (!requestRunningInstance("/api/profiles/" + name + "/activate", result)) {
+                result = facade.activateWorkspaceProfile(name);
+            }
+            out << QJsonDocument(result).toJson();
+        }
+        if (parser.isSet("workspace-delete")) {
+            facade.deleteWorkspaceProfile(parser.value("workspace-delete"));
+        }
+        if (parser.isSet("workspace-list")) {
+            out << QJsonDocument(facade.getWorkspaceProfiles()).toJson();
+        }
+        if (parser.isSet("nginx-profile")) {
+            facade.setNginxPerformanceProfile(parser.value("nginx-profile"));
+            ConfigurationManager::getInstance().setServerConfiguration("nginx", facade.getServerConfiguration("nginx"));
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+        }
+        if (parser.isSet("fastcgi-cache")) {
+            QString state = parser.value("fastcgi-cache");
+            if (state != "on" && state != "off") {
+                throw std::runtime_error("Invalid FastCGI cache state: expected on or off.");
+            }
+            QJsonObject settings = facade.getServerConfiguration("nginx")["fastcgi_cache"].toObject();
+            settings["enabled"] = state == "on";
+            facade.setNginxFastCGICache(settings);
+            ConfigurationManager::getInstance().setServerConfiguration("nginx", facade.getServerConfiguration("nginx"));
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+        }
+        if (parser.isSet("fastcgi-cache-purge")) {
+            QString target = parser.value("fastcgi-cache-purge");
+            out << QJsonDocument(facade.purgeNginxFastCGICache(target == "all" ? QString() : target)).toJson();
+        }
+        if (parser.isSet("fastcgi-cache-stats")) {
+            out << QJsonDocument(facade.getNginxFastCGICacheStats()).toJson();
+        }
+        if (parser.isSet("tls-enable") || parser.isSet("tls-disable")) {
+            QString serverName = parser.isSet("tls-enable") ? parser.value("tls-enable") : parser.value("tls-disable");
+            QJsonObject settings = facade.getServerConfiguration(serverName)["tls"].toObject();
+            settings["enabled"] = parser.isSet("tls-enable");
+            facade.setServerTls(serverName, settings);
+            ConfigurationManager::getInstance().setServerConfiguration(serverName, facade.getServerConfiguration(serverName));
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+            out << QJsonDocument(facade.getServerStatus(serverName)["tls"].toObject()).toJson();
+        }
+        if (parser.isSet("ports-auto-assign")) {
+            out << QJsonDocument(facade.resolvePortConflicts()).toJson();
+            for (const QString& serverName : QStringList() << "apache" << "nginx" << "mysql") {
+                ConfigurationManager::getInstance().setServerConfiguration(serverName, facade.getServerConfiguration(serverName));
+            }
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+        }
+        if (parser.isSet("versions-prune")) {
+            out << QJsonDocument(facade.pruneStaleVersions()).toJson();
+        }
+        if (parser.isSet("versions")) {
+            QJsonObject versions;
+            versions["apache"] = facade.getAvailableVersions("apache");
+            versions["nginx"] = facade.getAvailableVersions("nginx");
+            versions["mysql"] = facade.getAvailableVersions("mysql");
+            versions["php"] = facade.getAvailablePHPVersions("apache");
+            out << QJsonDocument(versions).toJson();
+        }
+        if (parser.isSet("ports")) {
+            out << QJsonDocument(facade.getPortReservations()).toJson();
+        }
+        if (parser.isSet("apache-profile")) {
+            int concurrency = facade.getServerConfiguration("apache")["expected_concurrency"].toInt();
+            if (parser.isSet("apache-concurrency")) {
+                concurrency = parser.value("apache-concurrency").toInt();
+            }
+            facade.setApacheTuningProfile(parser.value("apache-profile"), concurrency);
+            ConfigurationManager::getInstance().setServerConfiguration("apache", facade.getServerConfiguration("apache"));
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+        }
+        if (parser.isSet("opcache-preload")) {
+            out << QJsonDocument(facade.generateOpcachePreload(parser.value("opcache-preload"))).toJson();
+            ConfigurationManager::getInstance().setSectionConfiguration("php_runtime", facade.getPHPRuntimeSettings());
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+        }
+        if (parser.isSet("opcache-status")) {
+            out << QJsonDocument(facade.getOpcacheStatus(parser.value("opcache-status"))).toJson();
+        }
+        if (parser.isSet("precompress")) {
+            QString serverName = parser.value("precompress");
+            out << QJsonDocument(facade.precompressDocumentRoot(serverName)).toJson();
+            ConfigurationManager::getInstance().setServerConfiguration(serverName, facade.getServerConfiguration(serverName));
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+        }
+        if (parser.isSet("mysql-slow-log")) {
+            QString state = parser.value("mysql-slow-log");
+            if (state != "on" && state != "off") {
+                throw std::runtime_error("Invalid slow query log state: expected on or off.");
+            }
+            QJsonObject settings = facade.getServerConfiguration("mysql")["slow_query_log"].toObject();
+            settings["enabled"] = state == "on";
+            if (parser.isSet("mysql-long-query-time")) {
+                bool ok = false;
+                double seconds = parser.value("mysql-long-query-time").toDouble(&ok);
+                if (!ok) {
+                    throw std::runtime_error("Invalid long query time: expected a number of seconds.");
+                }
+                settings["long_query_time"] = seconds;
+            }
+            facade.setMySQLSlowQueryLog(settings);
+            ConfigurationManager::getInstance().setServerConfiguration("mysql", facade.getServerConfiguration("mysql"));
+            ConfigurationManager::getInstance().saveConfiguration("config.json");
+        }
+        if (parser.isSet("mysql-slow-queries")) {
+            int limit = parser.isSet("mysql-slow-queries-limit") ? parser.value("mysql-slow-queries-limit").toInt() : 20;
+            QString orderBy = parser.isSet("mysql-slow-queries-order") ? parser.value("mysql-slow-queries-order") : "total";
+            if (parser.isSet("mysql-slow-queries-follow")) {
+                // Ctrl+C ends the follow loop and prints the final aggregate below.
+                interrupted = 0;
+                auto previousHandler = std::signal(SIGINT, onInterrupt);
+                QEventLoop loop;
+                QString error;
+                auto print = [&]() {
+                    try {
+                        out << QJsonDocument(facade.getMySQLSlowQueries(limit, orderBy)).toJson(QJsonDocument::Compact) << Qt::endl;
+                    } catch (const std::runtime_error& e) {
+                        error = QString::fromStdString(e.what());
+                        loop.quit();
+                    }
+                };
+                QTimer printTimer;
+                printTimer.setInterval(2000);
+                QObject::connect(&printTimer, &QTimer::timeout, &loop, print);
+                QTimer interruptTimer;
+                interruptTimer.setInterval(100);
+                QObject::connect(&interruptTimer, &QTimer::timeout, &loop, [&loop]() {
+                    if (interrupted) {
+                        loop.quit();
+                    }
+                });
+                print();
+                if (error.isEmpty()) {
+                    printTimer.start();
+                    interruptTimer.start();
+                    loop.exec();
+                }
+                std::signal(SIGINT, previousHandler);
+                if (!error.isEmpty()) {
+                    throw std::runtime_error(error.toStdString());
+                }
+            }
+            out << QJsonDocument(facade.getMySQLSlowQueries(limit, orderBy)).toJson();
+        }
+        if (parser.isSet("mysql-status")) {
+            MySQLStatusPoller poller;
+            QJsonObject settings = facade.getMySQLStatusPolling();
+            settings["enabled"] = true;
+            settings["interval_ms"] = 1000;
+            poller.setSettings(settings);
+            QEventLoop loop;
+            QObject::connect(&poller, &MySQLStatusPoller::snapshotUpdated, &loop, [&loop](const QJsonObject& snapshot) {
+                if (snapshot.contains("qps") || snapshot.contains("error")) {
+                    loop.quit();
+                }
+            });
+            QTimer::singleShot(MySQLClient::connectTimeout + 2000, &loop, &QEventLoop::quit);
+            poller.start(facade.getServerConfiguration("mysql")["port"].toInt());
+            loop.exec();
+            QJsonObject snapshot = poller.getSnapshot();
+            poller.stop();
+            if (snapshot.contains("error")) {
+                throw std::runtime_error(snapshot.value("error").toString().toStdString());
+            }
+            out << QJsonDocument(snapshot).toJson();
+        }
+        if (parser.isSet("mysql-snapshot-list")) {
+            const QStringList snapshots = facade.getMySQLSnapshots();
+            for (const QString& snapshot : snapshots) {
+                out << snapshot << Qt::endl;
+            }
+        }
+    } catch (const std::runtime_error &e) {
+        err << e.what() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
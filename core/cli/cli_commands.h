@@ -0,0 +1,13 @@
+#ifndef CLI_COMMANDS_H
+#define CLI_COMMANDS_H
+
+#include <QCommandLineParser>
+
+class CliCommands {
+public:
+    static void addOptions(QCommandLineParser& parser);
+    static bool hasCommand(const QCommandLineParser& parser);
+    static int run(const QCommandLineParser& parser);
+};
+
+#endif // CLI_COMMANDS_H
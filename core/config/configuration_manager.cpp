@@ -1,9 +1,35 @@
 #include "configuration_manager.h"
+#include "../../utility/trace.h"
+#include <QDebug>
 #include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QCborMap>
+#include <QCborValue>
+#include <QCryptographicHash>
+#include <QThread>
 #include <QJsonDocument>
 #include <QJsonParseError>
+#include <QMutexLocker>
+
+ConfigurationManager::ConfigurationManager() {
+    saveTimer.setSingleShot(true);
+    saveTimer.setInterval(saveDelay);
+    QObject::connect(&saveTimer, &QTimer::timeout, [this]() {
+        flush();
+    });
+}
+
+static const int cacheFormatVersion = 1;
+
+QString ConfigurationManager::cachePath(const QString &filePath) {
+    QFileInfo info(filePath);
+    return info.absolutePath() + "/cache/" + info.fileName() + ".cbor";
+}
 
 bool ConfigurationManager::loadConfiguration(const QString& filePath) {
+    TRACE_SCOPE_ARG("startup", "ConfigurationManager::loadConfiguration", "file", filePath);
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         return false;
@@ -11,6 +37,11 @@ bool ConfigurationManager::loadConfiguration(const QString& filePath) {
 
     QByteArray fileData = file.readAll();
     file.close();
+    QByteArray hash = QCryptographicHash::hash(fileData, QCryptographicHash::Sha256);
+
+    if (loadCache(filePath, hash)) {
+        return true;
+    }
 
     QJsonParseError parseError;
     QJsonDocument jsonDoc = QJsonDocument::fromJson(fileData, &parseError);
@@ -18,35 +49,194 @@ bool ConfigurationManager::loadConfiguration(const QString& filePath) {
         return false;
     }
 
+    QMutexLocker locker(&mutex);
     configuration = jsonDoc.object();
+    loadedPath = filePath;
+    sourceHash = hash;
+    validated = false;
     return true;
 }
 
-bool ConfigurationManager::saveConfiguration(const QString& filePath) const {
-    QFile file(filePath);
+bool ConfigurationManager::loadCache(const QString &filePath, const QByteArray &hash) {
+    TRACE_SCOPE("startup", "ConfigurationManager::loadCache");
+    QFile cacheFile(cachePath(filePath));
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QCborParserError parseError;
+    QCborValue cache = QCborValue::fromCbor(cacheFile.readAll(), &parseError);
+    cacheFile.close();
+    if (parseError.error != QCborError::NoError || !cache.isMap()) {
+        return false;
+    }
+    QCborMap cacheMap = cache.toMap();
+    if (cacheMap.value(QStringLiteral("format")).toInteger() != cacheFormatVersion
+        || cacheMap.value(QStringLiteral("source_sha256")).toByteArray() != hash
+        || !cacheMap.value(QStringLiteral("configuration")).isMap()) {
+        return false;
+    }
+
+    QMutexLocker locker(&mutex);
+    configuration = cacheMap.value(QStringLiteral("configuration")).toMap().toJsonObject();
+    loadedPath = filePath;
+    sourceHash = hash;
+    validated = true;
+    return true;
+}
+
+void ConfigurationManager::writeCache(const QString &filePath, const QByteArray &hash, const QJsonObject &config) {
+    QCborMap cacheMap;
+    cacheMap.insert(QStringLiteral("format"), cacheFormatVersion);
+    cacheMap.insert(QStringLiteral("source_sha256"), hash);
+    cacheMap.insert(QStringLiteral("configuration"), QCborMap::fromJsonObject(config));
+    QString path = cachePath(filePath);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    if (!writeAtomically(path, cacheMap.toCborValue().toCbor())) {
+        qWarning() << "Failed to write configuration cache" << path;
+    }
+}
+
+bool ConfigurationManager::isValidated() const {
+    QMutexLocker locker(&mutex);
+    return validated;
+}
+
+void ConfigurationManager::markValidated() {
+    QString filePath;
+    QByteArray hash;
+    QJsonObject config;
+    {
+        QMutexLocker locker(&mutex);
+        bool wasValidated = validated;
+        validated = true;
+        if (wasValidated || loadedPath.isEmpty() || pendingPath == loadedPath) {
+            return;
+        }
+        filePath = loadedPath;
+        hash = sourceHash;
+        config = configuration;
+    }
+    writeCache(filePath, hash, config);
+}
+
+bool ConfigurationManager::writeAtomically(const QString &filePath, const QByteArray &data) {
+    QSaveFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open" << filePath << "for writing:" << file.errorString();
         return false;
     }
+    if (file.write(data) != data.size()) {
+        qWarning() << "Failed to write" << filePath << ":" << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "Failed to commit" << filePath << ":" << file.errorString();
+        return false;
+    }
+    return true;
+}
 
-    QJsonDocument jsonDoc(configuration);
-    file.write(jsonDoc.toJson());
-    file.close();
+bool ConfigurationManager::writeConfiguration(const QString &filePath, const QJsonObject &config) {
+    QByteArray data = QJsonDocument(config).toJson();
+    if (!writeAtomically(filePath, data)) {
+        return false;
+    }
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+    {
+        QMutexLocker locker(&mutex);
+        if (filePath != loadedPath) {
+            return true;
+        }
+        sourceHash = hash;
+        if (!validated) {
+            return true;
+        }
+    }
+    writeCache(filePath, hash, config);
     return true;
 }
 
+bool ConfigurationManager::saveConfiguration(const QString& filePath) {
+    TRACE_SCOPE_ARG("config", "ConfigurationManager::saveConfiguration", "file", filePath);
+    QJsonObject config;
+    {
+        QMutexLocker locker(&mutex);
+        config = configuration;
+        if (pendingPath == filePath) {
+            pendingPath.clear();
+        }
+    }
+    return writeConfiguration(filePath, config);
+}
+
+void ConfigurationManager::scheduleSave(const QString &filePath) {
+    {
+        QMutexLocker locker(&mutex);
+        if (!pendingPath.isEmpty() && pendingPath != filePath) {
+            QString previousPath = pendingPath;
+            QJsonObject config = configuration;
+            locker.unlock();
+            writeConfiguration(previousPath, config);
+            locker.relock();
+        }
+        pendingPath = filePath;
+    }
+    if (QThread::currentThread() == saveTimer.thread()) {
+        saveTimer.start();
+    } else {
+        QMetaObject::invokeMethod(&saveTimer, [this]() {
+            saveTimer.start();
+        }, Qt::QueuedConnection);
+    }
+}
+
+bool ConfigurationManager::flush() {
+    QString filePath;
+    QJsonObject config;
+    {
+        QMutexLocker locker(&mutex);
+        if (pendingPath.isEmpty()) {
+            return true;
+        }
+        filePath = pendingPath;
+        pendingPath.clear();
+        config = configuration;
+    }
+    if (QThread::currentThread() == saveTimer.thread()) {
+        saveTimer.stop();
+    }
+    TRACE_SCOPE_ARG("config", "ConfigurationManager::flush", "file", filePath);
+    return writeConfiguration(filePath, config);
+}
+
+bool ConfigurationManager::hasPendingSave() const {
+    QMutexLocker locker(&mutex);
+    return !pendingPath.isEmpty();
+}
+
 QJsonObject ConfigurationManager::getConfiguration() const {
+    QMutexLocker locker(&mutex);
     return configuration;
 }
 
 void ConfigurationManager::setConfiguration(const QJsonObject& config) {
+    QMutexLocker locker(&mutex);
     configuration = config;
 }
 
 void ConfigurationManager::setServerConfiguration(const QString &serverName, const QJsonObject &config)
 {
+    QMutexLocker locker(&mutex);
     QJsonObject servers = configuration["servers"].toObject();
     QJsonObject server = servers[serverName].toObject();
     server["config"] = config;
     servers[serverName] = server;
     configuration["servers"] = servers;
 }
+
+void ConfigurationManager::setSectionConfiguration(const QString &sectionName, const QJsonObject &config)
+{
+    QMutexLocker locker(&mutex);
+    configuration[sectionName] = config;
+}
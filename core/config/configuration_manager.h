@@ -3,9 +3,13 @@
 
 #include <QString>
 #include <QJsonObject>
+#include <QByteArray>
+#include <QMutex>
+#include <QTimer>
 
 class ConfigurationManager {
 public:
+    static const int saveDelay = 250;
 
     static ConfigurationManager& getInstance() {
         static ConfigurationManager instance;
@@ -16,7 +20,13 @@ public:
     bool loadConfiguration(const QString& filePath);
 
 
-    bool saveConfiguration(const QString& filePath) const;
+    bool saveConfiguration(const QString& filePath);
+    void scheduleSave(const QString& filePath);
+    bool flush();
+    bool hasPendingSave() const;
+    bool isValidated() const;
+    void markValidated();
+    static QString cachePath(const QString& filePath);
 
 
     QJsonObject getConfiguration() const;
@@ -24,10 +34,22 @@ public:
 
     void setConfiguration(const QJsonObject& config);
     void setServerConfiguration(const QString& serverName, const QJsonObject& config);
+    void setSectionConfiguration(const QString& sectionName, const QJsonObject& config);
 
 private:
-    ConfigurationManager() {}
+    ConfigurationManager();
     QJsonObject configuration;
+    QString loadedPath;
+    QString pendingPath;
+    QByteArray sourceHash;
+    bool validated = false;
+    mutable QMutex mutex;
+    QTimer saveTimer;
+
+    bool writeConfiguration(const QString& filePath, const QJsonObject& config);
+    bool loadCache(const QString& filePath, const QByteArray& hash);
+    static void writeCache(const QString& filePath, const QByteArray& hash, const QJsonObject& config);
+    static bool writeAtomically(const QString& filePath, const QByteArray& data);
 };
 
 #endif // CONFIGURATION_MANAGER_H
@@ -0,0 +1,236 @@
+#include "workspace_profile_store.h"
+#include "../../utility/trace.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSet>
+#include <QMutexLocker>
+
+const QString WorkspaceProfileStore::directoryPlaceholder = "@WEBDEVTOOLKIT_PROFILE_DIR@";
+
+WorkspaceProfileStore::WorkspaceProfileStore(const QDir &directory) : directory(directory) {
+}
+
+bool WorkspaceProfileStore::isValidProfileName(const QString &name) {
+    static const QRegularExpression nameRegex(R"(^[A-Za-z0-9][A-Za-z0-9_.-]{0,63}$)");
+    return nameRegex.match(name).hasMatch();
+}
+
+QStringList WorkspaceProfileStore::listProfiles() const {
+    QMutexLocker locker(&mutex);
+    QStringList profiles;
+    const QStringList manifests = directory.entryList(QStringList() << "*.json", QDir::Files, QDir::Name);
+    for (const QString& manifest : manifests) {
+        QString name = QFileInfo(manifest).completeBaseName();
+        if (isValidProfileName(name)) {
+            profiles.append(name);
+        }
+    }
+    return profiles;
+}
+
+QJsonObject WorkspaceProfileStore::getProfile(const QString &name) const {
+    if (!isValidProfileName(name)) {
+        QString errMsg = "Failed to read workspace profile: invalid profile name " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QMutexLocker locker(&mutex);
+    QFile file(directory.absoluteFilePath(name + ".json"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        QString errMsg = "Failed to read workspace profile: profile " + name + " does not exist.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QJsonObject profile = QJsonDocument::fromJson(file.readAll()).object();
+    if (profile.value("id").toString().isEmpty() || !profile.value("servers").isObject()) {
+        QString errMsg = "Failed to read workspace profile: manifest of " + name + " is corrupted.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return profile;
+}
+
+QJsonObject WorkspaceProfileStore::storeProfile(const QString &name, const QJsonObject &settings, const QJsonObject &states,
+                                                const QMap<QString, ConfigSet> &configSets) {
+    TRACE_SCOPE("config", "WorkspaceProfileStore::storeProfile");
+    if (!isValidProfileName(name)) {
+        QString errMsg = "Failed to store workspace profile: invalid profile name " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QMutexLocker locker(&mutex);
+    if (!directory.mkpath("objects") || !directory.mkpath("rendered")) {
+        QString errMsg = "Failed to store workspace profile: cannot create directory " + directory.absolutePath() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QJsonObject servers;
+    QStringList entries;
+    for (auto server = configSets.begin(); server != configSets.end(); ++server) {
+        QJsonObject files;
+        for (auto file = server.value().begin(); file != server.value().end(); ++file) {
+            QString hash = writeObject(file.value());
+            files[file.key()] = hash;
+            entries.append(server.key() + "/" + file.key() + " " + hash);
+        }
+        QJsonObject entry;
+        entry["config"] = states.value(server.key()).toObject();
+        entry["files"] = files;
+        servers[server.key()] = entry;
+    }
+    entries.sort();
+
+    QJsonObject profile;
+    profile["name"] = name;
+    profile["id"] = QString::fromLatin1(QCryptographicHash::hash(entries.join('\n').toUtf8(), QCryptographicHash::Sha256).toHex());
+    profile["created"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    profile["settings"] = settings;
+    profile["servers"] = servers;
+
+    QFile manifestFile(directory.absoluteFilePath(name + ".json"));
+    if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QString errMsg = "Failed to store workspace profile: cannot write manifest for " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    manifestFile.write(QJsonDocument(profile).toJson());
+    manifestFile.close();
+    collectGarbage();
+    return profile;
+}
+
+QString WorkspaceProfileStore::materialize(const QJsonObject &profile) {
+    TRACE_SCOPE("config", "WorkspaceProfileStore::materialize");
+    QMutexLocker locker(&mutex);
+    QString id = profile.value("id").toString();
+    QString renderedPath = directory.absoluteFilePath("rendered/" + id);
+    if (QFile::exists(renderedPath + "/.complete")) {
+        return renderedPath;
+    }
+
+    QString stagingPath = directory.absoluteFilePath("rendered/." + id + ".partial");
+    QDir(stagingPath).removeRecursively();
+    const QJsonObject servers = profile.value("servers").toObject();
+    for (auto server = servers.begin(); server != servers.end(); ++server) {
+        QString serverPath = stagingPath + "/" + server.key();
+        QByteArray serverDir = QDir::fromNativeSeparators(renderedPath + "/" + server.key()).toUtf8();
+        if (!QDir().mkpath(serverPath)) {
+            QString errMsg = "Failed to materialize workspace profile: cannot create " + serverPath + ".";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        const QJsonObject files = server.value().toObject().value("files").toObject();
+        for (auto file = files.begin(); file != files.end(); ++file) {
+            QByteArray content = readObject(file.value().toString());
+            content.replace(directoryPlaceholder.toUtf8(), serverDir);
+            QFile output(serverPath + "/" + file.key());
+            if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate) || output.write(content) != content.size()) {
+                QDir(stagingPath).removeRecursively();
+                QString errMsg = "Failed to materialize workspace profile: cannot write " + output.fileName() + ".";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+        }
+    }
+    QFile marker(stagingPath + "/.complete");
+    marker.open(QIODevice::WriteOnly);
+    marker.close();
+    QDir(renderedPath).removeRecursively();
+    if (!QDir().rename(stagingPath, renderedPath)) {
+        QDir(stagingPath).removeRecursively();
+        QString errMsg = "Failed to materialize workspace profile: cannot finalize " + renderedPath + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    qDebug() << "Materialized workspace profile" << profile.value("name").toString() << "in" << renderedPath;
+    return renderedPath;
+}
+
+void WorkspaceProfileStore::deleteProfile(const QString &name) {
+    if (!isValidProfileName(name)) {
+        QString errMsg = "Failed to delete workspace profile: invalid profile name " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QMutexLocker locker(&mutex);
+    if (!directory.remove(name + ".json")) {
+        QString errMsg = "Failed to delete workspace profile: profile " + name + " does not exist.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    collectGarbage();
+}
+
+QString WorkspaceProfileStore::writeObject(const QByteArray &content) {
+    QString hash = QString::fromLatin1(QCryptographicHash::hash(content, QCryptographicHash::Sha256).toHex());
+    QString path = objectPath(hash);
+    if (QFile::exists(path)) {
+        return hash;
+    }
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path + ".partial");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(content) != content.size()) {
+        QString errMsg = "Failed to store workspace profile: cannot write object " + hash + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    file.close();
+    if (!QFile::rename(path + ".partial", path)) {
+        QFile::remove(path + ".partial");
+        QString errMsg = "Failed to store workspace profile: cannot finalize object " + hash + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return hash;
+}
+
+QByteArray WorkspaceProfileStore::readObject(const QString &hash) const {
+    QFile file(objectPath(hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        QString errMsg = "Failed to read workspace profile: object " + hash + " is missing from the profile store.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QByteArray content = file.readAll();
+    if (QCryptographicHash::hash(content, QCryptographicHash::Sha256).toHex() != hash.toLatin1()) {
+        QString errMsg = "Failed to read workspace profile: object " + hash + " is corrupted.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return content;
+}
+
+QString WorkspaceProfileStore::objectPath(const QString &hash) const {
+    return directory.absoluteFilePath("objects/" + hash.left(2) + "/" + hash);
+}
+
+void WorkspaceProfileStore::collectGarbage() {
+    QSet<QString> ids;
+    QSet<QString> hashes;
+    const QStringList manifests = directory.entryList(QStringList() << "*.json", QDir::Files);
+    for (const QString& manifest : manifests) {
+        QFile file(directory.absoluteFilePath(manifest));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QJsonObject profile = QJsonDocument::fromJson(file.readAll()).object();
+        ids.insert(profile.value("id").toString());
+        const QJsonObject servers = profile.value("servers").toObject();
+        for (const QJsonValue& server : servers) {
+            const QJsonObject files = server.toObject().value("files").toObject();
+            for (const QJsonValue& hash : files) {
+                hashes.insert(hash.toString());
+            }
+        }
+    }
+
+    QDir rendered(directory.absoluteFilePath("rendered"));
+    const QStringList renderedIds = rendered.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& id : renderedIds) {
+        if (!ids.contains(id)) {
+            QDir(rendered.absoluteFilePath(id)).removeRecursively();
+        }
+    }
+    QDir objects(directory.absoluteFilePath("objects"));
+    const QStringList buckets = objects.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& bucket : buckets) {
+        QDir bucketDir(objects.absoluteFilePath(bucket));
+        const QStringList stored = bucketDir.entryList(QDir::Files);
+        for (const QString& hash : stored) {
+            if (!hashes.contains(hash)) {
+                bucketDir.remove(hash);
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef WORKSPACE_PROFILE_STORE_H
+#define WORKSPACE_PROFILE_STORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QJsonObject>
+#include <QByteArray>
+#include <QMap>
+#include <QMutex>
+
+class WorkspaceProfileStore {
+public:
+    using ConfigSet = QMap<QString, QByteArray>;
+
+    static const QString directoryPlaceholder;
+
+    explicit WorkspaceProfileStore(const QDir& directory);
+
+    static bool isValidProfileName(const QString& name);
+
+    QStringList listProfiles() const;
+    QJsonObject getProfile(const QString& name) const;
+    QJsonObject storeProfile(const QString& name, const QJsonObject& settings, const QJsonObject& states,
+                             const QMap<QString, ConfigSet>& configSets);
+    QString materialize(const QJsonObject& profile);
+    void deleteProfile(const QString& name);
+
+private:
+    QDir directory;
+    mutable QMutex mutex;
+
+    QString writeObject(const QByteArray& content);
+    QByteArray readObject(const QString& hash) const;
+    QString objectPath(const QString& hash) const;
+    void collectGarbage();
+};
+
+#endif // WORKSPACE_PROFILE_STORE_H
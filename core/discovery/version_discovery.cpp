@@ -0,0 +1,299 @@
+#include "version_discovery.h"
+#include "../../utility/trace.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <algorithm>
+
+VersionDiscovery::VersionDiscovery(QObject *parent) : QObject(parent), watcher(this), rescanTimer(this) {
+    backgroundPool.setMaxThreadCount(1);
+    rescanTimer.setSingleShot(true);
+    rescanTimer.setInterval(rescanDelay);
+    connect(&rescanTimer, &QTimer::timeout, this, &VersionDiscovery::rescanInBackground);
+    connect(&watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString&) {
+        rescanTimer.start();
+    });
+}
+
+VersionDiscovery::~VersionDiscovery() {
+    rescanTimer.stop();
+    backgroundPool.waitForDone();
+}
+
+QStringList VersionDiscovery::kinds() {
+    return QStringList() << "apache" << "nginx" << "mysql" << "php";
+}
+
+void VersionDiscovery::setBinRoot(const QString &root) {
+    binRoot = root;
+    if (!watcher.directories().isEmpty()) {
+        updateWatchedPaths();
+    }
+}
+
+QString VersionDiscovery::getBinRoot() const {
+    return binRoot;
+}
+
+QString VersionDiscovery::cachePath() {
+    return QDir::currentPath() + "/cache/discovery.json";
+}
+
+QString VersionDiscovery::findBinary(const QString &kind, const QDir &directory) {
+    QStringList candidates;
+    if (kind == "apache") {
+        candidates << "bin/httpd.exe" << "bin/httpd";
+    } else if (kind == "nginx") {
+        candidates << "nginx.exe" << "sbin/nginx" << "nginx";
+    } else if (kind == "mysql") {
+        candidates << "bin/mysqld.exe" << "bin/mysqld";
+    } else if (kind == "php") {
+        candidates << "php.exe" << "php" << "bin/php" << "php-cgi.exe" << "php-cgi" << "bin/php-cgi";
+    }
+    for (const QString& candidate : candidates) {
+        QFileInfo info(directory.filePath(candidate));
+        if (info.isFile() && info.isExecutable()) {
+            return info.absoluteFilePath();
+        }
+    }
+    return QString();
+}
+
+QStringList VersionDiscovery::requiredFiles(const QString &kind) {
+    if (kind == "apache") {
+        return QStringList() << "conf/httpd.conf";
+    } else if (kind == "nginx") {
+        return QStringList() << "conf/nginx.conf";
+    } else if (kind == "mysql") {
+        return QStringList() << "my.ini";
+    }
+    return QStringList();
+}
+
+QString VersionDiscovery::probeVersion(const QString &kind, const QString &binary) {
+    TRACE_SCOPE_ARG("discovery", "VersionDiscovery::probeVersion", "binary", binary);
+    QString versionFlag = kind == "mysql" ? "--version" : "-v";
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.setWorkingDirectory(QFileInfo(binary).absolutePath());
+    process.start(binary, QStringList() << versionFlag);
+    if (!process.waitForFinished(probeTimeout)) {
+        qWarning() << "Version probe timed out for" << binary;
+        process.kill();
+        process.waitForFinished();
+        return QString();
+    }
+    QString output = QString::fromLocal8Bit(process.readAll());
+
+    QString pattern;
+    if (kind == "apache") {
+        pattern = "Apache/(\\d+\\.\\d+(?:\\.\\d+)?)";
+    } else if (kind == "nginx") {
+        pattern = "nginx/(\\d+\\.\\d+(?:\\.\\d+)?)";
+    } else if (kind == "mysql") {
+        pattern = "Ver\\s+(\\d+\\.\\d+\\.\\d+)";
+    } else {
+        pattern = "PHP\\s+(\\d+\\.\\d+\\.\\d+)";
+    }
+    QRegularExpressionMatch match = QRegularExpression(pattern).match(output);
+    return match.hasMatch() ? match.captured(1) : QString();
+}
+
+QString VersionDiscovery::versionFromName(const QString &kind, const QString &directoryName) {
+    QString name = directoryName.startsWith(kind, Qt::CaseInsensitive) ? directoryName.mid(kind.size()) : directoryName;
+    QRegularExpressionMatch match = QRegularExpression("(\\d+(?:\\.\\d+)+)").match(name);
+    return match.hasMatch() ? match.captured(1) : QString();
+}
+
+void VersionDiscovery::loadCache() {
+    if (cacheLoaded) {
+        return;
+    }
+    cacheLoaded = true;
+    QFile file(cachePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject binaries = QJsonDocument::fromJson(file.readAll()).object().value("binaries").toObject();
+    file.close();
+    for (auto it = binaries.begin(); it != binaries.end(); ++it) {
+        QJsonObject entryObject = it.value().toObject();
+        CacheEntry entry;
+        entry.modified = qint64(entryObject["mtime"].toDouble());
+        entry.size = qint64(entryObject["size"].toDouble());
+        entry.version = entryObject["version"].toString();
+        if (!entry.version.isEmpty()) {
+            cache.insert(it.key(), entry);
+        }
+    }
+}
+
+void VersionDiscovery::saveCache() {
+    QJsonObject binaries;
+    for (auto it = cache.constBegin(); it != cache.constEnd(); ++it) {
+        QJsonObject entryObject;
+        entryObject["mtime"] = it.value().modified;
+        entryObject["size"] = it.value().size;
+        entryObject["version"] = it.value().version;
+        binaries[it.key()] = entryObject;
+    }
+    QJsonObject root;
+    root["binaries"] = binaries;
+
+    QString path = cachePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write version discovery cache" << path;
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+}
+
+QList<Installation> VersionDiscovery::scan(int maxThreads) {
+    TRACE_SCOPE("discovery", "VersionDiscovery::scan");
+    QMutexLocker locker(&mutex);
+    loadCache();
+
+    QList<Installation> candidates;
+    for (const QString& kind : kinds()) {
+        QDir kindDirectory(binRoot + "/" + kind);
+        if (!kindDirectory.exists()) {
+            continue;
+        }
+        const QStringList directories = kindDirectory.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+        for (const QString& directoryName : directories) {
+            QDir directory(kindDirectory.filePath(directoryName));
+            bool complete = true;
+            for (const QString& requiredFile : requiredFiles(kind)) {
+                if (!directory.exists(requiredFile)) {
+                    qWarning() << "Skipping" << directory.absolutePath() << ": missing" << requiredFile;
+                    complete = false;
+                }
+            }
+            if (!complete) {
+                continue;
+            }
+            Installation installation;
+            installation.kind = kind;
+            installation.path = binRoot + "/" + kind + "/" + directoryName;
+            installation.binary = findBinary(kind, directory);
+            candidates.append(installation);
+        }
+    }
+
+    QMutex resultsMutex;
+    QHash<QString, CacheEntry> probed;
+    QThreadPool pool;
+    if (maxThreads > 0) {
+        pool.setMaxThreadCount(maxThreads);
+    }
+    for (Installation& installation : candidates) {
+        if (installation.binary.isEmpty()) {
+            continue;
+        }
+        QFileInfo info(installation.binary);
+        CacheEntry current;
+        current.modified = info.lastModified().toMSecsSinceEpoch();
+        current.size = info.size();
+        CacheEntry cached = cache.value(installation.binary);
+        if (!cached.version.isEmpty() && cached.modified == current.modified && cached.size == current.size) {
+            installation.version = cached.version;
+            installation.cached = true;
+            continue;
+        }
+        pool.start([&, current, kind = installation.kind, binary = installation.binary]() mutable {
+            current.version = probeVersion(kind, binary);
+            QMutexLocker resultsLocker(&resultsMutex);
+            probed.insert(binary, current);
+        });
+    }
+    pool.waitForDone();
+
+    bool cacheChanged = false;
+    QList<Installation> installations;
+    for (Installation& installation : candidates) {
+        if (probed.contains(installation.binary)) {
+            CacheEntry entry = probed.value(installation.binary);
+            installation.version = entry.version;
+            if (!entry.version.isEmpty()) {
+                cache.insert(installation.binary, entry);
+                cacheChanged = true;
+            }
+        }
+        if (installation.version.isEmpty()) {
+            installation.version = versionFromName(installation.kind, QFileInfo(installation.path).fileName());
+        }
+        if (installation.version.isEmpty()) {
+            qWarning() << "Could not determine the version of" << installation.path;
+            continue;
+        }
+        installations.append(installation);
+    }
+
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (!QFileInfo::exists(it.key())) {
+            it = cache.erase(it);
+            cacheChanged = true;
+        } else {
+            ++it;
+        }
+    }
+    if (cacheChanged) {
+        saveCache();
+    }
+
+    qDebug() << "Discovered" << installations.size() << "installations in" << binRoot << "(" << probed.size() << "probed)";
+    return installations;
+}
+
+void VersionDiscovery::watch() {
+    updateWatchedPaths();
+}
+
+void VersionDiscovery::updateWatchedPaths() {
+    QStringList watched = watcher.directories();
+    if (!watched.isEmpty()) {
+        watcher.removePaths(watched);
+    }
+    QStringList paths;
+    QDir root(binRoot);
+    if (root.exists()) {
+        paths.append(root.absolutePath());
+    }
+    for (const QString& kind : kinds()) {
+        QDir kindDirectory(binRoot + "/" + kind);
+        if (kindDirectory.exists()) {
+            paths.append(kindDirectory.absolutePath());
+        }
+    }
+    if (!paths.isEmpty()) {
+        watcher.addPaths(paths);
+    }
+}
+
+void VersionDiscovery::rescanInBackground() {
+    updateWatchedPaths();
+    if (rescanRunning.exchange(true)) {
+        rescanPending = true;
+        return;
+    }
+    backgroundPool.start([this]() {
+        QList<Installation> installations = scan();
+        QMetaObject::invokeMethod(this, [this, installations]() {
+            rescanRunning = false;
+            emit installationsChanged(installations);
+            if (rescanPending.exchange(false)) {
+                rescanTimer.start();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
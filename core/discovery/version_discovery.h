@@ -0,0 +1,72 @@
+#ifndef VERSION_DISCOVERY_H
+#define VERSION_DISCOVERY_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QDir>
+#include <QMutex>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QThreadPool>
+#include <atomic>
+
+struct Installation {
+    QString kind;
+    QString version;
+    QString path;
+    QString binary;
+    bool cached = false;
+};
+
+class VersionDiscovery : public QObject {
+    Q_OBJECT
+public:
+    static const int probeTimeout = 5000;
+    static const int rescanDelay = 500;
+
+    explicit VersionDiscovery(QObject *parent = nullptr);
+    ~VersionDiscovery();
+
+    static QStringList kinds();
+
+    QList<Installation> scan(int maxThreads = 0);
+    void watch();
+    void setBinRoot(const QString& root);
+    QString getBinRoot() const;
+    static QString cachePath();
+
+signals:
+    void installationsChanged(const QList<Installation>& installations);
+
+private:
+    struct CacheEntry {
+        qint64 modified = 0;
+        qint64 size = 0;
+        QString version;
+    };
+
+    QString binRoot = "./bin";
+    QHash<QString, CacheEntry> cache;
+    bool cacheLoaded = false;
+    QMutex mutex;
+    QFileSystemWatcher watcher;
+    QTimer rescanTimer;
+    std::atomic<bool> rescanRunning{false};
+    std::atomic<bool> rescanPending{false};
+    QThreadPool backgroundPool;
+
+    void loadCache();
+    void saveCache();
+    void updateWatchedPaths();
+    void rescanInBackground();
+
+    static QStringList requiredFiles(const QString& kind);
+    static QString findBinary(const QString& kind, const QDir& directory);
+    static QString probeVersion(const QString& kind, const QString& binary);
+    static QString versionFromName(const QString& kind, const QString& directoryName);
+};
+
+#endif // VERSION_DISCOVERY_H
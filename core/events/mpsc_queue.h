@@ -0,0 +1,53 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head(new Node()), tail(head.load(std::memory_order_relaxed)) {
+    }
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    bool pop(T& value) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T nodeValue) : value(std::move(nodeValue)) {
+        }
+        T value;
+        std::atomic<Node*> next{nullptr};
+    };
+
+    std::atomic<Node*> head;
+    Node* tail;
+};
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,96 @@
+#include "server_event_bus.h"
+#include <QDebug>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+
+ServerEventBus::ServerEventBus(QObject *parent) : QObject(parent), frameTimer(this) {
+    frameTimer.setSingleShot(true);
+    frameTimer.setInterval(frameInterval);
+    connect(&frameTimer, &QTimer::timeout, this, &ServerEventBus::flush);
+}
+
+void ServerEventBus::publish(ServerEvent event) {
+    queue.push(std::move(event));
+    if (!frameScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, [this]() {
+            if (!frameTimer.isActive()) {
+                frameTimer.start();
+            }
+        }, Qt::QueuedConnection);
+    }
+}
+
+void ServerEventBus::publishState(const QString &serverName, bool running) {
+    ServerEvent event;
+    event.type = ServerEvent::Type::StateChanged;
+    event.serverName = serverName;
+    event.running = running;
+    publish(std::move(event));
+}
+
+void ServerEventBus::publishWarning(const QString &serverName, const QString &message) {
+    ServerEvent event;
+    event.type = ServerEvent::Type::Warning;
+    event.serverName = serverName;
+    event.message = message;
+    publish(std::move(event));
+}
+
+void ServerEventBus::publishError(const QString &serverName, const QString &title, const QString &message) {
+    ServerEvent event;
+    event.type = ServerEvent::Type::Error;
+    event.serverName = serverName;
+    event.title = title;
+    event.message = message;
+    publish(std::move(event));
+}
+
+void ServerEventBus::flush() {
+    frameScheduled.store(false, std::memory_order_release);
+
+    QStringList stateOrder;
+    QHash<QString, bool> states;
+    QStringList warningOrder;
+    QHash<QString, QString> warnings;
+    QList<ServerEvent> errors;
+    QList<int> errorCounts;
+
+    ServerEvent event;
+    while (queue.pop(event)) {
+        if (event.type == ServerEvent::Type::StateChanged) {
+            if (!states.contains(event.serverName)) {
+                stateOrder.append(event.serverName);
+            }
+            states[event.serverName] = event.running;
+        } else if (event.type == ServerEvent::Type::Warning) {
+            if (!warnings.contains(event.serverName)) {
+                warningOrder.append(event.serverName);
+            }
+            warnings[event.serverName] = event.message;
+        } else {
+            bool merged = false;
+            for (int i = 0; i < errors.size(); ++i) {
+                if (errors[i].serverName == event.serverName && errors[i].title == event.title && errors[i].message == event.message) {
+                    errorCounts[i]++;
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged) {
+                errors.append(event);
+                errorCounts.append(1);
+            }
+        }
+    }
+
+    for (const QString& serverName : stateOrder) {
+        emit stateChanged(serverName, states.value(serverName));
+    }
+    for (const QString& serverName : warningOrder) {
+        emit warningRaised(serverName, warnings.value(serverName));
+    }
+    for (int i = 0; i < errors.size(); ++i) {
+        emit errorRaised(errors[i].serverName, errors[i].title, errors[i].message, errorCounts[i]);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef SERVER_EVENT_BUS_H
+#define SERVER_EVENT_BUS_H
+
+#include "mpsc_queue.h"
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+
+struct ServerEvent {
+    enum class Type {
+        StateChanged,
+        Warning,
+        Error
+    };
+
+    Type type = Type::StateChanged;
+    QString serverName;
+    bool running = false;
+    QString title;
+    QString message;
+};
+
+class ServerEventBus : public QObject {
+    Q_OBJECT
+public:
+    static const int frameInterval = 16;
+
+    explicit ServerEventBus(QObject *parent = nullptr);
+
+    void publish(ServerEvent event);
+    void publishState(const QString& serverName, bool running);
+    void publishWarning(const QString& serverName, const QString& message);
+    void publishError(const QString& serverName, const QString& title, const QString& message);
+    void flush();
+
+signals:
+    void stateChanged(const QString& serverName, bool running);
+    void warningRaised(const QString& serverName, const QString& message);
+    void errorRaised(const QString& serverName, const QString& title, const QString& message, int count);
+
+private:
+    MpscQueue<ServerEvent> queue;
+    std::atomic<bool> frameScheduled{false};
+    QTimer frameTimer;
+};
+
+#endif // SERVER_EVENT_BUS_H
@@ -1,9 +1,21 @@
 #include "server_facade.h"
 #include "../config/configuration_manager.h"
+#include "../tuning/nginx_tuning_profile.h"
+#include "../tuning/apache_tuning_profile.h"
+#include "../../utility/asset_precompressor.h"
+#include "../../utility/trace.h"
+#include "../../utility/process_stats.h"
+#include "../metrics/metrics_registry.h"
 #include "../../gui/views/mainwindow.h"
 #include <QDebug>
 #include <QTcpSocket>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QJsonArray>
 #include <QThread>
+#include <QDeadlineTimer>
+#include <QMutexLocker>
 #include <QMessageBox>
 #include <QMainWindow>
 
@@ -11,24 +23,63 @@ ServerFacade::ServerFacade(){
     serverStates.insert("apache", false);
     serverStates.insert("nginx", false);
     serverStates.insert("mysql", false);
-    QMainWindow::connect(&apacheServer, &ApacheServer::updateState, this, &ServerFacade::setServerState);
-    QMainWindow::connect(&nginxServer, &NginxServer::updateState, this, &ServerFacade::setServerState);
-    QMainWindow::connect(&mysqlServer, &MySQLServer::updateState, this, &ServerFacade::setServerState);
-    QMainWindow::connect(&apacheServer, &ApacheServer::errorOccurred, this, &ServerFacade::handleError);
-    QMainWindow::connect(&nginxServer, &NginxServer::errorOccurred, this, &ServerFacade::handleError);
-    QMainWindow::connect(&mysqlServer, &MySQLServer::errorOccurred, this, &ServerFacade::handleError);
+    serverStates.insert("mysql_proxy", false);
+    QMainWindow::connect(&apacheServer, &ApacheServer::updateState, this, [this](const QString &serverName, bool isRunning) {
+        setServerState(serverName, isRunning);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&nginxServer, &NginxServer::updateState, this, [this](const QString &serverName, bool isRunning) {
+        setServerState(serverName, isRunning);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&mysqlServer, &MySQLServer::updateState, this, [this](const QString &serverName, bool isRunning) {
+        setServerState(serverName, isRunning);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&mysqlProxyServer, &MySQLProxyServer::updateState, this, [this](const QString &serverName, bool isRunning) {
+        setServerState(serverName, isRunning);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&apacheServer, &ApacheServer::errorOccurred, this, [this](const QString &errorTitle, const QString &errorMessage) {
+        eventBus.publishError("apache", errorTitle, errorMessage);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&nginxServer, &NginxServer::errorOccurred, this, [this](const QString &errorTitle, const QString &errorMessage) {
+        eventBus.publishError("nginx", errorTitle, errorMessage);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&mysqlServer, &MySQLServer::errorOccurred, this, [this](const QString &errorTitle, const QString &errorMessage) {
+        eventBus.publishError("mysql", errorTitle, errorMessage);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&mysqlProxyServer, &MySQLProxyServer::errorOccurred, this, [this](const QString &errorTitle, const QString &errorMessage) {
+        eventBus.publishError("mysql_proxy", errorTitle, errorMessage);
+    }, Qt::DirectConnection);
     QMainWindow::connect(&apacheServer, &ApacheServer::displayServerWarning, this, [this](const QString &warningMessage) {
-        onDisplayServerWarning("apache", warningMessage);
-    });
+        eventBus.publishWarning("apache", warningMessage);
+    }, Qt::DirectConnection);
     QMainWindow::connect(&nginxServer, &NginxServer::displayServerWarning, this, [this](const QString &warningMessage) {
-        onDisplayServerWarning("nginx", warningMessage);
-    });
+        eventBus.publishWarning("nginx", warningMessage);
+    }, Qt::DirectConnection);
     QMainWindow::connect(&mysqlServer, &MySQLServer::displayServerWarning, this, [this](const QString &warningMessage) {
-        onDisplayServerWarning("mysql", warningMessage);
+        eventBus.publishWarning("mysql", warningMessage);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&mysqlProxyServer, &MySQLProxyServer::displayServerWarning, this, [this](const QString &warningMessage) {
+        eventBus.publishWarning("mysql_proxy", warningMessage);
+    }, Qt::DirectConnection);
+    QMainWindow::connect(&eventBus, &ServerEventBus::stateChanged, this, &ServerFacade::onServerStateChanged);
+    QMainWindow::connect(&eventBus, &ServerEventBus::warningRaised, this, &ServerFacade::onDisplayServerWarning);
+    QMainWindow::connect(&eventBus, &ServerEventBus::errorRaised, this, [this](const QString &serverName, const QString &errorTitle, const QString &errorMessage, int count) {
+        Q_UNUSED(serverName);
+        handleError(errorTitle, count > 1 ? errorMessage + " (repeated " + QString::number(count) + " times)" : errorMessage);
+    });
+    QMainWindow::connect(this, &ServerFacade::updateState, &controlApi, &ControlApi::publishState);
+    QMainWindow::connect(this, &ServerFacade::displayServerWarning, &controlApi, &ControlApi::publishWarning);
+    QMainWindow::connect(this, &ServerFacade::errorOccurred, &controlApi, &ControlApi::publishError);
+    QMainWindow::connect(&versionDiscovery, &VersionDiscovery::installationsChanged, this, [this](const QList<Installation> &installations) {
+        QJsonObject result = mergeInstallations(installations);
+        if (!result["added"].toArray().isEmpty() || !result["removed"].toArray().isEmpty()) {
+            emit availableVersionsChanged();
+        }
     });
+    registerMetrics();
 }
 
-void ServerFacade::loadConfigurations(const QJsonObject& config) {
+void ServerFacade::validateConfiguration(const QJsonObject& config) {
+    TRACE_SCOPE("startup", "ServerFacade::validateConfiguration");
     if(!(config.contains("servers") && config["servers"].isObject())) {
         QString errMsg = "Configuration is corrupted or has invalid values.";
 
@@ -37,35 +88,40 @@ void ServerFacade::loadConfigurations(const QJsonObject& config) {
     }
     if (config["servers"].toObject().contains("apache")) {
         QJsonObject apacheConfig = config["servers"].toObject()["apache"].toObject()["config"].toObject();
-        QStringList validationErrors;
         if(!(apacheConfig.contains("version") && apacheConfig["version"].isString())) {
             QString errMsg = "Failed to set Apache version: configuration is corrupted or has invalid version value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        setServerVersion("apache", apacheConfig["version"].toString());
-
         if(!(apacheConfig.contains("php_version") && apacheConfig["php_version"].isString())) {
             QString errMsg = "Failed to set PHP version for Apache: configuration is corrupted or has invalid PHP version value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        setApachePHPVersion(apacheConfig["php_version"].toString());
-
         if (!(apacheConfig.contains("port") && apacheConfig["port"].isDouble())) {
             QString errMsg = "Failed to set port for Apache: configuration is corrupted or has invalid port value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        setServerPort("apache", apacheConfig["port"].toInt(), validationErrors);
-
         if(!(apacheConfig.contains("document_root") && apacheConfig["document_root"].isString())) {
             QString errMsg = "Failed to set document root for Apache: configuration is corrupted or has invalid document root value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        if(!setApacheDocumentRoot(apacheConfig["document_root"].toString())){
-            QString errMsg = "Failed to configure Apache: DocumentRoot path does not exist.";
+        if(apacheConfig.contains("tuning_profiles") && !(apacheConfig["tuning_profiles"].isObject() && apacheConfig["expected_concurrency"].isDouble())) {
+            QString errMsg = "Failed to set Apache tuning profile: configuration is corrupted or has invalid tuning values.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        if(!validationErrors.isEmpty()){
-            QString errMsg = "Failed to configure Apache: configuration has invalid values.";
+        if(apacheConfig.contains("isolation") && !apacheConfig["isolation"].isObject()) {
+            QString errMsg = "Failed to set process isolation for Apache: configuration is corrupted or has invalid isolation values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(apacheConfig.contains("cgroup") && !apacheConfig["cgroup"].isObject()) {
+            QString errMsg = "Failed to set cgroup limits for Apache: configuration is corrupted or has invalid cgroup values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(apacheConfig.contains("tls") && !apacheConfig["tls"].isObject()) {
+            QString errMsg = "Failed to set TLS for Apache: configuration is corrupted or has invalid TLS settings.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(apacheConfig.contains("document_root_mirror") && !apacheConfig["document_root_mirror"].isObject()) {
+            QString errMsg = "Failed to set the document root mirror for Apache: configuration is corrupted or has invalid mirror settings.";
             throw std::runtime_error(errMsg.toStdString());
         }
     } else{
@@ -75,40 +131,52 @@ void ServerFacade::loadConfigurations(const QJsonObject& config) {
 
     if (config["servers"].toObject().contains("nginx")) {
         QJsonObject nginxConfig = config["servers"].toObject()["nginx"].toObject()["config"].toObject();
-        QStringList validationErrors;
         if(!(nginxConfig.contains("version") && nginxConfig["version"].isString())) {
             QString errMsg = "Failed to set Nginx version: configuration is corrupted or has invalid version value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        setServerVersion("nginx", nginxConfig["version"].toString());
-
         if(!(nginxConfig.contains("php_version") && nginxConfig["php_version"].isString())) {
             QString errMsg = "Failed to set PHP version for Nginx: configuration is corrupted or has invalid PHP version value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        setNginxPHPVersion(nginxConfig["php_version"].toString());
-
         if (!(nginxConfig.contains("port") && nginxConfig["port"].isDouble())) {
             QString errMsg = "Failed to set port for Nginx: configuration is corrupted or has invalid port value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        setServerPort("nginx", nginxConfig["port"].toInt(), validationErrors);
-
         if(!(nginxConfig.contains("document_root") && nginxConfig["document_root"].isString())) {
             QString errMsg = "Failed to set document root for Nginx: configuration is corrupted or has invalid document root value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        if(!setNginxDocumentRoot(nginxConfig["document_root"].toString())){
-            QString errMsg = "Failed to configure Nginx: DocumentRoot path does not exist.";
-            throw std::runtime_error(errMsg.toStdString());
-        }
         if(!(nginxConfig.contains("php_cgi_port") && nginxConfig["php_cgi_port"].isDouble())) {
             QString errMsg = "Failed to set PHP-CGI port for Nginx: configuration is corrupted or has invalid port value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-        setNginxPHPCGIport(nginxConfig["php_cgi_port"].toInt(), validationErrors);
-        if(!validationErrors.isEmpty()){
-            QString errMsg = "Failed to configure Nginx: configuration has invalid values.";
+        if(nginxConfig.contains("performance_profile") && !nginxConfig["performance_profile"].isString()) {
+            QString errMsg = "Failed to set Nginx performance profile: configuration is corrupted or has invalid profile value.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(nginxConfig.contains("fastcgi_cache") && !nginxConfig["fastcgi_cache"].isObject()) {
+            QString errMsg = "Failed to set Nginx FastCGI cache: configuration is corrupted or has invalid cache settings.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(nginxConfig.contains("isolation") && !nginxConfig["isolation"].isObject()) {
+            QString errMsg = "Failed to set process isolation for Nginx: configuration is corrupted or has invalid isolation values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(nginxConfig.contains("cgroup") && !nginxConfig["cgroup"].isObject()) {
+            QString errMsg = "Failed to set cgroup limits for Nginx: configuration is corrupted or has invalid cgroup values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(nginxConfig.contains("transport") && !nginxConfig["transport"].isString()) {
+            QString errMsg = "Failed to set the PHP-CGI transport for Nginx: configuration is corrupted or has invalid transport value.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(nginxConfig.contains("tls") && !nginxConfig["tls"].isObject()) {
+            QString errMsg = "Failed to set TLS for Nginx: configuration is corrupted or has invalid TLS settings.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(nginxConfig.contains("document_root_mirror") && !nginxConfig["document_root_mirror"].isObject()) {
+            QString errMsg = "Failed to set the document root mirror for Nginx: configuration is corrupted or has invalid mirror settings.";
             throw std::runtime_error(errMsg.toStdString());
         }
     } else{
@@ -118,32 +186,238 @@ void ServerFacade::loadConfigurations(const QJsonObject& config) {
 
     if (config["servers"].toObject().contains("mysql")) {
         QJsonObject mysqlConfig = config["servers"].toObject()["mysql"].toObject()["config"].toObject();
-        QStringList validationErrors;
-
         if(!(mysqlConfig.contains("version") && mysqlConfig["version"].isString())) {
             QString errMsg = "Failed to set Mysql version: configuration is corrupted or has invalid version value.";
             throw std::runtime_error(errMsg.toStdString());
         }
-
-        setServerVersion("mysql", mysqlConfig["version"].toString());
-
         if (!(mysqlConfig.contains("port") && mysqlConfig["port"].isDouble())) {
             QString errMsg = "Failed to set port for Mysql: configuration is corrupted or has invalid port value.";
             throw std::runtime_error(errMsg.toStdString());
         }
+        if(mysqlConfig.contains("isolation") && !mysqlConfig["isolation"].isObject()) {
+            QString errMsg = "Failed to set process isolation for Mysql: configuration is corrupted or has invalid isolation values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(mysqlConfig.contains("cgroup") && !mysqlConfig["cgroup"].isObject()) {
+            QString errMsg = "Failed to set cgroup limits for Mysql: configuration is corrupted or has invalid cgroup values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(mysqlConfig.contains("slow_query_log") && !mysqlConfig["slow_query_log"].isObject()) {
+            QString errMsg = "Failed to set the slow query log for Mysql: configuration is corrupted or has invalid slow query log values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(mysqlConfig.contains("transport") && !mysqlConfig["transport"].isString()) {
+            QString errMsg = "Failed to set the transport for Mysql: configuration is corrupted or has invalid transport value.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    } else{
+        QString errMsg = "Failed to configure Mysql: server configuration not found or corrupted. ";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    if (config["servers"].toObject().contains("mysql_proxy")) {
+        QJsonObject proxyConfig = config["servers"].toObject()["mysql_proxy"].toObject()["config"].toObject();
+        if (!(proxyConfig.contains("port") && proxyConfig["port"].isDouble())) {
+            QString errMsg = "Failed to set port for the MySQL proxy: configuration is corrupted or has invalid port value.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+
+    if (config.contains("php_runtime")) {
+        if (!config["php_runtime"].isObject()) {
+            QString errMsg = "Failed to configure PHP runtime: configuration is corrupted or has invalid OPcache values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        QJsonObject phpRuntimeConfig = config["php_runtime"].toObject();
+        for (auto it = phpRuntimeConfig.begin(); it != phpRuntimeConfig.end(); ++it) {
+            if (!it.value().isObject()) {
+                QString errMsg = "Failed to configure PHP runtime: configuration for PHP " + it.key() + " is corrupted.";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+        }
+    }
+    if (config.contains("ports") && !config["ports"].isObject()) {
+        QString errMsg = "Failed to configure ports: configuration is corrupted or has invalid port ranges.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (config.contains("metrics") && !config["metrics"].isObject()) {
+        QString errMsg = "Failed to configure the metrics endpoint: configuration is corrupted or has invalid metrics settings.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (config.contains("control_api") && !config["control_api"].isObject()) {
+        QString errMsg = "Failed to configure the control API: configuration is corrupted or has invalid control API settings.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (config.contains("mysql_status") && !config["mysql_status"].isObject()) {
+        QString errMsg = "Failed to configure MySQL status polling: configuration is corrupted or has invalid polling settings.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (config.contains("workspace_profiles") && !config["workspace_profiles"].isObject()) {
+        QString errMsg = "Failed to configure workspace profiles: configuration is corrupted or has invalid workspace profile settings.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
+
+void ServerFacade::loadConfigurations(const QJsonObject& config, bool validated) {
+    TRACE_SCOPE("startup", "ServerFacade::loadConfigurations");
+    if (!validated) {
+        validateConfiguration(config);
+    }
+    {
+        TRACE_SCOPE("startup", "ServerFacade::loadConfigurations.apache");
+        QJsonObject apacheConfig = config["servers"].toObject()["apache"].toObject()["config"].toObject();
+        QStringList validationErrors;
+        setServerVersion("apache", apacheConfig["version"].toString());
+        setApachePHPVersion(apacheConfig["php_version"].toString());
+        setServerPort("apache", apacheConfig["port"].toInt(), validationErrors);
+        if(!setApacheDocumentRoot(apacheConfig["document_root"].toString())){
+            QString errMsg = "Failed to configure Apache: DocumentRoot path does not exist.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        if(apacheConfig.contains("tuning_profiles")) {
+            setApacheTuningProfiles(apacheConfig["tuning_profiles"].toObject(), apacheConfig["expected_concurrency"].toInt());
+        }
+        if(apacheConfig.contains("precompressed_assets")) {
+            setPrecompressedAssets("apache", apacheConfig["precompressed_assets"].toBool());
+        }
+        if(apacheConfig.contains("isolation")) {
+            setServerIsolation("apache", apacheConfig["isolation"].toObject());
+        }
+        if(apacheConfig.contains("cgroup")) {
+            setServerCgroup("apache", apacheConfig["cgroup"].toObject());
+        }
+        if(apacheConfig.contains("tls")) {
+            setServerTls("apache", apacheConfig["tls"].toObject());
+        }
+        if(apacheConfig.contains("document_root_mirror")) {
+            setServerDocumentRootMirror("apache", apacheConfig["document_root_mirror"].toObject());
+        }
+        if(!validationErrors.isEmpty()){
+            QString errMsg = "Failed to configure Apache: configuration has invalid values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+
+    {
+        TRACE_SCOPE("startup", "ServerFacade::loadConfigurations.nginx");
+        QJsonObject nginxConfig = config["servers"].toObject()["nginx"].toObject()["config"].toObject();
+        QStringList validationErrors;
+        setServerVersion("nginx", nginxConfig["version"].toString());
+        setNginxPHPVersion(nginxConfig["php_version"].toString());
+        setServerPort("nginx", nginxConfig["port"].toInt(), validationErrors);
+        if(!setNginxDocumentRoot(nginxConfig["document_root"].toString())){
+            QString errMsg = "Failed to configure Nginx: DocumentRoot path does not exist.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        setNginxPHPCGIport(nginxConfig["php_cgi_port"].toInt(), validationErrors);
+        if(nginxConfig.contains("php_fpm_port") && nginxConfig["php_fpm_port"].isDouble()) {
+            setNginxPHPFPMport(nginxConfig["php_fpm_port"].toInt(), validationErrors);
+        }
+        if(nginxConfig.contains("transport")) {
+            setServerTransport("nginx", nginxConfig["transport"].toString());
+        }
+        if(nginxConfig.contains("performance_profile")) {
+            setNginxPerformanceProfile(nginxConfig["performance_profile"].toString());
+        }
+        if(nginxConfig.contains("precompressed_assets")) {
+            setPrecompressedAssets("nginx", nginxConfig["precompressed_assets"].toBool());
+        }
+        if(nginxConfig.contains("fastcgi_cache")) {
+            setNginxFastCGICache(nginxConfig["fastcgi_cache"].toObject());
+        }
+        if(nginxConfig.contains("isolation")) {
+            setServerIsolation("nginx", nginxConfig["isolation"].toObject());
+        }
+        if(nginxConfig.contains("cgroup")) {
+            setServerCgroup("nginx", nginxConfig["cgroup"].toObject());
+        }
+        if(nginxConfig.contains("tls")) {
+            setServerTls("nginx", nginxConfig["tls"].toObject());
+        }
+        if(nginxConfig.contains("document_root_mirror")) {
+            setServerDocumentRootMirror("nginx", nginxConfig["document_root_mirror"].toObject());
+        }
+        if(!validationErrors.isEmpty()){
+            QString errMsg = "Failed to configure Nginx: configuration has invalid values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+
+    {
+        TRACE_SCOPE("startup", "ServerFacade::loadConfigurations.mysql");
+        QJsonObject mysqlConfig = config["servers"].toObject()["mysql"].toObject()["config"].toObject();
+        QStringList validationErrors;
+        setServerVersion("mysql", mysqlConfig["version"].toString());
         setServerPort("mysql", mysqlConfig["port"].toInt(), validationErrors);
+        if(mysqlConfig.contains("isolation")) {
+            setServerIsolation("mysql", mysqlConfig["isolation"].toObject());
+        }
+        if(mysqlConfig.contains("cgroup")) {
+            setServerCgroup("mysql", mysqlConfig["cgroup"].toObject());
+        }
+        if(mysqlConfig.contains("slow_query_log")) {
+            setMySQLSlowQueryLog(mysqlConfig["slow_query_log"].toObject());
+        }
+        if(mysqlConfig.contains("transport")) {
+            setServerTransport("mysql", mysqlConfig["transport"].toString());
+        }
 
         if(!validationErrors.isEmpty()){
 
             QString errMsg = "Failed to configure Mysql: configuration has invalid values.";
             throw std::runtime_error(errMsg.toStdString());
         }
+    }
 
-    } else{
-        QString errMsg = "Failed to configure Mysql: server configuration not found or corrupted. ";
-        throw std::runtime_error(errMsg.toStdString());
+    if (config["servers"].toObject().contains("mysql_proxy")) {
+        TRACE_SCOPE("startup", "ServerFacade::loadConfigurations.mysql_proxy");
+        QJsonObject proxyConfig = config["servers"].toObject()["mysql_proxy"].toObject()["config"].toObject();
+        QStringList validationErrors;
+        setServerPort("mysql_proxy", proxyConfig["port"].toInt(), validationErrors);
+        setMySQLProxySettings(proxyConfig);
+        if(!validationErrors.isEmpty()){
+            QString errMsg = "Failed to configure the MySQL proxy: configuration has invalid values.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+
+    if (config.contains("php_runtime")) {
+        QJsonObject phpRuntimeConfig = config["php_runtime"].toObject();
+        for (auto it = phpRuntimeConfig.begin(); it != phpRuntimeConfig.end(); ++it) {
+            if (getPHPPaths(it.key()).isEmpty()) {
+                qWarning() << "PHP" << it.key() << "is not installed; its OPcache settings are kept but not applied.";
+                phpRuntimeManager.storeSettings(it.key(), it.value().toObject());
+                continue;
+            }
+            setPHPRuntimeSettings(it.key(), it.value().toObject());
+        }
+    }
+    if (config.contains("ports")) {
+        QJsonObject portsConfig = config["ports"].toObject();
+        portAllocator.setRanges(portsConfig["ranges"].toObject());
+        if (portsConfig["auto_assign"].toBool()) {
+            resolvePortConflicts();
+        }
+    }
+    if (config.contains("metrics")) {
+        setMetricsEndpoint(config["metrics"].toObject());
+    }
+    if (config.contains("control_api")) {
+        setControlApiEndpoint(config["control_api"].toObject());
+    }
+    if (config.contains("mysql_status")) {
+        setMySQLStatusPolling(config["mysql_status"].toObject());
     }
     updateAbsolutePaths();
+    QString workspaceProfile = config["workspace_profiles"].toObject()["active"].toString();
+    if (!workspaceProfile.isEmpty()) {
+        try {
+            activateWorkspaceProfile(workspaceProfile);
+        } catch (const std::runtime_error& e) {
+            qWarning() << "Failed to activate workspace profile" << workspaceProfile << ":" << e.what();
+            saveActiveWorkspaceProfile();
+        }
+    }
 }
 
 QJsonObject ServerFacade::getConfigurations() const {
@@ -156,105 +430,786 @@ QJsonObject ServerFacade::getConfigurations() const {
     return servers;
 }
 
-QJsonObject ServerFacade::getServerConfiguration(const QString& serverName) {
+QJsonObject ServerFacade::getServerConfiguration(const QString& serverName) {
+    IServer* server = getServerByName(serverName);
+    return server->getConfig();
+}
+
+QJsonObject ServerFacade::getAvailableVersions(const QString& serverName) {
+    getServerByName(serverName);
+    const QJsonObject& serverConfig = ConfigurationManager::getInstance().getConfiguration()["servers"].toObject()[serverName].toObject();
+    QJsonObject versions = serverConfig["versions"].toObject();
+    return versions;
+}
+
+QJsonObject ServerFacade::getAvailablePHPVersions(const QString& serverName) const {
+    if(serverName == "apache" || serverName == "nginx") {
+        const QJsonObject& serverConfig = ConfigurationManager::getInstance().getConfiguration()["servers"].toObject()[serverName].toObject();
+        QJsonObject versions = serverConfig["php_versions"].toObject();
+        return versions;
+    } else{
+        QString errMsg = "Failed to get available PHP version for server: server " + serverName + "does not support PHP.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
+
+QJsonObject ServerFacade::discoverVersions() {
+    TRACE_SCOPE("startup", "ServerFacade::discoverVersions");
+    return mergeInstallations(versionDiscovery.scan());
+}
+
+QJsonObject ServerFacade::pruneStaleVersions() {
+    TRACE_SCOPE("config", "ServerFacade::pruneStaleVersions");
+    return mergeInstallations(versionDiscovery.scan(), true);
+}
+
+void ServerFacade::watchVersions() {
+    versionDiscovery.watch();
+}
+
+QJsonObject ServerFacade::mergeInstallations(const QList<Installation> &installations, bool pruneStale) {
+    ConfigurationManager& configManager = ConfigurationManager::getInstance();
+    QJsonObject config = configManager.getConfiguration();
+    QJsonObject serversConfig = config["servers"].toObject();
+    QJsonArray added;
+    QJsonArray removed;
+    QJsonArray stale;
+
+    auto targetsFor = [](const QString& kind) {
+        return kind == "php" ? QStringList() << "apache" << "nginx" : QStringList() << kind;
+    };
+
+    for (const QString& kind : VersionDiscovery::kinds()) {
+        QString key = kind == "php" ? "php_versions" : "versions";
+        QString selectedKey = kind == "php" ? "php_version" : "version";
+        QString discoveredPrefix = versionDiscovery.getBinRoot() + "/" + kind + "/";
+        for (const QString& serverName : targetsFor(kind)) {
+            if (!serversConfig.contains(serverName)) {
+                continue;
+            }
+            QJsonObject serverConfig = serversConfig[serverName].toObject();
+            QJsonObject versions = serverConfig[key].toObject();
+            QString selected = serverConfig["config"].toObject()[selectedKey].toString();
+            bool changed = false;
+
+            for (const QString& version : versions.keys()) {
+                QString path = versions[version].toString();
+                if (version != selected && path.startsWith(discoveredPrefix) && !QDir(path).exists()) {
+                    if (!pruneStale) {
+                        stale.append(serverName + ":" + kind + " " + version);
+                        continue;
+                    }
+                    versions.remove(version);
+                    removed.append(serverName + ":" + kind + " " + version);
+                    changed = true;
+                }
+            }
+            for (const Installation& installation : installations) {
+                if (installation.kind != kind || versions.contains(installation.version)) {
+                    continue;
+                }
+                bool known = false;
+                for (auto it = versions.begin(); it != versions.end(); ++it) {
+                    if (QDir(it.value().toString()).absolutePath() == QDir(installation.path).absolutePath()) {
+                        known = true;
+                        break;
+                    }
+                }
+                if (known) {
+                    continue;
+                }
+                versions[installation.version] = installation.path;
+                added.append(serverName + ":" + kind + " " + installation.version);
+                changed = true;
+            }
+
+            if (changed) {
+                serverConfig[key] = versions;
+                serversConfig[serverName] = serverConfig;
+            }
+        }
+    }
+
+    if (!added.isEmpty() || !removed.isEmpty()) {
+        config["servers"] = serversConfig;
+        configManager.setConfiguration(config);
+        configManager.scheduleSave("config.json");
+        qDebug() << "Version discovery added" << added.size() << "and removed" << removed.size() << "entries";
+    }
+    if (!stale.isEmpty()) {
+        qWarning() << "Configured versions no longer installed under" << versionDiscovery.getBinRoot() << ":" << stale.toVariantList()
+                   << "- run with --versions-prune to remove them from config.json.";
+    }
+
+    QJsonObject result;
+    result["installations"] = installations.size();
+    result["added"] = added;
+    result["removed"] = removed;
+    result["stale"] = stale;
+    return result;
+}
+
+QDir ServerFacade::getPHPPath(const QString& serverName) const {
+    if(serverName == "apache") {
+        return apacheServer.getPHPPath();
+    } else if(serverName == "nginx") {
+        return nginxServer.getPHPPath();
+    }
+    else{
+        QString errMsg = "Failed to get PHP version for server: server " + serverName + " does not support PHP.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
+
+void ServerFacade::startServer(const QString& serverName) {
+    TRACE_SCOPE_ARG("server", "ServerFacade::startServer", "server", serverName);
+    IServer* server = getServerByName(serverName);
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    QElapsedTimer timer;
+    timer.start();
+    bool started = false;
+    try {
+        started = server->start();
+    } catch (...) {
+        metrics.increment("webdevtoolkit_server_starts_total", {{"server", serverName}, {"result", "failure"}});
+        throw;
+    }
+    metrics.increment("webdevtoolkit_server_starts_total", {{"server", serverName}, {"result", started ? "success" : "skipped"}});
+    if (started) {
+        metrics.observe("webdevtoolkit_server_start_duration_seconds", {{"server", serverName}}, double(timer.nsecsElapsed()) / 1e9);
+    }
+}
+
+void ServerFacade::stopServer(const QString& serverName) {
+    TRACE_SCOPE_ARG("server", "ServerFacade::stopServer", "server", serverName);
+    IServer* server = getServerByName(serverName);
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    QElapsedTimer timer;
+    timer.start();
+    bool stopped = false;
+    try {
+        stopped = server->stop();
+    } catch (...) {
+        metrics.increment("webdevtoolkit_server_stops_total", {{"server", serverName}, {"result", "failure"}});
+        throw;
+    }
+    metrics.increment("webdevtoolkit_server_stops_total", {{"server", serverName}, {"result", stopped ? "success" : "skipped"}});
+    if (stopped) {
+        metrics.observe("webdevtoolkit_server_stop_duration_seconds", {{"server", serverName}}, double(timer.nsecsElapsed()) / 1e9);
+    }
+}
+
+void ServerFacade::restartServer(const QString &serverName) {
+    TRACE_SCOPE_ARG("server", "ServerFacade::restartServer", "server", serverName);
+    MetricsRegistry::getInstance().increment("webdevtoolkit_server_restarts_total", {{"server", serverName}});
+    if (getServerState(serverName)) {
+        stopServer(serverName);
+        waitForServerState(serverName, false, 5000);
+    }
+    startServer(serverName);
+}
+
+bool ServerFacade::waitForServerState(const QString &serverName, bool isRunning, int timeoutMs) {
+    QDeadlineTimer deadline(timeoutMs);
+    QMutexLocker locker(&stateMutex);
+    while (serverStates.value(serverName) != isRunning) {
+        if (!stateCondition.wait(&stateMutex, deadline)) {
+            return serverStates.value(serverName) == isRunning;
+        }
+    }
+    return true;
+}
+
+QStringList ServerFacade::configurableKeys(const QString &serverName) {
+    static const QHash<QString, QStringList> supportedKeys = {
+        {"apache", QStringList() << "version" << "php_version" << "port" << "document_root" << "tuning_profiles" << "expected_concurrency" << "precompressed_assets" << "isolation" << "cgroup" << "tls" << "document_root_mirror"},
+        {"nginx", QStringList() << "version" << "php_version" << "port" << "document_root" << "php_cgi_port" << "php_fpm_port" << "transport" << "performance_profile" << "precompressed_assets" << "fastcgi_cache" << "isolation" << "cgroup" << "tls" << "document_root_mirror"},
+        {"mysql", QStringList() << "version" << "port" << "transport" << "phpmyadmin_port" << "isolation" << "cgroup" << "slow_query_log"},
+        {"mysql_proxy", QStringList() << "port" << "enabled" << "pool_size" << "min_idle" << "idle_timeout_ms" << "acquire_timeout_ms" << "user" << "password"}
+    };
+    return supportedKeys.value(serverName);
+}
+
+QJsonObject ServerFacade::getConfigurableState(const QString &serverName) {
+    const QStringList keys = configurableKeys(serverName);
+    QJsonObject config = getServerConfiguration(serverName);
+    QJsonObject state;
+    for (auto it = config.begin(); it != config.end(); ++it) {
+        if (keys.contains(it.key())) {
+            state[it.key()] = it.value();
+        }
+    }
+    return state;
+}
+
+QStringList ServerFacade::applyServerConfiguration(const QString &serverName, const QJsonObject &changes) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::applyServerConfiguration", "server", serverName);
+    const QStringList supportedKeys = configurableKeys(serverName);
+    if (supportedKeys.isEmpty()) {
+        QString errMsg = "Failed to apply configuration: server " + serverName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    requireNoWorkspaceProfile(serverName);
+    for (auto it = changes.begin(); it != changes.end(); ++it) {
+        if (!supportedKeys.contains(it.key())) {
+            QString errMsg = "Failed to apply configuration: " + it.key() + " cannot be set for " + serverName + ".";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        bool isObjectKey = it.key() == "tuning_profiles" || it.key() == "fastcgi_cache" || it.key() == "isolation" || it.key() == "cgroup" || it.key() == "slow_query_log" || it.key() == "tls" || it.key() == "document_root_mirror";
+        bool isNumberKey = it.key().endsWith("port") || it.key().endsWith("_ms") || it.key() == "expected_concurrency" || it.key() == "pool_size" || it.key() == "min_idle";
+        bool isBoolKey = it.key() == "precompressed_assets" || it.key() == "enabled";
+        bool valid = isObjectKey ? it.value().isObject() : isNumberKey ? it.value().isDouble() : isBoolKey ? it.value().isBool() : it.value().isString();
+        if (!valid) {
+            QString errMsg = "Failed to apply configuration: " + it.key() + " has an invalid value.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+
+    QStringList validationErrors;
+    if (changes.contains("version")) {
+        setServerVersion(serverName, changes.value("version").toString());
+    }
+    if (changes.contains("php_version")) {
+        if (serverName == "apache") {
+            setApachePHPVersion(changes.value("php_version").toString());
+        } else {
+            setNginxPHPVersion(changes.value("php_version").toString());
+        }
+    }
+    if (changes.contains("port")) {
+        setServerPort(serverName, changes.value("port").toInt(), validationErrors);
+    }
+    if (changes.contains("document_root")) {
+        bool pathExists = serverName == "apache" ? setApacheDocumentRoot(changes.value("document_root").toString())
+                                                 : setNginxDocumentRoot(changes.value("document_root").toString());
+        if (!pathExists) {
+            validationErrors.append("DocumentRootNotFound");
+        }
+    }
+    if (changes.contains("php_cgi_port")) {
+        setNginxPHPCGIport(changes.value("php_cgi_port").toInt(), validationErrors);
+    }
+    if (changes.contains("php_fpm_port")) {
+        setNginxPHPFPMport(changes.value("php_fpm_port").toInt(), validationErrors);
+    }
+    if (changes.contains("transport")) {
+        setServerTransport(serverName, changes.value("transport").toString());
+    }
+    if (changes.contains("phpmyadmin_port")) {
+        setPHPMyAdminPort(changes.value("phpmyadmin_port").toInt(), validationErrors);
+    }
+    if (changes.contains("performance_profile")) {
+        setNginxPerformanceProfile(changes.value("performance_profile").toString());
+    }
+    if (changes.contains("tuning_profiles") || changes.contains("expected_concurrency")) {
+        QJsonObject current = getServerConfiguration("apache");
+        setApacheTuningProfiles(changes.value("tuning_profiles").toObject(current.value("tuning_profiles").toObject()),
+                                changes.value("expected_concurrency").toInt(current.value("expected_concurrency").toInt()));
+    }
+    if (changes.contains("precompressed_assets")) {
+        setPrecompressedAssets(serverName, changes.value("precompressed_assets").toBool());
+    }
+    if (changes.contains("fastcgi_cache")) {
+        setNginxFastCGICache(changes.value("fastcgi_cache").toObject());
+    }
+    if (changes.contains("isolation")) {
+        setServerIsolation(serverName, changes.value("isolation").toObject());
+    }
+    if (changes.contains("cgroup")) {
+        setServerCgroup(serverName, changes.value("cgroup").toObject());
+    }
+    if (changes.contains("tls")) {
+        setServerTls(serverName, changes.value("tls").toObject());
+    }
+    if (changes.contains("document_root_mirror")) {
+        setServerDocumentRootMirror(serverName, changes.value("document_root_mirror").toObject());
+    }
+    if (changes.contains("slow_query_log")) {
+        setMySQLSlowQueryLog(changes.value("slow_query_log").toObject());
+    }
+    if (serverName == "mysql_proxy") {
+        QJsonObject proxySettings = changes;
+        proxySettings.remove("port");
+        if (!proxySettings.isEmpty()) {
+            setMySQLProxySettings(proxySettings);
+        }
+    }
+    return validationErrors;
+}
+
+void ServerFacade::saveServerConfiguration(const QString &serverName) {
+    ConfigurationManager& configManager = ConfigurationManager::getInstance();
+    configManager.setServerConfiguration(serverName, getServerConfiguration(serverName));
+    if (!configManager.saveConfiguration("config.json")) {
+        throw std::runtime_error("Failed to save configuration: config.json is not writable.");
+    }
+}
+
+TaskPool &ServerFacade::getTaskPool() {
+    return taskPool;
+}
+
+void ServerFacade::runOnFacadeThread(const std::function<void()> &task) {
+    if (QThread::currentThread() == thread()) {
+        task();
+        return;
+    }
+    std::exception_ptr error;
+    QMetaObject::invokeMethod(this, [&task, &error]() {
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }, Qt::BlockingQueuedConnection);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ServerFacade::setServerVersion(const QString& serverName, const QString& version) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setServerVersion", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setServerVersion"}});
+    requireNoWorkspaceProfile(serverName);
+    IServer* server = getServerByName(serverName);
+
+    const QJsonObject& serverConfig = ConfigurationManager::getInstance().getConfiguration()["servers"].toObject()[serverName].toObject();
+    const QJsonObject& versions = serverConfig["versions"].toObject();
+
+    if (versions.contains(version) && versions[version].isString()) {
+        QString path = versions[version].toString();
+        server->setVersion(version);
+        serverConfig["config"].toObject()["version"] = version;
+        ConfigurationManager::getInstance().scheduleSave("config.json");
+    } else {
+        QString errMsg = "Failed to set version for " + serverName + ": the version " + version + " not found for this server.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+}
+
+bool ServerFacade::setServerPort(const QString& serverName, int port, QStringList &validationErrors) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setServerPort", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setServerPort"}});
+    requireNoWorkspaceProfile(serverName);
+    IServer* server = getServerByName(serverName);
+    bool changed = server->setPort(port, validationErrors);
+    if (changed) {
+        portAllocator.reserve(serverName, port);
+    }
+    return changed;
+}
+
+bool ServerFacade::setNginxPHPVersion(const QString& phpVersion) {
+    TRACE_SCOPE("config", "ServerFacade::setNginxPHPVersion");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setNginxPHPVersion"}});
+    requireNoWorkspaceProfile("nginx");
+    bool changed = nginxServer.setPHPVersion(phpVersion);
+    PHPRuntimeManager::applyMySQLSocket(nginxServer.getPHPPath(), mysqlServer.getSocketPath());
+    return changed;
+}
+
+bool ServerFacade::setApachePHPVersion(const QString& phpVersion) {
+    TRACE_SCOPE("config", "ServerFacade::setApachePHPVersion");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setApachePHPVersion"}});
+    requireNoWorkspaceProfile("apache");
+    bool changed = apacheServer.setPHPVersion(phpVersion);
+    PHPRuntimeManager::applyMySQLSocket(apacheServer.getPHPPath(), mysqlServer.getSocketPath());
+    return changed;
+}
+
+bool ServerFacade::setApacheDocumentRoot(const QString &newRoot) {
+    TRACE_SCOPE("config", "ServerFacade::setApacheDocumentRoot");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setApacheDocumentRoot"}});
+    requireNoWorkspaceProfile("apache");
+    return apacheServer.setDocumentRoot(newRoot);
+}
+
+bool ServerFacade::setNginxDocumentRoot(const QString &newRoot) {
+    TRACE_SCOPE("config", "ServerFacade::setNginxDocumentRoot");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setNginxDocumentRoot"}});
+    requireNoWorkspaceProfile("nginx");
+    return nginxServer.setDocumentRoot(newRoot);
+}
+
+bool ServerFacade::setNginxPHPFPMport(int port, QStringList &validationErrors) {
+    TRACE_SCOPE("config", "ServerFacade::setNginxPHPFPMport");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setNginxPHPFPMport"}});
+    requireNoWorkspaceProfile("nginx");
+    bool changed = nginxServer.setPHPFPMport(port, validationErrors);
+    if (changed && port == 0) {
+        portAllocator.release("nginx.php_fpm");
+    } else if (changed) {
+        portAllocator.reserve("nginx.php_fpm", port);
+    }
+    return changed;
+}
+
+bool ServerFacade::setNginxPHPCGIport(int port, QStringList &validationErrors){
+    TRACE_SCOPE("config", "ServerFacade::setNginxPHPCGIport");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setNginxPHPCGIport"}});
+    requireNoWorkspaceProfile("nginx");
+    bool changed = nginxServer.setPHPCGIPort(port, validationErrors);
+    if (changed) {
+        portAllocator.reserve("nginx.php_cgi", port);
+    }
+    return changed;
+}
+
+bool ServerFacade::setPHPMyAdminPort(int port, QStringList &validationErrors){
+    TRACE_SCOPE("config", "ServerFacade::setPHPMyAdminPort");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setPHPMyAdminPort"}});
+    requireNoWorkspaceProfile("mysql");
+    if (!mysqlServer.setPHPMyAdminPort(port, validationErrors)) {
+        return false;
+    }
+    if (port == mysqlServer.getConfig()["port"].toInt()) {
+        portAllocator.release("mysql.phpmyadmin");
+    } else {
+        portAllocator.reserve("mysql.phpmyadmin", port);
+    }
+    return true;
+}
+
+bool ServerFacade::setNginxPerformanceProfile(const QString &profileName) {
+    TRACE_SCOPE("config", "ServerFacade::setNginxPerformanceProfile");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setNginxPerformanceProfile"}});
+    requireNoWorkspaceProfile("nginx");
+    return nginxServer.setPerformanceProfile(profileName);
+}
+
+QStringList ServerFacade::getNginxPerformanceProfiles() const {
+    return NginxTuningProfile::availableProfiles();
+}
+
+bool ServerFacade::setNginxFastCGICache(const QJsonObject &settings) {
+    TRACE_SCOPE("config", "ServerFacade::setNginxFastCGICache");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setNginxFastCGICache"}});
+    requireNoWorkspaceProfile("nginx");
+    return nginxServer.setFastCGICache(settings);
+}
+
+QJsonObject ServerFacade::purgeNginxFastCGICache(const QString &target) {
+    return nginxServer.purgeFastCGICache(target);
+}
+
+QJsonObject ServerFacade::getNginxFastCGICacheStats() {
+    return nginxServer.getFastCGICacheStats();
+}
+
+bool ServerFacade::setApacheTuningProfile(const QString &profileName, int expectedConcurrency) {
+    requireNoWorkspaceProfile("apache");
+    return apacheServer.setTuningProfile(profileName, expectedConcurrency);
+}
+
+bool ServerFacade::setApacheTuningProfiles(const QJsonObject &profiles, int expectedConcurrency) {
+    TRACE_SCOPE("config", "ServerFacade::setApacheTuningProfiles");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setApacheTuningProfiles"}});
+    requireNoWorkspaceProfile("apache");
+    return apacheServer.setTuningProfiles(profiles, expectedConcurrency);
+}
+
+QStringList ServerFacade::getApacheTuningProfiles() const {
+    return ApacheTuningProfile::availableProfiles();
+}
+
+void ServerFacade::setPHPRuntimeSettings(const QString &phpVersion, const QJsonObject &settings) {
+    TRACE_SCOPE("config", "ServerFacade::setPHPRuntimeSettings");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setPHPRuntimeSettings"}});
+    const QStringList phpPaths = getPHPPaths(phpVersion);
+    if (phpPaths.isEmpty()) {
+        QString errMsg = "Failed to configure PHP runtime: PHP version " + phpVersion + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    for (const QString& phpPath : phpPaths) {
+        phpRuntimeManager.applyOpcacheSettings(phpVersion, QDir(phpPath), settings);
+    }
+}
+
+QStringList ServerFacade::getPHPPaths(const QString &phpVersion) {
+    QStringList phpPaths;
+    const QStringList phpServers = QStringList() << "apache" << "nginx";
+    for (const QString& serverName : phpServers) {
+        QJsonObject phpVersions = getAvailablePHPVersions(serverName);
+        if (phpVersions.contains(phpVersion) && phpVersions[phpVersion].isString()) {
+            QString phpPath = QDir(phpVersions[phpVersion].toString()).absolutePath();
+            if (!phpPaths.contains(phpPath) && QDir(phpPath).exists()) {
+                phpPaths.append(phpPath);
+            }
+        }
+    }
+    return phpPaths;
+}
+
+QJsonObject ServerFacade::getPHPRuntimeSettings() const {
+    return phpRuntimeManager.getSettings();
+}
+
+QJsonObject ServerFacade::generateOpcachePreload(const QString &serverName) {
     IServer* server = getServerByName(serverName);
-    return server->getConfig();
+    QJsonObject serverConfig = server->getConfig();
+    QStringList accessLogs = QStringList() << server->getPath().filePath("logs/access.log");
+    return phpRuntimeManager.generatePreload(serverConfig["php_version"].toString(), getPHPPath(serverName),
+                                             QDir(serverConfig["document_root"].toString()), accessLogs);
 }
 
-QJsonObject ServerFacade::getAvailableVersions(const QString& serverName) {
-    getServerByName(serverName);
-    const QJsonObject& serverConfig = ConfigurationManager::getInstance().getConfiguration()["servers"].toObject()[serverName].toObject();
-    QJsonObject versions = serverConfig["versions"].toObject();
-    return versions;
+QJsonObject ServerFacade::getOpcacheStatus(const QString &serverName) {
+    TRACE_SCOPE_ARG("probe", "ServerFacade::getOpcacheStatus", "server", serverName);
+    IServer* server = getServerByName(serverName);
+    getPHPPath(serverName);
+    if (!getServerState(serverName)) {
+        QString errMsg = "Failed to query OPcache status: server " + serverName + " is not running.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QJsonObject serverConfig = server->getConfig();
+    return phpRuntimeManager.queryOpcacheStatus(serverConfig["port"].toInt());
 }
 
-QJsonObject ServerFacade::getAvailablePHPVersions(const QString& serverName) const {
-    if(serverName == "apache" || serverName == "nginx") {
-        const QJsonObject& serverConfig = ConfigurationManager::getInstance().getConfiguration()["servers"].toObject()[serverName].toObject();
-        QJsonObject versions = serverConfig["php_versions"].toObject();
-        return versions;
-    } else{
-        QString errMsg = "Failed to get available PHP version for server: server " + serverName + "does not support PHP.";
+QJsonObject ServerFacade::precompressDocumentRoot(const QString &serverName) {
+    IServer* server = getServerByName(serverName);
+    QJsonObject serverConfig = server->getConfig();
+    if (!serverConfig.contains("document_root")) {
+        QString errMsg = "Failed to precompress assets: server " + serverName + " has no document root.";
         throw std::runtime_error(errMsg.toStdString());
     }
+    QJsonObject result = AssetPrecompressor::precompress(QDir(serverConfig["document_root"].toString()));
+    setPrecompressedAssets(serverName, true);
+    return result;
 }
 
+bool ServerFacade::setPrecompressedAssets(const QString &serverName, bool enabled) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setPrecompressedAssets", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setPrecompressedAssets"}});
+    requireNoWorkspaceProfile(serverName);
+    if (serverName == "apache") {
+        return apacheServer.setPrecompressedAssets(enabled);
+    } else if (serverName == "nginx") {
+        return nginxServer.setPrecompressedAssets(enabled);
+    } else {
+        QString errMsg = "Failed to configure precompressed assets: server " + serverName + " does not serve a document root.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
 
-QDir ServerFacade::getPHPPath(const QString& serverName) const {
-    if(serverName == "apache") {
-        return apacheServer.getPHPPath();
-    } else if(serverName == "nginx") {
-        return nginxServer.getPHPPath();
+bool ServerFacade::setServerTls(const QString &serverName, const QJsonObject &settings) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setServerTls", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setServerTls"}});
+    requireNoWorkspaceProfile(serverName);
+    if (!(serverName == "apache" || serverName == "nginx")) {
+        QString errMsg = "Failed to configure TLS: server " + serverName + " does not serve a document root.";
+        throw std::runtime_error(errMsg.toStdString());
     }
-    else{
-        QString errMsg = "Failed to get PHP version for server: server " + serverName + " does not support PHP.";
+    TlsSettings tls = TlsSettings::fromJson(settings, serverName == "apache" ? 8443 : 8543);
+    QString owner = serverName + ".tls";
+    if (tls.isEnabled() && portAllocator.ownerOf(tls.getPort()) != owner && !isPortFreeInApp(tls.getPort())) {
+        QString errMsg = "Failed to configure TLS for " + serverName + ": port " + QString::number(tls.getPort()) + " is already used by " + portAllocator.ownerOf(tls.getPort()) + ".";
         throw std::runtime_error(errMsg.toStdString());
     }
+    QList<TlsCertificate> certificates;
+    if (tls.isEnabled()) {
+        certificateAuthority.setSearchPaths(QStringList() << apacheServer.getPath().filePath("bin"));
+        certificates = certificateAuthority.issue(tls.getHosts());
+    }
+    bool changed = serverName == "apache" ? apacheServer.setTls(tls, certificates) : nginxServer.setTls(tls, certificates);
+    if (tls.isEnabled()) {
+        portAllocator.reserve(owner, tls.getPort());
+    } else {
+        portAllocator.release(owner);
+    }
+    return changed;
 }
 
-void ServerFacade::startServer(const QString& serverName) {
-    IServer* server = getServerByName(serverName);
-    server->start();
+bool ServerFacade::setServerTransport(const QString &serverName, const QString &transport) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setServerTransport", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setServerTransport"}});
+    requireNoWorkspaceProfile(serverName);
+    if (serverName == "nginx") {
+        return nginxServer.setTransport(transport);
+    } else if (serverName == "mysql") {
+        bool changed = mysqlServer.setTransport(transport);
+        PHPRuntimeManager::applyMySQLSocket(apacheServer.getPHPPath(), mysqlServer.getSocketPath());
+        PHPRuntimeManager::applyMySQLSocket(nginxServer.getPHPPath(), mysqlServer.getSocketPath());
+        return changed;
+    } else {
+        QString errMsg = "Failed to set transport: server " + serverName + " has no socket transport.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
 }
 
-void ServerFacade::stopServer(const QString& serverName) {
-    IServer* server = getServerByName(serverName);
-    server->stop();
+bool ServerFacade::setServerIsolation(const QString &serverName, const QJsonObject &settings) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setServerIsolation", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setServerIsolation"}});
+    requireNoWorkspaceProfile(serverName);
+    if (serverName == "apache") {
+        return apacheServer.setIsolation(settings);
+    } else if (serverName == "nginx") {
+        return nginxServer.setIsolation(settings);
+    } else if (serverName == "mysql") {
+        return mysqlServer.setIsolation(settings);
+    } else {
+        QString errMsg = "Failed to set process isolation: server " + serverName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
 }
 
-void ServerFacade::setServerVersion(const QString& serverName, const QString& version) {
-    IServer* server = getServerByName(serverName);
-
-    const QJsonObject& serverConfig = ConfigurationManager::getInstance().getConfiguration()["servers"].toObject()[serverName].toObject();
-    const QJsonObject& versions = serverConfig["versions"].toObject();
+bool ServerFacade::setServerCgroup(const QString &serverName, const QJsonObject &settings) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setServerCgroup", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setServerCgroup"}});
+    requireNoWorkspaceProfile(serverName);
+    if (serverName == "apache") {
+        return apacheServer.setCgroup(settings);
+    } else if (serverName == "nginx") {
+        return nginxServer.setCgroup(settings);
+    } else if (serverName == "mysql") {
+        return mysqlServer.setCgroup(settings);
+    } else {
+        QString errMsg = "Failed to set cgroup limits: server " + serverName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
 
-    if (versions.contains(version) && versions[version].isString()) {
-        QString path = versions[version].toString();
-        server->setVersion(version);
-        serverConfig["config"].toObject()["version"] = version;
-        ConfigurationManager::getInstance().saveConfiguration("config.json");
+bool ServerFacade::setServerDocumentRootMirror(const QString &serverName, const QJsonObject &settings) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::setServerDocumentRootMirror", "server", serverName);
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setServerDocumentRootMirror"}});
+    requireNoWorkspaceProfile(serverName);
+    if (serverName == "apache") {
+        return apacheServer.setDocumentRootMirror(settings);
+    } else if (serverName == "nginx") {
+        return nginxServer.setDocumentRootMirror(settings);
     } else {
-        QString errMsg = "Failed to set version for " + serverName + ": the version " + version + " not found for this server.";
+        QString errMsg = "Failed to set the document root mirror: server " + serverName + " not found.";
         throw std::runtime_error(errMsg.toStdString());
     }
+}
 
+bool ServerFacade::setMySQLSlowQueryLog(const QJsonObject &settings) {
+    TRACE_SCOPE("config", "ServerFacade::setMySQLSlowQueryLog");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setMySQLSlowQueryLog"}});
+    requireNoWorkspaceProfile("mysql");
+    return mysqlServer.setSlowQueryLog(settings);
 }
 
-bool ServerFacade::setServerPort(const QString& serverName, int port, QStringList &validationErrors) {
-    IServer* server = getServerByName(serverName);
-    return server->setPort(port, validationErrors);
+QJsonObject ServerFacade::getMySQLSlowQueries(int limit, const QString &orderBy) {
+    TRACE_SCOPE("probe", "ServerFacade::getMySQLSlowQueries");
+    return mysqlServer.getSlowQueries(limit, orderBy);
 }
 
-bool ServerFacade::setNginxPHPVersion(const QString& phpVersion) {
-    return nginxServer.setPHPVersion(phpVersion);
+bool ServerFacade::setMySQLStatusPolling(const QJsonObject &settings) {
+    TRACE_SCOPE("config", "ServerFacade::setMySQLStatusPolling");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setMySQLStatusPolling"}});
+    QJsonObject updated = mysqlStatusPoller.getSettings();
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        updated[it.key()] = it.value();
+    }
+    bool changed = updated != mysqlStatusPoller.getSettings();
+    mysqlStatusPoller.setSettings(updated);
+    if (changed && updated.value("enabled").toBool() && currentServerState("mysql") && !mysqlStatusPoller.isActive()) {
+        mysqlStatusPoller.start(mysqlServer.getConfig()["port"].toInt());
+    }
+    return changed;
 }
 
-bool ServerFacade::setApachePHPVersion(const QString& phpVersion) {
-    return apacheServer.setPHPVersion(phpVersion);
+QJsonObject ServerFacade::getMySQLStatusPolling() const {
+    return mysqlStatusPoller.getSettings();
 }
 
-bool ServerFacade::setApacheDocumentRoot(const QString &newRoot) {
-    return apacheServer.setDocumentRoot(newRoot);
+QJsonObject ServerFacade::getMySQLStatus() const {
+    return mysqlStatusPoller.getSnapshot();
 }
 
-bool ServerFacade::setNginxDocumentRoot(const QString &newRoot) {
-    return nginxServer.setDocumentRoot(newRoot);
+bool ServerFacade::setMySQLProxySettings(const QJsonObject &settings) {
+    TRACE_SCOPE("config", "ServerFacade::setMySQLProxySettings");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "setMySQLProxySettings"}});
+    return mysqlProxyServer.setSettings(settings);
 }
 
-bool ServerFacade::setNginxPHPFPMport(int port, QStringList &validationErrors) {
-    return nginxServer.setPHPFPMport(port, validationErrors);
+QJsonObject ServerFacade::getMySQLProxyStats() const {
+    return mysqlProxyServer.getPoolStats();
 }
 
-bool ServerFacade::setNginxPHPCGIport(int port, QStringList &validationErrors){
-    return nginxServer.setPHPCGIPort(port, validationErrors);
+QJsonObject ServerFacade::getServerResourceUsage(const QString &serverName) const {
+    if (serverName == "apache") {
+        return apacheServer.getResourceUsage();
+    } else if (serverName == "nginx") {
+        return nginxServer.getResourceUsage();
+    } else if (serverName == "mysql") {
+        return mysqlServer.getResourceUsage();
+    } else if (serverName == "mysql_proxy") {
+        return QJsonObject();
+    } else {
+        QString errMsg = "Failed to read resource usage: server " + serverName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
 }
 
-bool ServerFacade::setPHPMyAdminPort(int port, QStringList &validationErrors){
-    mysqlServer.setPHPMyAdminPort(port, validationErrors);
-    return true;
+QStringList ServerFacade::getServerNames() const {
+    QMutexLocker locker(&stateMutex);
+    QStringList names = serverStates.keys();
+    names.sort();
+    return names;
+}
+
+QJsonObject ServerFacade::getServerStatus(const QString &serverName) const {
+    QJsonObject status;
+    qint64 processId = 0;
+    QDateTime startTime;
+    if (serverName == "apache") {
+        processId = apacheServer.getProcessId();
+        startTime = apacheServer.getStartTime();
+        status["access_log"] = apacheServer.getPath().filePath("logs/access.log");
+        status["tls"] = apacheServer.getTls();
+        status["document_root_mirror"] = apacheServer.getDocumentRootMirrorStats();
+        status["workspace_profile"] = apacheServer.getRenderedConfigDir().isEmpty() ? QString() : activeWorkspaceProfile;
+    } else if (serverName == "nginx") {
+        processId = nginxServer.getProcessId();
+        startTime = nginxServer.getStartTime();
+        status["access_log"] = nginxServer.getPath().filePath("logs/access.log");
+        status["tls"] = nginxServer.getTls();
+        status["document_root_mirror"] = nginxServer.getDocumentRootMirrorStats();
+        status["workspace_profile"] = nginxServer.getRenderedConfigDir().isEmpty() ? QString() : activeWorkspaceProfile;
+        status["php_cgi_address"] = nginxServer.getPHPCGIAddress();
+    } else if (serverName == "mysql") {
+        processId = mysqlServer.getProcessId();
+        startTime = mysqlServer.getStartTime();
+        status["access_log"] = "";
+        status["socket"] = mysqlServer.getSocketPath();
+        status["workspace_profile"] = mysqlServer.getRenderedConfigDir().isEmpty() ? QString() : activeWorkspaceProfile;
+        QJsonObject mysqlStatus = mysqlStatusPoller.getSnapshot();
+        if (mysqlStatus.value("available").toBool()) {
+            status["mysql_status"] = mysqlStatus;
+        }
+    } else if (serverName == "mysql_proxy") {
+        startTime = mysqlProxyServer.getStartTime();
+        status["access_log"] = "";
+        status["pool"] = mysqlProxyServer.getPoolStats();
+    } else {
+        QString errMsg = "Failed to read server status: server " + serverName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (status.value("tls").toObject().value("enabled").toBool()) {
+        QJsonObject tls = status.value("tls").toObject();
+        tls["authority"] = certificateAuthority.getStatus();
+        status["tls"] = tls;
+    }
+    bool running = currentServerState(serverName);
+    status["running"] = running;
+    status["pid"] = running ? processId : 0;
+    status["uptime"] = running && startTime.isValid() ? startTime.secsTo(QDateTime::currentDateTime()) : 0;
+
+    QJsonArray ports;
+    QJsonObject reservations = portAllocator.getReservations();
+    for (auto it = reservations.begin(); it != reservations.end(); ++it) {
+        if (it.key() == serverName || it.key().startsWith(serverName + ".")) {
+            ports.append(it.value());
+        }
+    }
+    status["ports"] = ports;
+    return status;
 }
 
 bool ServerFacade::isPortFree(int port) const{
+    TRACE_SCOPE_ARG("probe", "ServerFacade::isPortFree", "port", QString::number(port));
+    MetricsTimer probeTimer("webdevtoolkit_port_probe_duration_seconds", {{"method", "connect"}});
     QTcpSocket socket;
     socket.connectToHost(QHostAddress::LocalHost, port);
     bool isFree = !socket.waitForConnected(100);
@@ -263,23 +1218,276 @@ bool ServerFacade::isPortFree(int port) const{
 }
 
 bool ServerFacade::isPortFreeInApp(int port) const {
-    if(apacheServer.getConfig()["port"].toInt() == port){
-        return false;
+    return !portAllocator.isReserved(port);
+}
+
+QJsonObject ServerFacade::getPortReservations() const {
+    QJsonObject result;
+    result["reservations"] = portAllocator.getReservations();
+    result["ranges"] = portAllocator.getRanges();
+    result["conflicts"] = getPortConflicts();
+    return result;
+}
+
+QJsonArray ServerFacade::getPortConflicts() const {
+    QJsonArray conflicts;
+    const QJsonObject reservations = portAllocator.getReservations();
+    for (auto it = reservations.begin(); it != reservations.end(); ++it) {
+        QString serverName = it.key().section('.', 0, 0);
+        bool checkSystem = !currentServerState(serverName);
+        if (it.key() == "toolkit.metrics") {
+            checkSystem = !metricsServer.isListening();
+        } else if (it.key() == "toolkit.control_api") {
+            checkSystem = !controlApi.isListening();
+        }
+        PortAllocator::Conflict conflict = portAllocator.check(it.key(), it.value().toInt(), checkSystem);
+        if (conflict != PortAllocator::Conflict::None) {
+            QJsonObject entry;
+            entry["owner"] = it.key();
+            entry["port"] = it.value().toInt();
+            entry["conflict"] = PortAllocator::conflictName(conflict);
+            conflicts.append(entry);
+        }
     }
-    if(nginxServer.getConfig()["port"].toInt() == port){
-        return false;
+    return conflicts;
+}
+
+int ServerFacade::assignFreePort(const QString &owner) {
+    QStringList validationErrors;
+    int port = 0;
+    if (owner == "apache" || owner == "nginx" || owner == "mysql" || owner == "mysql_proxy") {
+        port = portAllocator.findFreePort(owner);
+        setServerPort(owner, port, validationErrors);
+    } else if (owner == "nginx.php_cgi") {
+        port = portAllocator.findFreePort("php_cgi");
+        setNginxPHPCGIport(port, validationErrors);
+    } else if (owner == "nginx.php_fpm") {
+        port = portAllocator.findFreePort("php_fpm");
+        setNginxPHPFPMport(port, validationErrors);
+    } else if (owner == "apache.tls" || owner == "nginx.tls") {
+        QString serverName = owner.section('.', 0, 0);
+        port = portAllocator.findFreePort(serverName + "_tls");
+        QJsonObject tls = serverName == "apache" ? apacheServer.getTls() : nginxServer.getTls();
+        tls["port"] = port;
+        setServerTls(serverName, tls);
+    } else {
+        QString errMsg = "Failed to assign a free port: " + owner + " does not own an assignable port.";
+        throw std::runtime_error(errMsg.toStdString());
     }
-    if(nginxServer.getConfig()["php_cgi_port"].toInt() == port){
-        return false;
+    if (!validationErrors.isEmpty()) {
+        QString errMsg = "Failed to assign port " + QString::number(port) + " to " + owner + ": " + validationErrors.join(", ") + ".";
+        throw std::runtime_error(errMsg.toStdString());
     }
-    if(mysqlServer.getConfig()["port"].toInt() == port){
-        return false;
+    return port;
+}
+
+QJsonObject ServerFacade::resolvePortConflicts() {
+    QJsonObject reassigned;
+    const QJsonArray conflicts = getPortConflicts();
+    for (const QJsonValue& conflict : conflicts) {
+        QString owner = conflict.toObject()["owner"].toString();
+        if (owner == "mysql.phpmyadmin" || owner.startsWith("toolkit.")) {
+            continue;
+        }
+        reassigned[owner] = assignFreePort(owner);
+        qDebug() << "Port" << conflict.toObject()["port"].toInt() << "of" << owner << "is in use; reassigned to" << reassigned[owner].toInt();
     }
-    return true;
+    return reassigned;
+}
+
+bool ServerFacade::setMetricsEndpoint(const QJsonObject &settings) {
+    QJsonObject updated = metricsSettings;
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        updated[it.key()] = it.value();
+    }
+    if (!updated.value("enabled").isBool()) {
+        throw std::runtime_error("Failed to configure the metrics endpoint: enabled must be true or false.");
+    }
+    int port = updated.value("port").toInt();
+    if (!updated.value("port").isDouble() || port <= 0 || port > 65535) {
+        QString errMsg = "Failed to configure the metrics endpoint: invalid port " + updated.value("port").toVariant().toString() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (QHostAddress(updated.value("address").toString()).isNull()) {
+        QString errMsg = "Failed to configure the metrics endpoint: invalid address " + updated.value("address").toString() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (updated.value("enabled").toBool() && portAllocator.ownerOf(port) != "toolkit.metrics" && !isPortFreeInApp(port)) {
+        QString errMsg = "Failed to configure the metrics endpoint: port " + QString::number(port) + " is already used by " + portAllocator.ownerOf(port) + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    bool changed = updated != metricsSettings;
+    metricsSettings = updated;
+    if (metricsSettings.value("enabled").toBool()) {
+        portAllocator.reserve("toolkit.metrics", port);
+    } else {
+        portAllocator.release("toolkit.metrics");
+    }
+    if (changed) {
+        applyMetricsEndpoint();
+    }
+    return changed;
+}
+
+QJsonObject ServerFacade::getMetricsEndpoint() const {
+    QJsonObject result = metricsSettings;
+    result["listening"] = metricsServer.isListening();
+    return result;
+}
+
+bool ServerFacade::setControlApiEndpoint(const QJsonObject &settings) {
+    QJsonObject updated = controlApi.getSettings();
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        updated[it.key()] = it.value();
+    }
+    ControlApi::validateSettings(updated);
+    int port = updated.value("port").toInt();
+    bool usesTcp = updated.value("enabled").toBool() && updated.value("socket").toString().isEmpty();
+    if (usesTcp && portAllocator.ownerOf(port) != "toolkit.control_api" && !isPortFreeInApp(port)) {
+        QString errMsg = "Failed to configure the control API: port " + QString::number(port) + " is already used by " + portAllocator.ownerOf(port) + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    bool changed = updated != controlApi.getSettings();
+    controlApi.setSettings(updated);
+    if (usesTcp) {
+        portAllocator.reserve("toolkit.control_api", port);
+    } else {
+        portAllocator.release("toolkit.control_api");
+    }
+    if (changed) {
+        applyControlApiEndpoint();
+    }
+    return changed;
+}
+
+QJsonObject ServerFacade::getControlApiEndpoint() const {
+    QJsonObject result = controlApi.getSettings();
+    result.remove("token");
+    result["listening"] = controlApi.isListening();
+    return result;
+}
+
+void ServerFacade::startEndpoints() {
+    endpointsStarted = true;
+    applyMetricsEndpoint();
+    applyControlApiEndpoint();
+}
+
+void ServerFacade::applyControlApiEndpoint() {
+    if (!endpointsStarted) {
+        return;
+    }
+    if (!controlApi.start()) {
+        handleError("Control API unavailable", "The control API could not be started: " + controlApi.errorString());
+    }
+}
+
+void ServerFacade::applyMetricsEndpoint() {
+    if (!endpointsStarted) {
+        return;
+    }
+    metricsServer.close();
+    if (!metricsSettings.value("enabled").toBool()) {
+        return;
+    }
+    QHostAddress address(metricsSettings.value("address").toString());
+    if (!metricsServer.listen(address, quint16(metricsSettings.value("port").toInt()))) {
+        handleError("Metrics endpoint unavailable", "The metrics endpoint could not listen on port " + QString::number(metricsSettings.value("port").toInt()) + ": " + metricsServer.errorString());
+    }
+}
+
+void ServerFacade::registerMetrics() {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    metrics.describe("webdevtoolkit_server_up", MetricsRegistry::Type::Gauge, "Whether the managed server is running (1) or stopped (0).");
+    metrics.describe("webdevtoolkit_server_uptime_seconds", MetricsRegistry::Type::Gauge, "Seconds since the managed server was started.");
+    metrics.describe("webdevtoolkit_server_starts_total", MetricsRegistry::Type::Counter, "Server start attempts by result.");
+    metrics.describe("webdevtoolkit_server_stops_total", MetricsRegistry::Type::Counter, "Server stop attempts by result.");
+    metrics.describe("webdevtoolkit_server_restarts_total", MetricsRegistry::Type::Counter, "Server restarts requested.");
+    metrics.describe("webdevtoolkit_server_start_duration_seconds", MetricsRegistry::Type::Histogram, "Time taken to start a server.");
+    metrics.describe("webdevtoolkit_server_stop_duration_seconds", MetricsRegistry::Type::Histogram, "Time taken to stop a server.");
+    metrics.describe("webdevtoolkit_process_cpu_seconds_total", MetricsRegistry::Type::Counter, "User and system CPU time of the server's main process.");
+    metrics.describe("webdevtoolkit_process_resident_memory_bytes", MetricsRegistry::Type::Gauge, "Resident memory of the server's main process.");
+    metrics.describe("webdevtoolkit_port_probe_duration_seconds", MetricsRegistry::Type::Histogram, "Time taken by port availability probes.");
+    metrics.describe("webdevtoolkit_port_reservations", MetricsRegistry::Type::Gauge, "Ports currently reserved by the toolkit.");
+    metrics.describe("webdevtoolkit_config_apply_duration_seconds", MetricsRegistry::Type::Histogram, "Time taken to apply a configuration change.");
+    metrics.describe("webdevtoolkit_mysql_queries_per_second", MetricsRegistry::Type::Gauge, "Statements per second executed by MySQL over the last polling interval.");
+    metrics.describe("webdevtoolkit_mysql_threads_running", MetricsRegistry::Type::Gauge, "MySQL threads currently executing a statement.");
+    metrics.describe("webdevtoolkit_mysql_buffer_pool_hit_ratio", MetricsRegistry::Type::Gauge, "Share of InnoDB buffer pool reads served from memory.");
+    metrics.describe("webdevtoolkit_mysql_row_lock_waits_per_second", MetricsRegistry::Type::Gauge, "InnoDB row lock waits per second.");
+    metrics.describe("webdevtoolkit_mysql_tmp_disk_tables_per_second", MetricsRegistry::Type::Gauge, "Internal temporary tables created on disk per second.");
+    metrics.describe("webdevtoolkit_mysql_proxy_connections", MetricsRegistry::Type::Gauge, "Pooled MySQL backend connections by state.");
+    metrics.describe("webdevtoolkit_mysql_proxy_clients", MetricsRegistry::Type::Gauge, "Client sessions connected to the MySQL proxy, by whether they are pinned to a backend.");
+    metrics.describe("webdevtoolkit_mysql_proxy_waiting_clients", MetricsRegistry::Type::Gauge, "Client commands waiting for a pooled MySQL connection.");
+    metrics.describe("webdevtoolkit_mysql_proxy_backend_connects_total", MetricsRegistry::Type::Counter, "Backend connections opened by the MySQL proxy.");
+    metrics.describe("webdevtoolkit_mysql_proxy_leases_total", MetricsRegistry::Type::Counter, "Pooled MySQL connections handed to client commands.");
+    metrics.describe("webdevtoolkit_docroot_mirror_bytes", MetricsRegistry::Type::Gauge, "Bytes of document root content held in the RAM-backed mirror.");
+    metrics.describe("webdevtoolkit_docroot_mirror_files", MetricsRegistry::Type::Gauge, "Files held in the RAM-backed document root mirror.");
+    metrics.describe("webdevtoolkit_docroot_mirror_synced_files_total", MetricsRegistry::Type::Counter, "Files copied between the document root and its RAM-backed mirror, by direction.");
+    metrics.describe("webdevtoolkit_docroot_mirror_sync_lag_seconds", MetricsRegistry::Type::Histogram, "Time from a file change to its copy reaching the other side of the document root mirror.");
+    metrics.describe("webdevtoolkit_mysql_proxy_lease_wait_seconds", MetricsRegistry::Type::Histogram, "Time client commands waited for a pooled MySQL connection.");
+    metrics.describe("webdevtoolkit_workspace_profile_switch_duration_seconds", MetricsRegistry::Type::Histogram, "Time taken to repoint the servers at a pre-rendered workspace profile.");
+
+    metrics.addCollector([this](MetricsRegistry& registry) {
+        const QStringList serverNames = getServerNames();
+        for (const QString& serverName : serverNames) {
+            QJsonObject status = getServerStatus(serverName);
+            MetricsRegistry::Labels labels{{"server", serverName}};
+            registry.set("webdevtoolkit_server_up", labels, status.value("running").toBool() ? 1 : 0);
+            registry.set("webdevtoolkit_server_uptime_seconds", labels, status.value("uptime").toDouble());
+            qint64 cpuTimeMs = 0;
+            qint64 residentBytes = 0;
+            qint64 processId = status.value("pid").toInteger();
+            if (processId > 0 && ProcessStats::readProcess(processId, cpuTimeMs, residentBytes)) {
+                registry.set("webdevtoolkit_process_cpu_seconds_total", labels, double(cpuTimeMs) / 1000.0);
+                registry.set("webdevtoolkit_process_resident_memory_bytes", labels, double(residentBytes));
+            } else {
+                registry.set("webdevtoolkit_process_resident_memory_bytes", labels, 0);
+            }
+            if (status.contains("document_root_mirror")) {
+                QJsonObject mirror = status.value("document_root_mirror").toObject();
+                registry.set("webdevtoolkit_docroot_mirror_bytes", labels, mirror.value("mirror_bytes").toDouble());
+                registry.set("webdevtoolkit_docroot_mirror_files", labels, mirror.value("files").toDouble());
+                if (mirror.value("active").toBool()) {
+                    registry.set("webdevtoolkit_docroot_mirror_synced_files_total", {{"server", serverName}, {"direction", "to_mirror"}}, mirror.value("files_to_mirror").toDouble());
+                    registry.set("webdevtoolkit_docroot_mirror_synced_files_total", {{"server", serverName}, {"direction", "to_source"}}, mirror.value("files_to_source").toDouble());
+                }
+            }
+        }
+        registry.set("webdevtoolkit_port_reservations", MetricsRegistry::Labels(), portAllocator.getReservations().size());
+        QJsonObject mysqlStatus = mysqlStatusPoller.getSnapshot();
+        if (mysqlStatus.value("available").toBool()) {
+            registry.set("webdevtoolkit_mysql_queries_per_second", MetricsRegistry::Labels(), mysqlStatus.value("qps").toDouble());
+            registry.set("webdevtoolkit_mysql_threads_running", MetricsRegistry::Labels(), mysqlStatus.value("threads_running").toDouble());
+            registry.set("webdevtoolkit_mysql_buffer_pool_hit_ratio", MetricsRegistry::Labels(), mysqlStatus.value("buffer_pool_hit_ratio").toDouble());
+            registry.set("webdevtoolkit_mysql_row_lock_waits_per_second", MetricsRegistry::Labels(), mysqlStatus.value("row_lock_waits_per_second").toDouble());
+            registry.set("webdevtoolkit_mysql_tmp_disk_tables_per_second", MetricsRegistry::Labels(), mysqlStatus.value("tmp_disk_tables_per_second").toDouble());
+        }
+        QJsonObject proxyStats = mysqlProxyServer.getPoolStats();
+        registry.set("webdevtoolkit_mysql_proxy_connections", {{"state", "idle"}}, proxyStats.value("idle").toDouble());
+        registry.set("webdevtoolkit_mysql_proxy_connections", {{"state", "active"}}, proxyStats.value("active").toDouble());
+        registry.set("webdevtoolkit_mysql_proxy_connections", {{"state", "connecting"}}, proxyStats.value("connecting").toDouble());
+        registry.set("webdevtoolkit_mysql_proxy_clients", {{"pinned", "true"}}, proxyStats.value("pinned_clients").toDouble());
+        registry.set("webdevtoolkit_mysql_proxy_clients", {{"pinned", "false"}}, proxyStats.value("clients").toDouble() - proxyStats.value("pinned_clients").toDouble());
+        registry.set("webdevtoolkit_mysql_proxy_waiting_clients", MetricsRegistry::Labels(), proxyStats.value("waiting").toDouble());
+        registry.set("webdevtoolkit_mysql_proxy_backend_connects_total", MetricsRegistry::Labels(), proxyStats.value("connects_total").toDouble());
+        registry.set("webdevtoolkit_mysql_proxy_leases_total", MetricsRegistry::Labels(), proxyStats.value("leases_total").toDouble());
+    });
+
+    metricsServer.route("GET", "/metrics", [](const HttpRequest&) {
+        HttpResponse response;
+        response.contentType = "text/plain; version=0.0.4; charset=utf-8";
+        response.body = MetricsRegistry::getInstance().render();
+        return response;
+    });
+    metricsServer.route("GET", "/", [](const HttpRequest&) {
+        return HttpResponse::text("WebDevToolkit metrics are served at /metrics\n");
+    });
 }
 
 bool ServerFacade::updateAbsolutePaths()
 {
+    TRACE_SCOPE("config", "ServerFacade::updateAbsolutePaths");
+    MetricsTimer configApplyTimer("webdevtoolkit_config_apply_duration_seconds", {{"operation", "updateAbsolutePaths"}});
 
     ConfigurationManager& configManager = ConfigurationManager::getInstance();
     QJsonObject serversConfig = configManager.getConfiguration()["servers"].toObject();
@@ -453,6 +1661,8 @@ IServer* ServerFacade::getServerByName(const QString& serverName) {
         return &nginxServer;
     } else if (serverName == "mysql") {
         return &mysqlServer;
+    } else if (serverName == "mysql_proxy") {
+        return &mysqlProxyServer;
     }
     else{
         QString errMsg = "Failed to get server instance: server " + serverName + " not found.";
@@ -465,10 +1675,31 @@ void ServerFacade::setServerState(const QString& serverName, bool isRunning){
         QString errMsg = "Failed to set server status: server " + serverName + " not found.";
         throw std::runtime_error(errMsg.toStdString());
     }
-    serverStates[serverName] = isRunning;
-    bool allStopped = std::all_of(serverStates.begin(), serverStates.end(), [](bool value) {
-        return value == false;
-    });
+    // Runs on the strand that changed the process, so a start or stop queued
+    // right behind it sees the new state instead of the last GUI frame.
+    {
+        QMutexLocker locker(&stateMutex);
+        serverStates[serverName] = isRunning;
+        stateCondition.wakeAll();
+    }
+    eventBus.publishState(serverName, isRunning);
+}
+
+void ServerFacade::onServerStateChanged(const QString& serverName, bool isRunning){
+    bool allStopped = false;
+    {
+        QMutexLocker locker(&stateMutex);
+        allStopped = std::all_of(serverStates.begin(), serverStates.end(), [](bool value) {
+            return value == false;
+        });
+    }
+    if (serverName == "mysql") {
+        if (isRunning) {
+            mysqlStatusPoller.start(mysqlServer.getConfig()["port"].toInt());
+        } else {
+            mysqlStatusPoller.stop();
+        }
+    }
     emit updateState(serverName, isRunning);
     if(allStopped) {
         emit allServersStopped();
@@ -480,7 +1711,12 @@ bool ServerFacade::getServerState(const QString& serverName){
         QString errMsg = "Failed to set server status: server " + serverName + " not found.";
         throw std::runtime_error(errMsg.toStdString());
     }
-    return serverStates[serverName];
+    return currentServerState(serverName);
+}
+
+bool ServerFacade::currentServerState(const QString &serverName) const {
+    QMutexLocker locker(&stateMutex);
+    return serverStates.value(serverName);
 }
 
 bool ServerFacade::isRunning(const QString& serverName) {
@@ -488,6 +1724,321 @@ bool ServerFacade::isRunning(const QString& serverName) {
     return server->isRunning();
 }
 
+QStringList ServerFacade::getMySQLSnapshots() const {
+    return mysqlServer.getSnapshots();
+}
+
+QJsonObject ServerFacade::createMySQLSnapshot(const QString &name) {
+    return mysqlServer.createSnapshot(name);
+}
+
+QJsonObject ServerFacade::restoreMySQLSnapshot(const QString &name) {
+    return mysqlServer.restoreSnapshot(name);
+}
+
+void ServerFacade::deleteMySQLSnapshot(const QString &name) {
+    mysqlServer.deleteSnapshot(name);
+}
+
+QJsonArray ServerFacade::getWorkspaceProfiles() const {
+    QJsonArray profiles;
+    const QStringList names = workspaceProfiles.listProfiles();
+    for (const QString& name : names) {
+        try {
+            QJsonObject profile = workspaceProfiles.getProfile(name);
+            QJsonObject entry;
+            entry["name"] = name;
+            entry["id"] = profile.value("id");
+            entry["created"] = profile.value("created");
+            entry["settings"] = profile.value("settings");
+            entry["servers"] = QJsonArray::fromStringList(profile.value("servers").toObject().keys());
+            entry["active"] = name == activeWorkspaceProfile;
+            profiles.append(entry);
+        } catch (const std::runtime_error& e) {
+            qWarning() << e.what();
+        }
+    }
+    return profiles;
+}
+
+QJsonObject ServerFacade::createWorkspaceProfile(const QString &name, const QJsonObject &settings) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::createWorkspaceProfile", "profile", name);
+    const QStringList serverNames = QStringList() << "apache" << "nginx" << "mysql";
+    if (!WorkspaceProfileStore::isValidProfileName(name)) {
+        QString errMsg = "Failed to create workspace profile: invalid profile name " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!activeWorkspaceProfile.isEmpty()) {
+        QString errMsg = "Failed to create workspace profile: deactivate workspace profile " + activeWorkspaceProfile + " first.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        if (!serverNames.contains(it.key()) || !it.value().isObject()) {
+            QString errMsg = "Failed to create workspace profile: invalid settings for " + it.key() + ".";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+    for (const QString& serverName : serverNames) {
+        if (getServerState(serverName)) {
+            QString errMsg = "Failed to create workspace profile: stop the " + serverName + " server before rendering the profile.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+    auto configFilesOf = [this](const QString& serverName) {
+        return serverName == "apache" ? apacheServer.getConfigFiles()
+             : serverName == "nginx" ? nginxServer.getConfigFiles()
+             : mysqlServer.getConfigFiles();
+    };
+
+    // The profile is rendered through the regular setters, so the live files of
+    // every server (and of the versions being switched to) are backed up and put
+    // back once the rendered set has been captured.
+    QJsonObject previousStates;
+    QMap<QString, QByteArray> previousFiles;
+    QSet<QString> keptFiles;
+    QStringList renderedFiles;
+    auto backupFiles = [&previousFiles, &keptFiles](const QStringList& files) {
+        for (const QString& filePath : files) {
+            if (previousFiles.contains(filePath) || keptFiles.contains(filePath) || !QFileInfo::exists(filePath)) {
+                continue;
+            }
+            QFile file(filePath);
+            if (file.open(QIODevice::ReadOnly)) {
+                previousFiles[filePath] = file.readAll();
+            } else {
+                keptFiles.insert(filePath);
+            }
+        }
+    };
+    auto restore = [&]() {
+        for (auto it = previousStates.begin(); it != previousStates.end(); ++it) {
+            try {
+                applyServerConfiguration(it.key(), it.value().toObject());
+            } catch (const std::runtime_error& e) {
+                qWarning() << "Failed to restore the" << it.key() << "configuration after rendering a workspace profile:" << e.what();
+            }
+        }
+        for (const QString& filePath : renderedFiles) {
+            if (!previousFiles.contains(filePath) && !keptFiles.contains(filePath)) {
+                QFile::remove(filePath);
+            }
+        }
+        for (auto it = previousFiles.begin(); it != previousFiles.end(); ++it) {
+            QFile file(it.key());
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(it.value()) != it.value().size()) {
+                qWarning() << "Failed to restore" << it.key() << "after rendering a workspace profile.";
+            }
+        }
+    };
+
+    QMap<QString, WorkspaceProfileStore::ConfigSet> configSets;
+    QJsonObject states;
+    try {
+        for (const QString& serverName : serverNames) {
+            backupFiles(configFilesOf(serverName));
+        }
+        for (auto it = settings.begin(); it != settings.end(); ++it) {
+            previousStates[it.key()] = getConfigurableState(it.key());
+            QString version = it.value().toObject().value("version").toString();
+            if (!version.isEmpty()) {
+                setServerVersion(it.key(), version);
+                backupFiles(configFilesOf(it.key()));
+            }
+        }
+        for (auto it = settings.begin(); it != settings.end(); ++it) {
+            QStringList validationErrors = applyServerConfiguration(it.key(), it.value().toObject());
+            if (!validationErrors.isEmpty()) {
+                QString errMsg = "Failed to create workspace profile: settings for " + it.key() + " have invalid values (" + validationErrors.join(", ") + ").";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+        }
+        for (const QString& serverName : serverNames) {
+            configSets[serverName] = serverName == "apache" ? apacheServer.renderConfigSet()
+                                   : serverName == "nginx" ? nginxServer.renderConfigSet()
+                                   : mysqlServer.renderConfigSet();
+            states[serverName] = getConfigurableState(serverName);
+            renderedFiles += configFilesOf(serverName);
+        }
+    } catch (const std::runtime_error&) {
+        restore();
+        throw;
+    }
+    restore();
+
+    QJsonObject profile = workspaceProfiles.storeProfile(name, settings, states, configSets);
+    qDebug() << "Stored workspace profile" << name << "with id" << profile.value("id").toString();
+    return profile;
+}
+
+QJsonObject ServerFacade::activateWorkspaceProfile(const QString &name) {
+    TRACE_SCOPE_ARG("config", "ServerFacade::activateWorkspaceProfile", "profile", name);
+    QJsonObject profile = workspaceProfiles.getProfile(name);
+    QString renderedPath = workspaceProfiles.materialize(profile);
+    const QJsonObject servers = profile.value("servers").toObject();
+    const QStringList restarted = stopServers(servers.keys());
+
+    QElapsedTimer timer;
+    timer.start();
+    try {
+        runOnFacadeThread([this, &name, &renderedPath, &servers]() {
+            if (activeWorkspaceProfile.isEmpty()) {
+                workspaceBaseStates = QJsonObject();
+                for (auto it = servers.begin(); it != servers.end(); ++it) {
+                    workspaceBaseStates[it.key()] = getConfigurableState(it.key());
+                }
+            }
+            try {
+                for (auto it = servers.begin(); it != servers.end(); ++it) {
+                    useRenderedConfig(it.key(), renderedPath + "/" + it.key(), it.value().toObject().value("config").toObject());
+                }
+            } catch (const std::runtime_error& e) {
+                qWarning() << "Failed to activate workspace profile" << name << ":" << e.what();
+                restoreWorkspaceBase();
+                throw;
+            }
+            PHPRuntimeManager::applyMySQLSocket(apacheServer.getPHPPath(), mysqlServer.getSocketPath());
+            PHPRuntimeManager::applyMySQLSocket(nginxServer.getPHPPath(), mysqlServer.getSocketPath());
+            activeWorkspaceProfile = name;
+            saveActiveWorkspaceProfile();
+        });
+    } catch (const std::runtime_error&) {
+        for (const QString& serverName : restarted) {
+            startServer(serverName);
+        }
+        throw;
+    }
+    double switchSeconds = double(timer.nsecsElapsed()) / 1e9;
+    MetricsRegistry::getInstance().observe("webdevtoolkit_workspace_profile_switch_duration_seconds", {}, switchSeconds);
+    qDebug() << "Switched to workspace profile" << name << "in" << switchSeconds * 1000 << "ms.";
+
+    for (const QString& serverName : restarted) {
+        startServer(serverName);
+    }
+    QJsonObject result;
+    result["name"] = name;
+    result["id"] = profile.value("id");
+    result["rendered_path"] = renderedPath;
+    result["servers"] = QJsonArray::fromStringList(servers.keys());
+    result["restarted"] = QJsonArray::fromStringList(restarted);
+    result["switch_ms"] = switchSeconds * 1000;
+    return result;
+}
+
+QJsonObject ServerFacade::deactivateWorkspaceProfile() {
+    TRACE_SCOPE("config", "ServerFacade::deactivateWorkspaceProfile");
+    QString name;
+    QStringList serverNames;
+    runOnFacadeThread([this, &name, &serverNames]() {
+        name = activeWorkspaceProfile;
+        serverNames = workspaceBaseStates.keys();
+    });
+    if (name.isEmpty()) {
+        throw std::runtime_error("Failed to deactivate workspace profile: no workspace profile is active.");
+    }
+    const QStringList restarted = stopServers(serverNames);
+    runOnFacadeThread([this]() {
+        restoreWorkspaceBase();
+    });
+    for (const QString& serverName : restarted) {
+        startServer(serverName);
+    }
+    QJsonObject result;
+    result["name"] = name;
+    result["restarted"] = QJsonArray::fromStringList(restarted);
+    return result;
+}
+
+void ServerFacade::deleteWorkspaceProfile(const QString &name) {
+    if (name == activeWorkspaceProfile) {
+        QString errMsg = "Failed to delete workspace profile: " + name + " is active; deactivate it first.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    workspaceProfiles.deleteProfile(name);
+}
+
+QString ServerFacade::getActiveWorkspaceProfile() const {
+    return activeWorkspaceProfile;
+}
+
+bool ServerFacade::isWorkspaceProfileActive(const QString &serverName) const {
+    return !activeWorkspaceProfile.isEmpty() && workspaceBaseStates.contains(serverName);
+}
+
+void ServerFacade::requireNoWorkspaceProfile(const QString &serverName) const {
+    if (isWorkspaceProfileActive(serverName)) {
+        QString errMsg = "Failed to change the " + serverName + " configuration: workspace profile " + activeWorkspaceProfile + " is active; deactivate it before changing the configuration.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
+
+QStringList ServerFacade::stopServers(const QStringList &serverNames) {
+    QStringList stopped;
+    for (const QString& serverName : serverNames) {
+        if (getServerState(serverName)) {
+            stopServer(serverName);
+            waitForServerState(serverName, false, 5000);
+            stopped.append(serverName);
+        }
+    }
+    return stopped;
+}
+
+void ServerFacade::useRenderedConfig(const QString &serverName, const QString &configDir, const QJsonObject &state) {
+    if (serverName == "apache") {
+        apacheServer.useRenderedConfig(configDir, state);
+    } else if (serverName == "nginx") {
+        nginxServer.useRenderedConfig(configDir, state);
+    } else if (serverName == "mysql") {
+        mysqlServer.useRenderedConfig(configDir, state);
+    } else {
+        QString errMsg = "Failed to use workspace profile: server " + serverName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (configDir.isEmpty()) {
+        return;
+    }
+    portAllocator.reserve(serverName, state.value("port").toInt());
+    if (serverName == "nginx") {
+        portAllocator.reserve("nginx.php_cgi", state.value("php_cgi_port").toInt());
+        if (state.value("php_fpm_port").toInt() > 0) {
+            portAllocator.reserve("nginx.php_fpm", state.value("php_fpm_port").toInt());
+        } else {
+            portAllocator.release("nginx.php_fpm");
+        }
+    }
+    if (serverName != "mysql") {
+        QJsonObject tls = state.value("tls").toObject();
+        if (tls.value("enabled").toBool()) {
+            portAllocator.reserve(serverName + ".tls", tls.value("port").toInt());
+        } else {
+            portAllocator.release(serverName + ".tls");
+        }
+    }
+}
+
+void ServerFacade::restoreWorkspaceBase() {
+    activeWorkspaceProfile.clear();
+    const QJsonObject baseStates = workspaceBaseStates;
+    workspaceBaseStates = QJsonObject();
+    for (auto it = baseStates.begin(); it != baseStates.end(); ++it) {
+        useRenderedConfig(it.key(), QString(), QJsonObject());
+        try {
+            applyServerConfiguration(it.key(), it.value().toObject());
+        } catch (const std::runtime_error& e) {
+            qWarning() << "Failed to restore the" << it.key() << "configuration:" << e.what();
+        }
+    }
+    saveActiveWorkspaceProfile();
+}
+
+void ServerFacade::saveActiveWorkspaceProfile() {
+    ConfigurationManager& configManager = ConfigurationManager::getInstance();
+    QJsonObject section = configManager.getConfiguration()["workspace_profiles"].toObject();
+    section["active"] = activeWorkspaceProfile;
+    configManager.setSectionConfiguration("workspace_profiles", section);
+    configManager.scheduleSave("config.json");
+}
+
 void ServerFacade::handleError(const QString& errorTitle, const QString& errorMessage) {
     emit errorOccurred(errorTitle, errorMessage);
 }
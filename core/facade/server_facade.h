@@ -4,21 +4,45 @@
 #include "../servers/apache_server.h"
 #include "../servers/nginx_server.h"
 #include "../servers/mysql_server.h"
+#include "../servers/mysql_proxy_server.h"
+#include "../php/php_runtime_manager.h"
+#include "../ports/port_allocator.h"
+#include "../tls/certificate_authority.h"
+#include "../config/workspace_profile_store.h"
+#include "../events/server_event_bus.h"
+#include "../../utility/http_server.h"
+#include "../../utility/task_pool.h"
+#include "../api/control_api.h"
+#include "../discovery/version_discovery.h"
+#include "../mysql/mysql_status_poller.h"
+#include <QJsonArray>
+#include <QMutex>
+#include <QWaitCondition>
 
 
 class ServerFacade : public QObject{
     Q_OBJECT
 public:
     ServerFacade();
-    void loadConfigurations(const QJsonObject& config);
+    static void validateConfiguration(const QJsonObject& config);
+    void loadConfigurations(const QJsonObject& config, bool validated = false);
     QJsonObject getConfigurations() const;
     QJsonObject getServerConfiguration(const QString& serverName);
     QJsonObject getAvailableVersions(const QString& serverName);
     QJsonObject getAvailablePHPVersions(const QString& serverName) const;
+    QJsonObject discoverVersions();
+    QJsonObject pruneStaleVersions();
+    void watchVersions();
     bool getServerState(const QString& serverName);
     QDir getPHPPath(const QString& serverName) const;
     void startServer(const QString& serverName);
     void stopServer(const QString& serverName);
+    void restartServer(const QString& serverName);
+    bool waitForServerState(const QString& serverName, bool isRunning, int timeoutMs);
+    QStringList applyServerConfiguration(const QString& serverName, const QJsonObject& changes);
+    void saveServerConfiguration(const QString& serverName);
+    TaskPool& getTaskPool();
+    void runOnFacadeThread(const std::function<void()>& task);
     void setServerVersion(const QString& serverName, const QString& version);
     bool setApachePHPVersion(const QString& phpVersion);
     bool setNginxPHPVersion(const QString& phpVersion);
@@ -28,21 +52,101 @@ public:
     bool setNginxPHPFPMport(int port, QStringList &validationErrors);
     bool setNginxPHPCGIport(int port, QStringList &validationErrors);
     bool setPHPMyAdminPort(int port, QStringList &validationErrors);
+    bool setNginxPerformanceProfile(const QString& profileName);
+    QStringList getNginxPerformanceProfiles() const;
+    bool setNginxFastCGICache(const QJsonObject& settings);
+    QJsonObject purgeNginxFastCGICache(const QString& target);
+    QJsonObject getNginxFastCGICacheStats();
+    bool setApacheTuningProfile(const QString& profileName, int expectedConcurrency);
+    bool setApacheTuningProfiles(const QJsonObject& profiles, int expectedConcurrency);
+    QStringList getApacheTuningProfiles() const;
+    void setPHPRuntimeSettings(const QString& phpVersion, const QJsonObject& settings);
+    QJsonObject getPHPRuntimeSettings() const;
+    QJsonObject generateOpcachePreload(const QString& serverName);
+    QJsonObject getOpcacheStatus(const QString& serverName);
+    QJsonObject precompressDocumentRoot(const QString& serverName);
+    bool setPrecompressedAssets(const QString& serverName, bool enabled);
+    bool setServerTls(const QString& serverName, const QJsonObject& settings);
+    bool setServerTransport(const QString& serverName, const QString& transport);
+    bool setServerIsolation(const QString& serverName, const QJsonObject& settings);
+    bool setServerCgroup(const QString& serverName, const QJsonObject& settings);
+    bool setServerDocumentRootMirror(const QString& serverName, const QJsonObject& settings);
+    QJsonObject getServerResourceUsage(const QString& serverName) const;
+    bool setMySQLSlowQueryLog(const QJsonObject& settings);
+    QJsonObject getMySQLSlowQueries(int limit, const QString& orderBy);
+    bool setMySQLStatusPolling(const QJsonObject& settings);
+    QJsonObject getMySQLStatusPolling() const;
+    QJsonObject getMySQLStatus() const;
+    bool setMySQLProxySettings(const QJsonObject& settings);
+    QJsonObject getMySQLProxyStats() const;
+    QStringList getServerNames() const;
+    QJsonObject getServerStatus(const QString& serverName) const;
     bool updateAbsolutePaths();
     bool isPortFree(int port) const;
     bool isPortFreeInApp(int port) const;
+    QJsonObject getPortReservations() const;
+    QJsonArray getPortConflicts() const;
+    int assignFreePort(const QString& owner);
+    QJsonObject resolvePortConflicts();
+    bool setMetricsEndpoint(const QJsonObject& settings);
+    QJsonObject getMetricsEndpoint() const;
+    bool setControlApiEndpoint(const QJsonObject& settings);
+    QJsonObject getControlApiEndpoint() const;
+    void startEndpoints();
     bool isRunning(const QString& serverName);
+    QStringList getMySQLSnapshots() const;
+    QJsonObject createMySQLSnapshot(const QString& name);
+    QJsonObject restoreMySQLSnapshot(const QString& name);
+    void deleteMySQLSnapshot(const QString& name);
+    QJsonArray getWorkspaceProfiles() const;
+    QJsonObject createWorkspaceProfile(const QString& name, const QJsonObject& settings);
+    QJsonObject activateWorkspaceProfile(const QString& name);
+    QJsonObject deactivateWorkspaceProfile();
+    void deleteWorkspaceProfile(const QString& name);
+    QString getActiveWorkspaceProfile() const;
+    bool isWorkspaceProfileActive(const QString& serverName) const;
 
 private:
     ApacheServer apacheServer;
     NginxServer nginxServer;
     MySQLServer mysqlServer;
+    MySQLProxyServer mysqlProxyServer;
+    PHPRuntimeManager phpRuntimeManager;
+    PortAllocator portAllocator;
+    CertificateAuthority certificateAuthority{QDir("conf/tls")};
+    WorkspaceProfileStore workspaceProfiles{QDir("profiles")};
+    QString activeWorkspaceProfile;
+    QJsonObject workspaceBaseStates;
+    ServerEventBus eventBus;
+    HttpServer metricsServer;
+    TaskPool taskPool;
+    ControlApi controlApi;
+    VersionDiscovery versionDiscovery;
+    MySQLStatusPoller mysqlStatusPoller;
+    QJsonObject metricsSettings{{"enabled", false}, {"address", "127.0.0.1"}, {"port", 9464}};
+    bool endpointsStarted = false;
     QHash<QString, bool> serverStates;
+    mutable QMutex stateMutex;
+    QWaitCondition stateCondition;
 
     IServer* getServerByName(const QString& serverName);
+    QStringList getPHPPaths(const QString& phpVersion);
+    bool currentServerState(const QString& serverName) const;
+    static QStringList configurableKeys(const QString& serverName);
+    QJsonObject getConfigurableState(const QString& serverName);
+    void requireNoWorkspaceProfile(const QString& serverName) const;
+    QStringList stopServers(const QStringList& serverNames);
+    void useRenderedConfig(const QString& serverName, const QString& configDir, const QJsonObject& state);
+    void restoreWorkspaceBase();
+    void saveActiveWorkspaceProfile();
+    void registerMetrics();
+    void applyMetricsEndpoint();
+    void applyControlApiEndpoint();
+    QJsonObject mergeInstallations(const QList<Installation>& installations, bool pruneStale = false);
+    void setServerState(const QString& serverName, bool isRunning);
 
 public slots:
-    void setServerState(const QString& serverName, bool isRunning);
+    void onServerStateChanged(const QString& serverName, bool isRunning);
     void handleError(const QString& errorTitle, const QString& errorMessage);
     void onDisplayServerWarning(const QString& serverName, const QString& errorMessage);
 
@@ -51,6 +155,7 @@ signals:
      void errorOccurred(const QString& errorTitle, const QString& errorMessage);
      void updateState(const QString& serverName, bool isRunning);
      void displayServerWarning(const QString& serverName, const QString& errorMessage);
+     void availableVersionsChanged();
 };
 
 #endif // SERVER_FACADE_H
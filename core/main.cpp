@@ -1,6 +1,8 @@
 #include "../gui/views/mainwindow.h"
 #include "config/configuration_manager.h"
 #include "singleton/server_manager.h"
+#include "cli/cli_commands.h"
+#include "../utility/trace.h"
 #include <QJsonDocument>
 #include <QApplication>
 #include <QDebug>
@@ -14,11 +16,23 @@
 #include <QThread>
 #include <QStyleFactory>
 #include <QWidget>
+#include <QCommandLineParser>
 
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    CliCommands::addOptions(parser);
+    parser.process(a);
+
+    QString traceOut = parser.value("trace-out");
+    if (!traceOut.isEmpty()) {
+        Trace::setEnabled(true);
+    }
+    TraceScope startupScope("startup", "startup");
+
     a.setStyle(QStyleFactory::create("Fusion"));
     QPalette darkPalette;
     darkPalette.setColor(QPalette::Window, QColor(53, 53, 53));
@@ -38,14 +52,38 @@ int main(int argc, char *argv[])
 
     ConfigurationManager& configManager = ConfigurationManager::getInstance();
     configManager.loadConfiguration("config.json");
+    ServerManager::getInstance().getFacade().discoverVersions();
     try {
-        ServerManager::getInstance().getFacade().loadConfigurations(configManager.getConfiguration());
+        ServerManager::getInstance().getFacade().loadConfigurations(configManager.getConfiguration(), configManager.isValidated());
+        configManager.markValidated();
 
     } catch (const std::runtime_error &e) {
+        if (CliCommands::hasCommand(parser)) {
+            qCritical() << "Failed to load configuration from file:" << e.what();
+            configManager.flush();
+            return 1;
+        }
         QMessageBox::critical(nullptr, "Failed to load configuration from file", e.what());
 
     }
+    if (CliCommands::hasCommand(parser)) {
+        startupScope.end();
+        int result = CliCommands::run(parser);
+        configManager.flush();
+        if (!traceOut.isEmpty()) {
+            Trace::writeChromeTrace(traceOut);
+        }
+        return result;
+    }
+    ServerManager::getInstance().getFacade().startEndpoints();
+    ServerManager::getInstance().getFacade().watchVersions();
     MainWindow w;
     w.show();
-    return a.exec();
+    startupScope.end();
+    int result = a.exec();
+    configManager.flush();
+    if (!traceOut.isEmpty()) {
+        Trace::writeChromeTrace(traceOut);
+    }
+    return result;
 }
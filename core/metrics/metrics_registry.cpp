@@ -0,0 +1,122 @@
+#include "metrics_registry.h"
+#include <QMutexLocker>
+#include <QStringList>
+#include <cmath>
+
+QList<double> MetricsRegistry::latencyBuckets() {
+    return QList<double>() << 0.005 << 0.01 << 0.025 << 0.05 << 0.1 << 0.25 << 0.5 << 1 << 2.5 << 5 << 10;
+}
+
+void MetricsRegistry::describe(const QString &name, Type type, const QString &help, const QList<double> &buckets) {
+    QMutexLocker locker(&mutex);
+    Family& family = families[name];
+    family.type = type;
+    family.help = help;
+    family.buckets = type == Type::Histogram && buckets.isEmpty() ? latencyBuckets() : buckets;
+}
+
+void MetricsRegistry::increment(const QString &name, const Labels &labels, double delta) {
+    QMutexLocker locker(&mutex);
+    seriesFor(name, labels).value += delta;
+}
+
+void MetricsRegistry::set(const QString &name, const Labels &labels, double value) {
+    QMutexLocker locker(&mutex);
+    seriesFor(name, labels).value = value;
+}
+
+void MetricsRegistry::observe(const QString &name, const Labels &labels, double value) {
+    QMutexLocker locker(&mutex);
+    const QList<double>& buckets = families[name].buckets;
+    Series& series = seriesFor(name, labels);
+    if (series.bucketCounts.size() != buckets.size()) {
+        series.bucketCounts.fill(0, buckets.size());
+    }
+    for (int i = 0; i < buckets.size(); ++i) {
+        if (value <= buckets.at(i)) {
+            series.bucketCounts[i]++;
+        }
+    }
+    series.sum += value;
+    series.count++;
+}
+
+void MetricsRegistry::addCollector(Collector collector) {
+    QMutexLocker locker(&mutex);
+    collectors.append(std::move(collector));
+}
+
+QByteArray MetricsRegistry::render() {
+    QList<Collector> currentCollectors;
+    {
+        QMutexLocker locker(&mutex);
+        currentCollectors = collectors;
+    }
+    for (const Collector& collector : currentCollectors) {
+        collector(*this);
+    }
+
+    QMutexLocker locker(&mutex);
+    QString output;
+    for (auto family = families.constBegin(); family != families.constEnd(); ++family) {
+        const QString& name = family.key();
+        if (!family->help.isEmpty()) {
+            output += "# HELP " + name + " " + QString(family->help).replace('\\', "\\\\").replace('\n', "\\n") + "\n";
+        }
+        QString type = family->type == Type::Counter ? "counter" : family->type == Type::Histogram ? "histogram" : "gauge";
+        output += "# TYPE " + name + " " + type + "\n";
+        for (const Series& series : family->series) {
+            if (family->type != Type::Histogram) {
+                output += name + formatLabels(series.labels) + " " + formatValue(series.value) + "\n";
+                continue;
+            }
+            for (int i = 0; i < family->buckets.size(); ++i) {
+                output += name + "_bucket" + formatLabels(series.labels, "le", formatValue(family->buckets.at(i))) + " " + QString::number(series.bucketCounts.value(i)) + "\n";
+            }
+            output += name + "_bucket" + formatLabels(series.labels, "le", "+Inf") + " " + QString::number(series.count) + "\n";
+            output += name + "_sum" + formatLabels(series.labels) + " " + formatValue(series.sum) + "\n";
+            output += name + "_count" + formatLabels(series.labels) + " " + QString::number(series.count) + "\n";
+        }
+    }
+    return output.toUtf8();
+}
+
+MetricsRegistry::Series &MetricsRegistry::seriesFor(const QString &name, const Labels &labels) {
+    Series& series = families[name].series[labelKey(labels)];
+    if (series.labels.isEmpty()) {
+        series.labels = labels;
+    }
+    return series;
+}
+
+QString MetricsRegistry::labelKey(const Labels &labels) {
+    QString key;
+    for (const auto& label : labels) {
+        key += label.first + '\x1f' + label.second + '\x1e';
+    }
+    return key;
+}
+
+QString MetricsRegistry::formatLabels(const Labels &labels, const QString &extraName, const QString &extraValue) {
+    QStringList parts;
+    Labels all = labels;
+    if (!extraName.isEmpty()) {
+        all.append(qMakePair(extraName, extraValue));
+    }
+    for (const auto& label : all) {
+        QString value = label.second;
+        value.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+        parts.append(label.first + "=\"" + value + "\"");
+    }
+    return parts.isEmpty() ? QString() : "{" + parts.join(',') + "}";
+}
+
+QString MetricsRegistry::formatValue(double value) {
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    return QString::number(value, 'g', 15);
+}
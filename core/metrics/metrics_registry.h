@@ -0,0 +1,87 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QMap>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <functional>
+
+class MetricsRegistry {
+public:
+    enum class Type {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    using Labels = QList<QPair<QString, QString>>;
+    using Collector = std::function<void(MetricsRegistry&)>;
+
+    static MetricsRegistry& getInstance() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    static QList<double> latencyBuckets();
+
+    void describe(const QString& name, Type type, const QString& help, const QList<double>& buckets = QList<double>());
+    void increment(const QString& name, const Labels& labels = Labels(), double delta = 1.0);
+    void set(const QString& name, const Labels& labels, double value);
+    void observe(const QString& name, const Labels& labels, double value);
+    void addCollector(Collector collector);
+    QByteArray render();
+
+private:
+    struct Series {
+        Labels labels;
+        double value = 0.0;
+        QVector<quint64> bucketCounts;
+        double sum = 0.0;
+        quint64 count = 0;
+    };
+
+    struct Family {
+        Type type = Type::Gauge;
+        QString help;
+        QList<double> buckets;
+        QMap<QString, Series> series;
+    };
+
+    QMap<QString, Family> families;
+    QList<Collector> collectors;
+    QMutex mutex;
+
+    MetricsRegistry() {}
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    Series& seriesFor(const QString& name, const Labels& labels);
+    static QString labelKey(const Labels& labels);
+    static QString formatLabels(const Labels& labels, const QString& extraName = QString(), const QString& extraValue = QString());
+    static QString formatValue(double value);
+};
+
+class MetricsTimer {
+public:
+    MetricsTimer(const QString& name, const MetricsRegistry::Labels& labels) : name(name), labels(labels) {
+        timer.start();
+    }
+
+    ~MetricsTimer() {
+        MetricsRegistry::getInstance().observe(name, labels, double(timer.nsecsElapsed()) / 1e9);
+    }
+
+    MetricsTimer(const MetricsTimer&) = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+private:
+    QString name;
+    MetricsRegistry::Labels labels;
+    QElapsedTimer timer;
+};
+
+#endif // METRICS_REGISTRY_H
@@ -0,0 +1,617 @@
+#include "mysql_client.h"
+#include <QDebug>
+#include <QTimer>
+#include <QtEndian>
+#include <QCryptographicHash>
+
+static const quint32 maxPacketSize = 16777216;
+static const char utf8mb4GeneralCi = 45;
+
+MySQLClient::MySQLClient(QObject *parent) : QObject(parent), socket(this) {
+    connect(&socket, &QSslSocket::readyRead, this, &MySQLClient::onReadyRead);
+    connect(&socket, &QSslSocket::encrypted, this, &MySQLClient::onEncrypted);
+    connect(&socket, &QSslSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        if (state != State::Disconnected) {
+            fail("MySQL connection failed: " + socket.errorString());
+        }
+    });
+    connect(&socket, &QSslSocket::disconnected, this, [this]() {
+        if (state != State::Disconnected) {
+            fail("MySQL connection was closed by the server.");
+        }
+    });
+}
+
+MySQLClient::~MySQLClient() {
+    state = State::Disconnected;
+    socket.abort();
+}
+
+void MySQLClient::connectToServer(const QString &host, int port, const QString &user, const QString &password, const QString &database) {
+    if (state != State::Disconnected) {
+        close();
+    }
+    this->user = user;
+    this->password = password.toUtf8();
+    this->database = database;
+    lastError.clear();
+    buffer.clear();
+    sequenceId = 0;
+    useTls = false;
+    state = State::Handshake;
+    quint64 generation = ++connectionGeneration;
+    socket.connectToHost(host, quint16(port));
+    QTimer::singleShot(connectTimeout, this, [this, generation]() {
+        if (generation == connectionGeneration && (state == State::Handshake || state == State::TlsUpgrade || state == State::Authenticating)) {
+            fail("MySQL connection timed out during the handshake.");
+        }
+    });
+}
+
+void MySQLClient::query(const QString &sql, Callback callback) {
+    PendingQuery pending;
+    pending.sql = sql.toUtf8();
+    pending.callback = std::move(callback);
+    if (state == State::Disconnected) {
+        MySQLResult result;
+        result.error = lastError.isEmpty() ? "MySQL client is not connected." : lastError;
+        if (pending.callback) {
+            pending.callback(result);
+        }
+        return;
+    }
+    queries.enqueue(std::move(pending));
+    sendNextQuery();
+}
+
+void MySQLClient::relay(const QByteArray &packets, PacketCallback callback) {
+    if (state == State::Disconnected) {
+        if (callback) {
+            callback(QByteArray(), true);
+        }
+        return;
+    }
+    PendingQuery pending;
+    pending.packets = packets;
+    pending.relayCallback = std::move(callback);
+    queries.enqueue(std::move(pending));
+    sendNextQuery();
+}
+
+void MySQLClient::close() {
+    if (state == State::Disconnected) {
+        return;
+    }
+    if (state == State::Ready) {
+        sequenceId = 0;
+        sendPacket(QByteArray(1, char(0x01)));
+    }
+    state = State::Disconnected;
+    socket.disconnectFromHost();
+    buffer.clear();
+    QQueue<PendingQuery> pending;
+    pending.swap(queries);
+    for (const PendingQuery& query : pending) {
+        MySQLResult result;
+        result.error = "MySQL connection was closed.";
+        if (query.relayCallback) {
+            query.relayCallback(QByteArray(), true);
+        } else if (query.callback) {
+            query.callback(result);
+        }
+    }
+}
+
+bool MySQLClient::isReady() const {
+    return state != State::Disconnected && state != State::Handshake && state != State::TlsUpgrade && state != State::Authenticating;
+}
+
+bool MySQLClient::isConnecting() const {
+    return state == State::Handshake || state == State::TlsUpgrade || state == State::Authenticating;
+}
+
+QString MySQLClient::errorString() const {
+    return lastError;
+}
+
+QString MySQLClient::serverVersion() const {
+    return version;
+}
+
+quint16 MySQLClient::serverStatus() const {
+    return status;
+}
+
+QByteArray MySQLClient::scramble(const QString &plugin, const QByteArray &password, const QByteArray &nonce) {
+    if (password.isEmpty()) {
+        return QByteArray();
+    }
+    QByteArray salt = nonce.left(20);
+    QByteArray first;
+    QByteArray third;
+    if (plugin == "mysql_native_password") {
+        first = QCryptographicHash::hash(password, QCryptographicHash::Sha1);
+        QByteArray second = QCryptographicHash::hash(first, QCryptographicHash::Sha1);
+        third = QCryptographicHash::hash(salt + second, QCryptographicHash::Sha1);
+    } else if (plugin == "caching_sha2_password") {
+        first = QCryptographicHash::hash(password, QCryptographicHash::Sha256);
+        QByteArray second = QCryptographicHash::hash(first, QCryptographicHash::Sha256);
+        third = QCryptographicHash::hash(second + salt, QCryptographicHash::Sha256);
+    } else {
+        return QByteArray();
+    }
+    for (int i = 0; i < first.size(); ++i) {
+        first[i] = char(first.at(i) ^ third.at(i));
+    }
+    return first;
+}
+
+quint64 MySQLClient::readLengthEncodedInteger(const QByteArray &data, int &position, bool *isNull) {
+    if (isNull) {
+        *isNull = false;
+    }
+    if (position >= data.size()) {
+        return 0;
+    }
+    quint8 first = quint8(data.at(position));
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData()) + position + 1;
+    if (first < 0xFB) {
+        position += 1;
+        return first;
+    } else if (first == 0xFB) {
+        position += 1;
+        if (isNull) {
+            *isNull = true;
+        }
+        return 0;
+    } else if (first == 0xFC && position + 3 <= data.size()) {
+        position += 3;
+        return qFromLittleEndian<quint16>(bytes);
+    } else if (first == 0xFD && position + 4 <= data.size()) {
+        position += 4;
+        return quint64(bytes[0]) | (quint64(bytes[1]) << 8) | (quint64(bytes[2]) << 16);
+    } else if (first == 0xFE && position + 9 <= data.size()) {
+        position += 9;
+        return qFromLittleEndian<quint64>(bytes);
+    }
+    position = data.size();
+    return 0;
+}
+
+QByteArray MySQLClient::readLengthEncodedString(const QByteArray &data, int &position, bool *isNull) {
+    quint64 length = readLengthEncodedInteger(data, position, isNull);
+    if (isNull && *isNull) {
+        return QByteArray();
+    }
+    QByteArray value = data.mid(position, int(length));
+    position += int(length);
+    return value;
+}
+
+QByteArray MySQLClient::lengthEncodedInteger(quint64 value) {
+    QByteArray encoded;
+    if (value < 0xFB) {
+        encoded.append(char(value));
+    } else if (value <= 0xFFFF) {
+        encoded.append(char(0xFC));
+        encoded.append(char(value & 0xFF)).append(char((value >> 8) & 0xFF));
+    } else if (value <= 0xFFFFFF) {
+        encoded.append(char(0xFD));
+        encoded.append(char(value & 0xFF)).append(char((value >> 8) & 0xFF)).append(char((value >> 16) & 0xFF));
+    } else {
+        encoded.append(char(0xFE));
+        for (int i = 0; i < 8; ++i) {
+            encoded.append(char((value >> (8 * i)) & 0xFF));
+        }
+    }
+    return encoded;
+}
+
+MySQLResult MySQLClient::parseError(const QByteArray &packet) {
+    MySQLResult result;
+    if (packet.size() < 3) {
+        result.error = "MySQL returned a malformed error packet.";
+        return result;
+    }
+    result.errorCode = qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(packet.constData()) + 1);
+    QByteArray message = packet.size() > 3 && packet.at(3) == '#' ? packet.mid(9) : packet.mid(3);
+    result.error = "MySQL error " + QString::number(result.errorCode) + ": " + QString::fromUtf8(message);
+    return result;
+}
+
+QByteArray MySQLClient::framePacket(const QByteArray &payload, quint8 sequenceId) {
+    QByteArray packet(4, '\0');
+    packet[0] = char(payload.size() & 0xFF);
+    packet[1] = char((payload.size() >> 8) & 0xFF);
+    packet[2] = char((payload.size() >> 16) & 0xFF);
+    packet[3] = char(sequenceId);
+    packet.append(payload);
+    return packet;
+}
+
+quint16 MySQLClient::readStatusFlags(const QByteArray &payload) {
+    if (payload.isEmpty()) {
+        return 0;
+    }
+    int position = 1;
+    if (quint8(payload.at(0)) == 0xFE && payload.size() < 9) {
+        position = 3;
+    } else {
+        readLengthEncodedInteger(payload, position);
+        readLengthEncodedInteger(payload, position);
+    }
+    if (position + 2 > payload.size()) {
+        return 0;
+    }
+    return qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(payload.constData()) + position);
+}
+
+void MySQLClient::onReadyRead() {
+    buffer.append(socket.readAll());
+    while (state != State::Disconnected && buffer.size() >= 4) {
+        const uchar* header = reinterpret_cast<const uchar*>(buffer.constData());
+        int length = int(header[0]) | (int(header[1]) << 8) | (int(header[2]) << 16);
+        if (buffer.size() < 4 + length) {
+            break;
+        }
+        if (state == State::Relaying) {
+            QByteArray packet = buffer.left(4 + length);
+            buffer.remove(0, 4 + length);
+            handleRelayPacket(packet);
+            continue;
+        }
+        sequenceId = quint8(header[3] + 1);
+        QByteArray packet = buffer.mid(4, length);
+        buffer.remove(0, 4 + length);
+        handlePacket(packet);
+    }
+}
+
+void MySQLClient::onEncrypted() {
+    if (state == State::TlsUpgrade) {
+        state = State::Authenticating;
+        sendHandshakeResponse();
+    }
+}
+
+void MySQLClient::handlePacket(const QByteArray &packet) {
+    if (packet.isEmpty()) {
+        fail("MySQL sent an empty packet.");
+        return;
+    }
+    switch (state) {
+    case State::Handshake:
+        handleHandshake(packet);
+        break;
+    case State::Authenticating:
+        handleAuthentication(packet);
+        break;
+    case State::ColumnCount:
+    case State::Columns:
+    case State::Rows:
+        handleQueryResponse(packet);
+        break;
+    default:
+        qWarning() << "Ignoring unexpected MySQL packet in idle state.";
+        break;
+    }
+}
+
+void MySQLClient::handleHandshake(const QByteArray &packet) {
+    if (quint8(packet.at(0)) == 0xFF) {
+        fail(parseError(packet).error);
+        return;
+    }
+    if (packet.at(0) != 10) {
+        fail("MySQL handshake failed: unsupported protocol version " + QString::number(int(packet.at(0))) + ".");
+        return;
+    }
+    const uchar* bytes = reinterpret_cast<const uchar*>(packet.constData());
+    int position = 1;
+    int versionEnd = packet.indexOf('\0', position);
+    if (versionEnd < 0 || versionEnd + 16 > packet.size()) {
+        fail("MySQL handshake failed: malformed handshake packet.");
+        return;
+    }
+    version = QString::fromLatin1(packet.mid(position, versionEnd - position));
+    position = versionEnd + 1 + 4;
+    QByteArray authData = packet.mid(position, 8);
+    position += 9;
+    serverCapabilities = qFromLittleEndian<quint16>(bytes + position);
+    position += 2;
+    int authDataLength = 0;
+    if (position + 16 <= packet.size()) {
+        position += 3;
+        serverCapabilities |= quint32(qFromLittleEndian<quint16>(bytes + position)) << 16;
+        position += 2;
+        authDataLength = int(bytes[position]);
+        position += 11;
+        if (serverCapabilities & SecureConnection) {
+            int partLength = qMax(13, authDataLength - 8);
+            QByteArray part = packet.mid(position, partLength);
+            position += partLength;
+            if (part.endsWith('\0')) {
+                part.chop(1);
+            }
+            authData.append(part);
+        }
+        if (serverCapabilities & PluginAuth) {
+            int pluginEnd = packet.indexOf('\0', position);
+            authPlugin = QString::fromLatin1(packet.mid(position, pluginEnd < 0 ? -1 : pluginEnd - position));
+        }
+    }
+    nonce = authData;
+    if (authPlugin.isEmpty()) {
+        authPlugin = "mysql_native_password";
+    }
+    if (!(serverCapabilities & Protocol41)) {
+        fail("MySQL handshake failed: server " + version + " does not support protocol 4.1.");
+        return;
+    }
+
+    useTls = (serverCapabilities & Ssl) && QSslSocket::supportsSsl();
+    if (useTls) {
+        QByteArray request(32, '\0');
+        qToLittleEndian<quint32>(clientCapabilities(), reinterpret_cast<uchar*>(request.data()));
+        qToLittleEndian<quint32>(maxPacketSize, reinterpret_cast<uchar*>(request.data()) + 4);
+        request[8] = utf8mb4GeneralCi;
+        sendPacket(request);
+        state = State::TlsUpgrade;
+        socket.setPeerVerifyMode(QSslSocket::VerifyNone);
+        socket.startClientEncryption();
+        return;
+    }
+    state = State::Authenticating;
+    sendHandshakeResponse();
+}
+
+quint32 MySQLClient::clientCapabilities() const {
+    quint32 capabilities = LongPassword | LongFlag | Protocol41 | Transactions | SecureConnection | MultiStatements | MultiResults | PsMultiResults | PluginAuth;
+    if (!database.isEmpty()) {
+        capabilities |= ConnectWithDb;
+    }
+    if (useTls) {
+        capabilities |= Ssl;
+    }
+    return capabilities & (serverCapabilities | Protocol41);
+}
+
+void MySQLClient::sendHandshakeResponse() {
+    if (authPlugin != "mysql_native_password" && authPlugin != "caching_sha2_password") {
+        fail("MySQL authentication failed: unsupported authentication plugin " + authPlugin + ".");
+        return;
+    }
+    quint32 capabilities = clientCapabilities();
+    QByteArray response(32, '\0');
+    qToLittleEndian<quint32>(capabilities, reinterpret_cast<uchar*>(response.data()));
+    qToLittleEndian<quint32>(maxPacketSize, reinterpret_cast<uchar*>(response.data()) + 4);
+    response[8] = utf8mb4GeneralCi;
+    response.append(user.toUtf8()).append('\0');
+    QByteArray authResponse = scramble(authPlugin, password, nonce);
+    response.append(char(authResponse.size())).append(authResponse);
+    if (capabilities & ConnectWithDb) {
+        response.append(database.toUtf8()).append('\0');
+    }
+    if (capabilities & PluginAuth) {
+        response.append(authPlugin.toLatin1()).append('\0');
+    }
+    sendPacket(response);
+}
+
+void MySQLClient::handleAuthentication(const QByteArray &packet) {
+    quint8 header = quint8(packet.at(0));
+    if (header == 0x00) {
+        state = State::Ready;
+        emit ready();
+        sendNextQuery();
+    } else if (header == 0xFF) {
+        fail(parseError(packet).error);
+    } else if (header == 0xFE) {
+        int pluginEnd = packet.indexOf('\0', 1);
+        authPlugin = QString::fromLatin1(packet.mid(1, pluginEnd < 0 ? -1 : pluginEnd - 1));
+        nonce = pluginEnd < 0 ? QByteArray() : packet.mid(pluginEnd + 1);
+        if (nonce.endsWith('\0')) {
+            nonce.chop(1);
+        }
+        if (authPlugin != "mysql_native_password" && authPlugin != "caching_sha2_password") {
+            fail("MySQL authentication failed: unsupported authentication plugin " + authPlugin + ".");
+            return;
+        }
+        sendPacket(scramble(authPlugin, password, nonce));
+    } else if (header == 0x01 && authPlugin == "caching_sha2_password" && packet.size() >= 2) {
+        if (packet.at(1) == 0x03) {
+            return;
+        }
+        if (packet.at(1) == 0x04) {
+            if (socket.isEncrypted()) {
+                sendPacket(password + '\0');
+            } else {
+                fail("MySQL authentication failed: caching_sha2_password needs a TLS connection for the first login of "
+                     + user + " after the server starts.");
+            }
+            return;
+        }
+        fail("MySQL authentication failed: unexpected caching_sha2_password state.");
+    } else {
+        fail("MySQL authentication failed: unexpected packet during authentication.");
+    }
+}
+
+void MySQLClient::sendNextQuery() {
+    while (state == State::Ready && !queries.isEmpty()) {
+        if (!queries.head().relayCallback) {
+            currentResult = MySQLResult();
+            columnCount = 0;
+            state = State::ColumnCount;
+            sequenceId = 0;
+            sendPacket(QByteArray(1, char(0x03)) + queries.head().sql);
+            return;
+        }
+        relayCommand = queries.head().packets.size() > 4 ? quint8(queries.head().packets.at(4)) : 0;
+        socket.write(queries.head().packets);
+        if (relayCommand == 0x18 || relayCommand == 0x19) {
+            PendingQuery pending = queries.dequeue();
+            pending.relayCallback(QByteArray(), true);
+            continue;
+        }
+        relayStage = relayCommand == 0x04 ? RelayStage::Columns : RelayStage::Response;
+        relayColumns = 0;
+        relayContinuation = false;
+        state = State::Relaying;
+        return;
+    }
+}
+
+void MySQLClient::handleQueryResponse(const QByteArray &packet) {
+    quint8 header = quint8(packet.at(0));
+    bool isEof = header == 0xFE && packet.size() < 9;
+    if (header == 0xFF) {
+        finishQuery(parseError(packet));
+        return;
+    }
+    int position = 0;
+    if (state == State::ColumnCount) {
+        if (header == 0x00) {
+            position = 1;
+            status = readStatusFlags(packet);
+            currentResult.affectedRows = readLengthEncodedInteger(packet, position);
+            currentResult.ok = true;
+            finishQuery(currentResult);
+        } else if (header == 0xFB) {
+            fail("MySQL requested LOCAL INFILE data, which is not supported.");
+        } else {
+            columnCount = readLengthEncodedInteger(packet, position);
+            state = State::Columns;
+        }
+    } else if (state == State::Columns) {
+        if (isEof) {
+            state = State::Rows;
+            return;
+        }
+        for (int i = 0; i < 4; ++i) {
+            readLengthEncodedString(packet, position);
+        }
+        currentResult.columns.append(QString::fromUtf8(readLengthEncodedString(packet, position)));
+    } else {
+        if (isEof) {
+            status = readStatusFlags(packet);
+            currentResult.ok = true;
+            finishQuery(currentResult);
+            return;
+        }
+        QStringList row;
+        for (quint64 i = 0; i < columnCount; ++i) {
+            bool isNull = false;
+            QByteArray value = readLengthEncodedString(packet, position, &isNull);
+            row.append(isNull ? QString() : QString::fromUtf8(value));
+        }
+        currentResult.rows.append(row);
+    }
+}
+
+void MySQLClient::handleRelayPacket(const QByteArray &packet) {
+    QByteArray payload = packet.mid(4);
+    bool continuation = relayContinuation;
+    relayContinuation = payload.size() == 0xFFFFFF;
+    bool last = false;
+    if (!continuation && !payload.isEmpty()) {
+        quint8 header = quint8(payload.at(0));
+        bool isEof = header == 0xFE && payload.size() < 9;
+        switch (relayStage) {
+        case RelayStage::Response:
+            if (header == 0xFF) {
+                last = true;
+            } else if (relayCommand == 0x16 && header == 0x00 && payload.size() >= 9) {
+                const uchar* bytes = reinterpret_cast<const uchar*>(payload.constData());
+                relayColumns = qFromLittleEndian<quint16>(bytes + 5);
+                int params = qFromLittleEndian<quint16>(bytes + 7);
+                relayStage = params > 0 ? RelayStage::PrepareParams : RelayStage::PrepareColumns;
+                last = params == 0 && relayColumns == 0;
+            } else if (header == 0x00 || isEof) {
+                status = readStatusFlags(payload);
+                last = !(status & MoreResultsExist);
+            } else if (relayCommand == 0x03 || relayCommand == 0x17) {
+                relayStage = RelayStage::Columns;
+            } else {
+                last = true;
+            }
+            break;
+        case RelayStage::Columns:
+            if (isEof && relayCommand == 0x04) {
+                status = readStatusFlags(payload);
+                last = true;
+            } else if (isEof) {
+                relayStage = RelayStage::Rows;
+            }
+            break;
+        case RelayStage::Rows:
+            if (header == 0xFF) {
+                last = true;
+            } else if (isEof) {
+                status = readStatusFlags(payload);
+                relayStage = RelayStage::Response;
+                last = !(status & MoreResultsExist);
+            }
+            break;
+        case RelayStage::PrepareParams:
+            if (isEof) {
+                relayStage = RelayStage::PrepareColumns;
+                last = relayColumns == 0;
+            }
+            break;
+        case RelayStage::PrepareColumns:
+            last = isEof;
+            break;
+        }
+    }
+    if (queries.isEmpty()) {
+        state = State::Ready;
+        return;
+    }
+    if (!last) {
+        queries.head().relayCallback(packet, false);
+        return;
+    }
+    PendingQuery pending = queries.dequeue();
+    state = State::Ready;
+    pending.relayCallback(packet, true);
+    sendNextQuery();
+}
+
+void MySQLClient::finishQuery(const MySQLResult &result) {
+    if (queries.isEmpty()) {
+        state = State::Ready;
+        return;
+    }
+    PendingQuery pending = queries.dequeue();
+    state = State::Ready;
+    if (pending.callback) {
+        pending.callback(result);
+    }
+    sendNextQuery();
+}
+
+void MySQLClient::sendPacket(const QByteArray &payload) {
+    socket.write(framePacket(payload, sequenceId++));
+}
+
+void MySQLClient::fail(const QString &errorMessage) {
+    lastError = errorMessage;
+    qWarning() << errorMessage;
+    state = State::Disconnected;
+    socket.abort();
+    buffer.clear();
+    QQueue<PendingQuery> pending;
+    pending.swap(queries);
+    for (const PendingQuery& query : pending) {
+        MySQLResult result;
+        result.error = errorMessage;
+        if (query.relayCallback) {
+            query.relayCallback(QByteArray(), true);
+        } else if (query.callback) {
+            query.callback(result);
+        }
+    }
+    emit errorOccurred(errorMessage);
+    emit disconnected();
+}
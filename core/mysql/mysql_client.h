@@ -0,0 +1,143 @@
+#ifndef MYSQL_CLIENT_H
+#define MYSQL_CLIENT_H
+
+#include <QObject>
+#include <QSslSocket>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QQueue>
+#include <functional>
+
+struct MySQLResult {
+    bool ok = false;
+    QString error;
+    int errorCode = 0;
+    QStringList columns;
+    QList<QStringList> rows;
+    quint64 affectedRows = 0;
+};
+
+class MySQLClient : public QObject {
+    Q_OBJECT
+public:
+    using Callback = std::function<void(const MySQLResult&)>;
+    using PacketCallback = std::function<void(const QByteArray& packet, bool last)>;
+
+    static const int connectTimeout = 5000;
+
+    enum Capability : quint32 {
+        LongPassword = 0x00000001,
+        LongFlag = 0x00000004,
+        ConnectWithDb = 0x00000008,
+        Protocol41 = 0x00000200,
+        Ssl = 0x00000800,
+        Transactions = 0x00002000,
+        SecureConnection = 0x00008000,
+        MultiStatements = 0x00010000,
+        MultiResults = 0x00020000,
+        PsMultiResults = 0x00040000,
+        PluginAuth = 0x00080000,
+        PluginAuthLenencData = 0x00200000
+    };
+
+    enum ServerStatus : quint16 {
+        InTransaction = 0x0001,
+        Autocommit = 0x0002,
+        MoreResultsExist = 0x0008
+    };
+
+    explicit MySQLClient(QObject *parent = nullptr);
+    ~MySQLClient();
+
+    void connectToServer(const QString& host, int port, const QString& user, const QString& password, const QString& database = QString());
+    void query(const QString& sql, Callback callback);
+    void relay(const QByteArray& packets, PacketCallback callback);
+    void close();
+    bool isReady() const;
+    bool isConnecting() const;
+    QString errorString() const;
+    QString serverVersion() const;
+    quint16 serverStatus() const;
+
+    static QByteArray scramble(const QString& plugin, const QByteArray& password, const QByteArray& nonce);
+    static quint64 readLengthEncodedInteger(const QByteArray& data, int& position, bool* isNull = nullptr);
+    static QByteArray readLengthEncodedString(const QByteArray& data, int& position, bool* isNull = nullptr);
+    static QByteArray lengthEncodedInteger(quint64 value);
+    static MySQLResult parseError(const QByteArray& packet);
+    static QByteArray framePacket(const QByteArray& payload, quint8 sequenceId);
+    static quint16 readStatusFlags(const QByteArray& payload);
+
+signals:
+    void ready();
+    void errorOccurred(const QString& errorMessage);
+    void disconnected();
+
+private:
+    enum class State {
+        Disconnected,
+        Handshake,
+        TlsUpgrade,
+        Authenticating,
+        Ready,
+        ColumnCount,
+        Columns,
+        Rows,
+        Relaying
+    };
+
+    enum class RelayStage {
+        Response,
+        Columns,
+        Rows,
+        PrepareParams,
+        PrepareColumns
+    };
+
+    struct PendingQuery {
+        QByteArray sql;
+        Callback callback;
+        QByteArray packets;
+        PacketCallback relayCallback;
+    };
+
+    QSslSocket socket;
+    State state = State::Disconnected;
+    QByteArray buffer;
+    quint8 sequenceId = 0;
+    quint32 serverCapabilities = 0;
+    QString version;
+    QByteArray nonce;
+    QString authPlugin;
+    QString user;
+    QByteArray password;
+    QString database;
+    QString lastError;
+    QQueue<PendingQuery> queries;
+    MySQLResult currentResult;
+    quint64 columnCount = 0;
+    quint16 status = Autocommit;
+    RelayStage relayStage = RelayStage::Response;
+    quint8 relayCommand = 0;
+    int relayColumns = 0;
+    bool relayContinuation = false;
+    quint64 connectionGeneration = 0;
+    bool useTls = false;
+
+    void onReadyRead();
+    void onEncrypted();
+    void handlePacket(const QByteArray& packet);
+    void handleHandshake(const QByteArray& packet);
+    void handleAuthentication(const QByteArray& packet);
+    void handleQueryResponse(const QByteArray& packet);
+    void handleRelayPacket(const QByteArray& packet);
+    void sendPacket(const QByteArray& payload);
+    void sendHandshakeResponse();
+    quint32 clientCapabilities() const;
+    void sendNextQuery();
+    void finishQuery(const MySQLResult& result);
+    void fail(const QString& errorMessage);
+};
+
+#endif // MYSQL_CLIENT_H
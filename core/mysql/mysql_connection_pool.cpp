@@ -0,0 +1,241 @@
+#include "mysql_connection_pool.h"
+#include "../metrics/metrics_registry.h"
+#include "../../utility/trace.h"
+#include <QDebug>
+#include <QDateTime>
+
+MySQLConnectionPool::MySQLConnectionPool(QObject *parent) : QObject(parent), maintenanceTimer(this) {
+    maintenanceTimer.setInterval(maintenanceInterval);
+    connect(&maintenanceTimer, &QTimer::timeout, this, &MySQLConnectionPool::maintain);
+}
+
+MySQLConnectionPool::~MySQLConnectionPool() {
+    close();
+}
+
+void MySQLConnectionPool::setSettings(const QJsonObject &settings) {
+    bool reconnect = settings.value("user") != this->settings.value("user") || settings.value("password") != this->settings.value("password");
+    this->settings = settings;
+    if (reconnect) {
+        ++generation;
+        while (!idle.isEmpty()) {
+            remove(idle.first());
+        }
+    }
+    maintain();
+}
+
+void MySQLConnectionPool::open(int port) {
+    this->port = port;
+    opened = true;
+    lastError.clear();
+    maintenanceTimer.start();
+    maintain();
+}
+
+void MySQLConnectionPool::close() {
+    opened = false;
+    maintenanceTimer.stop();
+    QList<Waiter> pending;
+    pending.swap(waiters);
+    for (const Waiter& waiter : pending) {
+        waiter.callback(nullptr, "The MySQL proxy was stopped.");
+    }
+    const QList<MySQLBackend*> backends = idle + QList<MySQLBackend*>(leased.begin(), leased.end()) + QList<MySQLBackend*>(connecting.begin(), connecting.end());
+    for (MySQLBackend* backend : backends) {
+        remove(backend);
+    }
+}
+
+bool MySQLConnectionPool::isOpen() const {
+    return opened;
+}
+
+quint64 MySQLConnectionPool::acquire(LeaseCallback callback) {
+    Waiter waiter;
+    waiter.ticket = ++nextTicket;
+    waiter.callback = std::move(callback);
+    waiter.waited.start();
+    if (!opened) {
+        waiter.callback(nullptr, "The MySQL proxy is not running.");
+        return 0;
+    }
+    if (!idle.isEmpty()) {
+        lease(idle.takeLast(), waiter);
+        return 0;
+    }
+    waiters.append(waiter);
+    if (connecting.size() < waiters.size() && size() < settings.value("pool_size").toInt()) {
+        openConnection();
+    }
+    return waiter.ticket;
+}
+
+void MySQLConnectionPool::cancel(quint64 ticket) {
+    for (int i = 0; i < waiters.size(); ++i) {
+        if (waiters.at(i).ticket == ticket) {
+            waiters.removeAt(i);
+            return;
+        }
+    }
+}
+
+void MySQLConnectionPool::release(MySQLBackend *backend, bool reset) {
+    if (!leased.contains(backend)) {
+        return;
+    }
+    if (!opened || !backend->client->isReady() || backend->generation != generation) {
+        discard(backend);
+        return;
+    }
+    if (!reset) {
+        leased.remove(backend);
+        hand(backend);
+        return;
+    }
+    ++resetsTotal;
+    backend->client->relay(MySQLClient::framePacket(QByteArray(1, char(0x1F)), 0), [this, backend](const QByteArray& packet, bool last) {
+        if (!last || !leased.contains(backend)) {
+            return;
+        }
+        if (packet.size() > 4 && packet.at(4) == 0x00) {
+            backend->databaseKnown = false;
+            backend->collation = 0;
+            leased.remove(backend);
+            hand(backend);
+        } else {
+            qWarning() << "Dropping pooled MySQL connection: COM_RESET_CONNECTION failed.";
+            discard(backend);
+        }
+    });
+}
+
+void MySQLConnectionPool::discard(MySQLBackend *backend) {
+    if (!leased.contains(backend)) {
+        return;
+    }
+    remove(backend);
+    maintain();
+}
+
+QString MySQLConnectionPool::serverVersion() const {
+    return version;
+}
+
+QJsonObject MySQLConnectionPool::getStats() const {
+    QJsonObject stats;
+    stats["open"] = opened;
+    stats["backend_port"] = port;
+    stats["size"] = size();
+    stats["max_size"] = settings.value("pool_size").toInt();
+    stats["idle"] = idle.size();
+    stats["active"] = leased.size();
+    stats["connecting"] = connecting.size();
+    stats["waiting"] = waiters.size();
+    stats["connects_total"] = double(connectsTotal);
+    stats["connect_failures_total"] = double(connectFailuresTotal);
+    stats["leases_total"] = double(leasesTotal);
+    stats["resets_total"] = double(resetsTotal);
+    stats["timeouts_total"] = double(timeoutsTotal);
+    stats["reuse_ratio"] = leasesTotal > 0 ? qMax(0.0, 1.0 - double(connectsTotal) / double(leasesTotal)) : 0.0;
+    stats["server_version"] = version;
+    stats["last_error"] = lastError;
+    return stats;
+}
+
+int MySQLConnectionPool::size() const {
+    return idle.size() + leased.size() + connecting.size();
+}
+
+void MySQLConnectionPool::openConnection() {
+    TRACE_SCOPE("server", "MySQLConnectionPool::openConnection");
+    MySQLBackend* backend = new MySQLBackend;
+    backend->client = new MySQLClient(this);
+    backend->generation = generation;
+    connecting.insert(backend);
+    ++connectsTotal;
+    connect(backend->client, &MySQLClient::ready, this, [this, backend]() {
+        connecting.remove(backend);
+        version = backend->client->serverVersion();
+        lastError.clear();
+        hand(backend);
+    });
+    connect(backend->client, &MySQLClient::disconnected, this, [this, backend]() {
+        if (leased.contains(backend)) {
+            return;
+        }
+        if (connecting.contains(backend)) {
+            ++connectFailuresTotal;
+            lastError = backend->client->errorString();
+            remove(backend);
+            if (!waiters.isEmpty()) {
+                Waiter waiter = waiters.takeFirst();
+                waiter.callback(nullptr, lastError);
+            }
+            return;
+        }
+        remove(backend);
+    });
+    backend->client->connectToServer("127.0.0.1", port, settings.value("user").toString(), settings.value("password").toString());
+}
+
+void MySQLConnectionPool::hand(MySQLBackend *backend) {
+    backend->idleSince = QDateTime::currentMSecsSinceEpoch();
+    if (!waiters.isEmpty()) {
+        lease(backend, waiters.takeFirst());
+        return;
+    }
+    idle.append(backend);
+}
+
+void MySQLConnectionPool::lease(MySQLBackend *backend, Waiter waiter) {
+    leased.insert(backend);
+    ++backend->leases;
+    ++leasesTotal;
+    MetricsRegistry::getInstance().observe("webdevtoolkit_mysql_proxy_lease_wait_seconds", MetricsRegistry::Labels(), double(waiter.waited.nsecsElapsed()) / 1e9);
+    waiter.callback(backend, QString());
+}
+
+void MySQLConnectionPool::remove(MySQLBackend *backend) {
+    idle.removeAll(backend);
+    leased.remove(backend);
+    connecting.remove(backend);
+    disconnect(backend->client, nullptr, this, nullptr);
+    backend->client->close();
+    backend->client->deleteLater();
+    delete backend;
+}
+
+void MySQLConnectionPool::maintain() {
+    if (!opened) {
+        return;
+    }
+    int acquireTimeout = settings.value("acquire_timeout_ms").toInt();
+    QList<Waiter> expired;
+    for (int i = 0; i < waiters.size();) {
+        if (waiters.at(i).waited.elapsed() >= acquireTimeout) {
+            expired.append(waiters.takeAt(i));
+        } else {
+            ++i;
+        }
+    }
+    for (const Waiter& waiter : expired) {
+        ++timeoutsTotal;
+        waiter.callback(nullptr, "Timed out after " + QString::number(acquireTimeout) + " ms waiting for a pooled MySQL connection"
+                                 + (lastError.isEmpty() ? QString(".") : ": " + lastError));
+    }
+
+    int minIdle = settings.value("min_idle").toInt();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    while (idle.size() > minIdle && now - idle.first()->idleSince >= settings.value("idle_timeout_ms").toInt()) {
+        remove(idle.first());
+    }
+
+    int wanted = waiters.size() - connecting.size();
+    if (lastError.isEmpty()) {
+        wanted = qMax(wanted, minIdle - idle.size() - connecting.size());
+    }
+    while (wanted-- > 0 && size() < settings.value("pool_size").toInt()) {
+        openConnection();
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef MYSQL_CONNECTION_POOL_H
+#define MYSQL_CONNECTION_POOL_H
+
+#include "mysql_client.h"
+#include <QObject>
+#include <QJsonObject>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+
+struct MySQLBackend {
+    MySQLClient* client = nullptr;
+    QString database;
+    bool databaseKnown = true;
+    int collation = 45;
+    qint64 idleSince = 0;
+    quint64 leases = 0;
+    quint64 generation = 0;
+};
+
+class MySQLConnectionPool : public QObject {
+    Q_OBJECT
+public:
+    using LeaseCallback = std::function<void(MySQLBackend* backend, const QString& errorMessage)>;
+
+    static const int maintenanceInterval = 1000;
+
+    explicit MySQLConnectionPool(QObject *parent = nullptr);
+    ~MySQLConnectionPool();
+
+    void setSettings(const QJsonObject& settings);
+    void open(int port);
+    void close();
+    bool isOpen() const;
+    quint64 acquire(LeaseCallback callback);
+    void cancel(quint64 ticket);
+    void release(MySQLBackend* backend, bool reset);
+    void discard(MySQLBackend* backend);
+    QString serverVersion() const;
+    QJsonObject getStats() const;
+
+private:
+    struct Waiter {
+        quint64 ticket = 0;
+        LeaseCallback callback;
+        QElapsedTimer waited;
+    };
+
+    QJsonObject settings;
+    int port = 0;
+    bool opened = false;
+    QList<MySQLBackend*> idle;
+    QSet<MySQLBackend*> leased;
+    QSet<MySQLBackend*> connecting;
+    QList<Waiter> waiters;
+    quint64 nextTicket = 0;
+    quint64 generation = 0;
+    QTimer maintenanceTimer;
+    QString version;
+    QString lastError;
+    quint64 connectsTotal = 0;
+    quint64 connectFailuresTotal = 0;
+    quint64 leasesTotal = 0;
+    quint64 resetsTotal = 0;
+    quint64 timeoutsTotal = 0;
+
+    int size() const;
+    void openConnection();
+    void hand(MySQLBackend* backend);
+    void lease(MySQLBackend* backend, Waiter waiter);
+    void remove(MySQLBackend* backend);
+    void maintain();
+};
+
+#endif // MYSQL_CONNECTION_POOL_H
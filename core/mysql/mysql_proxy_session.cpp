@@ -0,0 +1,420 @@
+#include "mysql_proxy_session.h"
+#include <QDebug>
+#include <QHash>
+#include <QtEndian>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+
+static const char nativePassword[] = "mysql_native_password";
+
+MySQLProxySession::MySQLProxySession(QTcpSocket *socket, MySQLConnectionPool *pool, const QJsonObject &settings, const QString &serverVersion, quint32 connectionId, QObject *parent)
+    : QObject(parent), socket(socket), pool(pool), settings(settings), serverVersion(serverVersion), connectionId(connectionId) {
+    socket->setParent(this);
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(socket, &QTcpSocket::readyRead, this, &MySQLProxySession::onReadyRead);
+    connect(socket, &QTcpSocket::disconnected, this, &MySQLProxySession::close);
+    sendHandshake();
+}
+
+MySQLProxySession::~MySQLProxySession() {
+}
+
+void MySQLProxySession::close() {
+    if (state == State::Closed) {
+        return;
+    }
+    state = State::Closed;
+    if (leaseTicket != 0) {
+        pool->cancel(leaseTicket);
+        leaseTicket = 0;
+    }
+    if (backend && busy) {
+        pool->discard(backend);
+        backend = nullptr;
+    } else if (backend) {
+        releaseBackend();
+    }
+    socket->disconnect(this);
+    socket->disconnectFromHost();
+    emit finished(this);
+}
+
+bool MySQLProxySession::isPinned() const {
+    return statePinned || inTransaction;
+}
+
+bool MySQLProxySession::hasBackend() const {
+    return backend != nullptr;
+}
+
+quint64 MySQLProxySession::getCommandCount() const {
+    return commandCount;
+}
+
+quint32 MySQLProxySession::serverCapabilities() {
+    return MySQLClient::LongPassword | MySQLClient::LongFlag | MySQLClient::ConnectWithDb | MySQLClient::Protocol41
+           | MySQLClient::Transactions | MySQLClient::SecureConnection | MySQLClient::MultiStatements | MySQLClient::MultiResults
+           | MySQLClient::PsMultiResults | MySQLClient::PluginAuth | MySQLClient::PluginAuthLenencData;
+}
+
+bool MySQLProxySession::changesSessionState(const QByteArray &sql) {
+    static const QRegularExpression statementPattern(
+        R"(^\s*(?:/\*.*?\*/\s*)*(?:SET|USE|LOCK|UNLOCK|PREPARE|EXECUTE|DEALLOCATE|HANDLER|XA|CALL|DO|LOAD|INSERT|REPLACE|UPDATE|DELETE|CREATE\s+TEMPORARY|DROP\s+TEMPORARY)\b)",
+        QRegularExpression::CaseInsensitiveOption | QRegularExpression::DotMatchesEverythingOption);
+    static const QRegularExpression sessionPattern(R"(\b(?:SQL_CALC_FOUND_ROWS|GET_LOCK|LAST_INSERT_ID|FOUND_ROWS|ROW_COUNT)\b|@[A-Za-z_]|;\s*\S)",
+                                                   QRegularExpression::CaseInsensitiveOption);
+    QString statement = QString::fromUtf8(sql);
+    return statementPattern.match(statement).hasMatch() || sessionPattern.match(statement).hasMatch();
+}
+
+QString MySQLProxySession::charsetForCollation(int collation) {
+    static const QHash<int, QString> charsets = {
+        {8, "latin1"},
+        {33, "utf8"},
+        {45, "utf8mb4"},
+        {46, "utf8mb4 COLLATE utf8mb4_bin"},
+        {63, "binary"},
+        {83, "utf8 COLLATE utf8_bin"},
+        {192, "utf8 COLLATE utf8_unicode_ci"},
+        {224, "utf8mb4 COLLATE utf8mb4_unicode_ci"},
+        {255, "utf8mb4 COLLATE utf8mb4_0900_ai_ci"}
+    };
+    return charsets.value(collation);
+}
+
+void MySQLProxySession::onReadyRead() {
+    buffer.append(socket->readAll());
+    processBuffer();
+}
+
+void MySQLProxySession::processBuffer() {
+    while (!busy && state != State::Closed) {
+        int offset = 0;
+        bool complete = false;
+        QByteArray payload;
+        while (buffer.size() >= offset + 4) {
+            const uchar* header = reinterpret_cast<const uchar*>(buffer.constData()) + offset;
+            int length = int(header[0]) | (int(header[1]) << 8) | (int(header[2]) << 16);
+            if (buffer.size() < offset + 4 + length) {
+                break;
+            }
+            sequenceId = quint8(header[3] + 1);
+            payload.append(buffer.mid(offset + 4, length));
+            offset += 4 + length;
+            if (length < 0xFFFFFF) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete) {
+            return;
+        }
+        QByteArray packets = buffer.left(offset);
+        buffer.remove(0, offset);
+        if (state == State::Handshake) {
+            handleHandshakeResponse(payload);
+        } else if (state == State::AuthSwitch) {
+            authResponse = payload;
+            authenticate();
+        } else {
+            handleCommand(packets, payload);
+        }
+    }
+}
+
+void MySQLProxySession::handleHandshakeResponse(const QByteArray &payload) {
+    const uchar* bytes = reinterpret_cast<const uchar*>(payload.constData());
+    quint32 capabilities = payload.size() >= 4 ? qFromLittleEndian<quint32>(bytes) : 0;
+    if ((capabilities & MySQLClient::Ssl) && payload.size() == 32) {
+        sendError(1043, "08S01", "The MySQL proxy does not support TLS; connect with SSL disabled.");
+        close();
+        return;
+    }
+    int userEnd = payload.indexOf('\0', 32);
+    if (payload.size() < 33 || !(capabilities & MySQLClient::Protocol41) || userEnd < 0) {
+        sendError(1043, "08S01", "Bad handshake");
+        close();
+        return;
+    }
+    collation = quint8(payload.at(8));
+    user = QString::fromUtf8(payload.mid(32, userEnd - 32));
+    int position = userEnd + 1;
+    if (capabilities & MySQLClient::PluginAuthLenencData) {
+        authResponse = MySQLClient::readLengthEncodedString(payload, position);
+    } else if (capabilities & MySQLClient::SecureConnection) {
+        int length = position < payload.size() ? quint8(payload.at(position)) : 0;
+        authResponse = payload.mid(position + 1, length);
+        position += 1 + length;
+    } else {
+        int end = payload.indexOf('\0', position);
+        authResponse = payload.mid(position, end < 0 ? -1 : end - position);
+        position = end < 0 ? payload.size() : end + 1;
+    }
+    if (capabilities & MySQLClient::ConnectWithDb) {
+        int end = payload.indexOf('\0', position);
+        database = QString::fromUtf8(payload.mid(position, end < 0 ? -1 : end - position));
+        position = end < 0 ? payload.size() : end + 1;
+    }
+    QString plugin = nativePassword;
+    if (capabilities & MySQLClient::PluginAuth) {
+        int end = payload.indexOf('\0', position);
+        plugin = QString::fromLatin1(payload.mid(position, end < 0 ? -1 : end - position));
+    }
+    if (plugin != nativePassword) {
+        QByteArray authSwitch(1, char(0xFE));
+        authSwitch.append(nativePassword).append('\0').append(nonce).append('\0');
+        state = State::AuthSwitch;
+        sendPacket(authSwitch);
+        return;
+    }
+    authenticate();
+}
+
+void MySQLProxySession::authenticate() {
+    QByteArray expected = MySQLClient::scramble(nativePassword, settings.value("password").toString().toUtf8(), nonce);
+    if (user != settings.value("user").toString() || authResponse != expected) {
+        sendError(1045, "28000", "Access denied for user '" + user + "'@'localhost' (using password: " + (authResponse.isEmpty() ? "NO" : "YES") + ")");
+        close();
+        return;
+    }
+    if (database.isEmpty()) {
+        state = State::Command;
+        sendOk();
+        return;
+    }
+    busy = true;
+    withBackend([this]() {
+        state = State::Command;
+        sendOk();
+        finishCommand();
+    });
+}
+
+void MySQLProxySession::handleCommand(const QByteArray &packets, const QByteArray &payload) {
+    if (payload.isEmpty()) {
+        sendError(1047, "08S01", "Unknown command");
+        return;
+    }
+    ++commandCount;
+    quint8 command = quint8(payload.at(0));
+    QByteArray argument = payload.mid(1);
+    switch (command) {
+    case 0x01:
+        close();
+        return;
+    case 0x0E:
+        sendOk();
+        return;
+    case 0x02:
+    case 0x03:
+    case 0x04:
+    case 0x09:
+    case 0x16:
+    case 0x17:
+    case 0x18:
+    case 0x19:
+    case 0x1A:
+    case 0x1B:
+    case 0x1F:
+        break;
+    default:
+        sendError(1047, "08S01", "Command " + QString::number(command) + " is not supported by the MySQL proxy.");
+        return;
+    }
+    if ((command == 0x03 && changesSessionState(argument)) || command == 0x16 || command == 0x1B) {
+        statePinned = true;
+    }
+    if (command >= 0x17 && command <= 0x1A && !backend) {
+        if (command == 0x1A || command == 0x17) {
+            sendError(1243, "HY000", "Unknown prepared statement handler given to the MySQL proxy.");
+        }
+        return;
+    }
+    busy = true;
+    withBackend([this, packets, command, argument]() {
+        forward(packets, command, argument);
+    });
+}
+
+void MySQLProxySession::withBackend(std::function<void()> next) {
+    if (backend) {
+        prepareBackend(next);
+        return;
+    }
+    leaseTicket = pool->acquire([this, next](MySQLBackend* leased, const QString& errorMessage) {
+        leaseTicket = 0;
+        if (state == State::Closed) {
+            if (leased) {
+                pool->release(leased, false);
+            }
+            return;
+        }
+        if (!leased) {
+            sendError(1105, "HY000", errorMessage);
+            if (state != State::Command) {
+                close();
+                return;
+            }
+            finishCommand();
+            return;
+        }
+        backend = leased;
+        prepareBackend(next);
+    });
+}
+
+void MySQLProxySession::prepareBackend(std::function<void()> next) {
+    auto fail = [this](const QByteArray& packet, const QString& errorMessage) {
+        if (packet.size() > 4) {
+            QByteArray response = packet;
+            response[3] = char(sequenceId++);
+            socket->write(response);
+        } else {
+            sendError(2013, "HY000", errorMessage);
+        }
+        if (!backend->client->isReady()) {
+            pool->discard(backend);
+            backend = nullptr;
+            statePinned = false;
+            inTransaction = false;
+        }
+        if (state != State::Command) {
+            close();
+            return;
+        }
+        finishCommand();
+    };
+    if (!database.isEmpty() && (!backend->databaseKnown || backend->database != database)) {
+        QByteArray initDb = MySQLClient::framePacket(QByteArray(1, char(0x02)) + database.toUtf8(), 0);
+        backend->client->relay(initDb, [this, next, fail](const QByteArray& packet, bool last) {
+            if (!last || state == State::Closed) {
+                return;
+            }
+            if (packet.size() > 4 && packet.at(4) == 0x00) {
+                backend->database = database;
+                backend->databaseKnown = true;
+                prepareBackend(next);
+            } else {
+                fail(packet, "Lost connection to MySQL server while selecting the database.");
+            }
+        });
+        return;
+    }
+    QString charset = charsetForCollation(collation);
+    if (backend->collation != collation && !charset.isEmpty()) {
+        backend->client->query("SET NAMES " + charset, [this, next, fail](const MySQLResult& result) {
+            if (state == State::Closed) {
+                return;
+            }
+            if (!result.ok) {
+                fail(QByteArray(), result.error);
+                return;
+            }
+            backend->collation = collation;
+            prepareBackend(next);
+        });
+        return;
+    }
+    next();
+}
+
+void MySQLProxySession::forward(const QByteArray &packets, quint8 command, const QByteArray &argument) {
+    responseStarted = false;
+    backend->client->relay(packets, [this, command, argument](const QByteArray& packet, bool last) {
+        if (state == State::Closed) {
+            return;
+        }
+        if (!packet.isEmpty()) {
+            socket->write(packet);
+            responseStarted = true;
+        }
+        if (!last) {
+            return;
+        }
+        if (packet.isEmpty() && !backend->client->isReady()) {
+            pool->discard(backend);
+            backend = nullptr;
+            statePinned = false;
+            inTransaction = false;
+            if (responseStarted) {
+                close();
+                return;
+            }
+            sendError(2013, "HY000", "Lost connection to MySQL server during query");
+            finishCommand();
+            return;
+        }
+        bool ok = packet.size() > 4 && packet.at(4) == 0x00;
+        inTransaction = backend->client->serverStatus() & MySQLClient::InTransaction;
+        if (command == 0x02 && ok) {
+            database = QString::fromUtf8(argument);
+            backend->database = database;
+            backend->databaseKnown = true;
+        } else if (command == 0x1F && ok) {
+            statePinned = false;
+            inTransaction = false;
+            backend->databaseKnown = false;
+            backend->collation = 0;
+        }
+        finishCommand();
+    });
+}
+
+void MySQLProxySession::finishCommand() {
+    busy = false;
+    if (backend && !statePinned && !inTransaction) {
+        releaseBackend();
+    }
+    processBuffer();
+}
+
+void MySQLProxySession::releaseBackend() {
+    MySQLBackend* released = backend;
+    backend = nullptr;
+    pool->release(released, statePinned || inTransaction);
+}
+
+void MySQLProxySession::sendHandshake() {
+    QRandomGenerator* random = QRandomGenerator::system();
+    nonce.clear();
+    for (int i = 0; i < 20; ++i) {
+        nonce.append(char(random->bounded(33, 127)));
+    }
+    quint32 capabilities = serverCapabilities();
+    QByteArray handshake(1, char(10));
+    handshake.append(serverVersion.toLatin1()).append('\0');
+    QByteArray id(4, '\0');
+    qToLittleEndian<quint32>(connectionId, reinterpret_cast<uchar*>(id.data()));
+    handshake.append(id);
+    handshake.append(nonce.left(8)).append('\0');
+    handshake.append(char(capabilities & 0xFF)).append(char((capabilities >> 8) & 0xFF));
+    handshake.append(char(45));
+    handshake.append(char(MySQLClient::Autocommit)).append('\0');
+    handshake.append(char((capabilities >> 16) & 0xFF)).append(char((capabilities >> 24) & 0xFF));
+    handshake.append(char(nonce.size() + 1));
+    handshake.append(QByteArray(10, '\0'));
+    handshake.append(nonce.mid(8)).append('\0');
+    handshake.append(nativePassword).append('\0');
+    sequenceId = 0;
+    sendPacket(handshake);
+}
+
+void MySQLProxySession::sendPacket(const QByteArray &payload) {
+    socket->write(MySQLClient::framePacket(payload, sequenceId++));
+}
+
+void MySQLProxySession::sendOk() {
+    quint16 status = MySQLClient::Autocommit | (inTransaction ? MySQLClient::InTransaction : 0);
+    QByteArray ok(3, '\0');
+    ok.append(char(status & 0xFF)).append(char((status >> 8) & 0xFF));
+    ok.append(QByteArray(2, '\0'));
+    sendPacket(ok);
+}
+
+void MySQLProxySession::sendError(int code, const QString &sqlState, const QString &message) {
+    QByteArray error(1, char(0xFF));
+    error.append(char(code & 0xFF)).append(char((code >> 8) & 0xFF));
+    error.append('#').append(sqlState.toLatin1().left(5));
+    error.append(message.toUtf8());
+    sendPacket(error);
+}
@@ -0,0 +1,74 @@
+#ifndef MYSQL_PROXY_SESSION_H
+#define MYSQL_PROXY_SESSION_H
+
+#include "mysql_connection_pool.h"
+#include <QObject>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QString>
+#include <functional>
+
+class MySQLProxySession : public QObject {
+    Q_OBJECT
+public:
+    MySQLProxySession(QTcpSocket* socket, MySQLConnectionPool* pool, const QJsonObject& settings, const QString& serverVersion, quint32 connectionId, QObject *parent = nullptr);
+    ~MySQLProxySession();
+
+    void close();
+    bool isPinned() const;
+    bool hasBackend() const;
+    quint64 getCommandCount() const;
+
+    static quint32 serverCapabilities();
+    static bool changesSessionState(const QByteArray& sql);
+    static QString charsetForCollation(int collation);
+
+signals:
+    void finished(MySQLProxySession* session);
+
+private:
+    enum class State {
+        Handshake,
+        AuthSwitch,
+        Command,
+        Closed
+    };
+
+    QTcpSocket* socket;
+    MySQLConnectionPool* pool;
+    QJsonObject settings;
+    QString serverVersion;
+    quint32 connectionId;
+    State state = State::Handshake;
+    QByteArray buffer;
+    quint8 sequenceId = 0;
+    QByteArray nonce;
+    QString user;
+    QByteArray authResponse;
+    QString database;
+    int collation = 45;
+    MySQLBackend* backend = nullptr;
+    quint64 leaseTicket = 0;
+    bool busy = false;
+    bool responseStarted = false;
+    bool statePinned = false;
+    bool inTransaction = false;
+    quint64 commandCount = 0;
+
+    void onReadyRead();
+    void processBuffer();
+    void handleHandshakeResponse(const QByteArray& payload);
+    void authenticate();
+    void handleCommand(const QByteArray& packets, const QByteArray& payload);
+    void withBackend(std::function<void()> next);
+    void prepareBackend(std::function<void()> next);
+    void forward(const QByteArray& packets, quint8 command, const QByteArray& argument);
+    void finishCommand();
+    void releaseBackend();
+    void sendHandshake();
+    void sendPacket(const QByteArray& payload);
+    void sendOk();
+    void sendError(int code, const QString& sqlState, const QString& message);
+};
+
+#endif // MYSQL_PROXY_SESSION_H
@@ -0,0 +1,156 @@
+#include "mysql_status_poller.h"
+#include "../../utility/trace.h"
+#include <QDebug>
+#include <QDateTime>
+
+MySQLStatusPoller::MySQLStatusPoller(QObject *parent) : QObject(parent), client(this), pollTimer(this) {
+    connect(&pollTimer, &QTimer::timeout, this, &MySQLStatusPoller::poll);
+}
+
+void MySQLStatusPoller::validateSettings(const QJsonObject &settings) {
+    if (!settings.value("enabled").isBool()) {
+        throw std::runtime_error("Failed to configure MySQL status polling: enabled must be true or false.");
+    }
+    int interval = settings.value("interval_ms").toInt();
+    if (!settings.value("interval_ms").isDouble() || interval < minInterval || interval > maxInterval) {
+        QString errMsg = "Failed to configure MySQL status polling: interval_ms must be between " + QString::number(minInterval)
+                         + " and " + QString::number(maxInterval) + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!settings.value("user").isString() || settings.value("user").toString().isEmpty() || !settings.value("password").isString()) {
+        throw std::runtime_error("Failed to configure MySQL status polling: user and password must be strings.");
+    }
+}
+
+void MySQLStatusPoller::setSettings(const QJsonObject &settings) {
+    validateSettings(settings);
+    bool reconnect = settings.value("user") != this->settings.value("user") || settings.value("password") != this->settings.value("password");
+    this->settings = settings;
+    if (reconnect) {
+        client.close();
+    }
+    if (!settings.value("enabled").toBool()) {
+        stop();
+    } else if (pollTimer.isActive()) {
+        pollTimer.start(settings.value("interval_ms").toInt());
+    }
+}
+
+QJsonObject MySQLStatusPoller::getSettings() const {
+    return settings;
+}
+
+void MySQLStatusPoller::start(int port) {
+    if (!settings.value("enabled").toBool()) {
+        return;
+    }
+    if (this->port != port) {
+        client.close();
+    }
+    this->port = port;
+    previous.clear();
+    previousAt = 0;
+    pollTimer.start(settings.value("interval_ms").toInt());
+    poll();
+}
+
+void MySQLStatusPoller::stop() {
+    pollTimer.stop();
+    client.close();
+    pollInFlight = false;
+    previous.clear();
+    previousAt = 0;
+    publish(QJsonObject{{"available", false}});
+}
+
+bool MySQLStatusPoller::isActive() const {
+    return pollTimer.isActive();
+}
+
+QJsonObject MySQLStatusPoller::getSnapshot() const {
+    return snapshot;
+}
+
+void MySQLStatusPoller::poll() {
+    if (pollInFlight || port <= 0) {
+        return;
+    }
+    if (!client.isReady() && !client.isConnecting()) {
+        client.connectToServer("127.0.0.1", port, settings.value("user").toString(), settings.value("password").toString());
+    }
+    pollInFlight = true;
+    client.query("SHOW GLOBAL STATUS", [this](const MySQLResult& result) {
+        handleStatus(result);
+    });
+}
+
+void MySQLStatusPoller::handleStatus(const MySQLResult &result) {
+    TRACE_SCOPE("probe", "MySQLStatusPoller::handleStatus");
+    pollInFlight = false;
+    if (!pollTimer.isActive()) {
+        return;
+    }
+    if (!result.ok) {
+        previous.clear();
+        previousAt = 0;
+        publish(QJsonObject{{"available", false}, {"error", result.error}});
+        return;
+    }
+
+    QHash<QString, double> current;
+    for (const QStringList& row : result.rows) {
+        if (row.size() >= 2) {
+            bool ok = false;
+            double value = row.at(1).toDouble(&ok);
+            if (ok) {
+                current.insert(row.at(0), value);
+            }
+        }
+    }
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QJsonObject updated;
+    updated["available"] = true;
+    updated["server_version"] = client.serverVersion();
+    updated["uptime"] = current.value("Uptime");
+    updated["threads_running"] = current.value("Threads_running");
+    updated["threads_connected"] = current.value("Threads_connected");
+    updated["row_lock_current_waits"] = current.value("Innodb_row_lock_current_waits");
+
+    double readRequests = current.value("Innodb_buffer_pool_read_requests");
+    double diskReads = current.value("Innodb_buffer_pool_reads");
+    bool restarted = previous.isEmpty() || current.value("Uptime") < previous.value("Uptime") || current.value("Questions") < previous.value("Questions");
+    double elapsed = double(now - previousAt) / 1000.0;
+    if (!restarted && elapsed > 0.0) {
+        auto rate = [&](const QString& name) {
+            return qMax(0.0, current.value(name) - previous.value(name)) / elapsed;
+        };
+        double questions = qMax(0.0, current.value("Questions") - previous.value("Questions") - 1.0);
+        updated["qps"] = questions / elapsed;
+        updated["row_lock_waits_per_second"] = rate("Innodb_row_lock_waits");
+        updated["tmp_disk_tables_per_second"] = rate("Created_tmp_disk_tables");
+        updated["slow_queries_per_second"] = rate("Slow_queries");
+        double tmpTables = current.value("Created_tmp_tables") - previous.value("Created_tmp_tables");
+        double tmpDiskTables = current.value("Created_tmp_disk_tables") - previous.value("Created_tmp_disk_tables");
+        updated["tmp_tables_on_disk_ratio"] = tmpTables > 0.0 ? tmpDiskTables / tmpTables : 0.0;
+        double intervalRequests = readRequests - previous.value("Innodb_buffer_pool_read_requests");
+        if (intervalRequests > 0.0) {
+            readRequests = intervalRequests;
+            diskReads -= previous.value("Innodb_buffer_pool_reads");
+        }
+    }
+    updated["buffer_pool_hit_ratio"] = readRequests > 0.0 ? qBound(0.0, 1.0 - diskReads / readRequests, 1.0) : 1.0;
+    updated["sampled_at"] = now;
+
+    previous = current;
+    previousAt = now;
+    publish(updated);
+}
+
+void MySQLStatusPoller::publish(const QJsonObject &updated) {
+    if (updated == snapshot) {
+        return;
+    }
+    snapshot = updated;
+    emit snapshotUpdated(snapshot);
+}
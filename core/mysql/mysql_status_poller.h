@@ -0,0 +1,46 @@
+#ifndef MYSQL_STATUS_POLLER_H
+#define MYSQL_STATUS_POLLER_H
+
+#include "mysql_client.h"
+#include <QObject>
+#include <QJsonObject>
+#include <QHash>
+#include <QTimer>
+
+class MySQLStatusPoller : public QObject {
+    Q_OBJECT
+public:
+    static const int minInterval = 250;
+    static const int maxInterval = 60000;
+
+    explicit MySQLStatusPoller(QObject *parent = nullptr);
+
+    static void validateSettings(const QJsonObject& settings);
+    void setSettings(const QJsonObject& settings);
+    QJsonObject getSettings() const;
+    void start(int port);
+    void stop();
+    bool isActive() const;
+    QJsonObject getSnapshot() const;
+
+public slots:
+    void poll();
+
+signals:
+    void snapshotUpdated(const QJsonObject& snapshot);
+
+private:
+    MySQLClient client;
+    QTimer pollTimer;
+    QJsonObject settings{{"enabled", true}, {"interval_ms", 2000}, {"user", "root"}, {"password", ""}};
+    int port = 0;
+    bool pollInFlight = false;
+    QHash<QString, double> previous;
+    qint64 previousAt = 0;
+    QJsonObject snapshot{{"available", false}};
+
+    void handleStatus(const MySQLResult& result);
+    void publish(const QJsonObject& updated);
+};
+
+#endif // MYSQL_STATUS_POLLER_H
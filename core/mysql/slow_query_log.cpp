@@ -0,0 +1,224 @@
+#include "slow_query_log.h"
+#include <QDebug>
+#include <QFile>
+#include <QRegularExpression>
+#include <QRandomGenerator>
+#include <QDir>
+#include <algorithm>
+#include <cmath>
+
+SlowQueryLog SlowQueryLog::fromJson(const QJsonObject &settings) {
+    SlowQueryLog log;
+    log.enabled = settings.value("enabled").toBool(false);
+    log.longQueryTime = settings.value("long_query_time").toDouble(log.longQueryTime);
+    log.logQueriesNotUsingIndexes = settings.value("log_queries_not_using_indexes").toBool(false);
+    if (log.longQueryTime < 0.0 || log.longQueryTime > 3600.0) {
+        QString errMsg = "Invalid slow query log settings: long_query_time must be between 0 and 3600 seconds.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return log;
+}
+
+QJsonObject SlowQueryLog::toJson() const {
+    QJsonObject settings;
+    settings["enabled"] = enabled;
+    settings["long_query_time"] = longQueryTime;
+    settings["log_queries_not_using_indexes"] = logQueriesNotUsingIndexes;
+    return settings;
+}
+
+bool SlowQueryLog::isEnabled() const {
+    return enabled;
+}
+
+QStringList SlowQueryLog::serverArguments(const QString &logPath) const {
+    QStringList arguments;
+    if (!enabled) {
+        return arguments;
+    }
+    arguments << "--slow-query-log=ON"
+              << "--slow-query-log-file=" + QDir::toNativeSeparators(logPath)
+              << "--long-query-time=" + QString::number(longQueryTime, 'f', 6)
+              << "--log-output=FILE";
+    if (logQueriesNotUsingIndexes) {
+        arguments << "--log-queries-not-using-indexes=ON";
+    }
+    return arguments;
+}
+
+QStringList SlowQueryLog::orderings() {
+    return QStringList() << "total" << "count" << "avg" << "p95" << "max" << "rows_examined";
+}
+
+QString SlowQueryLog::fingerprint(const QString &statement) {
+    static const QRegularExpression blockCommentRegex(R"(/\*.*?\*/)", QRegularExpression::DotMatchesEverythingOption);
+    static const QRegularExpression lineCommentRegex(R"((?:--\s|#)[^\n]*)");
+    static const QRegularExpression singleQuotedRegex(R"('(?:[^'\\]|\\.|'')*')");
+    static const QRegularExpression doubleQuotedRegex(R"("(?:[^"\\]|\\.|"")*")");
+    static const QRegularExpression hexRegex(R"(\b0x[0-9a-fA-F]+\b)");
+    static const QRegularExpression numberRegex(R"((?<![\w.`])[-+]?\d+(?:\.\d+)?(?:[eE][-+]?\d+)?\b)");
+    static const QRegularExpression whitespaceRegex(R"(\s+)");
+    static const QRegularExpression inListRegex(R"(\bin\s*\(\s*\?(?:\s*,\s*\?)*\s*\))");
+    static const QRegularExpression valuesRegex(R"(\b(values?)\s*\([^()]*\)(?:\s*,\s*\([^()]*\))*)");
+
+    QString normalized = statement;
+    normalized.replace(blockCommentRegex, " ");
+    normalized.replace(singleQuotedRegex, "?");
+    normalized.replace(doubleQuotedRegex, "?");
+    normalized.replace(lineCommentRegex, " ");
+    normalized.replace(hexRegex, "?");
+    normalized.replace(numberRegex, "?");
+    normalized = normalized.toLower();
+    normalized.replace(whitespaceRegex, " ");
+    normalized = normalized.trimmed();
+    while (normalized.endsWith(';')) {
+        normalized.chop(1);
+        normalized = normalized.trimmed();
+    }
+    normalized.replace(inListRegex, "in(?+)");
+    normalized.replace(valuesRegex, "\\1(?+)");
+    return normalized;
+}
+
+void SlowQueryLog::read(const QString &logPath) {
+    QFile log(logPath);
+    if (!log.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    if (log.size() < offset) {
+        reset();
+    }
+    log.seek(offset);
+    while (!log.atEnd()) {
+        QByteArray line = log.readLine();
+        if (!line.endsWith('\n')) {
+            break;
+        }
+        offset += line.size();
+        parseLine(QString::fromUtf8(line).trimmed());
+    }
+    log.close();
+}
+
+void SlowQueryLog::parseLine(const QString &line) {
+    static const QRegularExpression metricsRegex(R"(^# Query_time:\s*([\d.]+)\s+Lock_time:\s*([\d.]+)\s+Rows_sent:\s*(\d+)\s+Rows_examined:\s*(\d+))");
+    static const QRegularExpression sessionRegex(R"(^(?:SET timestamp=\d+|use \S+);$)", QRegularExpression::CaseInsensitiveOption);
+
+    if (line.startsWith("#")) {
+        QRegularExpressionMatch match = metricsRegex.match(line);
+        if (match.hasMatch()) {
+            finishEntry();
+            inEntry = true;
+            queryTime = match.captured(1).toDouble();
+            lockTime = match.captured(2).toDouble();
+            rowsSent = match.captured(3).toLongLong();
+            rowsExamined = match.captured(4).toLongLong();
+        } else if (line.startsWith("# Time:") || line.startsWith("# User@Host:")) {
+            finishEntry();
+        }
+        return;
+    }
+    if (!inEntry || line.isEmpty()) {
+        return;
+    }
+    if (statement.isEmpty() && sessionRegex.match(line).hasMatch()) {
+        return;
+    }
+    statement += statement.isEmpty() ? line : "\n" + line;
+    if (line.endsWith(';')) {
+        finishEntry();
+    }
+}
+
+void SlowQueryLog::finishEntry() {
+    if (inEntry && !statement.isEmpty()) {
+        QString key = fingerprint(statement);
+        if (!key.isEmpty()) {
+            Stats& entry = stats[key];
+            entry.count++;
+            entry.totalTime += queryTime;
+            entry.totalLockTime += lockTime;
+            entry.rowsSent += rowsSent;
+            entry.rowsExamined += rowsExamined;
+            if (entry.samples.size() < maxSamples) {
+                entry.samples.append(queryTime);
+            } else {
+                qint64 slot = QRandomGenerator::global()->bounded(entry.count);
+                if (slot < maxSamples) {
+                    entry.samples[int(slot)] = queryTime;
+                }
+            }
+            if (entry.example.isEmpty() || queryTime >= entry.maxTime) {
+                entry.example = statement.left(maxExampleLength);
+            }
+            entry.maxTime = qMax(entry.maxTime, queryTime);
+            queryCount++;
+        }
+    }
+    inEntry = false;
+    statement.clear();
+}
+
+double SlowQueryLog::percentile(QVector<double> samples, double fraction) {
+    if (samples.isEmpty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    int index = qBound(0, int(std::ceil(fraction * samples.size())) - 1, samples.size() - 1);
+    return samples.at(index);
+}
+
+QJsonArray SlowQueryLog::top(int limit, const QString &orderBy) const {
+    if (!orderings().contains(orderBy)) {
+        QString errMsg = "Invalid slow query ordering " + orderBy + ": expected one of " + orderings().join(", ") + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QList<QJsonObject> rows;
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it) {
+        const Stats& entry = it.value();
+        QJsonObject row;
+        row["fingerprint"] = it.key();
+        row["count"] = entry.count;
+        row["total"] = entry.totalTime;
+        row["avg"] = entry.totalTime / double(entry.count);
+        row["p95"] = percentile(entry.samples, 0.95);
+        row["max"] = entry.maxTime;
+        row["lock_time"] = entry.totalLockTime;
+        row["rows_sent"] = entry.rowsSent;
+        row["rows_examined"] = entry.rowsExamined;
+        row["avg_rows_examined"] = double(entry.rowsExamined) / double(entry.count);
+        row["example"] = entry.example;
+        rows.append(row);
+    }
+    std::sort(rows.begin(), rows.end(), [&orderBy](const QJsonObject& left, const QJsonObject& right) {
+        double leftValue = left.value(orderBy).toDouble();
+        double rightValue = right.value(orderBy).toDouble();
+        if (leftValue != rightValue) {
+            return leftValue > rightValue;
+        }
+        return left.value("fingerprint").toString() < right.value("fingerprint").toString();
+    });
+
+    QJsonArray result;
+    for (int i = 0; i < rows.size() && (limit <= 0 || i < limit); ++i) {
+        result.append(rows.at(i));
+    }
+    return result;
+}
+
+qint64 SlowQueryLog::getQueryCount() const {
+    return queryCount;
+}
+
+int SlowQueryLog::getFingerprintCount() const {
+    return stats.size();
+}
+
+void SlowQueryLog::reset() {
+    offset = 0;
+    inEntry = false;
+    statement.clear();
+    queryCount = 0;
+    stats.clear();
+}
@@ -0,0 +1,62 @@
+#ifndef SLOW_QUERY_LOG_H
+#define SLOW_QUERY_LOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QVector>
+
+class SlowQueryLog {
+public:
+    static const int maxSamples = 512;
+    static const int maxExampleLength = 512;
+
+    static SlowQueryLog fromJson(const QJsonObject& settings);
+    QJsonObject toJson() const;
+
+    bool isEnabled() const;
+    QStringList serverArguments(const QString& logPath) const;
+
+    static QString fingerprint(const QString& statement);
+    static QStringList orderings();
+
+    void read(const QString& logPath);
+    QJsonArray top(int limit, const QString& orderBy) const;
+    qint64 getQueryCount() const;
+    int getFingerprintCount() const;
+    void reset();
+
+private:
+    struct Stats {
+        qint64 count = 0;
+        double totalTime = 0.0;
+        double maxTime = 0.0;
+        double totalLockTime = 0.0;
+        qint64 rowsSent = 0;
+        qint64 rowsExamined = 0;
+        QVector<double> samples;
+        QString example;
+    };
+
+    bool enabled = false;
+    double longQueryTime = 1.0;
+    bool logQueriesNotUsingIndexes = false;
+
+    qint64 offset = 0;
+    bool inEntry = false;
+    double queryTime = 0.0;
+    double lockTime = 0.0;
+    qint64 rowsSent = 0;
+    qint64 rowsExamined = 0;
+    QString statement;
+    qint64 queryCount = 0;
+    QHash<QString, Stats> stats;
+
+    void parseLine(const QString& line);
+    void finishEntry();
+    static double percentile(QVector<double> samples, double fraction);
+};
+
+#endif // SLOW_QUERY_LOG_H
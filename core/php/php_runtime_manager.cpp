@@ -0,0 +1,345 @@
+#include "php_runtime_manager.h"
+#include "../../utility/config_editor.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QUrl>
+#include <QVersionNumber>
+#include <algorithm>
+
+static const char *statusScriptPrefix = "/__webdevtoolkit";
+static const char *statusScriptName = "opcache_status.php";
+
+QJsonObject PHPRuntimeManager::defaultOpcacheSettings() {
+    QJsonObject defaults;
+    defaults["opcache_enabled"] = true;
+    defaults["memory_consumption"] = 128;
+    defaults["interned_strings_buffer"] = 16;
+    defaults["max_accelerated_files"] = 20000;
+    defaults["validate_timestamps"] = true;
+    defaults["revalidate_freq"] = 2;
+    defaults["jit"] = "tracing";
+    defaults["jit_buffer_size"] = 64;
+    defaults["preload"] = false;
+    defaults["preload_max_files"] = 200;
+    return defaults;
+}
+
+void PHPRuntimeManager::storeSettings(const QString &phpVersion, const QJsonObject &newSettings) {
+    settings[phpVersion] = newSettings;
+}
+
+QJsonObject PHPRuntimeManager::getSettings() const {
+    return settings;
+}
+
+QJsonObject PHPRuntimeManager::getSettings(const QString &phpVersion) const {
+    QJsonObject merged = defaultOpcacheSettings();
+    QJsonObject stored = settings[phpVersion].toObject();
+    for (auto it = stored.begin(); it != stored.end(); ++it) {
+        merged[it.key()] = it.value();
+    }
+    return merged;
+}
+
+QString PHPRuntimeManager::ensurePHPIni(const QDir &phpPath) {
+    QString iniPath = phpPath.filePath("php.ini");
+    if (QFile::exists(iniPath)) {
+        return iniPath;
+    }
+    const QStringList templates = QStringList() << "php.ini-development" << "php.ini-production";
+    for (const QString& iniTemplate : templates) {
+        if (QFile::exists(phpPath.filePath(iniTemplate)) && QFile::copy(phpPath.filePath(iniTemplate), iniPath)) {
+            return iniPath;
+        }
+    }
+    ConfigEditor::writeFile(iniPath, "[PHP]\n");
+    return iniPath;
+}
+
+QString PHPRuntimeManager::enableOpcacheExtension(const QString &content) {
+    QRegularExpression extensionRegex(R"(^[ \t]*;?[ \t]*zend_extension[ \t]*=[ \t]*"?(php_)?opcache(\.dll|\.so)?"?[ \t]*$)",
+                                      QRegularExpression::MultilineOption);
+    QString result = content;
+    if (extensionRegex.match(result).hasMatch()) {
+        result.replace(extensionRegex, "zend_extension=opcache");
+        return result;
+    }
+    QRegularExpression phpSectionRegex(R"(^\[PHP\][ \t]*$)", QRegularExpression::MultilineOption);
+    QRegularExpressionMatch match = phpSectionRegex.match(result);
+    if (match.hasMatch()) {
+        result.insert(match.capturedEnd(), "\nzend_extension=opcache");
+    } else {
+        result.prepend("zend_extension=opcache\n");
+    }
+    return result;
+}
+
+void PHPRuntimeManager::applyMySQLSocket(const QDir &phpPath, const QString &socketPath) {
+    if (!phpPath.exists() || (socketPath.isEmpty() && !QFile::exists(phpPath.filePath("php.ini")))) {
+        return;
+    }
+    QString iniPath = ensurePHPIni(phpPath);
+    QString original = ConfigEditor::readFile(iniPath);
+    QString content = original;
+    if (socketPath.isEmpty()) {
+        content = ConfigEditor::removeIniValue(content, "MySQLi", "mysqli.default_socket");
+        content = ConfigEditor::removeIniValue(content, "Pdo_mysql", "pdo_mysql.default_socket");
+    } else {
+        content = ConfigEditor::setIniValue(content, "MySQLi", "mysqli.default_socket", socketPath);
+        content = ConfigEditor::setIniValue(content, "Pdo_mysql", "pdo_mysql.default_socket", socketPath);
+    }
+    if (content != original) {
+        ConfigEditor::writeFile(iniPath, content);
+    }
+}
+
+void PHPRuntimeManager::applyOpcacheSettings(const QString &phpVersion, const QDir &phpPath, const QJsonObject &newSettings) {
+    if (!phpPath.exists()) {
+        QString errMsg = "Failed to configure OPcache: PHP " + phpVersion + " path " + phpPath.absolutePath() + " does not exist.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    settings[phpVersion] = newSettings;
+    QJsonObject effective = getSettings(phpVersion);
+    QVersionNumber version = QVersionNumber::fromString(phpVersion);
+    bool enabled = effective["opcache_enabled"].toBool();
+
+    QString iniPath = ensurePHPIni(phpPath);
+    QString original = ConfigEditor::readFile(iniPath);
+    QString content = enableOpcacheExtension(original);
+    content = ConfigEditor::setIniValue(content, "opcache", "opcache.enable", enabled ? "1" : "0");
+    content = ConfigEditor::setIniValue(content, "opcache", "opcache.enable_cli", "0");
+    content = ConfigEditor::setIniValue(content, "opcache", "opcache.memory_consumption", QString::number(effective["memory_consumption"].toInt()));
+    content = ConfigEditor::setIniValue(content, "opcache", "opcache.interned_strings_buffer", QString::number(effective["interned_strings_buffer"].toInt()));
+    content = ConfigEditor::setIniValue(content, "opcache", "opcache.max_accelerated_files", QString::number(effective["max_accelerated_files"].toInt()));
+    content = ConfigEditor::setIniValue(content, "opcache", "opcache.validate_timestamps", effective["validate_timestamps"].toBool() ? "1" : "0");
+    content = ConfigEditor::setIniValue(content, "opcache", "opcache.revalidate_freq", QString::number(effective["revalidate_freq"].toInt()));
+
+    if (version.majorVersion() >= 8) {
+        QString jit = effective["jit"].toString();
+        if (jit.isEmpty() || jit == "off" || jit == "disable") {
+            content = ConfigEditor::setIniValue(content, "opcache", "opcache.jit", "disable");
+            content = ConfigEditor::setIniValue(content, "opcache", "opcache.jit_buffer_size", "0");
+        } else {
+            content = ConfigEditor::setIniValue(content, "opcache", "opcache.jit", jit);
+            content = ConfigEditor::setIniValue(content, "opcache", "opcache.jit_buffer_size", QString::number(effective["jit_buffer_size"].toInt()) + "M");
+        }
+    }
+
+    QString preloadPath = QDir::currentPath() + "/conf/php/preload_" + phpVersion + ".php";
+#ifdef Q_OS_WIN
+    bool preloadSupported = false;
+#else
+    bool preloadSupported = version >= QVersionNumber(7, 4);
+#endif
+    if (preloadSupported && effective["preload"].toBool() && QFile::exists(preloadPath)) {
+        content = ConfigEditor::setIniValue(content, "opcache", "opcache.preload", "\"" + preloadPath + "\"");
+    } else {
+        content = ConfigEditor::removeIniValue(content, "opcache", "opcache.preload");
+    }
+
+    if (content == original) {
+        return;
+    }
+    ConfigEditor::writeFile(iniPath, content);
+    qDebug() << "OPcache settings applied for PHP" << phpVersion << "in" << iniPath;
+}
+
+QStringList PHPRuntimeManager::hottestFiles(const QDir &documentRoot, const QStringList &accessLogs, int maxFiles) {
+    QString rootPath = QFileInfo(documentRoot.absolutePath()).canonicalFilePath();
+    QHash<QString, int> hits;
+    QRegularExpression requestRegex(R"re("(?:GET|POST|HEAD) ([^ ?"]+))re");
+
+    for (const QString& logPath : accessLogs) {
+        QFile log(logPath);
+        if (!log.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            continue;
+        }
+        if (log.size() > 64 * 1024 * 1024) {
+            log.seek(log.size() - 64 * 1024 * 1024);
+            log.readLine();
+        }
+        while (!log.atEnd()) {
+            QRegularExpressionMatch match = requestRegex.match(QString::fromUtf8(log.readLine()));
+            if (!match.hasMatch()) {
+                continue;
+            }
+            QString requestPath = QUrl::fromPercentEncoding(match.captured(1).toUtf8());
+            if (requestPath.endsWith('/')) {
+                requestPath += "index.php";
+            }
+            if (!requestPath.endsWith(".php", Qt::CaseInsensitive)) {
+                continue;
+            }
+            hits[requestPath]++;
+        }
+    }
+
+    QList<QPair<int, QString>> ranked;
+    for (auto it = hits.begin(); it != hits.end(); ++it) {
+        ranked.append(qMakePair(it.value(), it.key()));
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<int, QString>& a, const QPair<int, QString>& b) {
+        return a.first > b.first;
+    });
+
+    QStringList files;
+    for (const auto& entry : ranked) {
+        QString filePath = QFileInfo(documentRoot.filePath(entry.second.mid(1))).canonicalFilePath();
+        if (!filePath.isEmpty() && filePath.startsWith(rootPath) && !files.contains(filePath)) {
+            files.append(filePath);
+        }
+        if (files.size() >= maxFiles) {
+            return files;
+        }
+    }
+
+    QList<QFileInfo> candidates;
+    QDirIterator it(documentRoot.absolutePath(), QStringList() << "*.php", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext() && candidates.size() < 20000) {
+        it.next();
+        candidates.append(it.fileInfo());
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const QFileInfo& a, const QFileInfo& b) {
+        return a.lastRead() > b.lastRead();
+    });
+    for (const QFileInfo& candidate : candidates) {
+        if (files.size() >= maxFiles) {
+            break;
+        }
+        QString filePath = candidate.canonicalFilePath();
+        if (!files.contains(filePath)) {
+            files.append(filePath);
+        }
+    }
+    return files;
+}
+
+QJsonObject PHPRuntimeManager::generatePreload(const QString &phpVersion, const QDir &phpPath, const QDir &documentRoot, const QStringList &accessLogs) {
+    QJsonObject effective = getSettings(phpVersion);
+    QStringList files = hottestFiles(documentRoot, accessLogs, effective["preload_max_files"].toInt());
+
+    QString preloadPath = QDir::currentPath() + "/conf/php/preload_" + phpVersion + ".php";
+    QDir().mkpath(QFileInfo(preloadPath).absolutePath());
+    QString script;
+    QTextStream out(&script);
+    out << "<?php\n";
+    out << "// Generated by WebDevToolkit for PHP " << phpVersion << " from " << documentRoot.absolutePath() << "\n";
+    out << "$files = [\n";
+    for (const QString& file : files) {
+        QString escaped = file;
+        escaped.replace("\\", "\\\\").replace("'", "\\'");
+        out << "    '" << escaped << "',\n";
+    }
+    out << "];\n";
+    out << "foreach ($files as $file) {\n";
+    out << "    if (is_file($file)) {\n";
+    out << "        @opcache_compile_file($file);\n";
+    out << "    }\n";
+    out << "}\n";
+    out.flush();
+    ConfigEditor::writeFile(preloadPath, script);
+
+    QJsonObject versionSettings = settings[phpVersion].toObject();
+    versionSettings["preload"] = true;
+    applyOpcacheSettings(phpVersion, phpPath, versionSettings);
+
+    QJsonObject result;
+    result["preload_script"] = preloadPath;
+    result["files"] = files.size();
+#ifdef Q_OS_WIN
+    result["preload_supported"] = false;
+#else
+    result["preload_supported"] = QVersionNumber::fromString(phpVersion) >= QVersionNumber(7, 4);
+#endif
+    return result;
+}
+
+QString PHPRuntimeManager::statusScriptUrlPrefix() {
+    return statusScriptPrefix;
+}
+
+QString PHPRuntimeManager::installStatusScript() {
+    QString statusDir = QDir::currentPath() + "/conf/php/status";
+    QString scriptPath = statusDir + "/" + statusScriptName;
+    if (QFile::exists(scriptPath)) {
+        return statusDir;
+    }
+    QDir().mkpath(statusDir);
+    ConfigEditor::writeFile(scriptPath,
+                            "<?php\n"
+                            "if (!in_array($_SERVER['REMOTE_ADDR'] ?? '', ['127.0.0.1', '::1'], true)) {\n"
+                            "    http_response_code(403);\n"
+                            "    exit;\n"
+                            "}\n"
+                            "header('Content-Type: application/json');\n"
+                            "$status = function_exists('opcache_get_status') ? opcache_get_status(false) : false;\n"
+                            "$configuration = function_exists('opcache_get_configuration') ? opcache_get_configuration() : false;\n"
+                            "echo json_encode([\n"
+                            "    'enabled' => $status !== false,\n"
+                            "    'status' => $status ?: null,\n"
+                            "    'directives' => $configuration ? $configuration['directives'] : null,\n"
+                            "]);\n");
+    return statusDir;
+}
+
+QByteArray PHPRuntimeManager::httpGet(int port, const QString &requestPath) {
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    if (!socket.waitForConnected(1000)) {
+        QString errMsg = "Failed to query OPcache status: cannot connect to port " + QString::number(port) + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    socket.write(QString("GET %1 HTTP/1.0\r\nHost: localhost\r\nConnection: close\r\n\r\n").arg(requestPath).toUtf8());
+    QByteArray response;
+    while (socket.state() == QAbstractSocket::ConnectedState && socket.waitForReadyRead(3000)) {
+        response += socket.readAll();
+    }
+    response += socket.readAll();
+
+    int headerEnd = response.indexOf("\r\n\r\n");
+    if (headerEnd < 0 || !response.startsWith("HTTP/1.") || response.mid(9, 3) != "200") {
+        QString errMsg = "Failed to query OPcache status: unexpected response from " + requestPath + "; restart the server if it was started before the status endpoint was installed.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return response.mid(headerEnd + 4);
+}
+
+QJsonObject PHPRuntimeManager::queryOpcacheStatus(int port) const {
+    QByteArray body = httpGet(port, QString("%1/%2").arg(statusScriptPrefix, statusScriptName));
+    QJsonParseError parseError;
+    QJsonObject response = QJsonDocument::fromJson(body, &parseError).object();
+    if (parseError.error != QJsonParseError::NoError) {
+        QString errMsg = "Failed to query OPcache status: status endpoint returned invalid JSON.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QJsonObject status = response["status"].toObject();
+    QJsonObject memory = status["memory_usage"].toObject();
+    QJsonObject statistics = status["opcache_statistics"].toObject();
+    QJsonObject internedStrings = status["interned_strings_usage"].toObject();
+    QJsonObject jit = status["jit"].toObject();
+
+    QJsonObject result;
+    result["enabled"] = response["enabled"].toBool() && status["opcache_enabled"].toBool();
+    result["hit_rate"] = statistics["opcache_hit_rate"].toDouble();
+    result["hits"] = statistics["hits"].toDouble();
+    result["misses"] = statistics["misses"].toDouble();
+    result["cached_scripts"] = statistics["num_cached_scripts"].toDouble();
+    result["memory_used"] = memory["used_memory"].toDouble();
+    result["memory_free"] = memory["free_memory"].toDouble();
+    result["memory_wasted"] = memory["wasted_memory"].toDouble();
+    result["interned_strings_used"] = internedStrings["used_memory"].toDouble();
+    result["interned_strings_free"] = internedStrings["free_memory"].toDouble();
+    result["jit_enabled"] = jit["enabled"].toBool();
+    result["jit_buffer_free"] = jit["buffer_free"].toDouble();
+    result["preload"] = status.contains("preload_statistics");
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef PHP_RUNTIME_MANAGER_H
+#define PHP_RUNTIME_MANAGER_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QDir>
+
+class PHPRuntimeManager {
+public:
+    static QJsonObject defaultOpcacheSettings();
+
+    void applyOpcacheSettings(const QString& phpVersion, const QDir& phpPath, const QJsonObject& settings);
+    void storeSettings(const QString& phpVersion, const QJsonObject& settings);
+    static void applyMySQLSocket(const QDir& phpPath, const QString& socketPath);
+    QJsonObject getSettings() const;
+    QJsonObject getSettings(const QString& phpVersion) const;
+    QJsonObject generatePreload(const QString& phpVersion, const QDir& phpPath, const QDir& documentRoot, const QStringList& accessLogs);
+    QJsonObject queryOpcacheStatus(int port) const;
+    static QString statusScriptUrlPrefix();
+    static QString installStatusScript();
+
+private:
+    QJsonObject settings;
+
+    static QString ensurePHPIni(const QDir& phpPath);
+    static QString enableOpcacheExtension(const QString& content);
+    static QStringList hottestFiles(const QDir& documentRoot, const QStringList& accessLogs, int maxFiles);
+    static QByteArray httpGet(int port, const QString& requestPath);
+};
+
+#endif // PHP_RUNTIME_MANAGER_H
@@ -0,0 +1,166 @@
+#include "port_allocator.h"
+#include "../../utility/trace.h"
+#include "../metrics/metrics_registry.h"
+#include <QDebug>
+#include <QTcpServer>
+#include <QRegularExpression>
+#include <QMutexLocker>
+
+PortAllocator::PortAllocator() {
+    ranges["apache"] = qMakePair(8080, 8179);
+    ranges["nginx"] = qMakePair(8180, 8279);
+    ranges["php_cgi"] = qMakePair(9000, 9099);
+    ranges["php_fpm"] = qMakePair(9100, 9199);
+    ranges["mysql"] = qMakePair(3306, 3405);
+    ranges["mysql_proxy"] = qMakePair(6033, 6132);
+    ranges["apache_tls"] = qMakePair(8443, 8542);
+    ranges["nginx_tls"] = qMakePair(8543, 8642);
+}
+
+void PortAllocator::setRanges(const QJsonObject &rangesConfig) {
+    QHash<QString, QPair<int, int>> updatedRanges;
+    static const QRegularExpression rangeRegex(R"(^(\d+)-(\d+)$)");
+    for (auto it = rangesConfig.begin(); it != rangesConfig.end(); ++it) {
+        QRegularExpressionMatch match = rangeRegex.match(it.value().toString());
+        int first = match.captured(1).toInt();
+        int last = match.captured(2).toInt();
+        if (!match.hasMatch() || first <= 0 || last > 65535 || first > last) {
+            QString errMsg = "Invalid port range for " + it.key() + ": expected \"<first>-<last>\" within 1-65535.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        updatedRanges[it.key()] = qMakePair(first, last);
+    }
+    QMutexLocker locker(&mutex);
+    for (auto it = updatedRanges.begin(); it != updatedRanges.end(); ++it) {
+        ranges[it.key()] = it.value();
+    }
+}
+
+QJsonObject PortAllocator::getRanges() const {
+    QMutexLocker locker(&mutex);
+    QJsonObject result;
+    for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+        result[it.key()] = QString::number(it.value().first) + "-" + QString::number(it.value().second);
+    }
+    return result;
+}
+
+bool PortAllocator::reserve(const QString &owner, int port) {
+    if (port <= 0 || port > 65535) {
+        return false;
+    }
+    QMutexLocker locker(&mutex);
+    if (reserved.test(size_t(port)) && owners.value(port) != owner) {
+        return false;
+    }
+    if (ports.contains(owner)) {
+        int previous = ports.value(owner);
+        reserved.reset(size_t(previous));
+        owners.remove(previous);
+    }
+    reserved.set(size_t(port));
+    owners[port] = owner;
+    ports[owner] = port;
+    return true;
+}
+
+void PortAllocator::release(const QString &owner) {
+    QMutexLocker locker(&mutex);
+    if (!ports.contains(owner)) {
+        return;
+    }
+    int port = ports.take(owner);
+    reserved.reset(size_t(port));
+    owners.remove(port);
+}
+
+bool PortAllocator::isReserved(int port) const {
+    if (port <= 0 || port > 65535) {
+        return false;
+    }
+    QMutexLocker locker(&mutex);
+    return reserved.test(size_t(port));
+}
+
+QString PortAllocator::ownerOf(int port) const {
+    QMutexLocker locker(&mutex);
+    return owners.value(port);
+}
+
+int PortAllocator::portOf(const QString &owner) const {
+    QMutexLocker locker(&mutex);
+    return ports.value(owner);
+}
+
+QJsonObject PortAllocator::getReservations() const {
+    QMutexLocker locker(&mutex);
+    QJsonObject result;
+    for (auto it = ports.begin(); it != ports.end(); ++it) {
+        result[it.key()] = it.value();
+    }
+    return result;
+}
+
+PortAllocator::Conflict PortAllocator::check(const QString &owner, int port, bool checkSystem) const {
+    if (port <= 0 || port > 65535) {
+        return Conflict::InvalidPort;
+    }
+    {
+        QMutexLocker locker(&mutex);
+        if (reserved.test(size_t(port)) && owners.value(port) != owner) {
+            return Conflict::InApp;
+        }
+    }
+    if (checkSystem && !isPortBindable(port)) {
+        return Conflict::System;
+    }
+    return Conflict::None;
+}
+
+int PortAllocator::findFreePort(const QString &rangeName) const {
+    QPair<int, int> range;
+    {
+        QMutexLocker locker(&mutex);
+        if (!ranges.contains(rangeName)) {
+            QString errMsg = "Failed to find a free port: port range " + rangeName + " is not configured.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        range = ranges.value(rangeName);
+    }
+    for (int port = range.first; port <= range.second; ++port) {
+        if (!isReserved(port) && isPortBindable(port)) {
+            return port;
+        }
+    }
+    QString errMsg = "Failed to find a free port: no free port left in range " + rangeName + ".";
+    throw std::runtime_error(errMsg.toStdString());
+}
+
+bool PortAllocator::isPortBindable(int port) {
+    TRACE_SCOPE_ARG("probe", "PortAllocator::isPortBindable", "port", QString::number(port));
+    MetricsTimer probeTimer("webdevtoolkit_port_probe_duration_seconds", {{"method", "bind"}});
+    // Apache and Nginx listen on all interfaces while the MySQL proxy and the
+    // endpoints listen on loopback, so a port is only usable if both binds succeed.
+    const QList<QHostAddress> addresses = QList<QHostAddress>() << QHostAddress(QHostAddress::AnyIPv4) << QHostAddress(QHostAddress::LocalHost);
+    for (const QHostAddress& address : addresses) {
+        QTcpServer server;
+        if (!server.listen(address, quint16(port))) {
+            return false;
+        }
+        server.close();
+    }
+    return true;
+}
+
+QString PortAllocator::conflictName(Conflict conflict) {
+    switch (conflict) {
+    case Conflict::InvalidPort:
+        return "invalid";
+    case Conflict::InApp:
+        return "in_app";
+    case Conflict::System:
+        return "system";
+    default:
+        return "none";
+    }
+}
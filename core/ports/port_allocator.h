@@ -0,0 +1,46 @@
+#ifndef PORT_ALLOCATOR_H
+#define PORT_ALLOCATOR_H
+
+#include <QString>
+#include <QHash>
+#include <QPair>
+#include <QJsonObject>
+#include <QMutex>
+#include <bitset>
+
+class PortAllocator {
+public:
+    enum class Conflict {
+        None,
+        InvalidPort,
+        InApp,
+        System
+    };
+
+    PortAllocator();
+
+    void setRanges(const QJsonObject& ranges);
+    QJsonObject getRanges() const;
+
+    bool reserve(const QString& owner, int port);
+    void release(const QString& owner);
+    bool isReserved(int port) const;
+    QString ownerOf(int port) const;
+    int portOf(const QString& owner) const;
+    QJsonObject getReservations() const;
+
+    Conflict check(const QString& owner, int port, bool checkSystem) const;
+    int findFreePort(const QString& rangeName) const;
+
+    static bool isPortBindable(int port);
+    static QString conflictName(Conflict conflict);
+
+private:
+    std::bitset<65536> reserved;
+    QHash<int, QString> owners;
+    QHash<QString, int> ports;
+    QHash<QString, QPair<int, int>> ranges;
+    mutable QMutex mutex;
+};
+
+#endif // PORT_ALLOCATOR_H
@@ -1,6 +1,11 @@
 #include "apache_server.h"
 #include "../../utility/process_manager.h"
+#include "../../utility/task_pool.h"
+#include "../../utility/config_editor.h"
+#include "../tuning/apache_tuning_profile.h"
+#include "../../utility/asset_precompressor.h"
 #include "../config/configuration_manager.h"
+#include "../php/php_runtime_manager.h"
 #include "../singleton/server_manager.h"
 #include <QDebug>
 #include <QFile>
@@ -9,6 +14,7 @@
 #include <QMainWindow>
 #include <QTextStream>
 #include <QMessageBox>
+#include <QVersionNumber>
 
 ApacheServer::ApacheServer() : process(new QProcess()), lastCrashed(true) {
 
@@ -19,8 +25,20 @@ ApacheServer::~ApacheServer() {
 
 bool ApacheServer::start() {
     if(!ServerManager::getInstance().getFacade().getServerState("apache")) {
-        if (ServerManager::getInstance().getFacade().isPortFree(port)) {
+        if (ServerManager::getInstance().getFacade().isPortFree(port) && (!tls.isEnabled() || ServerManager::getInstance().getFacade().isPortFree(tls.getPort()))) {
             qDebug() << "Starting Apache server version" << version << "with PHP version" << phpVersion << "on port" << port;
+            if (renderedConfigDir.isEmpty()) {
+                writeOpcacheStatusAlias();
+            }
+            if (documentRootMirror.isEnabled() && renderedConfigDir.isEmpty()) {
+                writeDocumentRoot(documentRootMirror.start(documentRoot.absolutePath()));
+            } else if (documentRootMirror.isEnabled()) {
+                qWarning() << "The document root mirror is not applied while Apache uses the pre-rendered configuration in" << renderedConfigDir;
+            }
+            QStringList arguments;
+            if (!renderedConfigDir.isEmpty()) {
+                arguments << "-d" << path.absolutePath() << "-f" << QDir(renderedConfigDir).absoluteFilePath("httpd.conf");
+            }
             QString command;
 #ifdef Q_OS_WIN
             command = QDir::toNativeSeparators(path.filePath("bin/httpd.exe"));
@@ -32,19 +50,26 @@ bool ApacheServer::start() {
             command = path + "/bin/apachectl start";
 #endif
             process = new QProcess();
+            isolation.prepare(process, cgroup.prepare());
             lastCrashed = true;
-            process->start(command);
+            process->start(command, arguments);
             if (!process->waitForStarted(5000)) {
                 QString errMsg = "Failed to start Apache server process:" + process->errorString();
                 qWarning() << errMsg;
+                releaseDocumentRootMirror();
                 throw std::runtime_error(errMsg.toStdString());
             } else {
+                isolation.apply(process);
+                cgroup.attach(process->processId());
+                TaskPool::releaseToMainThread(process);
                 qDebug() << "Apache server started successfully.";
                 QMainWindow::connect(process, &QProcess::finished, this, [this](){
                     if(lastCrashed){
                         emit errorOccurred("The server was stopped", "The Apache server was stopped due to an internal server error. For more detailed information, please check the Apache error log.");
                     }
                 });
+                runningProcessId = process->processId();
+                startedAt = QDateTime::currentMSecsSinceEpoch();
                 emit updateState("apache", true);
                 apacheProcessID = process->processId();
                 return true;
@@ -69,13 +94,19 @@ bool ApacheServer::stop() {
         QString command = QString("%1/bin/apachectl stop").arg(path);
 #endif
         lastCrashed = false;
+        TaskPool::pullToCurrentThread(process);
         process->kill();
         if (!process->waitForFinished(5000)) {
             QString errMsg = "Failed to stop Apache server process:" + process->errorString();
             qWarning() << errMsg;
             throw std::runtime_error(errMsg.toStdString());
         } else {
+            cgroup.kill();
+            TaskPool::releaseToMainThread(process);
+            releaseDocumentRootMirror();
             qDebug() << "Apache server stopped successfully.";
+            runningProcessId = 0;
+            startedAt = 0;
             emit updateState("apache", false);
             return true;
         }
@@ -96,6 +127,13 @@ QJsonObject ApacheServer::getConfig() const {
     config["version"] = version;
     config["php_version"] = phpVersion;
     config["document_root"] = documentRoot.absolutePath();
+    config["document_root_mirror"] = documentRootMirror.getSettings();
+    config["tuning_profiles"] = tuningProfiles;
+    config["expected_concurrency"] = expectedConcurrency;
+    config["precompressed_assets"] = precompressedAssets;
+    config["tls"] = tls.toJson();
+    config["isolation"] = isolation.toJson();
+    config["cgroup"] = cgroup.getSettings();
     return config;
 }
 
@@ -229,7 +267,7 @@ bool ApacheServer::setPort(int port, QStringList &validationErrors) {
     apacheConfFile.resize(0);
     confStream << config;
     apacheConfFile.close();
-
+    return true;
 }
 
 bool ApacheServer::setDocumentRoot(const QString &newPath) {
@@ -238,8 +276,36 @@ bool ApacheServer::setDocumentRoot(const QString &newPath) {
         return false;
     }
 
-    QString oldPath = documentRoot.absolutePath();
     this->documentRoot.setPath(dir.absolutePath());
+    if (documentRootMirror.isActive()) {
+        documentRootMirror.start(documentRoot.absolutePath());
+    }
+    writeDocumentRoot(getServedRoot());
+    return true;
+}
+
+bool ApacheServer::setDocumentRootMirror(const QJsonObject &settings) {
+    documentRootMirror.setSettings(settings);
+    return true;
+}
+
+QJsonObject ApacheServer::getDocumentRootMirrorStats() const {
+    return documentRootMirror.getStats();
+}
+
+QString ApacheServer::getServedRoot() const {
+    QString mirrorPath = documentRootMirror.getMirrorPath();
+    return mirrorPath.isEmpty() ? documentRoot.absolutePath() : mirrorPath;
+}
+
+void ApacheServer::releaseDocumentRootMirror() {
+    if (documentRootMirror.isActive()) {
+        documentRootMirror.stop();
+        writeDocumentRoot(getServedRoot());
+    }
+}
+
+void ApacheServer::writeDocumentRoot(const QString &root) {
     QFile file(path.filePath("conf/httpd.conf"));
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QString errMsg = "Unable to open the file for reading";
@@ -259,13 +325,13 @@ bool ApacheServer::setDocumentRoot(const QString &newPath) {
         if (docRootLine) {
             match = reDirectory.match(line);
             if (match.hasMatch()) {
-                line = QString("<Directory \"%1\">").arg(documentRoot.absolutePath());
+                line = QString("<Directory \"%1\">").arg(root);
             }
             docRootLine = false;
         } else {
             match = reDocRoot.match(line);
             if (match.hasMatch()) {
-                line = QString("DocumentRoot \"%1\"").arg(documentRoot.absolutePath());
+                line = QString("DocumentRoot \"%1\"").arg(root);
                 docRootLine = true;
             }
         }
@@ -281,10 +347,75 @@ bool ApacheServer::setDocumentRoot(const QString &newPath) {
     QTextStream out(&file);
     out << content;
     file.close();
-    return true;
+    if (precompressedAssets) {
+        writePrecompressedRules();
+    }
+    if (tls.isEnabled()) {
+        writeTlsConfig();
+    }
+}
+
+
+
+QMap<QString, QString> ApacheServer::listConfigFiles() const {
+    QMap<QString, QString> files;
+    QDir toolkitDir(QDir::currentPath() + "/conf/apache");
+    const QStringList includes = toolkitDir.entryList(QStringList() << "*.conf", QDir::Files);
+    for (const QString& name : includes) {
+        files[name] = toolkitDir.absoluteFilePath(name);
+    }
+    files["httpd.conf"] = path.filePath("conf/httpd.conf");
+    return files;
+}
+
+QStringList ApacheServer::getConfigFiles() const {
+    return listConfigFiles().values();
+}
+
+WorkspaceProfileStore::ConfigSet ApacheServer::renderConfigSet() const {
+    QByteArray placeholder = (WorkspaceProfileStore::directoryPlaceholder + "/").toUtf8();
+    QString toolkitDir = QDir::currentPath() + "/conf/apache/";
+    WorkspaceProfileStore::ConfigSet configSet;
+    const QMap<QString, QString> files = listConfigFiles();
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        QFile file(it.value());
+        if (!file.open(QIODevice::ReadOnly)) {
+            QString errMsg = "Failed to render Apache configuration: cannot read " + it.value() + ".";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        QByteArray content = file.readAll();
+        content.replace("../../../conf/apache/", placeholder);
+        content.replace(QDir::fromNativeSeparators(toolkitDir).toUtf8(), placeholder);
+        if (documentRootMirror.isActive()) {
+            content.replace(documentRootMirror.getMirrorPath().toUtf8(), documentRoot.absolutePath().toUtf8());
+        }
+        configSet[it.key()] = content;
+    }
+    return configSet;
 }
 
+void ApacheServer::useRenderedConfig(const QString &configDir, const QJsonObject &state) {
+    if (!configDir.isEmpty()) {
+        setVersion(state.value("version").toString());
+        const QJsonObject phpVersions = ConfigurationManager::getInstance().getConfiguration()["servers"].toObject()["apache"].toObject()["php_versions"].toObject();
+        phpVersion = state.value("php_version").toString(phpVersion);
+        phpPath.setPath(phpVersions.value(phpVersion).toString(phpPath.absolutePath()));
+        port = state.value("port").toInt(port);
+        documentRoot.setPath(state.value("document_root").toString(documentRoot.absolutePath()));
+        tuningProfiles = state.value("tuning_profiles").toObject(tuningProfiles);
+        expectedConcurrency = state.value("expected_concurrency").toInt(expectedConcurrency);
+        precompressedAssets = state.value("precompressed_assets").toBool(precompressedAssets);
+        tls = TlsSettings::fromJson(state.value("tls").toObject(), tls.getPort());
+        isolation = ProcessIsolation::fromJson(state.value("isolation").toObject());
+        cgroup.setSettings(state.value("cgroup").toObject());
+        documentRootMirror.setSettings(state.value("document_root_mirror").toObject());
+    }
+    renderedConfigDir = configDir;
+}
 
+QString ApacheServer::getRenderedConfigDir() const {
+    return renderedConfigDir;
+}
 
 bool ApacheServer::isRunning() const {
     if (process && process->state() == QProcess::Running) {
@@ -294,3 +425,283 @@ bool ApacheServer::isRunning() const {
     }
 }
 
+
+QString ApacheServer::getExecutablePath() const {
+#ifdef Q_OS_WIN
+    return QDir::toNativeSeparators(path.filePath("bin/httpd.exe"));
+#else
+    return path.filePath("bin/httpd");
+#endif
+}
+
+bool ApacheServer::validateConfiguration(QString &output) const {
+    QString command = getExecutablePath();
+    if (!QFileInfo::exists(command)) {
+        output = "Apache executable not found: " + command;
+        qWarning() << "Skipping Apache configuration test:" << output;
+        return true;
+    }
+    QProcess testProcess;
+    testProcess.setWorkingDirectory(path.absolutePath());
+    testProcess.setProcessChannelMode(QProcess::MergedChannels);
+    testProcess.start(command, QStringList() << "-t" << "-f" << path.filePath("conf/httpd.conf"));
+    if (!testProcess.waitForFinished(10000)) {
+        output = "Apache configuration test did not finish: " + testProcess.errorString();
+        testProcess.kill();
+        return false;
+    }
+    output = QString::fromLocal8Bit(testProcess.readAll()).trimmed();
+    return testProcess.exitStatus() == QProcess::NormalExit && testProcess.exitCode() == 0;
+}
+
+bool ApacheServer::setTuningProfile(const QString &profileName, int expectedConcurrency) {
+    if (!ApacheTuningProfile::availableProfiles().contains(profileName)) {
+        QString errMsg = "Failed to set Apache tuning profile: profile " + profileName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QString apacheConfigPath = path.filePath("conf/httpd.conf");
+    QString original = ConfigEditor::readFile(apacheConfigPath);
+    QString content = original;
+    QString tuningInclude = QString("Include ../../../conf/apache/tuning_%1.conf").arg(version);
+    QRegularExpression tuningIncludeRegex(R"(\n?Include\s+../../../conf/apache/tuning_[^\s]+\.conf)");
+    content.remove(tuningIncludeRegex);
+
+    QString tuningPath = QDir::currentPath() + "/conf/apache/tuning_" + version + ".conf";
+    bool hadTuning = QFile::exists(tuningPath);
+    QString previousTuning = hadTuning ? ConfigEditor::readFile(tuningPath) : QString();
+    QString tuning = previousTuning;
+
+    if (profileName != "none") {
+        ApacheTuningProfile profile = ApacheTuningProfile::derive(profileName, version, expectedConcurrency);
+        tuning = profile.render();
+
+        QRegularExpression phpIncludeRegex(R"(Include\s+../../../conf/apache/php\d+\.\d+\.\d+_fcgid\.conf)");
+        QRegularExpressionMatch match = phpIncludeRegex.match(content);
+        if (match.hasMatch()) {
+            content.insert(match.capturedEnd(), "\n" + tuningInclude);
+        } else {
+            content += "\n" + tuningInclude + "\n";
+        }
+    }
+
+    // The tuning file is only read through the Include line, so a changed
+    // profile has to pass httpd -t even when httpd.conf itself is unchanged.
+    bool tuningChanged = tuning != previousTuning;
+    if (tuningChanged) {
+        ConfigEditor::writeFile(tuningPath, tuning);
+    }
+    try {
+        applyConfiguration(original, content, "tuning profile " + profileName, tuningChanged);
+    } catch (const std::runtime_error &) {
+        if (hadTuning) {
+            ConfigEditor::writeFile(tuningPath, previousTuning);
+        } else {
+            QFile::remove(tuningPath);
+        }
+        throw;
+    }
+    tuningProfiles[version] = profileName;
+    this->expectedConcurrency = expectedConcurrency;
+    return true;
+}
+
+bool ApacheServer::setTuningProfiles(const QJsonObject &profiles, int expectedConcurrency) {
+    tuningProfiles = profiles;
+    this->expectedConcurrency = expectedConcurrency;
+    if (profiles.contains(version) && profiles[version].isString()) {
+        return setTuningProfile(profiles[version].toString(), expectedConcurrency);
+    }
+    return true;
+}
+
+QString ApacheServer::getTuningProfile() const {
+    return tuningProfiles[version].toString("none");
+}
+
+QString ApacheServer::setConfInclude(const QString &content, const QString &confName, bool enabled) const {
+    QString result = content;
+    QString includeLine = "Include ../../../conf/apache/" + confName;
+    QRegularExpression includeRegex("\\n?Include\\s+../../../conf/apache/" + QRegularExpression::escape(confName));
+    result.remove(includeRegex);
+    if (!enabled) {
+        return result;
+    }
+    QRegularExpression phpIncludeRegex(R"(Include\s+../../../conf/apache/php\d+\.\d+\.\d+_fcgid\.conf)");
+    QRegularExpressionMatch match = phpIncludeRegex.match(result);
+    if (match.hasMatch()) {
+        result.insert(match.capturedEnd(), "\n" + includeLine);
+    } else {
+        result += "\n" + includeLine + "\n";
+    }
+    return result;
+}
+
+void ApacheServer::applyConfiguration(const QString &original, const QString &updated, const QString &description, bool includesChanged) {
+    if (updated == original && !includesChanged) {
+        return;
+    }
+    QString apacheConfigPath = path.filePath("conf/httpd.conf");
+    if (updated != original) {
+        ConfigEditor::writeFile(apacheConfigPath, updated);
+    }
+    QString output;
+    if (!validateConfiguration(output)) {
+        if (updated != original) {
+            ConfigEditor::writeFile(apacheConfigPath, original);
+        }
+        QString errMsg = "Failed to apply Apache " + description + ": configuration test failed.\n" + output;
+        qWarning() << errMsg;
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    qDebug() << "Apache" << description << "applied.";
+}
+
+void ApacheServer::writePrecompressedRules() const {
+    QString extensions = AssetPrecompressor::compressibleExtensions().join('|');
+    QString content;
+    QTextStream out(&content);
+    out << "# Generated by WebDevToolkit: serve precompressed .br/.gz siblings\n\n";
+    out << "<Directory \"" << getServedRoot() << "\">\n";
+    out << "    <IfModule mod_rewrite.c>\n";
+    out << "        RewriteEngine On\n";
+    out << "        RewriteCond %{HTTP:Accept-Encoding} br\n";
+    out << "        RewriteCond %{REQUEST_FILENAME}.br -f\n";
+    out << "        RewriteRule ^(.+\\.(" << extensions << "))$ $1.br [L]\n";
+    out << "        RewriteCond %{HTTP:Accept-Encoding} gzip\n";
+    out << "        RewriteCond %{REQUEST_FILENAME}.gz -f\n";
+    out << "        RewriteRule ^(.+\\.(" << extensions << "))$ $1.gz [L]\n";
+    out << "        RewriteRule \\.css\\.(gz|br)$ - [T=text/css,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "        RewriteRule \\.m?js\\.(gz|br)$ - [T=application/javascript,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "        RewriteRule \\.svg\\.(gz|br)$ - [T=image/svg+xml,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "        RewriteRule \\.(json|map)\\.(gz|br)$ - [T=application/json,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "        RewriteRule \\.html?\\.(gz|br)$ - [T=text/html,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "        RewriteRule \\.xml\\.(gz|br)$ - [T=application/xml,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "        RewriteRule \\.txt\\.(gz|br)$ - [T=text/plain,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "        RewriteRule \\.wasm\\.(gz|br)$ - [T=application/wasm,E=no-gzip:1,E=no-brotli:1]\n";
+    out << "    </IfModule>\n";
+    out << "    <IfModule mod_headers.c>\n";
+    out << "        <FilesMatch \"\\.(" << extensions << ")\\.gz$\">\n";
+    out << "            Header set Content-Encoding gzip\n";
+    out << "            Header append Vary Accept-Encoding\n";
+    out << "        </FilesMatch>\n";
+    out << "        <FilesMatch \"\\.(" << extensions << ")\\.br$\">\n";
+    out << "            Header set Content-Encoding br\n";
+    out << "            Header append Vary Accept-Encoding\n";
+    out << "        </FilesMatch>\n";
+    out << "    </IfModule>\n";
+    out << "</Directory>\n";
+    out.flush();
+    ConfigEditor::writeFile(QDir::currentPath() + "/conf/apache/precompressed.conf", content);
+}
+
+void ApacheServer::writeOpcacheStatusAlias() {
+    QString statusDir = PHPRuntimeManager::installStatusScript();
+    QString content;
+    QTextStream out(&content);
+    out << "# Generated by WebDevToolkit: OPcache status endpoint served outside the document root\n\n";
+    out << "Alias \"" << PHPRuntimeManager::statusScriptUrlPrefix() << "\" \"" << statusDir << "\"\n";
+    out << "<Directory \"" << statusDir << "\">\n";
+    out << "    Options +ExecCGI\n";
+    out << "    Require local\n";
+    out << "</Directory>\n";
+    out.flush();
+    QString confPath = QDir::currentPath() + "/conf/apache/opcache_status.conf";
+    if (!QFile::exists(confPath) || ConfigEditor::readFile(confPath) != content) {
+        ConfigEditor::writeFile(confPath, content);
+    }
+    QString original = ConfigEditor::readFile(path.filePath("conf/httpd.conf"));
+    applyConfiguration(original, setConfInclude(original, "opcache_status.conf", true), "OPcache status alias");
+}
+
+bool ApacheServer::setPrecompressedAssets(bool enabled) {
+    QString original = ConfigEditor::readFile(path.filePath("conf/httpd.conf"));
+    if (enabled) {
+        writePrecompressedRules();
+    }
+    applyConfiguration(original, setConfInclude(original, "precompressed.conf", enabled),
+                       enabled ? "precompressed asset rules" : "precompressed asset rule removal");
+    precompressedAssets = enabled;
+    return true;
+}
+
+bool ApacheServer::hasHttp2Module() const {
+    return QVersionNumber::fromString(version) >= QVersionNumber(2, 4, 17) && QFile::exists(path.filePath("modules/mod_http2.so"));
+}
+
+void ApacheServer::writeTlsConfig() const {
+    bool http2Available = hasHttp2Module();
+    if (tls.usesHttp2() && !http2Available) {
+        qWarning() << "Apache" << version << "has no mod_http2; TLS listeners will serve HTTP/1.1 only.";
+    }
+    ConfigEditor::writeFile(QDir::currentPath() + "/conf/apache/tls.conf",
+                            tls.renderApacheConfig(version, tlsCertificates, getServedRoot(), http2Available));
+}
+
+bool ApacheServer::setTls(const TlsSettings &settings, const QList<TlsCertificate> &certificates) {
+    QString tlsConfPath = QDir::currentPath() + "/conf/apache/tls.conf";
+    QString original = ConfigEditor::readFile(path.filePath("conf/httpd.conf"));
+
+    TlsSettings previousTls = tls;
+    QList<TlsCertificate> previousCertificates = tlsCertificates;
+    QString previousTlsConf = QFile::exists(tlsConfPath) ? ConfigEditor::readFile(tlsConfPath) : QString();
+    try {
+        tls = settings;
+        tlsCertificates = certificates;
+        if (settings.isEnabled()) {
+            writeTlsConfig();
+        }
+        applyConfiguration(original, setConfInclude(original, "tls.conf", settings.isEnabled()),
+                           settings.isEnabled() ? "TLS listeners" : "TLS listener removal");
+    } catch (const std::runtime_error&) {
+        tls = previousTls;
+        tlsCertificates = previousCertificates;
+        if (!previousTlsConf.isEmpty()) {
+            ConfigEditor::writeFile(tlsConfPath, previousTlsConf);
+        }
+        throw;
+    }
+    return true;
+}
+
+QJsonObject ApacheServer::getTls() const {
+    return tls.toJson();
+}
+
+bool ApacheServer::setIsolation(const QJsonObject &settings) {
+    isolation = ProcessIsolation::fromJson(settings);
+    return true;
+}
+
+QJsonObject ApacheServer::getIsolation() const {
+    return isolation.toJson();
+}
+
+bool ApacheServer::setCgroup(const QJsonObject &settings) {
+    cgroup.setSettings(settings);
+    return true;
+}
+
+QJsonObject ApacheServer::getResourceUsage() const {
+    return cgroup.readUsage();
+}
+
+qint64 ApacheServer::getProcessId() const {
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+    if (runningProcessId != 0) {
+        QFile pidFile(path.filePath("logs/httpd.pid"));
+        if (pidFile.open(QIODevice::ReadOnly)) {
+            qint64 pid = pidFile.readAll().trimmed().toLongLong();
+            if (pid > 0) {
+                return pid;
+            }
+        }
+    }
+#endif
+    return runningProcessId;
+}
+
+QDateTime ApacheServer::getStartTime() const {
+    qint64 started = startedAt;
+    return started > 0 ? QDateTime::fromMSecsSinceEpoch(started) : QDateTime();
+}
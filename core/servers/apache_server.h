@@ -3,8 +3,15 @@
 
 #include "qglobal.h"
 #include "../interfaces/iserver.h"
+#include "../../utility/process_isolation.h"
+#include "../../utility/cgroup_manager.h"
+#include "../../utility/document_root_mirror.h"
+#include "../tls/tls_settings.h"
+#include "../config/workspace_profile_store.h"
 #include <QProcess>
 #include <QMap>
+#include <QDateTime>
+#include <atomic>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -31,6 +38,25 @@ public:
     bool setPHPVersion(const QString& phpVersion) override;
     bool setPort(int port, QStringList &validationErrors) override;
     bool setDocumentRoot(const QString& newPath);
+    bool setDocumentRootMirror(const QJsonObject& settings);
+    QJsonObject getDocumentRootMirrorStats() const;
+    QStringList getConfigFiles() const;
+    WorkspaceProfileStore::ConfigSet renderConfigSet() const;
+    void useRenderedConfig(const QString& configDir, const QJsonObject& state);
+    QString getRenderedConfigDir() const;
+    bool setTuningProfile(const QString& profileName, int expectedConcurrency);
+    bool setTuningProfiles(const QJsonObject& profiles, int expectedConcurrency);
+    QString getTuningProfile() const;
+    bool validateConfiguration(QString &output) const;
+    bool setPrecompressedAssets(bool enabled);
+    bool setTls(const TlsSettings& settings, const QList<TlsCertificate>& certificates);
+    QJsonObject getTls() const;
+    bool setIsolation(const QJsonObject& settings);
+    QJsonObject getIsolation() const;
+    bool setCgroup(const QJsonObject& settings);
+    QJsonObject getResourceUsage() const;
+    qint64 getProcessId() const;
+    QDateTime getStartTime() const;
 
 signals:
     void updateState(const QString& serverName, bool isRunning);
@@ -46,8 +72,31 @@ private:
     QDir path;
     QDir phpPath;
     QDir documentRoot;
+    DocumentRootMirror documentRootMirror{"apache"};
+    QString renderedConfigDir;
+    QJsonObject tuningProfiles;
+    int expectedConcurrency = 50;
+    bool precompressedAssets = false;
+    TlsSettings tls;
+    QList<TlsCertificate> tlsCertificates;
+    ProcessIsolation isolation;
+    CgroupManager cgroup{"apache"};
     QProcess* process;
+    std::atomic<qint64> runningProcessId{0};
+    std::atomic<qint64> startedAt{0};
     bool lastCrashed;
+
+    QString getExecutablePath() const;
+    QString getServedRoot() const;
+    QMap<QString, QString> listConfigFiles() const;
+    void writeDocumentRoot(const QString& root);
+    void releaseDocumentRootMirror();
+    QString setConfInclude(const QString& content, const QString& confName, bool enabled) const;
+    void applyConfiguration(const QString& original, const QString& updated, const QString& description, bool includesChanged = false);
+    void writePrecompressedRules() const;
+    void writeOpcacheStatusAlias();
+    bool hasHttp2Module() const;
+    void writeTlsConfig() const;
 };
 
 #endif // APACHE_SERVER_H
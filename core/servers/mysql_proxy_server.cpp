@@ -0,0 +1,211 @@
+#include "mysql_proxy_server.h"
+#include "../singleton/server_manager.h"
+#include <QDebug>
+#include <QThread>
+#include <QCoreApplication>
+
+MySQLProxyServer::MySQLProxyServer() : listener(this), pool(this) {
+    pool.setSettings(settings);
+    connect(&listener, &QTcpServer::newConnection, this, &MySQLProxyServer::onNewConnection);
+    workerThread.setObjectName("mysql-proxy");
+    moveToThread(&workerThread);
+    workerThread.start();
+}
+
+MySQLProxyServer::~MySQLProxyServer() {
+    invoke([this]() {
+        listener.close();
+        closeSessions();
+        pool.close();
+    });
+    workerThread.quit();
+    workerThread.wait();
+}
+
+bool MySQLProxyServer::start() {
+    ServerFacade& facade = ServerManager::getInstance().getFacade();
+    if (facade.getServerState("mysql_proxy")) {
+        qWarning() << "Failed to start MySQL proxy: the proxy is already running.";
+        return false;
+    }
+    if (!facade.isPortFree(port)) {
+        emit displayServerWarning("The MySQL proxy port is already in use.");
+        return false;
+    }
+    QJsonObject mysqlConfig = facade.getServerConfiguration("mysql");
+    int backendPort = mysqlConfig["port"].toInt();
+    backendVersion = mysqlConfig["version"].toString();
+    bool listening = false;
+    QString errorString;
+    invoke([this, backendPort, &listening, &errorString]() {
+        listening = listener.listen(QHostAddress::LocalHost, quint16(port));
+        if (listening) {
+            pool.open(backendPort);
+        } else {
+            errorString = listener.errorString();
+        }
+    });
+    if (!listening) {
+        QString errMsg = "Failed to start MySQL proxy: " + errorString;
+        qWarning() << errMsg;
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    qDebug() << "MySQL proxy listening on port" << port << "for MySQL on port" << backendPort;
+    startedAt = QDateTime::currentMSecsSinceEpoch();
+    emit updateState("mysql_proxy", true);
+    return true;
+}
+
+bool MySQLProxyServer::stop() {
+    qDebug() << "Stopping MySQL proxy...";
+    if (!ServerManager::getInstance().getFacade().getServerState("mysql_proxy")) {
+        qWarning() << "Failed to stop MySQL proxy: the proxy is not running.";
+        return false;
+    }
+    invoke([this]() {
+        listener.close();
+        closeSessions();
+        pool.close();
+    });
+    qDebug() << "MySQL proxy stopped successfully.";
+    startedAt = 0;
+    emit updateState("mysql_proxy", false);
+    return true;
+}
+
+QJsonObject MySQLProxyServer::getConfig() const {
+    QJsonObject config = settings;
+    config["port"] = port;
+    return config;
+}
+
+bool MySQLProxyServer::setVersion(const QString &version) {
+    Q_UNUSED(version);
+    throw std::runtime_error("Failed to set MySQL proxy version: the proxy is built into WebDevToolkit and has no installable versions.");
+}
+
+QString MySQLProxyServer::getVersion() const {
+    return QCoreApplication::applicationVersion();
+}
+
+QDir MySQLProxyServer::getPath() const {
+    return QDir(QDir::currentPath());
+}
+
+bool MySQLProxyServer::isRunning() const {
+    return startedAt > 0;
+}
+
+bool MySQLProxyServer::setPort(int newPort, QStringList &validationErrors) {
+    if (!(newPort > 0 && newPort <= 65535)) {
+        validationErrors.append("InvalidPortValue");
+        return false;
+    }
+    if (port == newPort) {
+        return false;
+    }
+    if (!ServerManager::getInstance().getFacade().isPortFreeInApp(newPort)) {
+        validationErrors.append("PortOccupied");
+        return false;
+    }
+    port = newPort;
+    return true;
+}
+
+void MySQLProxyServer::validateSettings(const QJsonObject &settings) {
+    if (!settings.value("enabled").isBool()) {
+        throw std::runtime_error("Failed to configure the MySQL proxy: enabled must be true or false.");
+    }
+    int poolSize = settings.value("pool_size").toInt();
+    if (!settings.value("pool_size").isDouble() || poolSize < 1 || poolSize > maxPoolSize) {
+        QString errMsg = "Failed to configure the MySQL proxy: pool_size must be between 1 and " + QString::number(maxPoolSize) + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    int minIdle = settings.value("min_idle").toInt();
+    if (!settings.value("min_idle").isDouble() || minIdle < 0 || minIdle > poolSize) {
+        throw std::runtime_error("Failed to configure the MySQL proxy: min_idle must be between 0 and pool_size.");
+    }
+    int idleTimeout = settings.value("idle_timeout_ms").toInt();
+    if (!settings.value("idle_timeout_ms").isDouble() || idleTimeout < 1000 || idleTimeout > 3600000) {
+        throw std::runtime_error("Failed to configure the MySQL proxy: idle_timeout_ms must be between 1000 and 3600000.");
+    }
+    int acquireTimeout = settings.value("acquire_timeout_ms").toInt();
+    if (!settings.value("acquire_timeout_ms").isDouble() || acquireTimeout < 100 || acquireTimeout > 60000) {
+        throw std::runtime_error("Failed to configure the MySQL proxy: acquire_timeout_ms must be between 100 and 60000.");
+    }
+    if (!settings.value("user").isString() || settings.value("user").toString().isEmpty() || !settings.value("password").isString()) {
+        throw std::runtime_error("Failed to configure the MySQL proxy: user and password must be strings.");
+    }
+}
+
+bool MySQLProxyServer::setSettings(const QJsonObject &settings) {
+    QJsonObject updated = this->settings;
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        if (it.key() != "port") {
+            updated[it.key()] = it.value();
+        }
+    }
+    validateSettings(updated);
+    if (updated == this->settings) {
+        return false;
+    }
+    invoke([this, updated]() {
+        this->settings = updated;
+        pool.setSettings(updated);
+    });
+    return true;
+}
+
+QJsonObject MySQLProxyServer::getSettings() const {
+    return settings;
+}
+
+QJsonObject MySQLProxyServer::getPoolStats() const {
+    QJsonObject stats;
+    invoke([this, &stats]() {
+        stats = pool.getStats();
+        int pinned = 0;
+        for (const MySQLProxySession* session : sessions) {
+            if (session->isPinned()) {
+                ++pinned;
+            }
+        }
+        stats["clients"] = sessions.size();
+        stats["pinned_clients"] = pinned;
+        stats["clients_total"] = double(sessionsTotal);
+    });
+    stats["port"] = port;
+    return stats;
+}
+
+QDateTime MySQLProxyServer::getStartTime() const {
+    qint64 started = startedAt;
+    return started > 0 ? QDateTime::fromMSecsSinceEpoch(started) : QDateTime();
+}
+
+void MySQLProxyServer::onNewConnection() {
+    while (listener.hasPendingConnections()) {
+        QTcpSocket* socket = listener.nextPendingConnection();
+        QString version = pool.serverVersion().isEmpty() ? backendVersion : pool.serverVersion();
+        MySQLProxySession* session = new MySQLProxySession(socket, &pool, settings, version, ++nextConnectionId, this);
+        sessions.append(session);
+        ++sessionsTotal;
+        connect(session, &MySQLProxySession::finished, this, [this](MySQLProxySession* finished) {
+            sessions.removeAll(finished);
+            finished->deleteLater();
+        });
+    }
+}
+
+void MySQLProxyServer::closeSessions() {
+    const QList<MySQLProxySession*> open = sessions;
+    for (MySQLProxySession* session : open) {
+        session->close();
+    }
+}
+
+void MySQLProxyServer::invoke(std::function<void()> task) const {
+    // Proxy traffic runs on its own thread; callers block only until the task has run there.
+    QMetaObject::invokeMethod(const_cast<MySQLProxyServer*>(this), task,
+                              thread() == QThread::currentThread() ? Qt::DirectConnection : Qt::BlockingQueuedConnection);
+}
@@ -0,0 +1,59 @@
+#ifndef MYSQL_PROXY_SERVER_H
+#define MYSQL_PROXY_SERVER_H
+
+#include "../interfaces/iserver.h"
+#include "../mysql/mysql_connection_pool.h"
+#include "../mysql/mysql_proxy_session.h"
+#include <QObject>
+#include <QTcpServer>
+#include <QThread>
+#include <QList>
+#include <QDateTime>
+#include <atomic>
+#include <functional>
+
+class MySQLProxyServer : public QObject, public IServer {
+    Q_OBJECT
+public:
+    static const int maxPoolSize = 256;
+
+    MySQLProxyServer();
+    ~MySQLProxyServer();
+    bool start() override;
+    bool stop() override;
+    QJsonObject getConfig() const override;
+    bool setVersion(const QString& version) override;
+    QString getVersion() const override;
+    QDir getPath() const override;
+    bool isRunning() const override;
+    bool setPort(int port, QStringList &validationErrors) override;
+    static void validateSettings(const QJsonObject& settings);
+    bool setSettings(const QJsonObject& settings);
+    QJsonObject getSettings() const;
+    QJsonObject getPoolStats() const;
+    QDateTime getStartTime() const;
+
+signals:
+    void updateState(const QString& serverName, bool isRunning);
+    void errorOccurred(const QString& errorTitle, const QString& errorMessage);
+    void displayServerWarning(const QString& errorMessage);
+
+private:
+    int port = 6033;
+    QJsonObject settings{{"enabled", false}, {"pool_size", 8}, {"min_idle", 2}, {"idle_timeout_ms", 60000},
+                         {"acquire_timeout_ms", 5000}, {"user", "root"}, {"password", ""}};
+    QThread workerThread;
+    QTcpServer listener;
+    MySQLConnectionPool pool;
+    QList<MySQLProxySession*> sessions;
+    QString backendVersion;
+    quint32 nextConnectionId = 0;
+    quint64 sessionsTotal = 0;
+    std::atomic<qint64> startedAt{0};
+
+    void onNewConnection();
+    void closeSessions();
+    void invoke(std::function<void()> task) const;
+};
+
+#endif // MYSQL_PROXY_SERVER_H
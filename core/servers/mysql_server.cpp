@@ -1,5 +1,9 @@
 #include "mysql_server.h"
 #include "../../utility/process_manager.h"
+#include "../../utility/task_pool.h"
+#include "../../utility/snapshot_manager.h"
+#include "../../utility/config_editor.h"
+#include "../../utility/socket_transport.h"
 #include "../config/configuration_manager.h"
 #include "../singleton/server_manager.h"
 #include <QDebug>
@@ -19,8 +23,15 @@ MySQLServer::~MySQLServer() {
 
 bool MySQLServer::start() {
     if(!ServerManager::getInstance().getFacade().getServerState("mysql")) {
+        if (!getSocketPath().isEmpty() && !SocketTransport::isSocketFree(getSocketPath())) {
+            emit displayServerWarning("The MySQL socket is already in use.");
+            return false;
+        }
         if (ServerManager::getInstance().getFacade().isPortFree(port)) {
             qDebug() << "Starting MySQL server version" << version << "on port" << port;
+            if (renderedConfigDir.isEmpty()) {
+                writeSocketSettings();
+            }
             QString command;
 #ifdef Q_OS_WIN
 
@@ -32,20 +43,38 @@ bool MySQLServer::start() {
 #elif defined(Q_OS_LINUX) || defined(Q_OS_MAC)
 
 #endif
+            QStringList arguments = slowQueryLog.serverArguments(getSlowQueryLogPath());
+            QString socketPath = getSocketPath();
+            if (!socketPath.isEmpty()) {
+                SocketTransport::createSocketDirectory(socketPath);
+                arguments << "--socket=" + socketPath;
+            }
+            if (!renderedConfigDir.isEmpty()) {
+                arguments.prepend("--defaults-file=" + QDir::toNativeSeparators(QDir(renderedConfigDir).absoluteFilePath("my.ini")));
+            }
+            if (slowQueryLog.isEnabled()) {
+                QDir().mkpath(QFileInfo(getSlowQueryLogPath()).absolutePath());
+            }
             process = new QProcess();
+            isolation.prepare(process, cgroup.prepare());
             lastCrashed = true;
-            process->start(command);
+            process->start(command, arguments);
             if (!process->waitForStarted(5000)) {
                 QString errMsg = "Failed to start MySQL server process:" + process->errorString();
                 qWarning() << errMsg;
                 throw std::runtime_error(errMsg.toStdString());
             } else {
+                isolation.apply(process);
+                cgroup.attach(process->processId());
+                TaskPool::releaseToMainThread(process);
                 qDebug() << "MySQL server started successfully.";
                 QMainWindow::connect(process, &QProcess::finished, this, [this](){
                     if(lastCrashed){
                         emit errorOccurred("The server was stopped", "The MySQL server was stopped due to an internal server error. For more detailed information, please check the MySQL error log.");
                     }
                 });
+                runningProcessId = process->processId();
+                startedAt = QDateTime::currentMSecsSinceEpoch();
                 emit updateState("mysql", true);
                 mysqlProcessID = process->processId();
                 return true;
@@ -70,15 +99,20 @@ bool MySQLServer::stop() {
 
 #endif
         lastCrashed = false;
+        TaskPool::pullToCurrentThread(process);
         process->kill();
         if (!process->waitForFinished(5000)) {
             QString errMsg = "Failed to stop MySQL server process:" + process->errorString();
             qWarning() << errMsg;
             throw std::runtime_error(errMsg.toStdString());
         } else {
+            cgroup.kill();
             qDebug() << "MySQL server stopped successfully.";
+            runningProcessId = 0;
+            startedAt = 0;
             emit updateState("mysql", false);
             delete process;
+            process = nullptr;
             return true;
         }
     } else{
@@ -95,7 +129,11 @@ bool MySQLServer::killChildProcesses() const {
 QJsonObject MySQLServer::getConfig() const {
     QJsonObject config;
     config["port"] = port;
+    config["transport"] = transport;
     config["version"] = version;
+    config["isolation"] = isolation.toJson();
+    config["cgroup"] = cgroup.getSettings();
+    config["slow_query_log"] = slowQueryLog.toJson();
     return config;
 }
 
@@ -120,6 +158,37 @@ bool MySQLServer::setVersion(const QString& version) {
     }
 }
 
+QStringList MySQLServer::getConfigFiles() const {
+    return QStringList() << path.filePath("my.ini");
+}
+
+WorkspaceProfileStore::ConfigSet MySQLServer::renderConfigSet() const {
+    WorkspaceProfileStore::ConfigSet configSet;
+    QFile file(path.filePath("my.ini"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        QString errMsg = "Failed to render MySQL configuration: cannot read " + file.fileName() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    configSet["my.ini"] = file.readAll();
+    return configSet;
+}
+
+void MySQLServer::useRenderedConfig(const QString &configDir, const QJsonObject &state) {
+    if (!configDir.isEmpty()) {
+        setVersion(state.value("version").toString());
+        port = state.value("port").toInt(port);
+        transport = state.value("transport").toString(transport);
+        isolation = ProcessIsolation::fromJson(state.value("isolation").toObject());
+        cgroup.setSettings(state.value("cgroup").toObject());
+        slowQueryLog = SlowQueryLog::fromJson(state.value("slow_query_log").toObject());
+    }
+    renderedConfigDir = configDir;
+}
+
+QString MySQLServer::getRenderedConfigDir() const {
+    return renderedConfigDir;
+}
+
 QString MySQLServer::getVersion() const {
     return version;
 }
@@ -181,6 +250,8 @@ bool MySQLServer::setPort(int newPort, QStringList &validationErrors) {
         QMessageBox::critical(nullptr, "Configuration failed", e.what());
     }
     qDebug() << "port completed here!";
+    // my.ini already carries the new port even when phpMyAdmin could not follow.
+    return true;
 }
 
 bool MySQLServer::isRunning() const {
@@ -235,3 +306,133 @@ bool MySQLServer::setPHPMyAdminPort(int newPort, QStringList &validationErrors)
         throw std::runtime_error(errMsg.toStdString());
     }
 }
+
+bool MySQLServer::setTransport(const QString &transport) {
+    SocketTransport::validate(transport);
+    if (transport == "unix" && !SocketTransport::isUnixSupported()) {
+        qWarning() << "Unix sockets are not available on this platform; MySQL keeps using TCP.";
+    }
+    bool changed = this->transport != transport;
+    this->transport = transport;
+    writeSocketSettings();
+    return changed;
+}
+
+QString MySQLServer::getSocketPath() const {
+    if (SocketTransport::effective(transport) == "unix") {
+        return SocketTransport::socketPath("mysql.sock");
+    }
+    return QString();
+}
+
+void MySQLServer::writeSocketSettings() const {
+    QString mysqlConfPath = path.filePath("my.ini");
+    if (!QFile::exists(mysqlConfPath)) {
+        QString errMsg = "Failed to set MySQL transport: MySQL configuration file not found: " + mysqlConfPath;
+        qWarning() << errMsg;
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QString original = ConfigEditor::readFile(mysqlConfPath);
+    QString config = original;
+    QString socketPath = getSocketPath();
+    for (const QString& section : QStringList() << "mysqld" << "client") {
+        if (socketPath.isEmpty()) {
+            config = ConfigEditor::removeIniValue(config, section, "socket");
+        } else {
+            config = ConfigEditor::setIniValue(config, section, "socket", socketPath);
+        }
+    }
+    if (config != original) {
+        ConfigEditor::writeFile(mysqlConfPath, config);
+    }
+}
+
+QString MySQLServer::getDataPath() const {
+    return path.absolutePath() + "/data";
+}
+
+QString MySQLServer::getSnapshotsPath() const {
+    return path.absolutePath() + "/snapshots";
+}
+
+QStringList MySQLServer::getSnapshots() const {
+    return SnapshotManager::listSnapshots(getSnapshotsPath());
+}
+
+QJsonObject MySQLServer::createSnapshot(const QString &name) {
+    if (ServerManager::getInstance().getFacade().getServerState("mysql") || isRunning()) {
+        QString errMsg = "Failed to create MySQL snapshot: stop the MySQL server before taking a snapshot.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    qDebug() << "Creating MySQL snapshot" << name << "of" << getDataPath();
+    return SnapshotManager::createSnapshot(getDataPath(), getSnapshotsPath(), name);
+}
+
+QJsonObject MySQLServer::restoreSnapshot(const QString &name) {
+    if (ServerManager::getInstance().getFacade().getServerState("mysql") || isRunning()) {
+        QString errMsg = "Failed to restore MySQL snapshot: stop the MySQL server before restoring a snapshot.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    qDebug() << "Restoring MySQL snapshot" << name << "into" << getDataPath();
+    return SnapshotManager::restoreSnapshot(getSnapshotsPath(), name, getDataPath());
+}
+
+void MySQLServer::deleteSnapshot(const QString &name) {
+    SnapshotManager::deleteSnapshot(getSnapshotsPath(), name);
+}
+
+bool MySQLServer::setIsolation(const QJsonObject &settings) {
+    isolation = ProcessIsolation::fromJson(settings);
+    return true;
+}
+
+QJsonObject MySQLServer::getIsolation() const {
+    return isolation.toJson();
+}
+
+bool MySQLServer::setCgroup(const QJsonObject &settings) {
+    cgroup.setSettings(settings);
+    return true;
+}
+
+QJsonObject MySQLServer::getResourceUsage() const {
+    return cgroup.readUsage();
+}
+
+qint64 MySQLServer::getProcessId() const {
+    return runningProcessId;
+}
+
+QDateTime MySQLServer::getStartTime() const {
+    qint64 started = startedAt;
+    return started > 0 ? QDateTime::fromMSecsSinceEpoch(started) : QDateTime();
+}
+
+bool MySQLServer::setSlowQueryLog(const QJsonObject &settings) {
+    SlowQueryLog updated = SlowQueryLog::fromJson(settings);
+    bool changed = updated.toJson() != slowQueryLog.toJson();
+    if (changed) {
+        slowQueryLog = updated;
+    }
+    return changed;
+}
+
+QJsonObject MySQLServer::getSlowQueryLog() const {
+    return slowQueryLog.toJson();
+}
+
+QString MySQLServer::getSlowQueryLogPath() const {
+    return path.absolutePath() + "/logs/slow_query.log";
+}
+
+QJsonObject MySQLServer::getSlowQueries(int limit, const QString &orderBy) {
+    slowQueryLog.read(getSlowQueryLogPath());
+    QJsonObject result;
+    result["enabled"] = slowQueryLog.isEnabled();
+    result["log_file"] = getSlowQueryLogPath();
+    result["queries"] = slowQueryLog.getQueryCount();
+    result["fingerprints"] = slowQueryLog.getFingerprintCount();
+    result["order_by"] = orderBy;
+    result["top"] = slowQueryLog.top(limit, orderBy);
+    return result;
+}
@@ -3,8 +3,14 @@
 
 #include "qglobal.h"
 #include "../interfaces/iserver.h"
+#include "../../utility/process_isolation.h"
+#include "../../utility/cgroup_manager.h"
+#include "../mysql/slow_query_log.h"
+#include "../config/workspace_profile_store.h"
 #include <QProcess>
 #include <QMap>
+#include <QDateTime>
+#include <atomic>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -26,6 +32,26 @@ public:
     bool isRunning() const override;
     bool setPort(int port, QStringList &validationErrors) override;
     bool setPHPMyAdminPort(int newPort, QStringList &validationErrors);
+    bool setTransport(const QString& transport);
+    QString getSocketPath() const;
+    QStringList getSnapshots() const;
+    QJsonObject createSnapshot(const QString& name);
+    QJsonObject restoreSnapshot(const QString& name);
+    void deleteSnapshot(const QString& name);
+    bool setIsolation(const QJsonObject& settings);
+    QJsonObject getIsolation() const;
+    bool setCgroup(const QJsonObject& settings);
+    QJsonObject getResourceUsage() const;
+    bool setSlowQueryLog(const QJsonObject& settings);
+    QJsonObject getSlowQueryLog() const;
+    QJsonObject getSlowQueries(int limit, const QString& orderBy);
+    QString getSlowQueryLogPath() const;
+    QStringList getConfigFiles() const;
+    WorkspaceProfileStore::ConfigSet renderConfigSet() const;
+    void useRenderedConfig(const QString& configDir, const QJsonObject& state);
+    QString getRenderedConfigDir() const;
+    qint64 getProcessId() const;
+    QDateTime getStartTime() const;
 
 signals:
     void updateState(const QString& serverName, bool isRunning);
@@ -34,12 +60,23 @@ signals:
 
 private:
     int port;
+    QString transport = "tcp";
     QString version;
     QDir path;
+    ProcessIsolation isolation;
+    CgroupManager cgroup{"mysql"};
+    SlowQueryLog slowQueryLog;
+    QString renderedConfigDir;
     QProcess* process;
+    std::atomic<qint64> runningProcessId{0};
+    std::atomic<qint64> startedAt{0};
     bool lastCrashed;
     int mysqlProcessID;
     int phpMyAdminPort;
+
+    QString getDataPath() const;
+    QString getSnapshotsPath() const;
+    void writeSocketSettings() const;
 };
 
 #endif // MYSQL_SERVER_H
@@ -1,6 +1,11 @@
 #include "nginx_server.h"
 #include "../../utility/process_manager.h"
+#include "../../utility/task_pool.h"
+#include "../../utility/config_editor.h"
+#include "../../utility/socket_transport.h"
+#include "../tuning/nginx_tuning_profile.h"
 #include "../config/configuration_manager.h"
+#include "../php/php_runtime_manager.h"
 #include "../singleton/server_manager.h"
 #include <QDebug>
 #include <QFile>
@@ -18,8 +23,20 @@ NginxServer::~NginxServer() {
 
 bool NginxServer::start() {
     if(!ServerManager::getInstance().getFacade().getServerState("nginx")) {
-        if (ServerManager::getInstance().getFacade().isPortFree(port)) {
+        if (ServerManager::getInstance().getFacade().isPortFree(port) && (!tls.isEnabled() || ServerManager::getInstance().getFacade().isPortFree(tls.getPort()))) {
             qDebug() << "Starting Nginx server version" << version << "with PHP version" << phpVersion << "on port" << port;
+            if (renderedConfigDir.isEmpty()) {
+                writeOpcacheStatusLocation();
+            }
+            if (documentRootMirror.isEnabled() && renderedConfigDir.isEmpty()) {
+                writeDocumentRoot(documentRootMirror.start(documentRoot.absolutePath()));
+            } else if (documentRootMirror.isEnabled()) {
+                qWarning() << "The document root mirror is not applied while Nginx uses the pre-rendered configuration in" << renderedConfigDir;
+            }
+            QStringList arguments;
+            if (!renderedConfigDir.isEmpty()) {
+                arguments << "-p" << path.absolutePath() + "/" << "-c" << QDir(renderedConfigDir).absoluteFilePath("nginx.conf");
+            }
             QString command;
 #ifdef Q_OS_WIN
             command = QDir::toNativeSeparators(path.filePath("nginx.exe"));
@@ -30,16 +47,23 @@ bool NginxServer::start() {
 
 #endif
             nginxProcess = new QProcess();
+            isolation.prepare(nginxProcess, cgroup.prepare());
             nginxProcess->setWorkingDirectory(QDir::toNativeSeparators(path.absolutePath()));
             lastCrashed = true;
-            nginxProcess->start(command);
+            nginxProcess->start(command, arguments);
             if (!nginxProcess->waitForStarted(5000)) {
                 QString errMsg = "Failed to start Nginx server process:" + nginxProcess->errorString();
                 qWarning() << errMsg;
+                releaseDocumentRootMirror();
                 throw std::runtime_error(errMsg.toStdString());
             } else {
+                isolation.apply(nginxProcess);
+                cgroup.attach(nginxProcess->processId());
+                TaskPool::releaseToMainThread(nginxProcess);
                 qDebug() << "Nginx server started successfully.";
                 if(startPHPCGI()){
+                    runningProcessId = nginxProcess->processId();
+                    startedAt = QDateTime::currentMSecsSinceEpoch();
                     emit updateState("nginx", true);
                 }
                 QMainWindow::connect(nginxProcess, &QProcess::finished, this, [this](){
@@ -66,14 +90,20 @@ bool NginxServer::stop() {
         Process_manager::killChildProcessesRecursively(nginxProcess->processId());
 #endif
         lastCrashed = false;
+        TaskPool::pullToCurrentThread(nginxProcess);
         nginxProcess->kill();
         if (!nginxProcess->waitForFinished(5000)) {
             QString errMsg = "Failed to stop Nginx server process:" + nginxProcess->errorString();
             qWarning() << errMsg;
             throw std::runtime_error(errMsg.toStdString());
         }
+        TaskPool::releaseToMainThread(nginxProcess);
         qDebug() << "Nginx server stopped successfully.";
         if(stopPHPCGI()){
+            cgroup.kill();
+            releaseDocumentRootMirror();
+            runningProcessId = 0;
+            startedAt = 0;
             emit updateState("nginx", false);
         }
         return true;
@@ -89,12 +119,17 @@ bool NginxServer::stopPHPCGI(){
         qWarning() << errMsg;
         throw std::runtime_error(errMsg.toStdString());
     }
+    TaskPool::pullToCurrentThread(phpCGIProcess);
     phpCGIProcess->kill();
     if (!phpCGIProcess->waitForFinished(5000)) {
         QString errMsg = "Failed to stop PHP-CGI process:" + phpCGIProcess->errorString();
         qWarning() << errMsg;
         throw std::runtime_error(errMsg.toStdString());
     }
+    TaskPool::releaseToMainThread(phpCGIProcess);
+    if (getPHPCGIAddress().startsWith('/')) {
+        QFile::remove(getPHPCGIAddress());
+    }
     qDebug() << "PHP-CGI stopped successfully.";
     return true;
 }
@@ -106,7 +141,15 @@ QJsonObject NginxServer::getConfig() const {
     config["php_version"] = phpVersion;
     config["php_fpm_port"] = phpFPMPort;
     config["php_cgi_port"] = phpCGIport;
+    config["transport"] = transport;
     config["document_root"] = documentRoot.absolutePath();
+    config["document_root_mirror"] = documentRootMirror.getSettings();
+    config["performance_profile"] = performanceProfile;
+    config["precompressed_assets"] = precompressedAssets;
+    config["fastcgi_cache"] = fastCGICache.toJson();
+    config["tls"] = tls.toJson();
+    config["isolation"] = isolation.toJson();
+    config["cgroup"] = cgroup.getSettings();
     return config;
 }
 
@@ -157,7 +200,19 @@ bool NginxServer::setPHPVersion(const QString& phpVersion) {
 }
 
 bool NginxServer::setPHPFPMport(int port, QStringList &validationErrors){
-    //in process
+    if (this->phpFPMPort == port) {
+        return false;
+    }
+    if(!(port >= 0 && port <= 65535)){
+        validationErrors.append("InvalidPHPFPMPortValue");
+        return false;
+    }
+    if(port != 0 && !ServerManager::getInstance().getFacade().isPortFreeInApp(port)) {
+        validationErrors.append("PHPFPMPortOccupied");
+        return false;
+    }
+    this->phpFPMPort = port;
+    return true;
 }
 
 QDir NginxServer::getPHPPath() const {
@@ -177,26 +232,58 @@ bool NginxServer::setPHPCGIPort(int port, QStringList &validationErrors) {
         return false;
     }
     this->phpCGIport = port;
+    writeFastCGIPass();
+    return true;
+}
+
+bool NginxServer::setTransport(const QString &transport) {
+    SocketTransport::validate(transport);
+    if (transport == "unix" && !SocketTransport::isUnixSupported()) {
+        qWarning() << "Unix sockets are not available on this platform; Nginx keeps using TCP for PHP-CGI.";
+    }
+    if (this->transport == transport) {
+        return false;
+    }
+    this->transport = transport;
+    writeFastCGIPass();
+    return true;
+}
+
+QString NginxServer::getPHPCGIAddress() const {
+    if (SocketTransport::effective(transport) == "unix") {
+        return SocketTransport::socketPath("php-cgi.sock");
+    }
+    return "127.0.0.1:" + QString::number(phpCGIport);
+}
+
+void NginxServer::writeFastCGIPass() {
     QString phpCGIconfPath = QDir::toNativeSeparators(QCoreApplication::applicationDirPath() + "/conf/nginx/php_cgi.conf");
     if (!QFile::exists(phpCGIconfPath)) {
-        QString errMsg = "Failed to set Nginx PHP-CGI port: PHP-CGI configuration file not found: " + phpCGIconfPath;
+        QString errMsg = "Failed to set Nginx PHP-CGI address: PHP-CGI configuration file not found: " + phpCGIconfPath;
         qWarning() << errMsg;
         throw std::runtime_error(errMsg.toStdString());
     }
     QFile phpCGIconfFile(phpCGIconfPath);
     if (!phpCGIconfFile.open(QIODevice::ReadWrite | QIODevice::Text)) {
-        QString errMsg = "Failed to set Nginx PHP-CGI port: Cannot open Nginx PHP-CGI configuration file: " + phpCGIconfPath;
+        QString errMsg = "Failed to set Nginx PHP-CGI address: Cannot open Nginx PHP-CGI configuration file: " + phpCGIconfPath;
         qWarning() << errMsg;
         throw std::runtime_error(errMsg.toStdString());
     }
 
+    QString address = getPHPCGIAddress();
+    QString fastcgiPass = address.startsWith('/') ? "unix:" + address : address;
     QTextStream confStream(&phpCGIconfFile);
     QString config = confStream.readAll();
-    config.replace(QRegularExpression("fastcgi_pass\\s+127.0.0.1:\\d+;"), "fastcgi_pass 127.0.0.1:" + QString::number(phpCGIport) + ";");
+    config.replace(QRegularExpression("fastcgi_pass\\s+[^;]+;"), "fastcgi_pass " + fastcgiPass + ";");
     phpCGIconfFile.resize(0);
     confStream << config;
     phpCGIconfFile.close();
-    return true;
+    if (fastCGICache.isEnabled()) {
+        writeFastCGICacheLocations();
+    }
+    if (QFile::exists(QCoreApplication::applicationDirPath() + "/conf/nginx/opcache_status.conf")) {
+        writeOpcacheStatusLocation();
+    }
 }
 
 
@@ -233,7 +320,7 @@ bool NginxServer::setPort(int port, QStringList &validationErrors) {
 
     QTextStream confStream(&nginxConfFile);
     QString config = confStream.readAll();
-    config.replace(QRegularExpression("listen\\s+\\d+;"), "listen " + QString::number(port) + ";");
+    config.replace(QRegularExpression("listen\\s+\\d+(\\s+reuseport)?;"), "listen " + QString::number(port) + "\\1;");
     nginxConfFile.resize(0);
     confStream << config;
     nginxConfFile.close();
@@ -242,11 +329,21 @@ bool NginxServer::setPort(int port, QStringList &validationErrors) {
 
 bool NginxServer::startPHPCGI() {
     if(phpCGIProcess->state() != QProcess::Running) {
-        if(ServerManager::getInstance().getFacade().isPortFree(phpCGIport)) {
+        QString address = getPHPCGIAddress();
+        bool unixSocket = address.startsWith('/');
+        if(unixSocket ? SocketTransport::isSocketFree(address) : ServerManager::getInstance().getFacade().isPortFree(phpCGIport)) {
+            if (unixSocket) {
+                SocketTransport::createSocketDirectory(address);
+            }
             phpCGIProcess = new QProcess();
+            isolation.prepare(phpCGIProcess, cgroup.prepare());
             QStringList arguments;
-            arguments << "-b" << "127.0.0.1:" + QString::number(phpCGIport);
+            arguments << "-b" << address;
+#ifdef Q_OS_WIN
             QString command = QDir::toNativeSeparators(phpPath.filePath("php-cgi.exe"));
+#else
+            QString command = phpPath.filePath("php-cgi");
+#endif
             if(!QFileInfo::exists(command)) {
                 throw std::runtime_error("Failed to start PHP CGI process: PHP CGI executable not found. Check you PHP CGI installation.");
             }
@@ -256,11 +353,14 @@ bool NginxServer::startPHPCGI() {
                 qWarning() << errMsg;
                 throw std::runtime_error(errMsg.toStdString());
             } else {
+                isolation.apply(phpCGIProcess);
+                cgroup.attach(phpCGIProcess->processId());
+                TaskPool::releaseToMainThread(phpCGIProcess);
                 qDebug() << "PHP CGI process started successfully.";
                 return true;
             }
         } else{
-            emit displayServerWarning("PHP-CGI port is already in use.");
+            emit displayServerWarning(unixSocket ? "PHP-CGI socket is already in use." : "PHP-CGI port is already in use.");
             return false;
         }
     }else {
@@ -285,6 +385,35 @@ bool NginxServer::setDocumentRoot(const QString& newPath) {
         return false;
     }
     this->documentRoot.setPath(dir.absolutePath());
+    if (documentRootMirror.isActive()) {
+        documentRootMirror.start(documentRoot.absolutePath());
+    }
+    writeDocumentRoot(getServedRoot());
+    return true;
+}
+
+bool NginxServer::setDocumentRootMirror(const QJsonObject &settings) {
+    documentRootMirror.setSettings(settings);
+    return true;
+}
+
+QJsonObject NginxServer::getDocumentRootMirrorStats() const {
+    return documentRootMirror.getStats();
+}
+
+QString NginxServer::getServedRoot() const {
+    QString mirrorPath = documentRootMirror.getMirrorPath();
+    return mirrorPath.isEmpty() ? documentRoot.absolutePath() : mirrorPath;
+}
+
+void NginxServer::releaseDocumentRootMirror() {
+    if (documentRootMirror.isActive()) {
+        documentRootMirror.stop();
+        writeDocumentRoot(getServedRoot());
+    }
+}
+
+void NginxServer::writeDocumentRoot(const QString &root) {
     QFile file(path.filePath("conf/nginx.conf"));
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QString errMsg = "Failed to set document root for Nginx: Unable to open Nginx configuration file for reading.";
@@ -302,7 +431,7 @@ bool NginxServer::setDocumentRoot(const QString& newPath) {
             match = re.match(line);
             if (match.hasMatch()) {
                 QString indent = match.captured(1);
-                line = QString("%1root %2;").arg(indent).arg(documentRoot.absolutePath());
+                line = QString("%1root %2;").arg(indent).arg(root);
             }
         content += line + '\n';
     }
@@ -316,6 +445,370 @@ bool NginxServer::setDocumentRoot(const QString& newPath) {
     QTextStream out(&file);
     out << content;
     file.close();
+    if (tls.isEnabled()) {
+        writeTlsConfig();
+    }
+}
+
+
+QMap<QString, QString> NginxServer::listConfigFiles() const {
+    QMap<QString, QString> files;
+    QDir confDir(path.filePath("conf"));
+    const QStringList names = confDir.entryList(QDir::Files);
+    for (const QString& name : names) {
+        files[name] = confDir.absoluteFilePath(name);
+    }
+    QDir toolkitDir(QCoreApplication::applicationDirPath() + "/conf/nginx");
+    const QStringList includes = toolkitDir.entryList(QStringList() << "*.conf", QDir::Files);
+    for (const QString& name : includes) {
+        files[name] = toolkitDir.absoluteFilePath(name);
+    }
+    return files;
+}
+
+QStringList NginxServer::getConfigFiles() const {
+    return listConfigFiles().values();
+}
+
+WorkspaceProfileStore::ConfigSet NginxServer::renderConfigSet() const {
+    QString toolkitDir = QCoreApplication::applicationDirPath() + "/conf/nginx/";
+    WorkspaceProfileStore::ConfigSet configSet;
+    const QMap<QString, QString> files = listConfigFiles();
+    for (auto it = files.begin(); it != files.end(); ++it) {
+        QFile file(it.value());
+        if (!file.open(QIODevice::ReadOnly)) {
+            QString errMsg = "Failed to render Nginx configuration: cannot read " + it.value() + ".";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        QByteArray content = file.readAll();
+        content.replace(QDir::fromNativeSeparators(toolkitDir).toUtf8(), (WorkspaceProfileStore::directoryPlaceholder + "/").toUtf8());
+        content.replace(QDir::toNativeSeparators(toolkitDir).toUtf8(), (WorkspaceProfileStore::directoryPlaceholder + "/").toUtf8());
+        if (documentRootMirror.isActive()) {
+            content.replace(documentRootMirror.getMirrorPath().toUtf8(), documentRoot.absolutePath().toUtf8());
+        }
+        configSet[it.key()] = content;
+    }
+    return configSet;
+}
+
+void NginxServer::useRenderedConfig(const QString &configDir, const QJsonObject &state) {
+    if (!configDir.isEmpty()) {
+        setVersion(state.value("version").toString());
+        setPHPVersion(state.value("php_version").toString());
+        port = state.value("port").toInt(port);
+        phpCGIport = state.value("php_cgi_port").toInt(phpCGIport);
+        phpFPMPort = state.value("php_fpm_port").toInt(phpFPMPort);
+        transport = state.value("transport").toString(transport);
+        documentRoot.setPath(state.value("document_root").toString(documentRoot.absolutePath()));
+        performanceProfile = state.value("performance_profile").toString(performanceProfile);
+        precompressedAssets = state.value("precompressed_assets").toBool(precompressedAssets);
+        fastCGICache = FastCGICache::fromJson(state.value("fastcgi_cache").toObject());
+        tls = TlsSettings::fromJson(state.value("tls").toObject(), tls.getPort());
+        isolation = ProcessIsolation::fromJson(state.value("isolation").toObject());
+        cgroup.setSettings(state.value("cgroup").toObject());
+        documentRootMirror.setSettings(state.value("document_root_mirror").toObject());
+    }
+    renderedConfigDir = configDir;
+}
+
+QString NginxServer::getRenderedConfigDir() const {
+    return renderedConfigDir;
+}
+
+QString NginxServer::getExecutablePath() const {
+#ifdef Q_OS_WIN
+    return QDir::toNativeSeparators(path.filePath("nginx.exe"));
+#else
+    if (QFileInfo::exists(path.filePath("sbin/nginx"))) {
+        return path.filePath("sbin/nginx");
+    }
+    return path.filePath("nginx");
+#endif
+}
+
+bool NginxServer::validateConfiguration(QString &output) const {
+    QString command = getExecutablePath();
+    if (!QFileInfo::exists(command)) {
+        output = "Nginx executable not found: " + command;
+        qWarning() << "Skipping Nginx configuration test:" << output;
+        return true;
+    }
+    QProcess testProcess;
+    testProcess.setWorkingDirectory(path.absolutePath());
+    testProcess.setProcessChannelMode(QProcess::MergedChannels);
+    testProcess.start(command, QStringList() << "-t" << "-p" << path.absolutePath() + "/" << "-c" << "conf/nginx.conf");
+    if (!testProcess.waitForFinished(10000)) {
+        output = "Nginx configuration test did not finish: " + testProcess.errorString();
+        testProcess.kill();
+        return false;
+    }
+    output = QString::fromLocal8Bit(testProcess.readAll()).trimmed();
+    return testProcess.exitStatus() == QProcess::NormalExit && testProcess.exitCode() == 0;
+}
+
+bool NginxServer::setPerformanceProfile(const QString &profileName) {
+    if (!NginxTuningProfile::availableProfiles().contains(profileName)) {
+        QString errMsg = "Failed to set Nginx performance profile: profile " + profileName + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (profileName == "none" && performanceProfile == "none") {
+        return true;
+    }
+
+    QString nginxConfPath = path.filePath("conf/nginx.conf");
+    QString original = ConfigEditor::readFile(nginxConfPath);
+    QString tuned = profileName == "none"
+        ? NginxTuningProfile::strip(original, port)
+        : NginxTuningProfile::preset(profileName).apply(original, port);
+    applyConfiguration(original, tuned, "performance profile " + profileName);
+    performanceProfile = profileName;
+    return true;
+}
+
+QString NginxServer::getPerformanceProfile() const {
+    return performanceProfile;
+}
+
+void NginxServer::applyConfiguration(const QString &original, const QString &updated, const QString &description) {
+    if (updated == original) {
+        return;
+    }
+    QString nginxConfPath = path.filePath("conf/nginx.conf");
+    ConfigEditor::writeFile(nginxConfPath, updated);
+    QString output;
+    if (!validateConfiguration(output)) {
+        ConfigEditor::writeFile(nginxConfPath, original);
+        QString errMsg = "Failed to apply Nginx " + description + ": configuration test failed.\n" + output;
+        qWarning() << errMsg;
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    qDebug() << "Nginx" << description << "applied.";
+}
+
+bool NginxServer::hasModule(const QString &moduleName) const {
+    QString command = getExecutablePath();
+    if (!QFileInfo::exists(command)) {
+        return false;
+    }
+    QProcess versionProcess;
+    versionProcess.setProcessChannelMode(QProcess::MergedChannels);
+    versionProcess.start(command, QStringList() << "-V");
+    if (!versionProcess.waitForFinished(5000)) {
+        versionProcess.kill();
+        return false;
+    }
+    return QString::fromLocal8Bit(versionProcess.readAll()).contains(moduleName);
+}
+
+bool NginxServer::setPrecompressedAssets(bool enabled) {
+    QString nginxConfPath = path.filePath("conf/nginx.conf");
+    QString original = ConfigEditor::readFile(nginxConfPath);
+    QString updated = original;
+    if (enabled) {
+        updated = ConfigEditor::setNginxDirective(updated, "http", "gzip_static", "on");
+        if (hasModule("brotli")) {
+            updated = ConfigEditor::setNginxDirective(updated, "http", "brotli_static", "on");
+        }
+    } else {
+        updated = ConfigEditor::removeNginxDirective(updated, "http", "gzip_static");
+        updated = ConfigEditor::removeNginxDirective(updated, "http", "brotli_static");
+    }
+    applyConfiguration(original, updated, enabled ? "precompressed asset serving" : "precompressed asset removal");
+    precompressedAssets = enabled;
+    return true;
+}
+
+QDir NginxServer::getFastCGICachePath() const {
+    return QDir(QDir::currentPath() + "/cache/nginx/fastcgi");
+}
+
+void NginxServer::writeFastCGICacheLocations() {
+    QString confDir = QCoreApplication::applicationDirPath() + "/conf/nginx";
+    QString phpCGIconf = ConfigEditor::readFile(confDir + "/php_cgi.conf");
+    QRegularExpressionMatch rootMatch = QRegularExpression(R"(\broot\s+([^;]+);)").match(phpCGIconf);
+    QRegularExpressionMatch passMatch = QRegularExpression(R"(\bfastcgi_pass\s+([^;]+);)").match(phpCGIconf);
+    QString root = rootMatch.hasMatch() ? rootMatch.captured(1).trimmed() : "$document_root";
+    QString fastcgiPass = passMatch.hasMatch() ? passMatch.captured(1).trimmed() : "127.0.0.1:" + QString::number(phpCGIport);
+    ConfigEditor::writeFile(confDir + "/fastcgi_cache_locations.conf", fastCGICache.renderLocations(root, fastcgiPass));
+}
+
+void NginxServer::writeOpcacheStatusLocation() {
+    QString confDir = QCoreApplication::applicationDirPath() + "/conf/nginx";
+    QString statusDir = PHPRuntimeManager::installStatusScript();
+    QString phpCGIconf = ConfigEditor::readFile(confDir + "/php_cgi.conf");
+    QRegularExpressionMatch passMatch = QRegularExpression(R"(\bfastcgi_pass\s+([^;]+);)").match(phpCGIconf);
+    QString fastcgiPass = passMatch.hasMatch() ? passMatch.captured(1).trimmed() : "127.0.0.1:" + QString::number(phpCGIport);
+
+    QString content;
+    QTextStream out(&content);
+    out << "# Generated by WebDevToolkit: OPcache status endpoint served outside the document root\n";
+    out << "location ^~ " << PHPRuntimeManager::statusScriptUrlPrefix() << "/ {\n";
+    out << "    allow 127.0.0.1;\n";
+    out << "    allow ::1;\n";
+    out << "    deny all;\n";
+    out << "    alias " << statusDir << "/;\n";
+    out << "    location ~ \\.php$ {\n";
+    out << "        include fastcgi_params;\n";
+    out << "        fastcgi_param SCRIPT_FILENAME $request_filename;\n";
+    out << "        fastcgi_pass " << fastcgiPass << ";\n";
+    out << "    }\n";
+    out << "}\n";
+    out.flush();
+    QString confPath = confDir + "/opcache_status.conf";
+    if (!QFile::exists(confPath) || ConfigEditor::readFile(confPath) != content) {
+        ConfigEditor::writeFile(confPath, content);
+    }
+    QString nginxConfPath = path.filePath("conf/nginx.conf");
+    QString original = ConfigEditor::readFile(nginxConfPath);
+    applyConfiguration(original, setLocationsInclude(original, confPath, true), "OPcache status location");
+}
+
+QString NginxServer::setLocationsInclude(const QString &config, const QString &includePath, bool enabled) const {
+    QStringList lines = config.split('\n');
+    QRegularExpression locationsRegex("^\\s*include\\s+" + QRegularExpression::escape(includePath) + "\\s*;");
+    for (int i = lines.size() - 1; i >= 0; --i) {
+        if (locationsRegex.match(lines[i]).hasMatch()) {
+            lines.removeAt(i);
+        }
+    }
+    if (enabled) {
+        QRegularExpression phpCGIRegex(R"(^(\s*)include\s+\S+/conf/nginx/php_cgi.conf;)");
+        for (int i = 0; i < lines.size(); ++i) {
+            QRegularExpressionMatch match = phpCGIRegex.match(lines[i]);
+            if (match.hasMatch()) {
+                lines.insert(i, match.captured(1) + "include " + includePath + ";");
+                break;
+            }
+        }
+    }
+    return lines.join('\n');
+}
+
+bool NginxServer::setFastCGICache(const QJsonObject &settings) {
+    FastCGICache updatedCache = FastCGICache::fromJson(settings);
+    updatedCache.keepStats(fastCGICache);
+    QString confDir = QCoreApplication::applicationDirPath() + "/conf/nginx";
+    QString httpConfPath = confDir + "/fastcgi_cache.conf";
+    QString phpCGIconfPath = confDir + "/php_cgi.conf";
+    QString nginxConfPath = path.filePath("conf/nginx.conf");
+    QString original = ConfigEditor::readFile(nginxConfPath);
+    QString updated = original;
+
+    FastCGICache previousCache = fastCGICache;
+    QString previousHttpConf = QFile::exists(httpConfPath) ? ConfigEditor::readFile(httpConfPath) : QString();
+    QString previousPHPCGIconf = QFile::exists(phpCGIconfPath) ? ConfigEditor::readFile(phpCGIconfPath) : QString();
+    try {
+        fastCGICache = updatedCache;
+        if (updatedCache.isEnabled()) {
+            if (!getFastCGICachePath().exists() && !QDir().mkpath(getFastCGICachePath().absolutePath())) {
+                QString errMsg = "Failed to enable Nginx FastCGI cache: cannot create cache directory " + getFastCGICachePath().absolutePath() + ".";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+            ConfigEditor::writeFile(httpConfPath, updatedCache.renderHttpConfig(getFastCGICachePath().absolutePath()));
+            writeFastCGICacheLocations();
+        }
+        if (!previousPHPCGIconf.isEmpty()) {
+            QString phpCGIconf = FastCGICache::setStatusHeader(previousPHPCGIconf, updatedCache.isEnabled());
+            if (phpCGIconf != previousPHPCGIconf) {
+                ConfigEditor::writeFile(phpCGIconfPath, phpCGIconf);
+            }
+        }
+        updated = ConfigEditor::setNginxInclude(updated, "http", httpConfPath, updatedCache.isEnabled());
+        updated = setLocationsInclude(updated, confDir + "/fastcgi_cache_locations.conf", updatedCache.isEnabled());
+        applyConfiguration(original, updated, updatedCache.isEnabled() ? "FastCGI cache" : "FastCGI cache removal");
+    } catch (const std::runtime_error&) {
+        fastCGICache = previousCache;
+        if (!previousHttpConf.isEmpty()) {
+            ConfigEditor::writeFile(httpConfPath, previousHttpConf);
+        }
+        if (!previousPHPCGIconf.isEmpty()) {
+            ConfigEditor::writeFile(phpCGIconfPath, previousPHPCGIconf);
+        }
+        if (previousCache.isEnabled()) {
+            writeFastCGICacheLocations();
+        }
+        throw;
+    }
+    return true;
+}
+
+QJsonObject NginxServer::getFastCGICache() const {
+    return fastCGICache.toJson();
+}
+
+QJsonObject NginxServer::purgeFastCGICache(const QString &target) {
+    return FastCGICache::purge(getFastCGICachePath(), target);
+}
+
+QJsonObject NginxServer::getFastCGICacheStats() {
+    QJsonObject stats = fastCGICache.readStats(path.filePath("logs/access.log"));
+    stats["enabled"] = fastCGICache.isEnabled();
+    return stats;
+}
+
+QString NginxServer::getTlsConfigPath() const {
+    return QCoreApplication::applicationDirPath() + "/conf/nginx/tls.conf";
+}
+
+void NginxServer::writeTlsConfig() const {
+    QString phpInclude = QCoreApplication::applicationDirPath() + "/conf/nginx/php_cgi.conf";
+    ConfigEditor::writeFile(getTlsConfigPath(), tls.renderNginxConfig(version, tlsCertificates, getServedRoot(), phpInclude));
+}
+
+bool NginxServer::setTls(const TlsSettings &settings, const QList<TlsCertificate> &certificates) {
+    QString tlsConfPath = getTlsConfigPath();
+    QString nginxConfPath = path.filePath("conf/nginx.conf");
+    QString original = ConfigEditor::readFile(nginxConfPath);
+
+    TlsSettings previousTls = tls;
+    QList<TlsCertificate> previousCertificates = tlsCertificates;
+    QString previousTlsConf = QFile::exists(tlsConfPath) ? ConfigEditor::readFile(tlsConfPath) : QString();
+    try {
+        tls = settings;
+        tlsCertificates = certificates;
+        if (settings.isEnabled()) {
+            writeTlsConfig();
+        }
+        QString updated = ConfigEditor::setNginxInclude(original, "http", tlsConfPath, settings.isEnabled());
+        applyConfiguration(original, updated, settings.isEnabled() ? "TLS listeners" : "TLS listener removal");
+    } catch (const std::runtime_error&) {
+        tls = previousTls;
+        tlsCertificates = previousCertificates;
+        if (!previousTlsConf.isEmpty()) {
+            ConfigEditor::writeFile(tlsConfPath, previousTlsConf);
+        }
+        throw;
+    }
+    return true;
+}
+
+QJsonObject NginxServer::getTls() const {
+    return tls.toJson();
+}
+
+bool NginxServer::setIsolation(const QJsonObject &settings) {
+    isolation = ProcessIsolation::fromJson(settings);
     return true;
 }
 
+QJsonObject NginxServer::getIsolation() const {
+    return isolation.toJson();
+}
+
+bool NginxServer::setCgroup(const QJsonObject &settings) {
+    cgroup.setSettings(settings);
+    return true;
+}
+
+QJsonObject NginxServer::getResourceUsage() const {
+    return cgroup.readUsage();
+}
+
+qint64 NginxServer::getProcessId() const {
+    return runningProcessId;
+}
+
+QDateTime NginxServer::getStartTime() const {
+    qint64 started = startedAt;
+    return started > 0 ? QDateTime::fromMSecsSinceEpoch(started) : QDateTime();
+}
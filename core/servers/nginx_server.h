@@ -3,8 +3,16 @@
 
 #include "qglobal.h"
 #include "../interfaces/iserver.h"
+#include "../../utility/process_isolation.h"
+#include "../../utility/cgroup_manager.h"
+#include "../../utility/document_root_mirror.h"
+#include "../cache/fastcgi_cache.h"
+#include "../tls/tls_settings.h"
+#include "../config/workspace_profile_store.h"
 #include <QProcess>
 #include <QMap>
+#include <QDateTime>
+#include <atomic>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -29,10 +37,35 @@ public:
     QDir getPath() const override;
 
     bool setPHPCGIPort(int port, QStringList &validationErrors);
+    bool setTransport(const QString& transport);
+    QString getPHPCGIAddress() const;
     bool setPHPFPMport(int port, QStringList &validationErrors);
     bool setPort(int port, QStringList &validationErrors) override;
     bool setDocumentRoot(const QString &newPath);
+    bool setDocumentRootMirror(const QJsonObject& settings);
+    QJsonObject getDocumentRootMirrorStats() const;
+    QStringList getConfigFiles() const;
+    WorkspaceProfileStore::ConfigSet renderConfigSet() const;
+    void useRenderedConfig(const QString& configDir, const QJsonObject& state);
+    QString getRenderedConfigDir() const;
     bool startPHPCGI();
+    bool setPerformanceProfile(const QString& profileName);
+    QString getPerformanceProfile() const;
+    bool validateConfiguration(QString &output) const;
+    bool setPrecompressedAssets(bool enabled);
+    bool hasModule(const QString& moduleName) const;
+    bool setFastCGICache(const QJsonObject& settings);
+    QJsonObject getFastCGICache() const;
+    QJsonObject purgeFastCGICache(const QString& target);
+    QJsonObject getFastCGICacheStats();
+    bool setTls(const TlsSettings& settings, const QList<TlsCertificate>& certificates);
+    QJsonObject getTls() const;
+    bool setIsolation(const QJsonObject& settings);
+    QJsonObject getIsolation() const;
+    bool setCgroup(const QJsonObject& settings);
+    QJsonObject getResourceUsage() const;
+    qint64 getProcessId() const;
+    QDateTime getStartTime() const;
 
 signals:
     void updateState(const QString& serverName, bool isRunning);
@@ -41,18 +74,44 @@ signals:
 
 private:
     int port;
-    int phpFPMPort;
+    int phpFPMPort = 0;
     int phpCGIport;
+    QString transport = "tcp";
     int phpMyAdminPort;
     QString version;
     QString phpVersion;
     QDir path;
     QDir phpPath;
     QDir documentRoot;
+    DocumentRootMirror documentRootMirror{"nginx"};
+    QString renderedConfigDir;
+    QString performanceProfile = "none";
+    bool precompressedAssets = false;
+    FastCGICache fastCGICache;
+    TlsSettings tls;
+    QList<TlsCertificate> tlsCertificates;
+    ProcessIsolation isolation;
+    CgroupManager cgroup{"nginx"};
     QProcess* nginxProcess;
+    std::atomic<qint64> runningProcessId{0};
+    std::atomic<qint64> startedAt{0};
     QProcess* phpFPMProcess;
     QProcess* phpCGIProcess;
     bool lastCrashed = true;
+
+    QString getExecutablePath() const;
+    QString getServedRoot() const;
+    QMap<QString, QString> listConfigFiles() const;
+    void writeDocumentRoot(const QString& root);
+    void releaseDocumentRootMirror();
+    void writeFastCGIPass();
+    void applyConfiguration(const QString& original, const QString& updated, const QString& description);
+    QDir getFastCGICachePath() const;
+    void writeFastCGICacheLocations();
+    QString setLocationsInclude(const QString& config, const QString& includePath, bool enabled) const;
+    void writeOpcacheStatusLocation();
+    QString getTlsConfigPath() const;
+    void writeTlsConfig() const;
 };
 
 #endif // NGINX_SERVER_H
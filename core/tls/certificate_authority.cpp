@@ -0,0 +1,219 @@
+#include "certificate_authority.h"
+#include "../../utility/config_editor.h"
+#include "../../utility/trace.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QStandardPaths>
+#include <QRegularExpression>
+#include <QRandomGenerator>
+#include <QHostAddress>
+#include <QLocale>
+#include <QTimeZone>
+#include <QJsonArray>
+#include <QMutexLocker>
+
+CertificateAuthority::CertificateAuthority(const QDir &directory) : directory(directory) {
+}
+
+void CertificateAuthority::setSearchPaths(const QStringList &paths) {
+    QMutexLocker locker(&mutex);
+    searchPaths = paths;
+}
+
+QString CertificateAuthority::getCaCertificatePath() const {
+    return directory.absoluteFilePath("ca.crt");
+}
+
+QList<TlsCertificate> CertificateAuthority::issue(const QStringList &hosts) {
+    TRACE_SCOPE("config", "CertificateAuthority::issue");
+    QMutexLocker locker(&mutex);
+    if (hosts.isEmpty()) {
+        throw std::runtime_error("Failed to issue TLS certificates: no host names were given.");
+    }
+    for (const QString& host : hosts) {
+        if (!isValidHost(host)) {
+            QString errMsg = "Failed to issue TLS certificates: invalid host name " + host + ".";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+    }
+    if (!directory.mkpath("hosts")) {
+        QString errMsg = "Failed to issue TLS certificates: cannot create directory " + directory.absolutePath() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    writeOpenSslConfig();
+    if (ensureCa()) {
+        issued.clear();
+    }
+    QList<TlsCertificate> certificates;
+    for (const QString& host : hosts) {
+        certificates.append(issueCertificate(host.toLower()));
+    }
+    return certificates;
+}
+
+QJsonObject CertificateAuthority::getStatus() const {
+    QMutexLocker locker(&mutex);
+    QJsonObject status;
+    status["ca_certificate"] = getCaCertificatePath();
+    status["ca_expires_at"] = caExpiresAt.isValid() ? caExpiresAt.toString(Qt::ISODate) : QString();
+    QJsonArray certificates;
+    for (auto it = issued.begin(); it != issued.end(); ++it) {
+        QJsonObject certificate;
+        certificate["host"] = it.value().host;
+        certificate["certificate"] = it.value().certificatePath;
+        certificate["key"] = it.value().keyPath;
+        certificate["expires_at"] = it.value().expiresAt.toString(Qt::ISODate);
+        certificates.append(certificate);
+    }
+    status["certificates"] = certificates;
+    return status;
+}
+
+bool CertificateAuthority::isValidHost(const QString &host) {
+    if (!QHostAddress(host).isNull()) {
+        return true;
+    }
+    static const QRegularExpression hostRegex(R"(^(\*\.)?[A-Za-z0-9]([A-Za-z0-9-]{0,61}[A-Za-z0-9])?(\.[A-Za-z0-9]([A-Za-z0-9-]{0,61}[A-Za-z0-9])?)*$)");
+    return host.size() <= 253 && hostRegex.match(host).hasMatch();
+}
+
+QString CertificateAuthority::findOpenSsl() const {
+    QString executable = QStandardPaths::findExecutable("openssl", searchPaths);
+    if (executable.isEmpty()) {
+        executable = QStandardPaths::findExecutable("openssl");
+    }
+    if (executable.isEmpty()) {
+        throw std::runtime_error("Failed to issue TLS certificates: the openssl executable was not found in the Apache bin directory or PATH.");
+    }
+    return executable;
+}
+
+QString CertificateAuthority::runOpenSsl(const QStringList &arguments) const {
+    QProcess process;
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("OPENSSL_CONF", directory.absoluteFilePath("openssl.cnf"));
+    process.setProcessEnvironment(environment);
+    process.setWorkingDirectory(directory.absolutePath());
+    process.start(findOpenSsl(), arguments);
+    if (!process.waitForFinished(30000)) {
+        process.kill();
+        QString errMsg = "Failed to run openssl " + arguments.value(0) + ": " + process.errorString();
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QString output = QString::fromLocal8Bit(process.readAllStandardOutput());
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        QString errMsg = "Failed to run openssl " + arguments.value(0) + ": " + QString::fromLocal8Bit(process.readAllStandardError()).trimmed();
+        qWarning() << errMsg;
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return output;
+}
+
+bool CertificateAuthority::ensureCa() {
+    QString certificatePath = getCaCertificatePath();
+    QString keyPath = directory.absoluteFilePath("ca.key");
+    if (QFile::exists(certificatePath) && QFile::exists(keyPath)) {
+        if (!caExpiresAt.isValid()) {
+            caExpiresAt = readExpiry(certificatePath);
+        }
+        if (caExpiresAt > QDateTime::currentDateTimeUtc().addDays(renewBeforeDays)) {
+            return false;
+        }
+        qDebug() << "Local certificate authority expires at" << caExpiresAt << "- generating a new one.";
+    }
+    runOpenSsl(QStringList() << "req" << "-x509" << "-new" << "-newkey" << "ec" << "-pkeyopt" << "ec_paramgen_curve:prime256v1"
+                             << "-nodes" << "-sha256" << "-days" << QString::number(caValidityDays)
+                             << "-subj" << "/O=WebDevToolkit/CN=WebDevToolkit Local CA"
+                             << "-config" << directory.absoluteFilePath("openssl.cnf") << "-extensions" << "ca_ext"
+                             << "-keyout" << keyPath << "-out" << certificatePath);
+    caExpiresAt = readExpiry(certificatePath);
+    QDir hostsDir(directory.absoluteFilePath("hosts"));
+    const QStringList stale = hostsDir.entryList(QStringList() << "*.crt" << "*.key", QDir::Files);
+    for (const QString& fileName : stale) {
+        hostsDir.remove(fileName);
+    }
+    qDebug() << "Generated local certificate authority" << certificatePath << "- import it into the browser trust store to trust local TLS sites.";
+    return true;
+}
+
+TlsCertificate CertificateAuthority::issueCertificate(const QString &host) {
+    TlsCertificate certificate;
+    certificate.host = host;
+    QString baseName = directory.absoluteFilePath("hosts/" + fileNameForHost(host));
+    certificate.certificatePath = baseName + ".crt";
+    certificate.keyPath = baseName + ".key";
+    if (QFile::exists(certificate.certificatePath) && QFile::exists(certificate.keyPath)) {
+        certificate.expiresAt = issued.contains(host) ? issued.value(host).expiresAt : readExpiry(certificate.certificatePath);
+        if (certificate.expiresAt > QDateTime::currentDateTimeUtc().addDays(renewBeforeDays)) {
+            issued[host] = certificate;
+            return certificate;
+        }
+    }
+
+    QString subjectAltName = QHostAddress(host).isNull() ? "DNS:" + host : "IP:" + host;
+    if (host == "localhost") {
+        subjectAltName += ",IP:127.0.0.1,IP:::1";
+    }
+    QString extensions;
+    extensions += "basicConstraints = CA:FALSE\n";
+    extensions += "keyUsage = critical, digitalSignature\n";
+    extensions += "extendedKeyUsage = serverAuth\n";
+    extensions += "subjectKeyIdentifier = hash\n";
+    extensions += "authorityKeyIdentifier = keyid, issuer\n";
+    extensions += "subjectAltName = " + subjectAltName + "\n";
+    QString extensionsPath = baseName + ".ext";
+    QString requestPath = baseName + ".csr";
+    ConfigEditor::writeFile(extensionsPath, extensions);
+    try {
+        runOpenSsl(QStringList() << "req" << "-new" << "-newkey" << "ec" << "-pkeyopt" << "ec_paramgen_curve:prime256v1"
+                                 << "-nodes" << "-sha256" << "-subj" << "/O=WebDevToolkit/CN=" + host
+                                 << "-config" << directory.absoluteFilePath("openssl.cnf")
+                                 << "-keyout" << certificate.keyPath << "-out" << requestPath);
+        runOpenSsl(QStringList() << "x509" << "-req" << "-sha256" << "-days" << QString::number(certificateValidityDays)
+                                 << "-in" << requestPath << "-CA" << getCaCertificatePath() << "-CAkey" << directory.absoluteFilePath("ca.key")
+                                 << "-set_serial" << QString::number(QRandomGenerator::global()->generate64() >> 1)
+                                 << "-extfile" << extensionsPath << "-out" << certificate.certificatePath);
+    } catch (const std::runtime_error&) {
+        QFile::remove(extensionsPath);
+        QFile::remove(requestPath);
+        throw;
+    }
+    QFile::remove(extensionsPath);
+    QFile::remove(requestPath);
+    certificate.expiresAt = readExpiry(certificate.certificatePath);
+    issued[host] = certificate;
+    qDebug() << "Issued local TLS certificate for" << host << "valid until" << certificate.expiresAt;
+    return certificate;
+}
+
+void CertificateAuthority::writeOpenSslConfig() const {
+    QString config;
+    config += "[req]\n";
+    config += "distinguished_name = req_dn\n";
+    config += "\n[req_dn]\n";
+    config += "\n[ca_ext]\n";
+    config += "basicConstraints = critical, CA:TRUE, pathlen:0\n";
+    config += "keyUsage = critical, keyCertSign, cRLSign\n";
+    config += "subjectKeyIdentifier = hash\n";
+    QString configPath = directory.absoluteFilePath("openssl.cnf");
+    if (!QFile::exists(configPath) || ConfigEditor::readFile(configPath) != config) {
+        ConfigEditor::writeFile(configPath, config);
+    }
+}
+
+QDateTime CertificateAuthority::readExpiry(const QString &certificatePath) const {
+    QString output = runOpenSsl(QStringList() << "x509" << "-noout" << "-enddate" << "-in" << certificatePath).simplified();
+    QRegularExpressionMatch match = QRegularExpression(R"(notAfter=(\w{3} \d{1,2} \d{2}:\d{2}:\d{2} \d{4}) GMT)").match(output);
+    QDateTime expiresAt = match.hasMatch() ? QLocale::c().toDateTime(match.captured(1), "MMM d HH:mm:ss yyyy") : QDateTime();
+    expiresAt.setTimeZone(QTimeZone::utc());
+    return expiresAt;
+}
+
+QString CertificateAuthority::fileNameForHost(const QString &host) {
+    QString fileName = host;
+    fileName.replace("*", "_wildcard").replace(":", "_");
+    return fileName;
+}
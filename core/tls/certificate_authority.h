@@ -0,0 +1,51 @@
+#ifndef CERTIFICATE_AUTHORITY_H
+#define CERTIFICATE_AUTHORITY_H
+
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+
+struct TlsCertificate {
+    QString host;
+    QString certificatePath;
+    QString keyPath;
+    QDateTime expiresAt;
+};
+
+class CertificateAuthority {
+public:
+    static const int caValidityDays = 3650;
+    static const int certificateValidityDays = 825;
+    static const int renewBeforeDays = 30;
+
+    explicit CertificateAuthority(const QDir& directory);
+
+    void setSearchPaths(const QStringList& paths);
+    QString getCaCertificatePath() const;
+    QList<TlsCertificate> issue(const QStringList& hosts);
+    QJsonObject getStatus() const;
+
+    static bool isValidHost(const QString& host);
+
+private:
+    QDir directory;
+    QStringList searchPaths;
+    QDateTime caExpiresAt;
+    QHash<QString, TlsCertificate> issued;
+    mutable QMutex mutex;
+
+    QString findOpenSsl() const;
+    QString runOpenSsl(const QStringList& arguments) const;
+    bool ensureCa();
+    TlsCertificate issueCertificate(const QString& host);
+    void writeOpenSslConfig() const;
+    QDateTime readExpiry(const QString& certificatePath) const;
+    static QString fileNameForHost(const QString& host);
+};
+
+#endif // CERTIFICATE_AUTHORITY_H
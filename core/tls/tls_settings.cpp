@@ -0,0 +1,159 @@
+#include "tls_settings.h"
+#include <QDir>
+#include <QJsonArray>
+#include <QVersionNumber>
+
+const QString TlsSettings::sessionZoneName = "WEBDEVTOOLKIT_TLS";
+
+TlsSettings TlsSettings::fromJson(const QJsonObject &settings, int defaultPort) {
+    TlsSettings tls;
+    tls.enabled = settings.value("enabled").toBool(false);
+    tls.port = settings.value("port").toInt(defaultPort);
+    tls.http2 = settings.value("http2").toBool(tls.http2);
+    tls.sessionCacheMb = settings.value("session_cache_mb").toInt(tls.sessionCacheMb);
+    tls.sessionTimeout = settings.value("session_timeout").toInt(tls.sessionTimeout);
+    tls.sessionTickets = settings.value("session_tickets").toBool(tls.sessionTickets);
+    if (tls.port <= 0 || tls.port > 65535) {
+        QString errMsg = "Invalid TLS settings: invalid port " + QString::number(tls.port) + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (tls.sessionCacheMb <= 0 || tls.sessionCacheMb > 1024 || tls.sessionTimeout <= 0) {
+        throw std::runtime_error("Invalid TLS settings: session cache size must be between 1 and 1024 MB and the session timeout must be positive.");
+    }
+    if (settings.contains("hosts")) {
+        tls.hosts.clear();
+        const QJsonArray hosts = settings.value("hosts").toArray();
+        for (const QJsonValue& host : hosts) {
+            QString name = host.toString().toLower();
+            if (!CertificateAuthority::isValidHost(name)) {
+                QString errMsg = "Invalid TLS settings: invalid host name " + host.toString() + ".";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+            if (!tls.hosts.contains(name)) {
+                tls.hosts.append(name);
+            }
+        }
+        if (tls.hosts.isEmpty()) {
+            throw std::runtime_error("Invalid TLS settings: at least one host name is required.");
+        }
+    }
+    return tls;
+}
+
+QJsonObject TlsSettings::toJson() const {
+    QJsonObject settings;
+    settings["enabled"] = enabled;
+    settings["port"] = port;
+    settings["hosts"] = QJsonArray::fromStringList(hosts);
+    settings["http2"] = http2;
+    settings["session_cache_mb"] = sessionCacheMb;
+    settings["session_timeout"] = sessionTimeout;
+    settings["session_tickets"] = sessionTickets;
+    return settings;
+}
+
+bool TlsSettings::isEnabled() const {
+    return enabled;
+}
+
+int TlsSettings::getPort() const {
+    return port;
+}
+
+void TlsSettings::setPort(int port) {
+    this->port = port;
+}
+
+QStringList TlsSettings::getHosts() const {
+    return hosts;
+}
+
+bool TlsSettings::usesHttp2() const {
+    return http2;
+}
+
+QString TlsSettings::renderNginxConfig(const QString &nginxVersion, const QList<TlsCertificate> &certificates,
+                                       const QString &documentRoot, const QString &phpInclude) const {
+    bool http2Directive = QVersionNumber::fromString(nginxVersion) >= QVersionNumber(1, 25, 1);
+    QStringList lines;
+    lines << "# Generated by WebDevToolkit: local TLS listeners";
+    lines << "ssl_protocols TLSv1.2 TLSv1.3;";
+    lines << "ssl_prefer_server_ciphers off;";
+    lines << "ssl_session_cache shared:" + sessionZoneName + ":" + QString::number(sessionCacheMb) + "m;";
+    lines << "ssl_session_timeout " + QString::number(sessionTimeout) + "s;";
+    lines << QString("ssl_session_tickets ") + (sessionTickets ? "on;" : "off;");
+    for (int i = 0; i < certificates.size(); ++i) {
+        const TlsCertificate& certificate = certificates.at(i);
+        QString listen = "    listen " + QString::number(port) + " ssl";
+        if (http2 && !http2Directive) {
+            listen += " http2";
+        }
+        if (i == 0) {
+            listen += " default_server";
+        }
+        lines << "";
+        lines << "server {";
+        lines << listen + ";";
+        if (http2 && http2Directive) {
+            lines << "    http2 on;";
+        }
+        lines << "    server_name " + certificate.host + ";";
+        lines << "    ssl_certificate \"" + QDir::fromNativeSeparators(certificate.certificatePath) + "\";";
+        lines << "    ssl_certificate_key \"" + QDir::fromNativeSeparators(certificate.keyPath) + "\";";
+        lines << "    root \"" + QDir::fromNativeSeparators(documentRoot) + "\";";
+        lines << "    index index.php index.html index.htm;";
+        lines << "    include " + QDir::fromNativeSeparators(phpInclude) + ";";
+        lines << "}";
+    }
+    return lines.join('\n') + '\n';
+}
+
+QString TlsSettings::renderApacheConfig(const QString &apacheVersion, const QList<TlsCertificate> &certificates,
+                                        const QString &documentRoot, bool http2Available) const {
+    QVersionNumber version = QVersionNumber::fromString(apacheVersion);
+    bool apache24 = version >= QVersionNumber(2, 4);
+    QStringList lines;
+    lines << "# Generated by WebDevToolkit: local TLS listeners";
+    lines << "Listen " + QString::number(port);
+    lines << "<IfModule !ssl_module>";
+    lines << "    LoadModule ssl_module modules/mod_ssl.so";
+    lines << "</IfModule>";
+    if (apache24) {
+        lines << "<IfModule !socache_shmcb_module>";
+        lines << "    LoadModule socache_shmcb_module modules/mod_socache_shmcb.so";
+        lines << "</IfModule>";
+    }
+    if (http2 && http2Available) {
+        lines << "<IfModule !http2_module>";
+        lines << "    LoadModule http2_module modules/mod_http2.so";
+        lines << "</IfModule>";
+    }
+    lines << (apache24 ? "SSLProtocol all -SSLv3 -TLSv1 -TLSv1.1" : "SSLProtocol all -SSLv2 -SSLv3");
+    lines << "SSLSessionCache \"shmcb:logs/ssl_scache(" + QString::number(qint64(sessionCacheMb) * 1024 * 1024) + ")\"";
+    lines << "SSLSessionCacheTimeout " + QString::number(sessionTimeout);
+    if (version >= QVersionNumber(2, 4, 11)) {
+        lines << QString("SSLSessionTickets ") + (sessionTickets ? "on" : "off");
+    }
+    if (!apache24) {
+        lines << "NameVirtualHost *:" + QString::number(port);
+    }
+    for (const TlsCertificate& certificate : certificates) {
+        lines << "";
+        lines << "<VirtualHost *:" + QString::number(port) + ">";
+        if (certificate.host.startsWith("*.")) {
+            lines << "    ServerName " + certificate.host.mid(2);
+            lines << "    ServerAlias " + certificate.host;
+        } else {
+            lines << "    ServerName " + certificate.host;
+        }
+        if (http2 && http2Available) {
+            lines << "    Protocols h2 http/1.1";
+        }
+        lines << "    DocumentRoot \"" + QDir::fromNativeSeparators(documentRoot) + "\"";
+        lines << "    SSLEngine on";
+        lines << "    SSLCertificateFile \"" + QDir::fromNativeSeparators(certificate.certificatePath) + "\"";
+        lines << "    SSLCertificateKeyFile \"" + QDir::fromNativeSeparators(certificate.keyPath) + "\"";
+        lines << "</VirtualHost>";
+    }
+    return lines.join('\n') + '\n';
+}
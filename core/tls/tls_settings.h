@@ -0,0 +1,38 @@
+#ifndef TLS_SETTINGS_H
+#define TLS_SETTINGS_H
+
+#include "certificate_authority.h"
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QList>
+
+class TlsSettings {
+public:
+    static const QString sessionZoneName;
+
+    static TlsSettings fromJson(const QJsonObject& settings, int defaultPort);
+    QJsonObject toJson() const;
+
+    bool isEnabled() const;
+    int getPort() const;
+    void setPort(int port);
+    QStringList getHosts() const;
+    bool usesHttp2() const;
+
+    QString renderNginxConfig(const QString& nginxVersion, const QList<TlsCertificate>& certificates,
+                              const QString& documentRoot, const QString& phpInclude) const;
+    QString renderApacheConfig(const QString& apacheVersion, const QList<TlsCertificate>& certificates,
+                               const QString& documentRoot, bool http2Available) const;
+
+private:
+    bool enabled = false;
+    int port = 0;
+    QStringList hosts = QStringList() << "localhost";
+    bool http2 = true;
+    int sessionCacheMb = 10;
+    int sessionTimeout = 86400;
+    bool sessionTickets = true;
+};
+
+#endif // TLS_SETTINGS_H
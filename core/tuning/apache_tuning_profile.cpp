@@ -0,0 +1,105 @@
+#include "apache_tuning_profile.h"
+#include <QThread>
+#include <QTextStream>
+
+QStringList ApacheTuningProfile::availableProfiles() {
+    return QStringList() << "none" << "development" << "staging" << "production";
+}
+
+ApacheTuningProfile ApacheTuningProfile::derive(const QString &name, const QString &apacheVersion, int expectedConcurrency) {
+    if (expectedConcurrency < 1) {
+        QString errMsg = "Failed to derive Apache tuning profile: expected concurrency must be positive.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    ApacheTuningProfile profile;
+    profile.name = name;
+    profile.apacheVersion = apacheVersion;
+    profile.legacyDirectives = apacheVersion.startsWith("2.2");
+    int cores = qMax(1, QThread::idealThreadCount());
+
+    double headroom;
+    int phpWorkersPerCore;
+    if (name == "development") {
+        profile.threadsPerChild = 25;
+        headroom = 1.0;
+        phpWorkersPerCore = 1;
+        profile.fcgidMaxRequestsPerProcess = 500;
+        profile.fcgidIOTimeout = 600;
+        profile.fcgidProcessLifeTime = 3600;
+    } else if (name == "staging") {
+        profile.threadsPerChild = 32;
+        headroom = 1.5;
+        phpWorkersPerCore = 2;
+        profile.fcgidMaxRequestsPerProcess = 1000;
+        profile.fcgidIOTimeout = 120;
+        profile.fcgidProcessLifeTime = 7200;
+    } else if (name == "production") {
+        profile.threadsPerChild = 64;
+        headroom = 2.0;
+        phpWorkersPerCore = 4;
+        profile.fcgidMaxRequestsPerProcess = 10000;
+        profile.fcgidIOTimeout = 60;
+        profile.fcgidProcessLifeTime = 86400;
+    } else {
+        QString errMsg = "Failed to derive Apache tuning profile: profile " + name + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    int workers = qMax(profile.threadsPerChild, int(expectedConcurrency * headroom));
+    profile.serverLimit = (workers + profile.threadsPerChild - 1) / profile.threadsPerChild;
+    profile.maxRequestWorkers = profile.serverLimit * profile.threadsPerChild;
+    profile.winntThreadsPerChild = qBound(64, workers, 1920);
+    profile.fcgidMaxProcesses = qBound(2, qMin(expectedConcurrency, cores * phpWorkersPerCore), 256);
+    return profile;
+}
+
+QString ApacheTuningProfile::getName() const {
+    return name;
+}
+
+QString ApacheTuningProfile::render() const {
+    QString maxWorkersDirective = legacyDirectives ? "MaxClients" : "MaxRequestWorkers";
+    QString maxConnectionsDirective = legacyDirectives ? "MaxRequestsPerChild" : "MaxConnectionsPerChild";
+    QString content;
+    QTextStream out(&content);
+    out << "# Generated by WebDevToolkit: " << name << " profile for Apache " << apacheVersion << "\n\n";
+
+    out << "<IfModule mpm_winnt_module>\n";
+    out << "    ThreadsPerChild " << winntThreadsPerChild << "\n";
+    out << "    " << maxConnectionsDirective << " 0\n";
+    out << "</IfModule>\n\n";
+
+    if (!legacyDirectives) {
+        out << "<IfModule mpm_event_module>\n";
+        out << "    ServerLimit " << serverLimit << "\n";
+        out << "    ThreadLimit " << threadsPerChild << "\n";
+        out << "    StartServers " << qMin(serverLimit, 2) << "\n";
+        out << "    ThreadsPerChild " << threadsPerChild << "\n";
+        out << "    MaxRequestWorkers " << maxRequestWorkers << "\n";
+        out << "    MinSpareThreads " << threadsPerChild << "\n";
+        out << "    MaxSpareThreads " << threadsPerChild * qMax(2, serverLimit / 2) << "\n";
+        out << "    MaxConnectionsPerChild 0\n";
+        out << "</IfModule>\n\n";
+    }
+
+    out << "<IfModule mpm_worker_module>\n";
+    out << "    ServerLimit " << serverLimit << "\n";
+    out << "    ThreadLimit " << threadsPerChild << "\n";
+    out << "    StartServers " << qMin(serverLimit, 2) << "\n";
+    out << "    ThreadsPerChild " << threadsPerChild << "\n";
+    out << "    " << maxWorkersDirective << " " << maxRequestWorkers << "\n";
+    out << "    MinSpareThreads " << threadsPerChild << "\n";
+    out << "    MaxSpareThreads " << threadsPerChild * qMax(2, serverLimit / 2) << "\n";
+    out << "    " << maxConnectionsDirective << " 0\n";
+    out << "</IfModule>\n\n";
+
+    out << "<IfModule fcgid_module>\n";
+    out << "    FcgidMaxProcesses " << fcgidMaxProcesses << "\n";
+    out << "    FcgidMaxProcessesPerClass " << fcgidMaxProcesses << "\n";
+    out << "    FcgidMaxRequestsPerProcess " << fcgidMaxRequestsPerProcess << "\n";
+    out << "    FcgidIOTimeout " << fcgidIOTimeout << "\n";
+    out << "    FcgidProcessLifeTime " << fcgidProcessLifeTime << "\n";
+    out << "</IfModule>\n";
+    out.flush();
+    return content;
+}
@@ -0,0 +1,31 @@
+#ifndef APACHE_TUNING_PROFILE_H
+#define APACHE_TUNING_PROFILE_H
+
+#include <QString>
+#include <QStringList>
+
+class ApacheTuningProfile {
+public:
+    static QStringList availableProfiles();
+    static ApacheTuningProfile derive(const QString& name, const QString& apacheVersion, int expectedConcurrency);
+
+    QString getName() const;
+    QString render() const;
+
+private:
+    ApacheTuningProfile() {}
+
+    QString name;
+    QString apacheVersion;
+    bool legacyDirectives = false;
+    int threadsPerChild = 25;
+    int maxRequestWorkers = 150;
+    int serverLimit = 6;
+    int winntThreadsPerChild = 150;
+    int fcgidMaxProcesses = 4;
+    int fcgidMaxRequestsPerProcess = 500;
+    int fcgidIOTimeout = 600;
+    int fcgidProcessLifeTime = 3600;
+};
+
+#endif // APACHE_TUNING_PROFILE_H
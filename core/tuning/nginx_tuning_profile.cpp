@@ -0,0 +1,152 @@
+#include "nginx_tuning_profile.h"
+#include "../../utility/config_editor.h"
+#include <QThread>
+#include <QRegularExpression>
+#include <QSet>
+
+QStringList NginxTuningProfile::availableProfiles() {
+    return QStringList() << "none" << "development" << "staging" << "production";
+}
+
+NginxTuningProfile NginxTuningProfile::preset(const QString &name) {
+    NginxTuningProfile profile;
+    profile.name = name;
+
+    if (name == "development") {
+        profile.workerProcesses = "1";
+        profile.workerConnections = 1024;
+        profile.keepaliveRequests = 100;
+    } else if (name == "staging") {
+        profile.workerProcesses = "auto";
+        profile.workerConnections = 2048;
+        profile.multiAccept = true;
+        profile.tcpNopush = true;
+        profile.openFileCacheMax = 2000;
+        profile.openFileCacheMinUses = 2;
+        profile.keepaliveRequests = 1000;
+        profile.gzip = true;
+        profile.gzipCompLevel = 4;
+    } else if (name == "production") {
+        profile.workerProcesses = "auto";
+        profile.workerConnections = 4096;
+        profile.multiAccept = true;
+        profile.tcpNopush = true;
+        profile.openFileCacheMax = 10000;
+        profile.openFileCacheInactive = 30;
+        profile.openFileCacheValid = 60;
+        profile.openFileCacheMinUses = 2;
+        profile.keepaliveRequests = 10000;
+        profile.gzip = true;
+        profile.gzipCompLevel = 5;
+#if defined(Q_OS_LINUX)
+        profile.cpuAffinity = QThread::idealThreadCount() > 1;
+        profile.reuseport = true;
+#endif
+    } else {
+        QString errMsg = "Failed to load Nginx performance profile: profile " + name + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    profile.workerRlimitNofile = profile.workerConnections * 2;
+    return profile;
+}
+
+QString NginxTuningProfile::getName() const {
+    return name;
+}
+
+QString NginxTuningProfile::apply(const QString &config, int listenPort) const {
+    auto onOff = [](bool value) { return QString(value ? "on" : "off"); };
+    QString result = config;
+
+    result = ConfigEditor::setNginxDirective(result, "", "worker_processes", workerProcesses);
+    if (cpuAffinity) {
+        result = ConfigEditor::setNginxDirective(result, "", "worker_cpu_affinity", "auto");
+    } else {
+        result = ConfigEditor::removeNginxDirective(result, "", "worker_cpu_affinity");
+    }
+    result = ConfigEditor::setNginxDirective(result, "", "worker_rlimit_nofile", QString::number(workerRlimitNofile));
+
+    result = ConfigEditor::setNginxDirective(result, "events", "worker_connections", QString::number(workerConnections));
+    result = ConfigEditor::setNginxDirective(result, "events", "multi_accept", onOff(multiAccept));
+
+    result = ConfigEditor::setNginxDirective(result, "http", "sendfile", onOff(sendfile));
+    result = ConfigEditor::setNginxDirective(result, "http", "tcp_nopush", onOff(tcpNopush));
+    result = ConfigEditor::setNginxDirective(result, "http", "tcp_nodelay", onOff(tcpNodelay));
+    if (openFileCacheMax > 0) {
+        result = ConfigEditor::setNginxDirective(result, "http", "open_file_cache",
+                                                 QString("max=%1 inactive=%2s").arg(openFileCacheMax).arg(openFileCacheInactive));
+        result = ConfigEditor::setNginxDirective(result, "http", "open_file_cache_valid", QString::number(openFileCacheValid) + "s");
+        result = ConfigEditor::setNginxDirective(result, "http", "open_file_cache_min_uses", QString::number(openFileCacheMinUses));
+        result = ConfigEditor::setNginxDirective(result, "http", "open_file_cache_errors", "on");
+    } else {
+        result = ConfigEditor::setNginxDirective(result, "http", "open_file_cache", "off");
+        result = ConfigEditor::removeNginxDirective(result, "http", "open_file_cache_valid");
+        result = ConfigEditor::removeNginxDirective(result, "http", "open_file_cache_min_uses");
+        result = ConfigEditor::removeNginxDirective(result, "http", "open_file_cache_errors");
+    }
+    result = ConfigEditor::setNginxDirective(result, "http", "keepalive_requests", QString::number(keepaliveRequests));
+
+    result = ConfigEditor::setNginxDirective(result, "http", "gzip", onOff(gzip));
+    if (gzip) {
+        result = ConfigEditor::setNginxDirective(result, "http", "gzip_comp_level", QString::number(gzipCompLevel));
+        result = ConfigEditor::setNginxDirective(result, "http", "gzip_min_length", "1024");
+        result = ConfigEditor::setNginxDirective(result, "http", "gzip_vary", "on");
+        result = ConfigEditor::setNginxDirective(result, "http", "gzip_proxied", "any");
+        result = ConfigEditor::setNginxDirective(result, "http", "gzip_types",
+                                                 "text/css text/plain text/xml application/javascript application/json application/xml image/svg+xml");
+    } else {
+        result = ConfigEditor::removeNginxDirective(result, "http", "gzip_comp_level");
+        result = ConfigEditor::removeNginxDirective(result, "http", "gzip_min_length");
+        result = ConfigEditor::removeNginxDirective(result, "http", "gzip_vary");
+        result = ConfigEditor::removeNginxDirective(result, "http", "gzip_proxied");
+        result = ConfigEditor::removeNginxDirective(result, "http", "gzip_types");
+    }
+
+    return setReuseport(result, listenPort, reuseport);
+}
+
+QString NginxTuningProfile::strip(const QString &config, int listenPort) {
+    static const QStringList mainDirectives = QStringList() << "worker_cpu_affinity" << "worker_rlimit_nofile";
+    static const QStringList httpDirectives = QStringList()
+        << "tcp_nopush" << "tcp_nodelay" << "open_file_cache" << "open_file_cache_valid" << "open_file_cache_min_uses"
+        << "open_file_cache_errors" << "keepalive_requests" << "gzip" << "gzip_comp_level" << "gzip_min_length"
+        << "gzip_vary" << "gzip_proxied" << "gzip_types";
+    QString result = config;
+    // Values of the nginx.conf shipped with Nginx.
+    result = ConfigEditor::setNginxDirective(result, "", "worker_processes", "1");
+    result = ConfigEditor::setNginxDirective(result, "events", "worker_connections", "1024");
+    result = ConfigEditor::removeNginxDirective(result, "events", "multi_accept");
+    result = ConfigEditor::setNginxDirective(result, "http", "sendfile", "on");
+    for (const QString& directive : mainDirectives) {
+        result = ConfigEditor::removeNginxDirective(result, "", directive);
+    }
+    for (const QString& directive : httpDirectives) {
+        result = ConfigEditor::removeNginxDirective(result, "http", directive);
+    }
+    return setReuseport(result, listenPort, false);
+}
+
+QString NginxTuningProfile::setReuseport(const QString &config, int listenPort, bool enabled) {
+    // reuseport may only appear once per address:port, so it goes on the first listen of each.
+    QRegularExpression listenRegex("\\blisten\\s+((?:\\S+:)?" + QString::number(listenPort) + ")\\b([^;]*);");
+    QRegularExpression reuseportRegex("\\s+reuseport\\b");
+    QSet<QString> addresses;
+    QString result;
+    qsizetype position = 0;
+    QRegularExpressionMatchIterator it = listenRegex.globalMatch(config);
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        QString address = match.captured(1);
+        QString parameters = match.captured(2);
+        parameters.remove(reuseportRegex);
+        if (enabled && !addresses.contains(address)) {
+            parameters += " reuseport";
+        }
+        addresses.insert(address);
+        result += config.mid(position, match.capturedStart() - position);
+        result += "listen " + address + parameters + ";";
+        position = match.capturedEnd();
+    }
+    result += config.mid(position);
+    return result;
+}
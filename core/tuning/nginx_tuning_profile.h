@@ -0,0 +1,40 @@
+#ifndef NGINX_TUNING_PROFILE_H
+#define NGINX_TUNING_PROFILE_H
+
+#include <QString>
+#include <QStringList>
+
+class NginxTuningProfile {
+public:
+    static QStringList availableProfiles();
+    static NginxTuningProfile preset(const QString& name);
+
+    QString getName() const;
+    QString apply(const QString& config, int listenPort) const;
+    static QString strip(const QString& config, int listenPort);
+
+private:
+    NginxTuningProfile() {}
+
+    static QString setReuseport(const QString& config, int listenPort, bool enabled);
+
+    QString name;
+    QString workerProcesses;
+    bool cpuAffinity = false;
+    int workerConnections = 1024;
+    int workerRlimitNofile = 2048;
+    bool multiAccept = false;
+    bool sendfile = true;
+    bool tcpNopush = false;
+    bool tcpNodelay = true;
+    int openFileCacheMax = 0;
+    int openFileCacheInactive = 20;
+    int openFileCacheValid = 30;
+    int openFileCacheMinUses = 2;
+    int keepaliveRequests = 100;
+    bool reuseport = false;
+    bool gzip = false;
+    int gzipCompLevel = 1;
+};
+
+#endif // NGINX_TUNING_PROFILE_H
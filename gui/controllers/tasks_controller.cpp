@@ -3,117 +3,87 @@
 #include "../../core/singleton/server_manager.h"
 #include "qapplication.h"
 #include <QMessageBox>
+#include <QTimer>
 
 TasksController::TasksController(QObject *parent) :
     QObject(parent)
-    , progressDialog(nullptr)
-    , apacheThread(new QThread(this))
-    , apacheTask(new ServerTask())
-    , nginxThread(new QThread(this))
-    , nginxTask(new ServerTask())
-    , mysqlThread(new QThread(this))
-    , mysqlTask(new ServerTask()){
-    apacheTask->moveToThread(apacheThread);
-    nginxTask->moveToThread(nginxThread);
-
-    connect(apacheTask, &ServerTask::errorOccurred, (MainWindow*)parent, &MainWindow::handleError);
-    connect(nginxTask, &ServerTask::errorOccurred, (MainWindow*)parent, &MainWindow::handleError);
-    connect(apacheThread, &QThread::finished, apacheThread, &QObject::deleteLater);
-    connect(nginxThread, &QThread::finished, nginxThread, &QObject::deleteLater);
-
+    , progressDialog(nullptr){
+    connect(this, &TasksController::errorOccurred, (MainWindow*)parent, &MainWindow::handleError);
 }
 
 TasksController::~TasksController() {
 }
 
-void TasksController::startServer(const QString& serverName) {
-
-    if(serverName == "apache") {
-        if(!apacheThread->isRunning()){
-            apacheThread = new QThread(this);
-            apacheTask = new ServerTask();
-            apacheTask->moveToThread(apacheThread);
-            apacheThread->start();
-        }
-        QMetaObject::invokeMethod(apacheTask, "startServer", Qt::QueuedConnection, Q_ARG(QString, "apache"));
-    }
-    else if(serverName == "nginx"){
-        if(!nginxThread->isRunning()){
-            nginxThread = new QThread(this);
-            nginxTask = new ServerTask();
-            nginxTask->moveToThread(nginxThread);
-            nginxThread->start();
-        }
-        QMetaObject::invokeMethod(nginxTask, "startServer", Qt::QueuedConnection, Q_ARG(QString, "nginx"));
-    }
-    else if(serverName == "mysql"){
-        if(!mysqlThread->isRunning()){
-            mysqlThread = new QThread(this);
-            mysqlTask = new ServerTask();
-            mysqlTask->moveToThread(mysqlThread);
-            mysqlThread->start();
-        }
-        QMetaObject::invokeMethod(mysqlTask, "startServer", Qt::QueuedConnection, Q_ARG(QString, "mysql"));
-    }
-    else{
-        QString errMsg = "Cannot start the server: server " + serverName + " not found.";
+QFuture<void> TasksController::submit(const QString &serverName, const QString &description, const QString &errorTitle, std::function<void()> task) {
+    if (!(serverName == "apache" || serverName == "nginx" || serverName == "mysql" || serverName == "mysql_proxy")) {
+        QString errMsg = "Cannot " + description + " the server: server " + serverName + " not found.";
         throw std::runtime_error(errMsg.toStdString());
     }
+    return ServerManager::getInstance().getFacade().getTaskPool().submit(serverName, description, std::move(task))
+        .onFailed(this, [this, errorTitle](const std::exception& e) {
+            emit errorOccurred(errorTitle, QString::fromUtf8(e.what()));
+        });
 }
 
-void TasksController::stopServer(const QString& serverName) {
-    if(serverName == "apache") {
-        if(!apacheThread->isRunning()){
-            qWarning() << "Cannot stop Apache server: Apache is not running.";
-            return;
-        }
-        QMetaObject::invokeMethod(apacheTask, "stopServer", Qt::QueuedConnection, Q_ARG(QString, "apache"));
-    }
-    else if(serverName == "nginx"){
-        if(!nginxThread->isRunning()){
-            qWarning() << "Cannot stop Nginx server: Nginx is not running.";
-            return;
-        }
-        QMetaObject::invokeMethod(nginxTask, "stopServer", Qt::QueuedConnection, Q_ARG(QString, "nginx"));
-    }
-    else if(serverName == "mysql") {
-        if(!mysqlThread->isRunning()){
-            qWarning() << "Cannot stop Apache server: MySQL is not running.";
-            return;
-        }
-        QMetaObject::invokeMethod(mysqlTask, "stopServer", Qt::QueuedConnection, Q_ARG(QString, "mysql"));
-    }
-    else {
-        QString errMsg = "Cannot start the server: server " + serverName + " not found.";
-        throw std::runtime_error(errMsg.toStdString());
-    }
+QFuture<void> TasksController::startServer(const QString& serverName) {
+    return submit(serverName, "start", "Failed to start the server", [serverName]() {
+        ServerManager::getInstance().getFacade().startServer(serverName);
+    });
+}
+
+QFuture<void> TasksController::stopServer(const QString& serverName) {
+    return submit(serverName, "stop", "Failed to stop the server", [serverName]() {
+        ServerManager::getInstance().getFacade().stopServer(serverName);
+    });
+}
+
+QFuture<void> TasksController::restartServer(const QString &serverName) {
+    return submit(serverName, "restart", "Failed to restart the server", [serverName]() {
+        ServerManager::getInstance().getFacade().restartServer(serverName);
+    });
+}
+
+QFuture<void> TasksController::applyConfiguration(const QString &serverName, const QString &description, std::function<void()> apply) {
+    return submit(serverName, description, "Failed to apply the configuration", std::move(apply));
 }
 
 void TasksController::stopAllServers() {
     stopServer("apache");
     stopServer("nginx");
     stopServer("mysql");
+    if (ServerManager::getInstance().getFacade().getServerState("mysql_proxy")) {
+        stopServer("mysql_proxy");
+    }
 }
 
 void TasksController::startAllServers() {
     startServer("apache");
     startServer("nginx");
     startServer("mysql");
+    if (ServerManager::getInstance().getFacade().getServerConfiguration("mysql_proxy")["enabled"].toBool()) {
+        startServer("mysql_proxy");
+    }
 }
 
-void TasksController::stopAllTasks() {
-    if (apacheThread->isRunning()) {
-        apacheThread->quit();
-        apacheThread->wait();
-    }
-    if (nginxThread->isRunning()) {
-        nginxThread->quit();
-        nginxThread->wait();
-    }
-    if (mysqlThread->isRunning()) {
-        mysqlThread->quit();
-        mysqlThread->wait();
+void TasksController::stopAllTasks(std::function<void()> onStopped) {
+    TaskPool& taskPool = ServerManager::getInstance().getFacade().getTaskPool();
+    taskPool.cancelPending();
+    if (taskPool.waitForDone(0)) {
+        onStopped();
+        return;
     }
+    // Running tasks may still hand objects back to the GUI thread, so keep the
+    // event loop alive while they drain instead of blocking on the pool.
+    QTimer* timer = new QTimer(this);
+    timer->setInterval(20);
+    connect(timer, &QTimer::timeout, this, [timer, onStopped]() {
+        if (ServerManager::getInstance().getFacade().getTaskPool().waitForDone(0)) {
+            timer->stop();
+            timer->deleteLater();
+            onStopped();
+        }
+    });
+    timer->start();
 }
 
 void TasksController::setProgressDialog(QProgressDialog* dialog) {
@@ -134,17 +104,18 @@ void TasksController::exitApplication() {
     bool apacheState = ServerManager::getInstance().getFacade().getServerState("apache");
     bool nginxState = ServerManager::getInstance().getFacade().getServerState("nginx");
     bool mysqlState = ServerManager::getInstance().getFacade().getServerState("mysql");
+    bool mysqlProxyState = ServerManager::getInstance().getFacade().getServerState("mysql_proxy");
 
-    if (allFalse({apacheState, nginxState, mysqlState})) {
-        this->stopAllTasks();
+    auto finish = [this]() {
         progressDialog->hide();
         QApplication::exit();
+    };
+    if (allFalse({apacheState, nginxState, mysqlState, mysqlProxyState})) {
+        this->stopAllTasks(finish);
     } else {
-        QMainWindow::connect(&(ServerManager::getInstance().getFacade()), &ServerFacade::allServersStopped, this, [this](){
+        QMainWindow::connect(&(ServerManager::getInstance().getFacade()), &ServerFacade::allServersStopped, this, [this, finish](){
             qDebug() << "All servers stopped.";
-            this->stopAllTasks();
-            progressDialog->hide();
-            QApplication::exit();
+            this->stopAllTasks(finish);
         } );
         this->stopAllServers();
     }
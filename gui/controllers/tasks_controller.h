@@ -2,12 +2,9 @@
 #define TASKS_CONTROLLER_H
 
 #include <QObject>
-#include <QHash>
-#include <QThread>
+#include <QFuture>
 #include <QProgressDialog>
-#include <QHash>
-
-#include "../../utility/server_task.h"
+#include <functional>
 
 class TasksController : public QObject {
     Q_OBJECT
@@ -16,23 +13,23 @@ public:
     explicit TasksController(QObject *parent = nullptr);
     ~TasksController();
 
-    void startServer(const QString& serverName);
-    void stopServer(const QString& serverName);
+    QFuture<void> startServer(const QString& serverName);
+    QFuture<void> stopServer(const QString& serverName);
+    QFuture<void> restartServer(const QString& serverName);
+    QFuture<void> applyConfiguration(const QString& serverName, const QString& description, std::function<void()> apply);
     void stopAllServers();
     void startAllServers();
-    void stopAllTasks();
+    void stopAllTasks(std::function<void()> onStopped);
     void setProgressDialog(QProgressDialog* dialog);
     void exitApplication();
 
+signals:
+    void errorOccurred(const QString& errorTitle, const QString& errorMessage);
+
 private:
     QProgressDialog* progressDialog;
-    QThread* apacheThread;
-    ServerTask* apacheTask;
-    QThread* nginxThread;
-    ServerTask* nginxTask;
-    QThread* mysqlThread;
-    ServerTask* mysqlTask;
 
+    QFuture<void> submit(const QString& serverName, const QString& description, const QString& errorTitle, std::function<void()> task);
 };
 
 #endif // TASKSCONTROLLER_H
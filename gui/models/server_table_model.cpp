@@ -0,0 +1,261 @@
+#include "server_table_model.h"
+#include "../../core/singleton/server_manager.h"
+#include "../../utility/trace.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QDebug>
+
+ServerTableModel::ServerTableModel(QObject *parent)
+    : QAbstractTableModel(parent), refreshTimer(this)
+{
+    refreshTimer.setInterval(refreshInterval);
+    connect(&refreshTimer, &QTimer::timeout, this, &ServerTableModel::refresh);
+    refreshTimer.start();
+}
+
+const QIcon& ServerTableModel::stateIcon(bool isRunning) {
+    static const QIcon runningIcon(":/icons/icons/on1.png");
+    static const QIcon stoppedIcon(":/icons/icons/off1.png");
+    return isRunning ? runningIcon : stoppedIcon;
+}
+
+int ServerTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int ServerTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ServerTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+    const Row& row = rows.at(index.row());
+    if (role == Qt::DecorationRole && index.column() == StateColumn) {
+        return stateIcon(row.running);
+    }
+    if (role == Qt::ToolTipRole && index.column() == RequestsColumn && !row.details.isEmpty()) {
+        return row.details;
+    }
+    if (role == Qt::TextAlignmentRole && index.column() >= PidColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (index.column()) {
+    case NameColumn:
+        return row.name;
+    case StateColumn:
+        return row.running ? tr("Running") : tr("Stopped");
+    case PidColumn:
+        return row.pid > 0 ? QVariant(row.pid) : QVariant("-");
+    case PortsColumn:
+        return row.ports;
+    case UptimeColumn:
+        return row.running ? formatUptime(row.uptime) : QString("-");
+    case CpuColumn:
+        return row.pid > 0 ? QString::number(row.cpuPercent, 'f', 1) + " %" : QString("-");
+    case MemoryColumn:
+        return row.pid > 0 ? formatBytes(row.residentBytes) : QString("-");
+    case RequestsColumn:
+        return row.running && row.hasRequests ? QString::number(row.requestsPerSecond, 'f', 1) : QString("-");
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ServerTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case NameColumn:
+        return tr("Server");
+    case StateColumn:
+        return tr("State");
+    case PidColumn:
+        return tr("PID");
+    case PortsColumn:
+        return tr("Ports");
+    case UptimeColumn:
+        return tr("Uptime");
+    case CpuColumn:
+        return tr("CPU");
+    case MemoryColumn:
+        return tr("RSS");
+    case RequestsColumn:
+        return tr("Req/s");
+    default:
+        return QVariant();
+    }
+}
+
+void ServerTableModel::setServers(const QStringList &serverNames) {
+    beginResetModel();
+    rows.clear();
+    for (const QString& serverName : serverNames) {
+        Row row;
+        row.name = serverName;
+        try {
+            row.running = ServerManager::getInstance().getFacade().getServerState(serverName);
+        } catch (const std::runtime_error& e) {
+            qWarning() << e.what();
+        }
+        rows.append(row);
+    }
+    endResetModel();
+    refresh();
+}
+
+void ServerTableModel::setServerState(const QString &serverName, bool isRunning) {
+    for (int i = 0; i < rows.size(); ++i) {
+        if (rows[i].name == serverName) {
+            if (rows[i].running != isRunning) {
+                rows[i].running = isRunning;
+                emit dataChanged(index(i, StateColumn), index(i, StateColumn), {Qt::DisplayRole, Qt::DecorationRole});
+            }
+            return;
+        }
+    }
+}
+
+void ServerTableModel::refresh() {
+    TRACE_SCOPE("probe", "ServerTableModel::refresh");
+    TaskPool& taskPool = ServerManager::getInstance().getFacade().getTaskPool();
+    for (const Row& row : std::as_const(rows)) {
+        QString serverName = row.name;
+        if (pendingSamples.contains(serverName)) {
+            continue;
+        }
+        std::shared_ptr<ProcessStats> stats = processStats.value(serverName);
+        if (!stats) {
+            stats = std::make_shared<ProcessStats>();
+            processStats.insert(serverName, stats);
+        }
+        pendingSamples.insert(serverName);
+        // The status getters read members the server's strand mutates, so the
+        // sample is taken on that strand, which also keeps the /proc and
+        // access log reads off the GUI thread.
+        qint64 previousPid = row.pid;
+        auto sample = std::make_shared<Row>();
+        taskPool.submit(serverName, "sample status", [serverName, previousPid, stats, sample]() {
+            *sample = sampleRow(serverName, *stats);
+            if (sample->pid != previousPid && previousPid > 0) {
+                stats->forget(previousPid);
+            }
+        }).then(this, [this, sample]() {
+            pendingSamples.remove(sample->name);
+            applySample(*sample);
+        }).onCanceled(this, [this, serverName]() {
+            pendingSamples.remove(serverName);
+        });
+    }
+}
+
+void ServerTableModel::applySample(const Row &current) {
+    for (int i = 0; i < rows.size(); ++i) {
+        if (rows[i].name != current.name) {
+            continue;
+        }
+        int lastColumn = -1;
+        int firstColumn = firstChangedColumn(rows[i], current, lastColumn);
+        rows[i] = current;
+        if (lastColumn >= 0) {
+            emit dataChanged(index(i, firstColumn), index(i, lastColumn));
+        }
+        return;
+    }
+}
+
+ServerTableModel::Row ServerTableModel::sampleRow(const QString &serverName, ProcessStats &stats) {
+    Row row;
+    row.name = serverName;
+    QJsonObject status;
+    try {
+        status = ServerManager::getInstance().getFacade().getServerStatus(serverName);
+    } catch (const std::runtime_error& e) {
+        qWarning() << e.what();
+        return row;
+    }
+    row.running = status.value("running").toBool();
+    row.uptime = status.value("uptime").toInteger();
+
+    QStringList ports;
+    const QJsonArray portList = status.value("ports").toArray();
+    for (const QJsonValue& port : portList) {
+        ports.append(QString::number(port.toInt()));
+    }
+    row.ports = ports.join(", ");
+
+    if (row.running) {
+        ProcessStats::Sample sample = stats.sampleProcess(status.value("pid").toInteger());
+        if (sample.valid) {
+            row.pid = status.value("pid").toInteger();
+            row.cpuPercent = sample.cpuPercent;
+            row.residentBytes = sample.residentBytes;
+        }
+        QString accessLog = status.value("access_log").toString();
+        QJsonObject mysqlStatus = status.value("mysql_status").toObject();
+        if (!accessLog.isEmpty()) {
+            row.hasRequests = true;
+            row.requestsPerSecond = stats.sampleRequestRate(accessLog);
+        } else if (mysqlStatus.contains("qps")) {
+            row.hasRequests = true;
+            row.requestsPerSecond = mysqlStatus.value("qps").toDouble();
+            row.details = formatMySQLStatus(mysqlStatus);
+        }
+    }
+    return row;
+}
+
+int ServerTableModel::firstChangedColumn(const Row &previous, const Row &current, int &lastColumn) {
+    bool changed[ColumnCount] = {
+        previous.name != current.name,
+        previous.running != current.running,
+        previous.pid != current.pid,
+        previous.ports != current.ports,
+        previous.uptime != current.uptime,
+        !qFuzzyCompare(previous.cpuPercent + 1.0, current.cpuPercent + 1.0),
+        previous.residentBytes != current.residentBytes,
+        previous.hasRequests != current.hasRequests || !qFuzzyCompare(previous.requestsPerSecond + 1.0, current.requestsPerSecond + 1.0)
+            || previous.details != current.details
+    };
+    int firstColumn = ColumnCount;
+    lastColumn = -1;
+    for (int column = 0; column < ColumnCount; ++column) {
+        if (changed[column]) {
+            firstColumn = qMin(firstColumn, column);
+            lastColumn = column;
+        }
+    }
+    return firstColumn;
+}
+
+QString ServerTableModel::formatUptime(qint64 seconds) {
+    qint64 hours = seconds / 3600;
+    qint64 minutes = (seconds % 3600) / 60;
+    return QString("%1:%2:%3").arg(hours).arg(minutes, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+QString ServerTableModel::formatBytes(qint64 bytes) {
+    if (bytes >= 1024LL * 1024 * 1024) {
+        return QString::number(double(bytes) / (1024.0 * 1024 * 1024), 'f', 2) + " GiB";
+    }
+    if (bytes >= 1024LL * 1024) {
+        return QString::number(double(bytes) / (1024.0 * 1024), 'f', 1) + " MiB";
+    }
+    return QString::number(bytes / 1024) + " KiB";
+}
+
+QString ServerTableModel::formatMySQLStatus(const QJsonObject &mysqlStatus) {
+    QStringList lines;
+    lines << tr("Queries/s: %1").arg(mysqlStatus.value("qps").toDouble(), 0, 'f', 1);
+    lines << tr("Threads running: %1 of %2 connected").arg(mysqlStatus.value("threads_running").toInt()).arg(mysqlStatus.value("threads_connected").toInt());
+    lines << tr("Buffer pool hit ratio: %1 %").arg(mysqlStatus.value("buffer_pool_hit_ratio").toDouble() * 100.0, 0, 'f', 2);
+    lines << tr("Row lock waits/s: %1").arg(mysqlStatus.value("row_lock_waits_per_second").toDouble(), 0, 'f', 2);
+    lines << tr("Temp tables on disk/s: %1 (%2 % of temp tables)").arg(mysqlStatus.value("tmp_disk_tables_per_second").toDouble(), 0, 'f', 2)
+                                                                  .arg(mysqlStatus.value("tmp_tables_on_disk_ratio").toDouble() * 100.0, 0, 'f', 1);
+    return lines.join("\n");
+}
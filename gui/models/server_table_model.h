@@ -0,0 +1,75 @@
+#ifndef SERVER_TABLE_MODEL_H
+#define SERVER_TABLE_MODEL_H
+
+#include "../../utility/process_stats.h"
+#include <QAbstractTableModel>
+#include <QIcon>
+#include <QTimer>
+#include <QVector>
+#include <QStringList>
+#include <QJsonObject>
+#include <QHash>
+#include <QSet>
+#include <memory>
+
+class ServerTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        StateColumn,
+        PidColumn,
+        PortsColumn,
+        UptimeColumn,
+        CpuColumn,
+        MemoryColumn,
+        RequestsColumn,
+        ColumnCount
+    };
+
+    static const int refreshInterval = 1000;
+
+    explicit ServerTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    static const QIcon& stateIcon(bool isRunning);
+
+public slots:
+    void setServers(const QStringList& serverNames);
+    void setServerState(const QString& serverName, bool isRunning);
+    void refresh();
+
+private:
+    struct Row {
+        QString name;
+        bool running = false;
+        qint64 pid = 0;
+        QString ports;
+        qint64 uptime = 0;
+        double cpuPercent = 0.0;
+        qint64 residentBytes = 0;
+        double requestsPerSecond = 0.0;
+        bool hasRequests = false;
+        QString details;
+    };
+
+    QVector<Row> rows;
+    QHash<QString, std::shared_ptr<ProcessStats>> processStats;
+    QSet<QString> pendingSamples;
+    QTimer refreshTimer;
+
+    void applySample(const Row& current);
+    static Row sampleRow(const QString& serverName, ProcessStats& stats);
+    static int firstChangedColumn(const Row& previous, const Row& current, int& lastColumn);
+    static QString formatUptime(qint64 seconds);
+    static QString formatBytes(qint64 bytes);
+    static QString formatMySQLStatus(const QJsonObject& mysqlStatus);
+};
+
+#endif // SERVER_TABLE_MODEL_H
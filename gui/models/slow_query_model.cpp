@@ -0,0 +1,125 @@
+#include "slow_query_model.h"
+#include "../../core/singleton/server_manager.h"
+#include "../../utility/trace.h"
+#include <QJsonArray>
+#include <QDebug>
+
+SlowQueryModel::SlowQueryModel(QObject *parent)
+    : QAbstractTableModel(parent), refreshTimer(this)
+{
+    refreshTimer.setInterval(refreshInterval);
+    connect(&refreshTimer, &QTimer::timeout, this, &SlowQueryModel::refresh);
+    refreshTimer.start();
+}
+
+int SlowQueryModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int SlowQueryModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SlowQueryModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+    const QJsonObject& row = rows.at(index.row());
+    if (role == Qt::ToolTipRole && index.column() == FingerprintColumn) {
+        return row.value("example").toString();
+    }
+    if (role == Qt::TextAlignmentRole && index.column() > FingerprintColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (index.column()) {
+    case FingerprintColumn:
+        return row.value("fingerprint").toString();
+    case CountColumn:
+        return row.value("count").toInteger();
+    case TotalColumn:
+        return formatSeconds(row.value("total").toDouble());
+    case AverageColumn:
+        return formatSeconds(row.value("avg").toDouble());
+    case P95Column:
+        return formatSeconds(row.value("p95").toDouble());
+    case MaxColumn:
+        return formatSeconds(row.value("max").toDouble());
+    case RowsExaminedColumn:
+        return row.value("rows_examined").toInteger();
+    default:
+        return QVariant();
+    }
+}
+
+QVariant SlowQueryModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case FingerprintColumn:
+        return tr("Query");
+    case CountColumn:
+        return tr("Count");
+    case TotalColumn:
+        return tr("Total");
+    case AverageColumn:
+        return tr("Avg");
+    case P95Column:
+        return tr("P95");
+    case MaxColumn:
+        return tr("Max");
+    case RowsExaminedColumn:
+        return tr("Rows examined");
+    default:
+        return QVariant();
+    }
+}
+
+void SlowQueryModel::refresh() {
+    TRACE_SCOPE("probe", "SlowQueryModel::refresh");
+    QJsonArray top;
+    try {
+        top = ServerManager::getInstance().getFacade().getMySQLSlowQueries(rowLimit, "total").value("top").toArray();
+    } catch (const std::runtime_error& e) {
+        qWarning() << e.what();
+        return;
+    }
+
+    bool sameOrder = top.size() == rows.size();
+    for (int i = 0; sameOrder && i < rows.size(); ++i) {
+        sameOrder = rows[i].value("fingerprint") == top[i].toObject().value("fingerprint");
+    }
+    if (!sameOrder) {
+        beginResetModel();
+        rows.clear();
+        for (const QJsonValue& row : top) {
+            rows.append(row.toObject());
+        }
+        endResetModel();
+        return;
+    }
+
+    int firstChanged = -1;
+    for (int i = 0; i <= rows.size(); ++i) {
+        bool changed = i < rows.size() && rows[i] != top[i].toObject();
+        if (changed) {
+            rows[i] = top[i].toObject();
+            if (firstChanged < 0) {
+                firstChanged = i;
+            }
+        } else if (firstChanged >= 0) {
+            emit dataChanged(index(firstChanged, 0), index(i - 1, ColumnCount - 1));
+            firstChanged = -1;
+        }
+    }
+}
+
+QString SlowQueryModel::formatSeconds(double seconds) {
+    if (seconds < 1.0) {
+        return QString::number(seconds * 1000.0, 'f', 1) + " ms";
+    }
+    return QString::number(seconds, 'f', 2) + " s";
+}
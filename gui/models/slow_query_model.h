@@ -0,0 +1,45 @@
+#ifndef SLOW_QUERY_MODEL_H
+#define SLOW_QUERY_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QTimer>
+#include <QVector>
+#include <QJsonObject>
+
+class SlowQueryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        FingerprintColumn,
+        CountColumn,
+        TotalColumn,
+        AverageColumn,
+        P95Column,
+        MaxColumn,
+        RowsExaminedColumn,
+        ColumnCount
+    };
+
+    static const int refreshInterval = 2000;
+    static const int rowLimit = 50;
+
+    explicit SlowQueryModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+public slots:
+    void refresh();
+
+private:
+    QVector<QJsonObject> rows;
+    QTimer refreshTimer;
+
+    static QString formatSeconds(double seconds);
+};
+
+#endif // SLOW_QUERY_MODEL_H
@@ -2,6 +2,7 @@
 #include "./ui_mainwindow.h"
 #include "../../core/singleton/server_manager.h"
 #include "../../core/config/configuration_manager.h"
+#include "../../utility/trace.h"
 #include <QtConcurrent/QtConcurrent>
 #include <QMessageBox>
 #include <QTreeWidget>
@@ -11,15 +12,25 @@
 #include <QVBoxLayout>
 #include <QIntValidator>
 #include <QFileDialog>
+#include <QHeaderView>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , tasksController(new TasksController(this))
     , progressDialog(new QProgressDialog(this))
+    , notificationPanel(new NotificationPanel(this))
+    , serverTableModel(new ServerTableModel(this))
+    , dashboardDock(new QDockWidget(tr("Dashboard"), this))
+    , dashboardView(new QTableView(dashboardDock))
+    , slowQueryModel(new SlowQueryModel(this))
+    , slowQueryDock(new QDockWidget(tr("Slow Queries"), this))
+    , slowQueryView(new QTableView(slowQueryDock))
 {
+    TRACE_SCOPE("startup", "MainWindow::MainWindow");
 
     ui->setupUi(this);
+    addDockWidget(Qt::BottomDockWidgetArea, notificationPanel);
     progressDialog->setWindowTitle(tr("Stopping Servers"));
     progressDialog->setLabelText(tr("Please wait while stopping servers..."));
     progressDialog->setCancelButton(nullptr);
@@ -42,7 +53,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->saveMySQLConfigurationBtn, &QPushButton::clicked, this, &MainWindow::onSaveMySQLConfigurationButtonClicked);
     connect(&ServerManager::getInstance().getFacade(), &ServerManager::getInstance().getFacade().errorOccurred, this, &MainWindow::handleError);
     connect(&ServerManager::getInstance().getFacade(), &ServerManager::getInstance().getFacade().updateState, this, &MainWindow::setServerIndicator);
+    connect(&ServerManager::getInstance().getFacade(), &ServerManager::getInstance().getFacade().updateState, serverTableModel, &ServerTableModel::setServerState);
     connect(&ServerManager::getInstance().getFacade(), &ServerManager::getInstance().getFacade().displayServerWarning, this, &MainWindow::onDisplayServerWarning);
+    connect(&ServerManager::getInstance().getFacade(), &ServerManager::getInstance().getFacade().availableVersionsChanged, this, &MainWindow::onAvailableVersionsChanged);
     int pageIndex = 0;
     traverseTree(ui->treeWidget->invisibleRootItem(), pageIndex);
     connect(ui->treeWidget, &QTreeWidget::itemSelectionChanged, this, &MainWindow::onItemSelectionChanged);
@@ -50,6 +63,7 @@ MainWindow::MainWindow(QWidget *parent)
     setupApacheConfigurationPage();
     setupNginxConfigurationPage();
     setupMySQLConfigurationPage();
+    setupDashboard();
 }
 
 MainWindow::~MainWindow()
@@ -59,7 +73,7 @@ MainWindow::~MainWindow()
 
 void MainWindow::handleError(const QString& errorTitle, const QString& errorMessage)
 {
-    QMessageBox::critical(this, errorTitle, errorMessage);
+    notificationPanel->addNotification(errorTitle, errorMessage);
 }
 
 void MainWindow::onStartApacheButtonClicked()
@@ -129,7 +143,9 @@ void MainWindow::onItemSelectionChanged() {
 
 void MainWindow::setServerIndicator(const QString& serverName, bool isRunning) {
     try {
-        QPixmap pixmap(isRunning ? ":/icons/icons/on1.png" : ":/icons/icons/off1.png");
+        static const QPixmap runningPixmap(":/icons/icons/on1.png");
+        static const QPixmap stoppedPixmap(":/icons/icons/off1.png");
+        const QPixmap& pixmap = isRunning ? runningPixmap : stoppedPixmap;
         if(serverName == "apache") {
             ui->apacheIndicator->setPixmap(pixmap);
             ui->apacheIndicator_2->setPixmap(pixmap);
@@ -141,6 +157,8 @@ void MainWindow::setServerIndicator(const QString& serverName, bool isRunning) {
         else if(serverName == "nginx") {
             ui->nginxIndicator->setPixmap(pixmap);
             ui->nginxIndicator_2->setPixmap(pixmap);
+        } else if(serverName == "mysql_proxy") {
+            return;
         } else{
             QString errMsg = "Failed to set server indicator state: server " + serverName + " not found.";
             throw std::runtime_error(errMsg.toStdString());
@@ -160,7 +178,7 @@ void MainWindow::onDisplayServerWarning(const QString &serverName, const QString
     } else if(serverName == "nginx") {
         ui->nginxWarning->setText(errorMessage);
 
-    } else if(serverName == "mysql") {
+    } else if(serverName == "mysql" || serverName == "mysql_proxy") {
         ui->mysqlWarning->setText(errorMessage);
     }
     else{
@@ -186,6 +204,11 @@ void MainWindow::onSaveApacheConfigurationButtonClicked(){
                                  QMessageBox::Ok);
         return;
     }
+    if(ServerManager::getInstance().getFacade().isWorkspaceProfileActive("apache")){
+        QMessageBox::information(this, "Configuration", "Configuration cannot be applied while workspace profile " + ServerManager::getInstance().getFacade().getActiveWorkspaceProfile() + " is active. Deactivate the profile and save the configuration.",
+                                 QMessageBox::Ok);
+        return;
+    }
     QStringList validationErrors;
     try {
         ServerManager::getInstance().getFacade().setServerVersion("apache", ui->apacheVersionSelect->currentText());
@@ -213,6 +236,12 @@ void MainWindow::onSaveApacheConfigurationButtonClicked(){
     } catch (const std::runtime_error &e) {
         QMessageBox::critical(nullptr, "Failed to set configuration", e.what());
     }
+    try {
+        QJsonObject currentConfig = ServerManager::getInstance().getFacade().getServerConfiguration("apache");
+        ServerManager::getInstance().getFacade().setApacheTuningProfiles(currentConfig["tuning_profiles"].toObject(), currentConfig["expected_concurrency"].toInt());
+    } catch (const std::runtime_error &e) {
+        QMessageBox::critical(nullptr, "Failed to set configuration", e.what());
+    }
     QJsonObject apacheConfig = ServerManager::getInstance().getFacade().getServerConfiguration("apache");
     ConfigurationManager& configManager = ConfigurationManager::getInstance();
     try {
@@ -234,6 +263,11 @@ void MainWindow::onSaveNginxConfigurationButtonClicked(){
                               QMessageBox::Ok);
         return;
     }
+    if(ServerManager::getInstance().getFacade().isWorkspaceProfileActive("nginx")){
+        QMessageBox::information(this, "Configuration", "Configuration cannot be applied while workspace profile " + ServerManager::getInstance().getFacade().getActiveWorkspaceProfile() + " is active. Deactivate the profile and save the configuration.",
+                                 QMessageBox::Ok);
+        return;
+    }
     QStringList validationErrors;
     try {
         ServerManager::getInstance().getFacade().setServerVersion("nginx", ui->nginxVersionSelect->currentText());
@@ -269,6 +303,12 @@ void MainWindow::onSaveNginxConfigurationButtonClicked(){
     } catch (const std::runtime_error &e) {
         QMessageBox::critical(nullptr, "Failed to set configuration", e.what());
     }
+    try {
+        QString profile = ServerManager::getInstance().getFacade().getServerConfiguration("nginx")["performance_profile"].toString();
+        ServerManager::getInstance().getFacade().setNginxPerformanceProfile(profile);
+    } catch (const std::runtime_error &e) {
+        QMessageBox::critical(nullptr, "Failed to set configuration", e.what());
+    }
     QJsonObject nginxConfig = ServerManager::getInstance().getFacade().getServerConfiguration("nginx");
     ConfigurationManager& configManager = ConfigurationManager::getInstance();
     try {
@@ -290,6 +330,11 @@ void MainWindow::onSaveMySQLConfigurationButtonClicked(){
                               QMessageBox::Ok);
         return;
     }
+    if(ServerManager::getInstance().getFacade().isWorkspaceProfileActive("mysql")){
+        QMessageBox::information(this, "Configuration", "Configuration cannot be applied while workspace profile " + ServerManager::getInstance().getFacade().getActiveWorkspaceProfile() + " is active. Deactivate the profile and save the configuration.",
+                                 QMessageBox::Ok);
+        return;
+    }
     QStringList validationErrors;
     try {
         ServerManager::getInstance().getFacade().setServerVersion("mysql", ui->mysqlVersionSelect->currentText());
@@ -319,6 +364,7 @@ void MainWindow::onSaveMySQLConfigurationButtonClicked(){
 }
 
 void MainWindow::setupApacheConfigurationPage() {
+    TRACE_SCOPE("startup", "MainWindow::setupApacheConfigurationPage");
     QObject::connect(ui->apachePortLineEdit, &QLineEdit::textChanged, [this]() {
         ui->apachePortWarning->setText("");
         QString text = ui->apachePortLineEdit->text();
@@ -374,6 +420,7 @@ void MainWindow::setupApacheConfigurationPage() {
 }
 
 void MainWindow::setupNginxConfigurationPage() {
+    TRACE_SCOPE("startup", "MainWindow::setupNginxConfigurationPage");
     QObject::connect(ui->nginxPortLineEdit, &QLineEdit::textChanged, [this]() {
         ui->nginxPortWarning->setText("");
         QString text = ui->nginxPortLineEdit->text();
@@ -440,6 +487,7 @@ void MainWindow::setupNginxConfigurationPage() {
 
 void MainWindow::setupMySQLConfigurationPage()
 {
+    TRACE_SCOPE("startup", "MainWindow::setupMySQLConfigurationPage");
     QObject::connect(ui->mysqlPortLineEdit, &QLineEdit::textChanged, [this]() {
         ui->mysqlPortWarning->setText("");
         QString text = ui->mysqlPortLineEdit->text();
@@ -466,6 +514,61 @@ void MainWindow::setupMySQLConfigurationPage()
     ui->mysqlPortLineEdit->setText(QString::number(mysqlConfig["port"].toDouble()));
 }
 
+void MainWindow::onAvailableVersionsChanged()
+{
+    ServerFacade& facade = ServerManager::getInstance().getFacade();
+    refreshVersionSelect(ui->apacheVersionSelect, facade.getAvailableVersions("apache"));
+    refreshVersionSelect(ui->apachePHPVersionSelect, facade.getAvailablePHPVersions("apache"));
+    refreshVersionSelect(ui->nginxVersionSelect, facade.getAvailableVersions("nginx"));
+    refreshVersionSelect(ui->nginxPHPVersionSelect, facade.getAvailablePHPVersions("nginx"));
+    refreshVersionSelect(ui->mysqlVersionSelect, facade.getAvailableVersions("mysql"));
+}
+
+void MainWindow::refreshVersionSelect(QComboBox *select, const QJsonObject &versions)
+{
+    QString current = select->currentText();
+    QSignalBlocker blocker(select);
+    select->clear();
+    for (auto it = versions.begin(); it != versions.end(); ++it) {
+        select->addItem(it.key());
+    }
+    int index = select->findText(current);
+    if (index != -1) {
+        select->setCurrentIndex(index);
+    }
+}
+
+void MainWindow::setupDashboard()
+{
+    TRACE_SCOPE("startup", "MainWindow::setupDashboard");
+    dashboardDock->setObjectName("dashboardDock");
+    dashboardDock->setFeatures(QDockWidget::DockWidgetClosable | QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable);
+    dashboardView->setModel(serverTableModel);
+    dashboardView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    dashboardView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    dashboardView->verticalHeader()->hide();
+    dashboardView->horizontalHeader()->setStretchLastSection(true);
+    dashboardDock->setWidget(dashboardView);
+    addDockWidget(Qt::BottomDockWidgetArea, dashboardDock);
+    tabifyDockWidget(dashboardDock, notificationPanel);
+
+    slowQueryDock->setObjectName("slowQueryDock");
+    slowQueryDock->setFeatures(QDockWidget::DockWidgetClosable | QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetFloatable);
+    slowQueryView->setModel(slowQueryModel);
+    slowQueryView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    slowQueryView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    slowQueryView->setWordWrap(false);
+    slowQueryView->verticalHeader()->hide();
+    slowQueryView->horizontalHeader()->setSectionResizeMode(SlowQueryModel::FingerprintColumn, QHeaderView::Stretch);
+    slowQueryDock->setWidget(slowQueryView);
+    addDockWidget(Qt::BottomDockWidgetArea, slowQueryDock);
+    tabifyDockWidget(dashboardDock, slowQueryDock);
+
+    dashboardDock->raise();
+    serverTableModel->setServers(ServerManager::getInstance().getFacade().getServerNames());
+    dashboardView->resizeColumnsToContents();
+}
+
 void MainWindow::closeEvent(QCloseEvent *event)
 {
 
@@ -2,11 +2,18 @@
 #define MAINWINDOW_H
 
 #include "../controllers/tasks_controller.h"
+#include "notification_panel.h"
+#include "../models/server_table_model.h"
+#include "../models/slow_query_model.h"
 #include <QMainWindow>
 #include <QProgressDialog>
 #include <QTreeWidgetItem>
 #include <QMessageBox>
 #include <QCloseEvent>
+#include <QDockWidget>
+#include <QTableView>
+#include <QComboBox>
+#include <QJsonObject>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -26,6 +33,7 @@ public slots:
     void onItemSelectionChanged();
     void setServerIndicator(const QString& serverName, bool isRunning);
     void onDisplayServerWarning(const QString& serverName, const QString& errorMessage);
+    void onAvailableVersionsChanged();
 private slots:
     void onStartApacheButtonClicked();
     void onStartMySQLButtonClicked();
@@ -44,11 +52,20 @@ private:
     Ui::MainWindow *ui;
     TasksController *tasksController;
     QProgressDialog *progressDialog;
+    NotificationPanel *notificationPanel;
+    ServerTableModel *serverTableModel;
+    QDockWidget *dashboardDock;
+    QTableView *dashboardView;
+    SlowQueryModel *slowQueryModel;
+    QDockWidget *slowQueryDock;
+    QTableView *slowQueryView;
 
     void traverseTree(QTreeWidgetItem *parentItem, int &pageIndex);
     void setupApacheConfigurationPage();
     void setupNginxConfigurationPage();
     void setupMySQLConfigurationPage();
+    void setupDashboard();
+    void refreshVersionSelect(QComboBox *select, const QJsonObject& versions);
 
 protected:
     void closeEvent(QCloseEvent *event) override;
@@ -0,0 +1,81 @@
+#include "notification_panel.h"
+#include <QColor>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QWidget>
+
+NotificationPanel::NotificationPanel(QWidget *parent)
+    : QDockWidget(tr("Notifications"), parent)
+    , notificationList(new QListWidget(this))
+    , clearButton(new QPushButton(tr("Clear"), this))
+{
+    setObjectName("notificationPanel");
+    setFeatures(QDockWidget::DockWidgetClosable | QDockWidget::DockWidgetMovable);
+
+    QWidget *content = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+    notificationList->setWordWrap(true);
+    notificationList->setSelectionMode(QAbstractItemView::NoSelection);
+    layout->addWidget(notificationList);
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(clearButton);
+    layout->addLayout(buttonLayout);
+    setWidget(content);
+
+    connect(clearButton, &QPushButton::clicked, this, &NotificationPanel::clearNotifications);
+    hide();
+}
+
+int NotificationPanel::notificationCount() const {
+    return notificationList->count();
+}
+
+void NotificationPanel::addNotification(const QString &title, const QString &message) {
+    QString key = title + '\n' + message;
+    QString time = QDateTime::currentDateTime().toString("HH:mm:ss");
+    QListWidgetItem *item = itemsByKey.value(key, nullptr);
+    if (item) {
+        int count = ++repeatCounts[item];
+        item->setText("[" + time + "] " + title + ": " + message + " (x" + QString::number(count) + ")");
+        notificationList->takeItem(notificationList->row(item));
+        notificationList->insertItem(0, item);
+    } else {
+        if (notificationList->count() >= maxNotifications) {
+            removeOldest();
+        }
+        item = new QListWidgetItem("[" + time + "] " + title + ": " + message);
+        item->setToolTip(message);
+        item->setForeground(QColor(255, 110, 110));
+        notificationList->insertItem(0, item);
+        itemsByKey.insert(key, item);
+        repeatCounts.insert(item, 1);
+    }
+    if (!isVisible()) {
+        show();
+    }
+}
+
+void NotificationPanel::clearNotifications() {
+    notificationList->clear();
+    itemsByKey.clear();
+    repeatCounts.clear();
+    hide();
+}
+
+void NotificationPanel::removeOldest() {
+    QListWidgetItem *item = notificationList->takeItem(notificationList->count() - 1);
+    if (!item) {
+        return;
+    }
+    for (auto it = itemsByKey.begin(); it != itemsByKey.end(); ++it) {
+        if (it.value() == item) {
+            itemsByKey.erase(it);
+            break;
+        }
+    }
+    repeatCounts.remove(item);
+    delete item;
+}
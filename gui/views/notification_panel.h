@@ -0,0 +1,33 @@
+#ifndef NOTIFICATION_PANEL_H
+#define NOTIFICATION_PANEL_H
+
+#include <QDockWidget>
+#include <QListWidget>
+#include <QPushButton>
+#include <QHash>
+
+class NotificationPanel : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    static const int maxNotifications = 200;
+
+    explicit NotificationPanel(QWidget *parent = nullptr);
+
+    int notificationCount() const;
+
+public slots:
+    void addNotification(const QString& title, const QString& message);
+    void clearNotifications();
+
+private:
+    QListWidget *notificationList;
+    QPushButton *clearButton;
+    QHash<QString, QListWidgetItem*> itemsByKey;
+    QHash<QListWidgetItem*, int> repeatCounts;
+
+    void removeOldest();
+};
+
+#endif // NOTIFICATION_PANEL_H
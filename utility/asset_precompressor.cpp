@@ -0,0 +1,248 @@
+#include "asset_precompressor.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+
+#ifdef WEBDEVTOOLKIT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef WEBDEVTOOLKIT_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+static const qint64 minimumAssetSize = 256;
+
+QStringList AssetPrecompressor::compressibleExtensions() {
+    return QStringList() << "css" << "js" << "mjs" << "svg" << "json" << "map" << "html" << "htm" << "xml" << "txt" << "wasm";
+}
+
+bool AssetPrecompressor::isGzipAvailable() {
+#ifdef WEBDEVTOOLKIT_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool AssetPrecompressor::isBrotliAvailable() {
+#ifdef WEBDEVTOOLKIT_HAVE_BROTLI
+    return true;
+#else
+    return false;
+#endif
+}
+
+QString AssetPrecompressor::indexPath(const QDir &documentRoot) {
+    QByteArray rootHash = QCryptographicHash::hash(documentRoot.absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir::currentPath() + "/cache/precompress/" + QString::fromLatin1(rootHash) + ".json";
+}
+
+QByteArray AssetPrecompressor::gzipCompress(const QByteArray &data) {
+#ifdef WEBDEVTOOLKIT_HAVE_ZLIB
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return QByteArray();
+    }
+    QByteArray output(int(deflateBound(&stream, uLong(data.size()))), Qt::Uninitialized);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+    stream.avail_in = uInt(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = uInt(output.size());
+    int status = deflate(&stream, Z_FINISH);
+    qint64 written = qint64(stream.total_out);
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        return QByteArray();
+    }
+    output.resize(written);
+    return output;
+#else
+    Q_UNUSED(data);
+    return QByteArray();
+#endif
+}
+
+QByteArray AssetPrecompressor::brotliCompress(const QByteArray &data) {
+#ifdef WEBDEVTOOLKIT_HAVE_BROTLI
+    size_t outputSize = BrotliEncoderMaxCompressedSize(size_t(data.size()));
+    if (outputSize == 0) {
+        return QByteArray();
+    }
+    QByteArray output(int(outputSize), Qt::Uninitialized);
+    if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, size_t(data.size()),
+                               reinterpret_cast<const uint8_t*>(data.constData()), &outputSize,
+                               reinterpret_cast<uint8_t*>(output.data()))) {
+        return QByteArray();
+    }
+    output.resize(int(outputSize));
+    return output;
+#else
+    Q_UNUSED(data);
+    return QByteArray();
+#endif
+}
+
+bool AssetPrecompressor::writeSibling(const QString &sourcePath, const QString &suffix, const QByteArray &original, const QByteArray &compressed) {
+    QString siblingPath = sourcePath + suffix;
+    if (compressed.isEmpty() || compressed.size() >= original.size() * 95 / 100) {
+        QFile::remove(siblingPath);
+        return false;
+    }
+    QFile sibling(siblingPath);
+    if (!sibling.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write precompressed asset" << siblingPath;
+        return false;
+    }
+    sibling.write(compressed);
+    sibling.flush();
+    sibling.setFileTime(QFileInfo(sourcePath).lastModified(), QFileDevice::FileModificationTime);
+    sibling.close();
+    return true;
+}
+
+QJsonObject AssetPrecompressor::precompress(const QDir &documentRoot, int maxThreads) {
+    if (!documentRoot.exists()) {
+        QString errMsg = "Failed to precompress assets: document root " + documentRoot.absolutePath() + " does not exist.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!isGzipAvailable() && !isBrotliAvailable()) {
+        QString errMsg = "Failed to precompress assets: the application was built without zlib and brotli support.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QString index = indexPath(documentRoot);
+    QJsonObject previousIndex;
+    QFile indexFile(index);
+    if (indexFile.open(QIODevice::ReadOnly)) {
+        previousIndex = QJsonDocument::fromJson(indexFile.readAll()).object();
+        indexFile.close();
+    }
+    const QJsonObject previousFiles = previousIndex.value("files").toObject();
+    bool previousGzip = previousIndex.value("gzip").toBool();
+    bool previousBrotli = previousIndex.value("brotli").toBool();
+
+    QStringList sources;
+    QStringList extensions = compressibleExtensions();
+    QDirIterator it(documentRoot.absolutePath(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        if (info.size() >= minimumAssetSize && extensions.contains(info.suffix().toLower())) {
+            sources.append(info.absoluteFilePath());
+        }
+    }
+
+    QMutex mutex;
+    QJsonObject files;
+    int compressed = 0;
+    int unchanged = 0;
+    qint64 originalBytes = 0;
+    qint64 gzipBytes = 0;
+    qint64 brotliBytes = 0;
+
+    QThreadPool pool;
+    if (maxThreads > 0) {
+        pool.setMaxThreadCount(maxThreads);
+    }
+    for (const QString& source : sources) {
+        pool.start([&, source]() {
+            QFileInfo info(source);
+            QString relativePath = documentRoot.relativeFilePath(source);
+            qint64 modified = info.lastModified().toMSecsSinceEpoch();
+            const QJsonObject previous = previousFiles.value(relativePath).toObject();
+            bool siblingsPresent = (!isGzipAvailable() || !previous["gzip"].toBool() || QFile::exists(source + ".gz"))
+                                   && (!isBrotliAvailable() || !previous["brotli"].toBool() || QFile::exists(source + ".br"));
+            bool encodersUnchanged = previousGzip == isGzipAvailable() && previousBrotli == isBrotliAvailable();
+
+            if (!previous.isEmpty() && encodersUnchanged && siblingsPresent
+                && previous["size"].toDouble() == info.size() && previous["mtime"].toDouble() == modified) {
+                QMutexLocker locker(&mutex);
+                files[relativePath] = previous;
+                unchanged++;
+                return;
+            }
+
+            QFile file(source);
+            if (!file.open(QIODevice::ReadOnly)) {
+                qWarning() << "Failed to read asset for precompression" << source;
+                return;
+            }
+            QByteArray data = file.readAll();
+            file.close();
+            QString hash = QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+
+            QJsonObject entry;
+            entry["size"] = info.size();
+            entry["mtime"] = modified;
+            entry["hash"] = hash;
+            if (!previous.isEmpty() && encodersUnchanged && siblingsPresent && previous["hash"].toString() == hash) {
+                entry["gzip"] = previous["gzip"];
+                entry["brotli"] = previous["brotli"];
+                QMutexLocker locker(&mutex);
+                files[relativePath] = entry;
+                unchanged++;
+                return;
+            }
+
+            QByteArray gzipData = isGzipAvailable() ? gzipCompress(data) : QByteArray();
+            QByteArray brotliData = isBrotliAvailable() ? brotliCompress(data) : QByteArray();
+            entry["gzip"] = writeSibling(source, ".gz", data, gzipData);
+            entry["brotli"] = writeSibling(source, ".br", data, brotliData);
+
+            QMutexLocker locker(&mutex);
+            files[relativePath] = entry;
+            compressed++;
+            originalBytes += data.size();
+            gzipBytes += entry["gzip"].toBool() ? gzipData.size() : 0;
+            brotliBytes += entry["brotli"].toBool() ? brotliData.size() : 0;
+        });
+    }
+    pool.waitForDone();
+
+    int removed = 0;
+    for (auto previousIt = previousFiles.begin(); previousIt != previousFiles.end(); ++previousIt) {
+        if (!files.contains(previousIt.key())) {
+            QString source = documentRoot.absoluteFilePath(previousIt.key());
+            QFile::remove(source + ".gz");
+            QFile::remove(source + ".br");
+            removed++;
+        }
+    }
+
+    QJsonObject newIndex;
+    newIndex["document_root"] = documentRoot.absolutePath();
+    newIndex["gzip"] = isGzipAvailable();
+    newIndex["brotli"] = isBrotliAvailable();
+    newIndex["files"] = files;
+    QDir().mkpath(QFileInfo(index).absolutePath());
+    if (indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        indexFile.write(QJsonDocument(newIndex).toJson(QJsonDocument::Compact));
+        indexFile.close();
+    } else {
+        qWarning() << "Failed to write precompression index" << index;
+    }
+
+    QJsonObject result;
+    result["scanned"] = sources.size();
+    result["compressed"] = compressed;
+    result["unchanged"] = unchanged;
+    result["removed"] = removed;
+    result["original_bytes"] = originalBytes;
+    result["gzip_bytes"] = gzipBytes;
+    result["brotli_bytes"] = brotliBytes;
+    result["gzip"] = isGzipAvailable();
+    result["brotli"] = isBrotliAvailable();
+    result["elapsed_ms"] = timer.elapsed();
+    qDebug() << "Precompressed" << compressed << "of" << sources.size() << "assets in" << documentRoot.absolutePath();
+    return result;
+}
@@ -0,0 +1,24 @@
+#ifndef ASSET_PRECOMPRESSOR_H
+#define ASSET_PRECOMPRESSOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QDir>
+
+class AssetPrecompressor {
+public:
+    static QStringList compressibleExtensions();
+    static bool isGzipAvailable();
+    static bool isBrotliAvailable();
+    static QJsonObject precompress(const QDir& documentRoot, int maxThreads = 0);
+
+private:
+    static QString indexPath(const QDir& documentRoot);
+    static QByteArray gzipCompress(const QByteArray& data);
+    static QByteArray brotliCompress(const QByteArray& data);
+    static bool writeSibling(const QString& sourcePath, const QString& suffix, const QByteArray& original, const QByteArray& compressed);
+};
+
+#endif // ASSET_PRECOMPRESSOR_H
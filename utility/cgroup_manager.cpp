@@ -0,0 +1,281 @@
+#include "cgroup_manager.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QCoreApplication>
+
+#ifdef Q_OS_LINUX
+#include <signal.h>
+#endif
+
+static const QString cgroupMount = "/sys/fs/cgroup";
+static const QString sliceName = "webdevtoolkit.slice";
+
+CgroupManager::CgroupManager(const QString &serviceName) : serviceName(serviceName) {
+
+}
+
+bool CgroupManager::isAvailable() {
+#ifdef Q_OS_LINUX
+    return QFile::exists(cgroupMount + "/cgroup.controllers");
+#else
+    return false;
+#endif
+}
+
+QString CgroupManager::delegatedRoot() {
+    QString ownCgroup;
+    const QStringList lines = readControlFile("/proc/self/cgroup").split('\n');
+    for (const QString& line : lines) {
+        if (line.startsWith("0::")) {
+            ownCgroup = line.mid(3).trimmed();
+        }
+    }
+    if (ownCgroup.isEmpty()) {
+        return QString();
+    }
+    QString parent = ownCgroup == "/" ? QString() : ownCgroup.section('/', 0, -2);
+    QString root = cgroupMount + parent;
+    if (!QFileInfo(root + "/cgroup.procs").isWritable() || !QFileInfo(root).isWritable()) {
+        return QString();
+    }
+    return root;
+}
+
+void CgroupManager::setSettings(const QJsonObject &settings) {
+    static const QRegularExpression memoryRegex(R"(^(max|\d+[KMGT]?)$)");
+    static const QRegularExpression cpuRegex(R"(^(max|\d+)( \d+)?$)");
+    static const QRegularExpression ioRegex(R"(^(\d+:\d+( (rbps|wbps|riops|wiops)=(\d+|max))+)?$)");
+
+    QString updatedMemoryMax = settings.value("memory_max").toString("max");
+    QString updatedMemoryHigh = settings.value("memory_high").toString("max");
+    QString updatedCpuMax = settings.value("cpu_max").toString("max 100000");
+    QString updatedIoMax = settings.value("io_max").toString();
+    if (!memoryRegex.match(updatedMemoryMax).hasMatch() || !memoryRegex.match(updatedMemoryHigh).hasMatch()) {
+        QString errMsg = "Invalid cgroup settings for " + serviceName + ": memory limits must be max or a byte count such as 512M.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!cpuRegex.match(updatedCpuMax).hasMatch()) {
+        QString errMsg = "Invalid cgroup settings for " + serviceName + ": cpu_max must be \"<quota|max> <period>\".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!ioRegex.match(updatedIoMax).hasMatch()) {
+        QString errMsg = "Invalid cgroup settings for " + serviceName + ": io_max must be \"<major>:<minor> rbps=<n> wbps=<n>\".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    enabled = settings.value("enabled").toBool(false);
+    memoryMax = updatedMemoryMax;
+    memoryHigh = updatedMemoryHigh;
+    cpuMax = updatedCpuMax;
+    ioMax = updatedIoMax;
+    if (enabled && !cgroupPath.isEmpty() && QDir(cgroupPath).exists()) {
+        applyLimits();
+    }
+}
+
+QJsonObject CgroupManager::getSettings() const {
+    QJsonObject settings;
+    settings["enabled"] = enabled;
+    settings["memory_max"] = memoryMax;
+    settings["memory_high"] = memoryHigh;
+    settings["cpu_max"] = cpuMax;
+    settings["io_max"] = ioMax;
+    return settings;
+}
+
+bool CgroupManager::isEnabled() const {
+    return enabled;
+}
+
+QString CgroupManager::prepare() {
+    cgroupPath.clear();
+    if (!enabled) {
+        return QString();
+    }
+    if (!isAvailable()) {
+        qWarning() << "cgroup v2 is not available; starting" << serviceName << "without resource limits.";
+        return QString();
+    }
+    QString root = delegatedRoot();
+    if (root.isEmpty()) {
+        qWarning() << "No writable delegated cgroup subtree found; starting" << serviceName << "without resource limits.";
+        return QString();
+    }
+
+    QString slicePath = root + "/" + sliceName;
+    QString leafPath = slicePath + "/" + serviceName;
+    if (!QDir().mkpath(leafPath)) {
+        qWarning() << "Failed to create cgroup" << leafPath << "; starting" << serviceName << "without resource limits.";
+        return QString();
+    }
+    // Only the toolkit-owned slice is reconfigured; the controllers have to be
+    // delegated to it already, since the parent's subtree_control is not ours.
+    const QStringList delegated = readControlFile(slicePath + "/cgroup.controllers").simplified().split(' ', Qt::SkipEmptyParts);
+    for (const QString& controller : QStringList() << "memory" << "cpu" << "io") {
+        if (!delegated.contains(controller)) {
+            qWarning() << "cgroup controller" << controller << "is not delegated to" << slicePath;
+            continue;
+        }
+        if (!writeControlFile(slicePath + "/cgroup.subtree_control", "+" + controller)) {
+            qWarning() << "Failed to enable cgroup controller" << controller << "in" << slicePath;
+        }
+    }
+    cgroupPath = leafPath;
+    applyLimits();
+    return cgroupPath + "/cgroup.procs";
+}
+
+void CgroupManager::attach(qint64 processId) {
+    if (cgroupPath.isEmpty() || processId <= 0) {
+        return;
+    }
+    QStringList procs = readControlFile(cgroupPath + "/cgroup.procs").split('\n', Qt::SkipEmptyParts);
+    if (!procs.contains(QString::number(processId)) && !writeControlFile(cgroupPath + "/cgroup.procs", QString::number(processId))) {
+        qWarning() << "Failed to move process" << processId << "into cgroup" << cgroupPath;
+    }
+}
+
+void CgroupManager::applyLimits() const {
+    bool applied = writeControlFile(cgroupPath + "/memory.max", memoryMax)
+                   && writeControlFile(cgroupPath + "/memory.high", memoryHigh)
+                   && writeControlFile(cgroupPath + "/cpu.max", cpuMax);
+    if (!ioMax.isEmpty()) {
+        applied = writeControlFile(cgroupPath + "/io.max", ioMax) && applied;
+    }
+    if (!applied) {
+        qWarning() << "Some resource limits could not be applied to cgroup" << cgroupPath;
+    }
+}
+
+QJsonObject CgroupManager::readUsage() const {
+    QJsonObject usage;
+    usage["available"] = isAvailable();
+    usage["enabled"] = enabled;
+    if (cgroupPath.isEmpty() || !QDir(cgroupPath).exists()) {
+        return usage;
+    }
+    usage["path"] = cgroupPath;
+    usage["processes"] = readControlFile(cgroupPath + "/cgroup.procs").split('\n', Qt::SkipEmptyParts).size();
+    usage["memory_current"] = readControlFile(cgroupPath + "/memory.current").trimmed().toDouble();
+    if (QFile::exists(cgroupPath + "/memory.peak")) {
+        usage["memory_peak"] = readControlFile(cgroupPath + "/memory.peak").trimmed().toDouble();
+    }
+    usage["memory_events"] = readKeyValues(cgroupPath + "/memory.events");
+    usage["cpu"] = readKeyValues(cgroupPath + "/cpu.stat");
+
+    double readBytes = 0;
+    double writtenBytes = 0;
+    const QStringList ioLines = readControlFile(cgroupPath + "/io.stat").split('\n', Qt::SkipEmptyParts);
+    for (const QString& line : ioLines) {
+        const QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        for (const QString& field : fields) {
+            if (field.startsWith("rbytes=")) {
+                readBytes += field.mid(7).toDouble();
+            } else if (field.startsWith("wbytes=")) {
+                writtenBytes += field.mid(7).toDouble();
+            }
+        }
+    }
+    usage["io_read_bytes"] = readBytes;
+    usage["io_write_bytes"] = writtenBytes;
+
+    QJsonObject pressure;
+    pressure["cpu"] = readPressure(cgroupPath + "/cpu.pressure");
+    pressure["memory"] = readPressure(cgroupPath + "/memory.pressure");
+    pressure["io"] = readPressure(cgroupPath + "/io.pressure");
+    usage["pressure"] = pressure;
+    return usage;
+}
+
+void CgroupManager::kill() {
+#ifdef Q_OS_LINUX
+    if (cgroupPath.isEmpty() || !QDir(cgroupPath).exists()) {
+        return;
+    }
+    if (!QFile::exists(cgroupPath + "/cgroup.kill") || !writeControlFile(cgroupPath + "/cgroup.kill", "1")) {
+        const QStringList procs = readControlFile(cgroupPath + "/cgroup.procs").split('\n', Qt::SkipEmptyParts);
+        for (const QString& pid : procs) {
+            ::kill(pid_t(pid.toLongLong()), SIGKILL);
+        }
+    }
+    reportKilled(cgroupPath, serviceName, 0);
+#endif
+}
+
+bool CgroupManager::isPopulated(const QString &cgroupPath) {
+    if (!QDir(cgroupPath).exists()) {
+        return false;
+    }
+    QString events = readControlFile(cgroupPath + "/cgroup.events");
+    if (!events.isEmpty()) {
+        return !events.contains("populated 0");
+    }
+    return !readControlFile(cgroupPath + "/cgroup.procs").trimmed().isEmpty();
+}
+
+void CgroupManager::reportKilled(const QString &cgroupPath, const QString &serviceName, int attempt) {
+    if (!isPopulated(cgroupPath)) {
+        qDebug() << "Killed process tree of" << serviceName << "in cgroup" << cgroupPath;
+        return;
+    }
+    if (attempt >= 40 || !QCoreApplication::instance()) {
+        qWarning() << "Processes of" << serviceName << "are still running in cgroup" << cgroupPath << "after the kill request.";
+        return;
+    }
+    // Check again from the main event loop instead of blocking the stopping thread.
+    QTimer::singleShot(50, QCoreApplication::instance(), [cgroupPath, serviceName, attempt]() {
+        reportKilled(cgroupPath, serviceName, attempt + 1);
+    });
+}
+
+bool CgroupManager::writeControlFile(const QString &filePath, const QString &value) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        return false;
+    }
+    bool written = file.write(value.toLatin1()) == value.size();
+    file.close();
+    return written;
+}
+
+QString CgroupManager::readControlFile(const QString &filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return QString::fromLatin1(file.readAll());
+}
+
+QJsonObject CgroupManager::readKeyValues(const QString &filePath) {
+    QJsonObject values;
+    const QStringList lines = readControlFile(filePath).split('\n', Qt::SkipEmptyParts);
+    for (const QString& line : lines) {
+        QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        if (fields.size() == 2) {
+            values[fields[0]] = fields[1].toDouble();
+        }
+    }
+    return values;
+}
+
+QJsonObject CgroupManager::readPressure(const QString &filePath) {
+    QJsonObject pressure;
+    const QStringList lines = readControlFile(filePath).split('\n', Qt::SkipEmptyParts);
+    for (const QString& line : lines) {
+        QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        if (fields.isEmpty()) {
+            continue;
+        }
+        QJsonObject values;
+        for (int i = 1; i < fields.size(); ++i) {
+            values[fields[i].section('=', 0, 0)] = fields[i].section('=', 1).toDouble();
+        }
+        pressure[fields[0]] = values;
+    }
+    return pressure;
+}
@@ -0,0 +1,42 @@
+#ifndef CGROUP_MANAGER_H
+#define CGROUP_MANAGER_H
+
+#include "qglobal.h"
+#include <QString>
+#include <QJsonObject>
+
+class CgroupManager {
+public:
+    explicit CgroupManager(const QString& serviceName);
+
+    static bool isAvailable();
+    static QString delegatedRoot();
+
+    void setSettings(const QJsonObject& settings);
+    QJsonObject getSettings() const;
+    bool isEnabled() const;
+
+    QString prepare();
+    void attach(qint64 processId);
+    QJsonObject readUsage() const;
+    void kill();
+
+private:
+    QString serviceName;
+    bool enabled = false;
+    QString memoryMax = "max";
+    QString memoryHigh = "max";
+    QString cpuMax = "max 100000";
+    QString ioMax;
+    QString cgroupPath;
+
+    void applyLimits() const;
+    static bool writeControlFile(const QString& filePath, const QString& value);
+    static QString readControlFile(const QString& filePath);
+    static QJsonObject readKeyValues(const QString& filePath);
+    static QJsonObject readPressure(const QString& filePath);
+    static bool isPopulated(const QString& cgroupPath);
+    static void reportKilled(const QString& cgroupPath, const QString& serviceName, int attempt);
+};
+
+#endif // CGROUP_MANAGER_H
@@ -0,0 +1,179 @@
+#include "config_editor.h"
+#include <QDebug>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <QRegularExpression>
+
+QString ConfigEditor::readFile(const QString &filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QString errMsg = "Unable to open configuration file for reading: " + filePath;
+        qWarning() << errMsg;
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QTextStream in(&file);
+    QString content = in.readAll();
+    file.close();
+    return content;
+}
+
+void ConfigEditor::writeFile(const QString &filePath, const QString &content) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        QString errMsg = "Unable to open configuration file for writing: " + filePath;
+        qWarning() << errMsg;
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QTextStream out(&file);
+    out << content;
+    file.close();
+}
+
+int ConfigEditor::findNginxDirective(const QStringList &lines, const QString &block, const QString &name, int &blockLine) {
+    QRegularExpression blockRegex("^\\s*" + QRegularExpression::escape(block) + "\\s*\\{");
+    QRegularExpression activeRegex("^\\s*" + QRegularExpression::escape(name) + "(\\s|;)");
+    QRegularExpression commentedRegex("^\\s*#\\s*" + QRegularExpression::escape(name) + "(\\s|;)");
+    int targetDepth = block.isEmpty() ? 0 : 1;
+    bool inBlock = block.isEmpty();
+    int depth = 0;
+    int active = -1;
+    int commented = -1;
+    blockLine = -1;
+
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString& line = lines[i];
+        QString code = line.section('#', 0, 0);
+        if (!block.isEmpty() && depth == 0 && blockLine < 0 && blockRegex.match(line).hasMatch()) {
+            blockLine = i;
+            inBlock = true;
+        } else if (inBlock && depth == targetDepth) {
+            if (active < 0 && activeRegex.match(line).hasMatch()) {
+                active = i;
+            } else if (commented < 0 && commentedRegex.match(line).hasMatch()) {
+                commented = i;
+            }
+        }
+        depth += code.count('{') - code.count('}');
+        if (!block.isEmpty() && inBlock && depth == 0) {
+            inBlock = false;
+        }
+    }
+    return active >= 0 ? active : commented;
+}
+
+QString ConfigEditor::setNginxDirective(const QString &config, const QString &block, const QString &name, const QString &value) {
+    QStringList lines = config.split('\n');
+    int blockLine = -1;
+    int index = findNginxDirective(lines, block, name, blockLine);
+    QString indent = block.isEmpty() ? "" : "    ";
+    if (index >= 0) {
+        QRegularExpressionMatch match = QRegularExpression("^(\\s*)").match(lines[index]);
+        lines[index] = match.captured(1) + name + " " + value + ";";
+    } else if (block.isEmpty()) {
+        lines.insert(0, name + " " + value + ";");
+    } else if (blockLine >= 0) {
+        lines.insert(blockLine + 1, indent + name + " " + value + ";");
+    } else {
+        QString errMsg = "Failed to set Nginx directive " + name + ": block " + block + " not found in configuration.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return lines.join('\n');
+}
+
+QString ConfigEditor::removeNginxDirective(const QString &config, const QString &block, const QString &name) {
+    QStringList lines = config.split('\n');
+    int blockLine = -1;
+    int index = findNginxDirective(lines, block, name, blockLine);
+    if (index >= 0 && !lines[index].trimmed().startsWith('#')) {
+        lines.removeAt(index);
+    }
+    return lines.join('\n');
+}
+
+QString ConfigEditor::setNginxInclude(const QString &config, const QString &block, const QString &includePath, bool enabled) {
+    QStringList lines = config.split('\n');
+    QRegularExpression includeRegex("^\\s*include\\s+\"?" + QRegularExpression::escape(includePath) + "\"?\\s*;");
+    for (int i = lines.size() - 1; i >= 0; --i) {
+        if (includeRegex.match(lines[i]).hasMatch()) {
+            if (enabled) {
+                return config;
+            }
+            lines.removeAt(i);
+        }
+    }
+    if (!enabled) {
+        return lines.join('\n');
+    }
+    int blockLine = -1;
+    findNginxDirective(lines, block, "include", blockLine);
+    if (blockLine < 0) {
+        QString errMsg = "Failed to add Nginx include " + includePath + ": block " + block + " not found in configuration.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    lines.insert(blockLine + 1, "    include " + includePath + ";");
+    return lines.join('\n');
+}
+
+int ConfigEditor::findIniValue(const QStringList &lines, const QString &section, const QString &key, int &sectionLine) {
+    QRegularExpression sectionRegex(R"(^\s*\[([^\]]+)\]\s*$)");
+    QRegularExpression activeRegex("^\\s*" + QRegularExpression::escape(key) + "\\s*=");
+    QRegularExpression commentedRegex("^\\s*[;#]\\s*" + QRegularExpression::escape(key) + "\\s*=");
+    bool inSection = section.isEmpty();
+    int active = -1;
+    int commented = -1;
+    sectionLine = -1;
+
+    for (int i = 0; i < lines.size(); ++i) {
+        QRegularExpressionMatch sectionMatch = sectionRegex.match(lines[i]);
+        if (sectionMatch.hasMatch()) {
+            if (section.isEmpty()) {
+                continue;
+            }
+            inSection = sectionMatch.captured(1).trimmed().compare(section, Qt::CaseInsensitive) == 0;
+            if (inSection && sectionLine < 0) {
+                sectionLine = i;
+            }
+            continue;
+        }
+        if (!inSection) {
+            continue;
+        }
+        if (active < 0 && activeRegex.match(lines[i]).hasMatch()) {
+            active = i;
+        } else if (commented < 0 && commentedRegex.match(lines[i]).hasMatch()) {
+            commented = i;
+        }
+    }
+    return active >= 0 ? active : commented;
+}
+
+QString ConfigEditor::setIniValue(const QString &config, const QString &section, const QString &key, const QString &value) {
+    QStringList lines = config.split('\n');
+    int sectionLine = -1;
+    int index = findIniValue(lines, section, key, sectionLine);
+    QString line = key + "=" + value;
+    if (index >= 0) {
+        lines[index] = line;
+    } else if (sectionLine >= 0) {
+        lines.insert(sectionLine + 1, line);
+    } else if (section.isEmpty()) {
+        lines.append(line);
+    } else {
+        if (!lines.isEmpty() && lines.last().isEmpty()) {
+            lines.removeLast();
+        }
+        lines << "" << "[" + section + "]" << line << "";
+    }
+    return lines.join('\n');
+}
+
+QString ConfigEditor::removeIniValue(const QString &config, const QString &section, const QString &key) {
+    QStringList lines = config.split('\n');
+    int sectionLine = -1;
+    int index = findIniValue(lines, section, key, sectionLine);
+    if (index >= 0 && !lines[index].trimmed().startsWith(';') && !lines[index].trimmed().startsWith('#')) {
+        lines.removeAt(index);
+    }
+    return lines.join('\n');
+}
@@ -0,0 +1,23 @@
+#ifndef CONFIG_EDITOR_H
+#define CONFIG_EDITOR_H
+
+#include <QString>
+
+class ConfigEditor {
+public:
+    static QString readFile(const QString& filePath);
+    static void writeFile(const QString& filePath, const QString& content);
+
+    static QString setNginxDirective(const QString& config, const QString& block, const QString& name, const QString& value);
+    static QString removeNginxDirective(const QString& config, const QString& block, const QString& name);
+    static QString setNginxInclude(const QString& config, const QString& block, const QString& includePath, bool enabled);
+
+    static QString setIniValue(const QString& config, const QString& section, const QString& key, const QString& value);
+    static QString removeIniValue(const QString& config, const QString& section, const QString& key);
+
+private:
+    static int findNginxDirective(const QStringList& lines, const QString& block, const QString& name, int& blockLine);
+    static int findIniValue(const QStringList& lines, const QString& section, const QString& key, int& sectionLine);
+};
+
+#endif // CONFIG_EDITOR_H
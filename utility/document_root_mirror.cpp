@@ -0,0 +1,536 @@
+#include "document_root_mirror.h"
+#include "trace.h"
+#include "../core/metrics/metrics_registry.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QStorageInfo>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QMutexLocker>
+
+static const QString syncSuffix = ".wdtsync";
+static const QDir::Filters entryFilters = QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System | QDir::NoSymLinks;
+
+DocumentRootMirror::DocumentRootMirror(const QString &serverName) : serverName(serverName) {
+    settings["enabled"] = false;
+    settings["path"] = "";
+    settings["max_size_mb"] = 1024;
+    settings["debounce_ms"] = 200;
+    settings["scan_interval_ms"] = 5000;
+    settings["exclude"] = QJsonArray::fromStringList(QStringList() << ".git");
+    excludedNames = QStringList() << ".git";
+    workerThread.setObjectName("docroot-mirror-" + serverName);
+    moveToThread(&workerThread);
+    workerThread.start();
+}
+
+DocumentRootMirror::~DocumentRootMirror() {
+    if (isActive()) {
+        stop();
+    }
+    workerThread.quit();
+    workerThread.wait();
+}
+
+void DocumentRootMirror::validateSettings(const QJsonObject &settings) {
+    if (!settings.value("enabled").isBool()) {
+        throw std::runtime_error("Invalid document root mirror settings: enabled must be true or false.");
+    }
+    if (!settings.value("path").isString()) {
+        throw std::runtime_error("Invalid document root mirror settings: path must be a string.");
+    }
+    int maxSize = settings.value("max_size_mb").toInt();
+    if (!settings.value("max_size_mb").isDouble() || maxSize < 1 || maxSize > 262144) {
+        throw std::runtime_error("Invalid document root mirror settings: max_size_mb must be between 1 and 262144.");
+    }
+    int debounce = settings.value("debounce_ms").toInt();
+    if (!settings.value("debounce_ms").isDouble() || debounce < 10 || debounce > 10000) {
+        throw std::runtime_error("Invalid document root mirror settings: debounce_ms must be between 10 and 10000.");
+    }
+    int scanInterval = settings.value("scan_interval_ms").toInt();
+    if (!settings.value("scan_interval_ms").isDouble() || scanInterval < 500 || scanInterval > 600000) {
+        throw std::runtime_error("Invalid document root mirror settings: scan_interval_ms must be between 500 and 600000.");
+    }
+    const QJsonArray exclude = settings.value("exclude").toArray();
+    for (const QJsonValue& name : exclude) {
+        if (!name.isString() || name.toString().isEmpty() || name.toString().contains('/') || name.toString().contains('\\')) {
+            throw std::runtime_error("Invalid document root mirror settings: exclude must list file or directory names.");
+        }
+    }
+}
+
+void DocumentRootMirror::setSettings(const QJsonObject &settings) {
+    QJsonObject updated = getSettings();
+    for (auto it = settings.begin(); it != settings.end(); ++it) {
+        updated[it.key()] = it.value();
+    }
+    validateSettings(updated);
+    {
+        QMutexLocker locker(&mutex);
+        this->settings = updated;
+    }
+    QStringList exclude;
+    const QJsonArray names = updated.value("exclude").toArray();
+    for (const QJsonValue& name : names) {
+        exclude.append(name.toString());
+    }
+    invoke([this, updated, exclude]() {
+        excludedNames = exclude;
+        if (debounceTimer) {
+            debounceTimer->setInterval(updated.value("debounce_ms").toInt());
+        }
+        if (scanTimer) {
+            scanTimer->setInterval(updated.value("scan_interval_ms").toInt());
+        }
+    });
+}
+
+QJsonObject DocumentRootMirror::getSettings() const {
+    QMutexLocker locker(&mutex);
+    return settings;
+}
+
+bool DocumentRootMirror::isEnabled() const {
+    QMutexLocker locker(&mutex);
+    return settings.value("enabled").toBool();
+}
+
+bool DocumentRootMirror::isActive() const {
+    QMutexLocker locker(&mutex);
+    return active;
+}
+
+QString DocumentRootMirror::getMirrorPath() const {
+    QMutexLocker locker(&mutex);
+    return active ? mirrorPath : QString();
+}
+
+QJsonObject DocumentRootMirror::getStats() const {
+    QMutexLocker locker(&mutex);
+    QJsonObject result = active ? stats : QJsonObject();
+    result["enabled"] = settings.value("enabled").toBool();
+    result["active"] = active;
+    return result;
+}
+
+QString DocumentRootMirror::start(const QString &sourcePath) {
+    TRACE_SCOPE_ARG("server", "DocumentRootMirror::start", "server", serverName);
+    QString errorString;
+    invoke([this, sourcePath, &errorString]() {
+        QString source = QDir(sourcePath).absolutePath();
+        if (active && this->sourcePath == source) {
+            return;
+        }
+        if (active) {
+            syncAll();
+            shutdown();
+        }
+        try {
+            QJsonObject current = getSettings();
+            QString base = resolveBasePath();
+            qint64 sourceBytes = measureSource(source);
+            qint64 limitBytes = qint64(current.value("max_size_mb").toInt()) * 1024 * 1024;
+            if (sourceBytes > limitBytes) {
+                QString errMsg = "Failed to mirror the " + serverName + " document root: " + QString::number(sourceBytes / (1024 * 1024))
+                                 + " MB exceeds max_size_mb (" + QString::number(current.value("max_size_mb").toInt()) + ").";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+            QStorageInfo storage(base);
+            if (storage.isValid() && storage.bytesAvailable() < sourceBytes) {
+                QString errMsg = "Failed to mirror the " + serverName + " document root: not enough free space in " + base + ".";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+            QString target = QDir(base).absoluteFilePath("webdevtoolkit/" + serverName + "-document-root");
+            // Leftovers of an earlier session would otherwise be copied back into the source.
+            if (QDir(target).exists() && !QDir(target).removeRecursively()) {
+                QString errMsg = "Failed to mirror the " + serverName + " document root: cannot clear the stale mirror " + target + ".";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+            if (!QDir().mkpath(target)) {
+                QString errMsg = "Failed to mirror the " + serverName + " document root: cannot create " + target + ".";
+                throw std::runtime_error(errMsg.toStdString());
+            }
+
+            this->sourcePath = source;
+            manifest.clear();
+            pendingDirectories.clear();
+            watchedDirectories.clear();
+            filesToMirror = 0;
+            filesToSource = 0;
+            removedEntries = 0;
+            conflicts = 0;
+            lastLagMs = 0;
+            maxLagMs = 0;
+            {
+                QMutexLocker locker(&mutex);
+                mirrorPath = target;
+            }
+            watcher = new QFileSystemWatcher(this);
+            connect(watcher, &QFileSystemWatcher::directoryChanged, this, &DocumentRootMirror::onPathChanged);
+            debounceTimer = new QTimer(this);
+            debounceTimer->setSingleShot(true);
+            debounceTimer->setInterval(current.value("debounce_ms").toInt());
+            connect(debounceTimer, &QTimer::timeout, this, &DocumentRootMirror::syncPending);
+            scanTimer = new QTimer(this);
+            scanTimer->setInterval(current.value("scan_interval_ms").toInt());
+            connect(scanTimer, &QTimer::timeout, this, &DocumentRootMirror::syncAll);
+
+            QElapsedTimer elapsed;
+            elapsed.start();
+            initialSync = true;
+            watch(QString());
+            reconcileDirectory(QString(), true);
+            initialSync = false;
+            {
+                QMutexLocker locker(&mutex);
+                active = true;
+            }
+            scanTimer->start();
+            updateStats(elapsed.elapsed());
+            qDebug() << "Mirrored the" << serverName << "document root" << source << "to" << target << "in" << elapsed.elapsed() << "ms.";
+        } catch (const std::runtime_error& e) {
+            errorString = QString::fromStdString(e.what());
+            shutdown();
+        }
+    });
+    if (!errorString.isEmpty()) {
+        qWarning() << errorString;
+        throw std::runtime_error(errorString.toStdString());
+    }
+    return getMirrorPath();
+}
+
+void DocumentRootMirror::stop() {
+    TRACE_SCOPE_ARG("server", "DocumentRootMirror::stop", "server", serverName);
+    invoke([this]() {
+        if (active) {
+            syncAll();
+            qDebug() << "Wrote the" << serverName << "document root mirror back to" << sourcePath;
+        }
+        shutdown();
+    });
+}
+
+void DocumentRootMirror::shutdown() {
+    delete watcher;
+    watcher = nullptr;
+    delete debounceTimer;
+    debounceTimer = nullptr;
+    delete scanTimer;
+    scanTimer = nullptr;
+    QString target;
+    {
+        QMutexLocker locker(&mutex);
+        target = mirrorPath;
+        active = false;
+        mirrorPath.clear();
+        stats = QJsonObject();
+    }
+    if (!target.isEmpty()) {
+        QDir(target).removeRecursively();
+    }
+    manifest.clear();
+    pendingDirectories.clear();
+    watchedDirectories.clear();
+}
+
+QString DocumentRootMirror::resolveBasePath() const {
+    QString path = getSettings().value("path").toString();
+    if (!path.isEmpty()) {
+        if (!QFileInfo(path).isDir() || !QFileInfo(path).isWritable()) {
+            QString errMsg = "Failed to mirror the " + serverName + " document root: " + path + " is not a writable directory.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        return QDir(path).absolutePath();
+    }
+#ifdef Q_OS_WIN
+    throw std::runtime_error("Failed to mirror the document root: set document_root_mirror.path to a RAM disk (for example R:/) on Windows.");
+#else
+#ifdef Q_OS_LINUX
+    if (QFileInfo("/dev/shm").isDir() && QFileInfo("/dev/shm").isWritable()) {
+        return "/dev/shm";
+    }
+#endif
+    QString runtimePath = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (runtimePath.isEmpty()) {
+        throw std::runtime_error("Failed to mirror the document root: no RAM-backed directory was found; set document_root_mirror.path.");
+    }
+    return runtimePath;
+#endif
+}
+
+qint64 DocumentRootMirror::measureSource(const QString &directoryPath) const {
+    qint64 total = 0;
+    const QFileInfoList entries = QDir(directoryPath).entryInfoList(entryFilters);
+    for (const QFileInfo& info : entries) {
+        if (isExcluded(info.fileName())) {
+            continue;
+        }
+        total += info.isDir() ? measureSource(info.absoluteFilePath()) : info.size();
+    }
+    return total;
+}
+
+bool DocumentRootMirror::isExcluded(const QString &name) const {
+    return name.endsWith(syncSuffix) || excludedNames.contains(name);
+}
+
+QString DocumentRootMirror::sidePath(const QString &relativePath, bool mirror) const {
+    QString base = mirror ? mirrorPath : sourcePath;
+    return relativePath.isEmpty() ? base : base + "/" + relativePath;
+}
+
+void DocumentRootMirror::watch(const QString &relativePath) {
+    if (!watcher || watchedDirectories.contains(relativePath)) {
+        return;
+    }
+    watchedDirectories.insert(relativePath);
+    const QStringList failed = watcher->addPaths(QStringList() << sidePath(relativePath, false) << sidePath(relativePath, true));
+    if (!failed.isEmpty() && !watchLimitReported) {
+        watchLimitReported = true;
+        qWarning() << "Cannot watch all" << serverName << "document root directories; changes in unwatched directories are picked up by the periodic scan.";
+    }
+}
+
+void DocumentRootMirror::onPathChanged(const QString &path) {
+    QString relativePath;
+    if (path == sourcePath || path == mirrorPath) {
+        relativePath = QString();
+    } else if (path.startsWith(sourcePath + "/")) {
+        relativePath = path.mid(sourcePath.size() + 1);
+    } else if (path.startsWith(mirrorPath + "/")) {
+        relativePath = path.mid(mirrorPath.size() + 1);
+    } else {
+        return;
+    }
+    pendingDirectories.insert(relativePath);
+    if (debounceTimer) {
+        debounceTimer->start();
+    }
+}
+
+void DocumentRootMirror::syncPending() {
+    if (!active || !rootsAvailable()) {
+        return;
+    }
+    QElapsedTimer elapsed;
+    elapsed.start();
+    const QSet<QString> directories = pendingDirectories;
+    pendingDirectories.clear();
+    for (const QString& relativePath : directories) {
+        reconcileDirectory(relativePath, false);
+    }
+    updateStats(elapsed.elapsed());
+}
+
+void DocumentRootMirror::syncAll() {
+    if (!active || !rootsAvailable()) {
+        return;
+    }
+    QElapsedTimer elapsed;
+    elapsed.start();
+    pendingDirectories.clear();
+    reconcileDirectory(QString(), true);
+    updateStats(elapsed.elapsed());
+}
+
+bool DocumentRootMirror::rootsAvailable() const {
+    // A vanished root (unmounted share, cleaned tmpfs) must not be mistaken for a mass deletion.
+    if (QFileInfo(sourcePath).isDir() && QFileInfo(mirrorPath).isDir()) {
+        return true;
+    }
+    qWarning() << "Skipping" << serverName << "document root mirror sync:" << sourcePath << "or" << mirrorPath << "is not available.";
+    return false;
+}
+
+void DocumentRootMirror::reconcileDirectory(const QString &relativePath, bool recursive) {
+    QStringList names = QDir(sidePath(relativePath, false)).entryList(entryFilters);
+    const QStringList mirrorNames = QDir(sidePath(relativePath, true)).entryList(entryFilters);
+    for (const QString& name : mirrorNames) {
+        if (!names.contains(name)) {
+            names.append(name);
+        }
+    }
+    for (const QString& name : names) {
+        if (!isExcluded(name)) {
+            reconcileEntry(relativePath.isEmpty() ? name : relativePath + "/" + name, recursive);
+        }
+    }
+}
+
+void DocumentRootMirror::reconcileEntry(const QString &relativePath, bool recursive) {
+    QFileInfo source(sidePath(relativePath, false));
+    QFileInfo mirror(sidePath(relativePath, true));
+    auto known = manifest.constFind(relativePath);
+    bool isKnown = known != manifest.constEnd();
+
+    if (source.exists() && mirror.exists()) {
+        if (source.isDir() && mirror.isDir()) {
+            manifest[relativePath] = entryOf(source);
+            watch(relativePath);
+            if (recursive) {
+                reconcileDirectory(relativePath, true);
+            }
+            return;
+        }
+        if (source.isDir() != mirror.isDir()) {
+            ++conflicts;
+            removeEntry(relativePath, true);
+            copyEntry(relativePath, true);
+            return;
+        }
+        Entry sourceEntry = entryOf(source);
+        Entry mirrorEntry = entryOf(mirror);
+        if (sourceEntry.size == mirrorEntry.size && sourceEntry.modified == mirrorEntry.modified) {
+            manifest[relativePath] = sourceEntry;
+            return;
+        }
+        bool sourceChanged = !isKnown || sourceEntry.size != known->size || sourceEntry.modified != known->modified;
+        bool mirrorChanged = !isKnown || mirrorEntry.size != known->size || mirrorEntry.modified != known->modified;
+        if (sourceChanged && mirrorChanged) {
+            ++conflicts;
+            copyEntry(relativePath, sourceEntry.modified >= mirrorEntry.modified);
+        } else {
+            copyEntry(relativePath, sourceChanged);
+        }
+    } else if (source.exists() || mirror.exists()) {
+        if (isKnown) {
+            removeEntry(relativePath, mirror.exists());
+        } else {
+            copyEntry(relativePath, source.exists());
+        }
+    } else {
+        forget(relativePath);
+    }
+}
+
+void DocumentRootMirror::copyEntry(const QString &relativePath, bool toMirror) {
+    QString from = sidePath(relativePath, !toMirror);
+    QString to = sidePath(relativePath, toMirror);
+    QFileInfo info(from);
+    if (info.isDir()) {
+        if (!QDir().mkpath(to)) {
+            qWarning() << "Failed to create document root mirror directory" << to;
+            return;
+        }
+        manifest[relativePath] = entryOf(info);
+        watch(relativePath);
+        reconcileDirectory(relativePath, true);
+        return;
+    }
+
+    QString temporary = to + syncSuffix;
+    QFile::remove(temporary);
+    if (!QFile::copy(from, temporary)) {
+        qWarning() << "Failed to sync" << from << "to" << to;
+        return;
+    }
+    QFile copied(temporary);
+    if (copied.open(QIODevice::ReadWrite)) {
+        copied.setFileTime(info.lastModified(), QFileDevice::FileModificationTime);
+        copied.close();
+    }
+    QFile::remove(to);
+    if (!QFile::rename(temporary, to)) {
+        qWarning() << "Failed to sync" << from << "to" << to << "- the file is in use; retrying on the next scan.";
+        QFile::remove(temporary);
+        return;
+    }
+    manifest[relativePath] = entryOf(info);
+    if (toMirror) {
+        ++filesToMirror;
+    } else {
+        ++filesToSource;
+    }
+    if (!initialSync) {
+        double lagMs = qMax<qint64>(0, QDateTime::currentMSecsSinceEpoch() - info.lastModified().toMSecsSinceEpoch());
+        lastLagMs = lagMs;
+        maxLagMs = qMax(maxLagMs, lagMs);
+        MetricsRegistry::getInstance().observe("webdevtoolkit_docroot_mirror_sync_lag_seconds",
+                                               {{"server", serverName}, {"direction", toMirror ? "to_mirror" : "to_source"}}, lagMs / 1000.0);
+    }
+}
+
+void DocumentRootMirror::removeEntry(const QString &relativePath, bool fromMirror) {
+    QString target = sidePath(relativePath, fromMirror);
+    bool removed = QFileInfo(target).isDir() ? QDir(target).removeRecursively() : QFile::remove(target);
+    if (!removed) {
+        qWarning() << "Failed to remove" << target << "while syncing the" << serverName << "document root mirror.";
+        return;
+    }
+    ++removedEntries;
+    forget(relativePath);
+}
+
+void DocumentRootMirror::forget(const QString &relativePath) {
+    manifest.remove(relativePath);
+    watchedDirectories.remove(relativePath);
+    QString prefix = relativePath + "/";
+    for (auto it = manifest.begin(); it != manifest.end();) {
+        if (it.key().startsWith(prefix)) {
+            it = manifest.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = watchedDirectories.begin(); it != watchedDirectories.end();) {
+        if (it->startsWith(prefix)) {
+            it = watchedDirectories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DocumentRootMirror::updateStats(qint64 durationMs) {
+    qint64 mirrorBytes = 0;
+    int files = 0;
+    int directories = 0;
+    for (auto it = manifest.constBegin(); it != manifest.constEnd(); ++it) {
+        if (it->directory) {
+            ++directories;
+        } else {
+            ++files;
+            mirrorBytes += it->size;
+        }
+    }
+    QStorageInfo storage(mirrorPath);
+    QJsonObject updated;
+    updated["source_path"] = sourcePath;
+    updated["mirror_path"] = mirrorPath;
+    updated["filesystem"] = QString::fromUtf8(storage.fileSystemType());
+    updated["filesystem_used_bytes"] = double(storage.bytesTotal() - storage.bytesAvailable());
+    updated["filesystem_available_bytes"] = double(storage.bytesAvailable());
+    updated["mirror_bytes"] = double(mirrorBytes);
+    updated["files"] = files;
+    updated["directories"] = directories;
+    updated["watched_directories"] = watchedDirectories.size();
+    updated["files_to_mirror"] = double(filesToMirror);
+    updated["files_to_source"] = double(filesToSource);
+    updated["removed"] = double(removedEntries);
+    updated["conflicts"] = double(conflicts);
+    updated["last_sync_ms"] = double(durationMs);
+    updated["last_sync_at"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    updated["last_lag_ms"] = lastLagMs;
+    updated["max_lag_ms"] = maxLagMs;
+    QMutexLocker locker(&mutex);
+    stats = updated;
+}
+
+void DocumentRootMirror::invoke(std::function<void()> task) {
+    QMetaObject::invokeMethod(this, task, thread() == QThread::currentThread() ? Qt::DirectConnection : Qt::BlockingQueuedConnection);
+}
+
+DocumentRootMirror::Entry DocumentRootMirror::entryOf(const QFileInfo &info) {
+    Entry entry;
+    entry.directory = info.isDir();
+    entry.size = entry.directory ? 0 : info.size();
+    entry.modified = entry.directory ? 0 : info.lastModified().toMSecsSinceEpoch();
+    return entry;
+}
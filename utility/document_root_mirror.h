@@ -0,0 +1,87 @@
+#ifndef DOCUMENT_ROOT_MIRROR_H
+#define DOCUMENT_ROOT_MIRROR_H
+
+#include "qglobal.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QMutex>
+#include <functional>
+
+class QFileSystemWatcher;
+class QTimer;
+class QFileInfo;
+
+class DocumentRootMirror : public QObject {
+    Q_OBJECT
+public:
+    explicit DocumentRootMirror(const QString& serverName);
+    ~DocumentRootMirror();
+
+    static void validateSettings(const QJsonObject& settings);
+    void setSettings(const QJsonObject& settings);
+    QJsonObject getSettings() const;
+    bool isEnabled() const;
+    bool isActive() const;
+
+    QString start(const QString& sourcePath);
+    void stop();
+    QString getMirrorPath() const;
+    QJsonObject getStats() const;
+
+private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 modified = 0;
+        bool directory = false;
+    };
+
+    QString serverName;
+    QJsonObject settings;
+    QThread workerThread;
+    QStringList excludedNames;
+    QString sourcePath;
+    QString mirrorPath;
+    QHash<QString, Entry> manifest;
+    QSet<QString> pendingDirectories;
+    QSet<QString> watchedDirectories;
+    QFileSystemWatcher* watcher = nullptr;
+    QTimer* debounceTimer = nullptr;
+    QTimer* scanTimer = nullptr;
+    bool initialSync = false;
+    bool watchLimitReported = false;
+    quint64 filesToMirror = 0;
+    quint64 filesToSource = 0;
+    quint64 removedEntries = 0;
+    quint64 conflicts = 0;
+    double lastLagMs = 0;
+    double maxLagMs = 0;
+    mutable QMutex mutex;
+    bool active = false;
+    QJsonObject stats;
+
+    void shutdown();
+    QString resolveBasePath() const;
+    qint64 measureSource(const QString& directoryPath) const;
+    bool isExcluded(const QString& name) const;
+    QString sidePath(const QString& relativePath, bool mirror) const;
+    void watch(const QString& relativePath);
+    void onPathChanged(const QString& path);
+    void syncPending();
+    void syncAll();
+    bool rootsAvailable() const;
+    void reconcileDirectory(const QString& relativePath, bool recursive);
+    void reconcileEntry(const QString& relativePath, bool recursive);
+    void copyEntry(const QString& relativePath, bool toMirror);
+    void removeEntry(const QString& relativePath, bool fromMirror);
+    void forget(const QString& relativePath);
+    void updateStats(qint64 durationMs);
+    void invoke(std::function<void()> task);
+    static Entry entryOf(const QFileInfo& info);
+};
+
+#endif // DOCUMENT_ROOT_MIRROR_H
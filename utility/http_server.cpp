@@ -0,0 +1,284 @@
+#include "http_server.h"
+#include <QTcpSocket>
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QUrl>
+#include <QDebug>
+
+HttpResponse HttpResponse::text(const QByteArray &body, int status) {
+    HttpResponse response;
+    response.status = status;
+    response.body = body;
+    return response;
+}
+
+HttpResponse HttpResponse::json(const QJsonObject &object, int status) {
+    HttpResponse response;
+    response.status = status;
+    response.contentType = "application/json";
+    response.body = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    return response;
+}
+
+HttpResponse HttpResponse::error(int status, const QString &message) {
+    QJsonObject object;
+    object["error"] = message;
+    return json(object, status);
+}
+
+HttpServer::HttpServer(QObject *parent) : QObject(parent), tcpServer(this), localServer(this) {
+    connect(&tcpServer, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket* socket = tcpServer.nextPendingConnection()) {
+            acceptConnection(socket);
+        }
+    });
+    connect(&localServer, &QLocalServer::newConnection, this, [this]() {
+        while (QLocalSocket* socket = localServer.nextPendingConnection()) {
+            acceptConnection(socket);
+        }
+    });
+}
+
+HttpServer::~HttpServer() {
+    close();
+}
+
+bool HttpServer::listen(const QHostAddress &address, quint16 port) {
+    tcpServer.close();
+    if (!tcpServer.listen(address, port)) {
+        qWarning() << "HTTP server failed to listen on" << address.toString() << port << ":" << tcpServer.errorString();
+        return false;
+    }
+    qDebug() << "HTTP server listening on" << address.toString() << tcpServer.serverPort();
+    return true;
+}
+
+bool HttpServer::listenLocal(const QString &socketPath) {
+    localServer.close();
+    QLocalServer::removeServer(socketPath);
+    localServer.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!localServer.listen(socketPath)) {
+        qWarning() << "HTTP server failed to listen on local socket" << socketPath << ":" << localServer.errorString();
+        return false;
+    }
+    qDebug() << "HTTP server listening on local socket" << localServer.fullServerName();
+    return true;
+}
+
+void HttpServer::close() {
+    tcpServer.close();
+    localServer.close();
+    const QList<QIODevice*> connections = buffers.keys();
+    for (QIODevice* connection : connections) {
+        closeConnection(connection);
+    }
+    buffers.clear();
+}
+
+bool HttpServer::isListening() const {
+    return tcpServer.isListening() || localServer.isListening();
+}
+
+quint16 HttpServer::serverPort() const {
+    return tcpServer.serverPort();
+}
+
+QString HttpServer::errorString() const {
+    return tcpServer.errorString().isEmpty() ? localServer.errorString() : tcpServer.errorString();
+}
+
+void HttpServer::route(const QByteArray &method, const QString &path, Handler handler) {
+    Route entry;
+    entry.method = method;
+    entry.prefix = path.endsWith('*');
+    entry.path = entry.prefix ? path.chopped(1) : path;
+    entry.handler = std::move(handler);
+    routes.append(std::move(entry));
+}
+
+void HttpServer::routeStream(const QByteArray &method, const QString &path, StreamHandler handler) {
+    Route entry;
+    entry.method = method;
+    entry.prefix = path.endsWith('*');
+    entry.path = entry.prefix ? path.chopped(1) : path;
+    entry.streamHandler = std::move(handler);
+    routes.append(std::move(entry));
+}
+
+void HttpServer::acceptConnection(QIODevice *connection) {
+    buffers.insert(connection, QByteArray());
+    connect(connection, &QIODevice::readyRead, this, [this, connection]() {
+        processBuffer(connection);
+    });
+    connect(connection, &QObject::destroyed, this, [this, connection]() {
+        buffers.remove(connection);
+    });
+    if (QTcpSocket* socket = qobject_cast<QTcpSocket*>(connection)) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    } else if (QLocalSocket* socket = qobject_cast<QLocalSocket*>(connection)) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void HttpServer::processBuffer(QIODevice *connection) {
+    auto it = buffers.find(connection);
+    if (it == buffers.end()) {
+        return;
+    }
+    it.value().append(connection->readAll());
+    while (buffers.contains(connection)) {
+        QByteArray& buffer = buffers[connection];
+        HttpRequest request;
+        int errorStatus = 0;
+        if (!parseRequest(buffer, request, errorStatus)) {
+            if (errorStatus != 0) {
+                writeResponse(connection, HttpResponse::error(errorStatus, QString::fromLatin1(reasonPhrase(errorStatus))), false);
+                buffers.remove(connection);
+                closeConnection(connection);
+            }
+            return;
+        }
+        bool pathMatched = false;
+        const Route* route = findRoute(request, pathMatched);
+        if (route && route->streamHandler) {
+            buffers.remove(connection);
+            try {
+                route->streamHandler(request, connection);
+            } catch (const std::exception& e) {
+                writeResponse(connection, HttpResponse::error(500, QString::fromUtf8(e.what())), false);
+                closeConnection(connection);
+            }
+            return;
+        }
+        QByteArray connectionHeader = request.headers.value("connection").toLower();
+        bool keepAlive = connectionHeader != "close";
+        writeResponse(connection, route ? dispatch(route, request) : HttpResponse::error(pathMatched ? 405 : 404, pathMatched ? "Method not allowed" : "Not found"), keepAlive);
+        if (!keepAlive) {
+            buffers.remove(connection);
+            closeConnection(connection);
+            return;
+        }
+    }
+}
+
+const HttpServer::Route *HttpServer::findRoute(const HttpRequest &request, bool &pathMatched) const {
+    pathMatched = false;
+    for (const Route& entry : routes) {
+        bool matches = entry.prefix ? request.path.startsWith(entry.path) : request.path == entry.path;
+        if (!matches) {
+            continue;
+        }
+        pathMatched = true;
+        if (entry.method == request.method || (entry.method == "GET" && request.method == "HEAD" && entry.handler)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+HttpResponse HttpServer::dispatch(const Route *route, const HttpRequest &request) const {
+    try {
+        HttpResponse response = route->handler(request);
+        if (request.method == "HEAD") {
+            response.headers.append(qMakePair(QByteArray("Content-Length"), QByteArray::number(response.body.size())));
+            response.body.clear();
+        }
+        return response;
+    } catch (const std::exception& e) {
+        return HttpResponse::error(500, QString::fromUtf8(e.what()));
+    }
+}
+
+bool HttpServer::parseRequest(QByteArray &buffer, HttpRequest &request, int &errorStatus) {
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (buffer.size() > maxHeaderSize) {
+            errorStatus = 431;
+        }
+        return false;
+    }
+    QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    QList<QByteArray> requestLine = lines.takeFirst().trimmed().split(' ');
+    if (requestLine.size() != 3 || !requestLine.at(2).startsWith("HTTP/1.")) {
+        errorStatus = 400;
+        return false;
+    }
+    request.method = requestLine.at(0).toUpper();
+    QUrl url = QUrl::fromEncoded(requestLine.at(1));
+    request.path = url.path();
+    request.query = QUrlQuery(url);
+    for (const QByteArray& line : lines) {
+        int separator = line.indexOf(':');
+        if (separator > 0) {
+            request.headers.insert(line.left(separator).trimmed().toLower(), line.mid(separator + 1).trimmed());
+        }
+    }
+    if (requestLine.at(2) == "HTTP/1.0" && request.headers.value("connection").toLower() != "keep-alive") {
+        request.headers.insert("connection", "close");
+    }
+
+    bool ok = true;
+    qint64 contentLength = request.headers.value("content-length", "0").toLongLong(&ok);
+    if (!ok || contentLength < 0) {
+        errorStatus = 400;
+        return false;
+    }
+    if (contentLength > maxBodySize) {
+        errorStatus = 413;
+        return false;
+    }
+    qint64 requestSize = headerEnd + 4 + contentLength;
+    if (buffer.size() < requestSize) {
+        return false;
+    }
+    request.body = buffer.mid(headerEnd + 4, contentLength);
+    buffer.remove(0, requestSize);
+    return true;
+}
+
+void HttpServer::writeResponse(QIODevice *connection, const HttpResponse &response, bool keepAlive) {
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + ' ' + reasonPhrase(response.status) + "\r\n";
+    head += "Content-Type: " + response.contentType + "\r\n";
+    bool hasLength = false;
+    for (const auto& header : response.headers) {
+        hasLength = hasLength || header.first.compare("Content-Length", Qt::CaseInsensitive) == 0;
+        head += header.first + ": " + header.second + "\r\n";
+    }
+    if (!hasLength) {
+        head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    }
+    head += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    connection->write(head);
+    connection->write(response.body);
+}
+
+void HttpServer::closeConnection(QIODevice *connection) {
+    if (QTcpSocket* socket = qobject_cast<QTcpSocket*>(connection)) {
+        socket->disconnectFromHost();
+    } else if (QLocalSocket* socket = qobject_cast<QLocalSocket*>(connection)) {
+        socket->disconnectFromServer();
+    } else {
+        connection->close();
+        connection->deleteLater();
+    }
+}
+
+QByteArray HttpServer::reasonPhrase(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 202: return "Accepted";
+    case 204: return "No Content";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 415: return "Unsupported Media Type";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default: return "Unknown";
+    }
+}
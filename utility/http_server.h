@@ -0,0 +1,81 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QLocalServer>
+#include <QHostAddress>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QUrlQuery>
+#include <QJsonObject>
+#include <functional>
+
+struct HttpRequest {
+    QByteArray method;
+    QString path;
+    QUrlQuery query;
+    QHash<QByteArray, QByteArray> headers;
+    QByteArray body;
+};
+
+struct HttpResponse {
+    int status = 200;
+    QByteArray contentType = "text/plain; charset=utf-8";
+    QByteArray body;
+    QList<QPair<QByteArray, QByteArray>> headers;
+
+    static HttpResponse text(const QByteArray& body, int status = 200);
+    static HttpResponse json(const QJsonObject& object, int status = 200);
+    static HttpResponse error(int status, const QString& message);
+};
+
+class HttpServer : public QObject {
+    Q_OBJECT
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+    using StreamHandler = std::function<void(const HttpRequest&, QIODevice*)>;
+
+    static const int maxHeaderSize = 16 * 1024;
+    static const int maxBodySize = 1024 * 1024;
+
+    explicit HttpServer(QObject *parent = nullptr);
+    ~HttpServer();
+
+    bool listen(const QHostAddress& address, quint16 port);
+    bool listenLocal(const QString& socketPath);
+    void close();
+    bool isListening() const;
+    quint16 serverPort() const;
+    QString errorString() const;
+
+    void route(const QByteArray& method, const QString& path, Handler handler);
+    void routeStream(const QByteArray& method, const QString& path, StreamHandler handler);
+
+    static QByteArray reasonPhrase(int status);
+    static void writeResponse(QIODevice* connection, const HttpResponse& response, bool keepAlive);
+    static void closeConnection(QIODevice* connection);
+
+private:
+    struct Route {
+        QByteArray method;
+        QString path;
+        bool prefix;
+        Handler handler;
+        StreamHandler streamHandler;
+    };
+
+    QList<Route> routes;
+    QHash<QIODevice*, QByteArray> buffers;
+    QTcpServer tcpServer;
+    QLocalServer localServer;
+
+    void acceptConnection(QIODevice* connection);
+    void processBuffer(QIODevice* connection);
+    const Route* findRoute(const HttpRequest& request, bool& pathMatched) const;
+    HttpResponse dispatch(const Route* route, const HttpRequest& request) const;
+    static bool parseRequest(QByteArray& buffer, HttpRequest& request, int& errorStatus);
+};
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,226 @@
+#include "process_isolation.h"
+#include <QDebug>
+#include <QStringList>
+#include <QThread>
+#include <QFile>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+static const QStringList ioniceClasses = QStringList() << "none" << "realtime" << "best-effort" << "idle";
+static const QStringList priorityClasses = QStringList() << "idle" << "below_normal" << "normal" << "above_normal" << "high";
+
+QList<int> ProcessIsolation::parseCpuList(const QString &cpus) {
+    QList<int> result;
+    if (cpus.trimmed().isEmpty()) {
+        return result;
+    }
+    const QStringList ranges = cpus.split(',');
+    for (const QString& range : ranges) {
+        QStringList bounds = range.trimmed().split('-');
+        bool firstOk = false;
+        bool lastOk = false;
+        int first = bounds.value(0).toInt(&firstOk);
+        int last = bounds.size() == 2 ? bounds.value(1).toInt(&lastOk) : first;
+        if (bounds.size() == 1) {
+            lastOk = firstOk;
+        }
+        if (!firstOk || !lastOk || bounds.size() > 2 || first < 0 || last < first || last >= 1024) {
+            QString errMsg = "Invalid CPU list " + cpus + ": expected a list such as 0-3,6.";
+            throw std::runtime_error(errMsg.toStdString());
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            if (!result.contains(cpu)) {
+                result.append(cpu);
+            }
+        }
+    }
+    return result;
+}
+
+ProcessIsolation ProcessIsolation::fromJson(const QJsonObject &settings) {
+    ProcessIsolation isolation;
+    isolation.cpus = settings.value("cpus").toString();
+    isolation.cpuList = parseCpuList(isolation.cpus);
+    isolation.nice = settings.value("nice").toInt(0);
+    isolation.ioniceClass = settings.value("ionice_class").toString("none");
+    isolation.ioniceLevel = settings.value("ionice_level").toInt(4);
+    isolation.priorityClass = settings.value("priority_class").toString("normal");
+
+    if (isolation.nice < -20 || isolation.nice > 19) {
+        throw std::runtime_error("Invalid process isolation settings: nice level must be between -20 and 19.");
+    }
+    if (!ioniceClasses.contains(isolation.ioniceClass) || isolation.ioniceLevel < 0 || isolation.ioniceLevel > 7) {
+        throw std::runtime_error("Invalid process isolation settings: ionice class must be none, realtime, best-effort or idle with a level between 0 and 7.");
+    }
+    if (!priorityClasses.contains(isolation.priorityClass)) {
+        QString errMsg = "Invalid process isolation settings: priority class must be one of " + priorityClasses.join(", ") + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    int cpuCount = QThread::idealThreadCount();
+    for (int cpu : isolation.cpuList) {
+        if (cpu >= cpuCount) {
+            qWarning() << "CPU" << cpu << "in CPU list" << isolation.cpus << "is not available on this machine.";
+        }
+    }
+    return isolation;
+}
+
+QJsonObject ProcessIsolation::toJson() const {
+    QJsonObject settings;
+    settings["cpus"] = cpus;
+    settings["nice"] = nice;
+    settings["ionice_class"] = ioniceClass;
+    settings["ionice_level"] = ioniceLevel;
+    settings["priority_class"] = priorityClass;
+    return settings;
+}
+
+bool ProcessIsolation::isEmpty() const {
+    return cpuList.isEmpty() && nice == 0 && ioniceClass == "none" && priorityClass == "normal";
+}
+
+void ProcessIsolation::prepare(QProcess *process, const QString &cgroupProcsPath) const {
+#ifdef Q_OS_WIN
+    Q_UNUSED(cgroupProcsPath);
+    if (isEmpty()) {
+        return;
+    }
+    process->setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments *args) {
+        args->flags |= CREATE_SUSPENDED;
+    });
+#elif QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    if (isEmpty() && cgroupProcsPath.isEmpty()) {
+        return;
+    }
+    int niceLevel = nice;
+#ifdef Q_OS_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpuList) {
+        CPU_SET(cpu, &cpuSet);
+    }
+    bool setAffinity = !cpuList.isEmpty();
+    int ioprio = ioniceClass == "none" ? -1 : (ioniceClasses.indexOf(ioniceClass) << 13) | (ioniceClass == "idle" ? 0 : ioniceLevel);
+    QByteArray cgroupProcs = QFile::encodeName(cgroupProcsPath);
+    process->setChildProcessModifier([cpuSet, setAffinity, niceLevel, ioprio, cgroupProcs]() {
+        if (!cgroupProcs.isEmpty()) {
+            int fd = ::open(cgroupProcs.constData(), O_WRONLY | O_CLOEXEC);
+            if (fd >= 0) {
+                ssize_t written = ::write(fd, "0", 1);
+                Q_UNUSED(written);
+                ::close(fd);
+            }
+        }
+        if (setAffinity) {
+            sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+        }
+        if (ioprio >= 0) {
+            syscall(SYS_ioprio_set, 1, 0, ioprio);
+        }
+        if (niceLevel != 0) {
+            setpriority(PRIO_PROCESS, 0, niceLevel);
+        }
+    });
+#else
+    Q_UNUSED(cgroupProcsPath);
+    process->setChildProcessModifier([niceLevel]() {
+        if (niceLevel != 0) {
+            setpriority(PRIO_PROCESS, 0, niceLevel);
+        }
+    });
+#endif
+#else
+    Q_UNUSED(process);
+    Q_UNUSED(cgroupProcsPath);
+    if (!isEmpty()) {
+        qWarning() << "Process isolation requires Qt 6 on this platform and was not applied.";
+    }
+#endif
+}
+
+void ProcessIsolation::apply(QProcess *process) const {
+    if (isEmpty()) {
+        return;
+    }
+#ifdef Q_OS_WIN
+    DWORD processId = DWORD(process->processId());
+    HANDLE job = CreateJobObjectW(NULL, NULL);
+    HANDLE processHandle = OpenProcess(PROCESS_SET_QUOTA | PROCESS_TERMINATE | PROCESS_QUERY_INFORMATION, FALSE, processId);
+    if (job && processHandle) {
+        JOBOBJECT_BASIC_LIMIT_INFORMATION limits = {};
+        if (!cpuList.isEmpty()) {
+            DWORD_PTR mask = 0;
+            for (int cpu : cpuList) {
+                if (cpu < int(sizeof(DWORD_PTR) * 8)) {
+                    mask |= DWORD_PTR(1) << cpu;
+                }
+            }
+            limits.LimitFlags |= JOB_OBJECT_LIMIT_AFFINITY;
+            limits.Affinity = mask;
+        }
+        if (priorityClass != "normal") {
+            limits.LimitFlags |= JOB_OBJECT_LIMIT_PRIORITY_CLASS;
+            limits.PriorityClass = windowsPriorityClass();
+        }
+        if (!SetInformationJobObject(job, JobObjectBasicLimitInformation, &limits, sizeof(limits))
+            || !AssignProcessToJobObject(job, processHandle)) {
+            qWarning() << "Failed to apply process isolation to process" << processId << ": error" << GetLastError();
+        }
+    } else {
+        qWarning() << "Failed to apply process isolation to process" << processId << ": error" << GetLastError();
+    }
+    if (processHandle) {
+        CloseHandle(processHandle);
+    }
+    if (job) {
+        CloseHandle(job);
+    }
+    resumeProcess(processId);
+#else
+    Q_UNUSED(process);
+#endif
+}
+
+#ifdef Q_OS_WIN
+DWORD ProcessIsolation::windowsPriorityClass() const {
+    if (priorityClass == "idle") {
+        return IDLE_PRIORITY_CLASS;
+    } else if (priorityClass == "below_normal") {
+        return BELOW_NORMAL_PRIORITY_CLASS;
+    } else if (priorityClass == "above_normal") {
+        return ABOVE_NORMAL_PRIORITY_CLASS;
+    } else if (priorityClass == "high") {
+        return HIGH_PRIORITY_CLASS;
+    }
+    return NORMAL_PRIORITY_CLASS;
+}
+
+void ProcessIsolation::resumeProcess(DWORD processId) {
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    THREADENTRY32 entry;
+    entry.dwSize = sizeof(entry);
+    if (Thread32First(snapshot, &entry)) {
+        do {
+            if (entry.th32OwnerProcessID == processId) {
+                HANDLE thread = OpenThread(THREAD_SUSPEND_RESUME, FALSE, entry.th32ThreadID);
+                if (thread) {
+                    ResumeThread(thread);
+                    CloseHandle(thread);
+                }
+            }
+        } while (Thread32Next(snapshot, &entry));
+    }
+    CloseHandle(snapshot);
+}
+#endif
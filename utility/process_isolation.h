@@ -0,0 +1,40 @@
+#ifndef PROCESS_ISOLATION_H
+#define PROCESS_ISOLATION_H
+
+#include "qglobal.h"
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+#include <QProcess>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <tlhelp32.h>
+#endif
+
+class ProcessIsolation {
+public:
+    static ProcessIsolation fromJson(const QJsonObject& settings);
+    QJsonObject toJson() const;
+    bool isEmpty() const;
+
+    void prepare(QProcess* process, const QString& cgroupProcsPath = QString()) const;
+    void apply(QProcess* process) const;
+
+    static QList<int> parseCpuList(const QString& cpus);
+
+private:
+    QString cpus;
+    QList<int> cpuList;
+    int nice = 0;
+    QString ioniceClass = "none";
+    int ioniceLevel = 4;
+    QString priorityClass = "normal";
+
+#ifdef Q_OS_WIN
+    DWORD windowsPriorityClass() const;
+    static void resumeProcess(DWORD processId);
+#endif
+};
+
+#endif // PROCESS_ISOLATION_H
@@ -0,0 +1,110 @@
+#include "process_stats.h"
+#include <QFile>
+#include <QThread>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+ProcessStats::ProcessStats() {
+    clock.start();
+}
+
+ProcessStats::Sample ProcessStats::sampleProcess(qint64 processId) {
+    Sample sample;
+    qint64 cpuTimeMs = 0;
+    if (processId <= 0 || !readProcess(processId, cpuTimeMs, sample.residentBytes)) {
+        cpuReadings.remove(processId);
+        return sample;
+    }
+    sample.valid = true;
+
+    qint64 now = clock.elapsed();
+    auto previous = cpuReadings.constFind(processId);
+    if (previous != cpuReadings.constEnd() && now > previous->wallTimeMs && cpuTimeMs >= previous->cpuTimeMs) {
+        sample.cpuPercent = 100.0 * double(cpuTimeMs - previous->cpuTimeMs) / double(now - previous->wallTimeMs) / qMax(1, QThread::idealThreadCount());
+    }
+    cpuReadings.insert(processId, CpuReading{cpuTimeMs, now});
+    return sample;
+}
+
+double ProcessStats::sampleRequestRate(const QString &accessLogPath) {
+    QFile file(accessLogPath);
+    if (accessLogPath.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        logReadings.remove(accessLogPath);
+        return 0.0;
+    }
+
+    qint64 now = clock.elapsed();
+    LogReading& reading = logReadings[accessLogPath];
+    if (reading.offset < 0 || reading.offset > file.size()) {
+        reading.offset = file.size();
+        reading.wallTimeMs = now;
+        return 0.0;
+    }
+
+    qint64 requests = 0;
+    file.seek(reading.offset);
+    while (!file.atEnd()) {
+        QByteArray chunk = file.read(64 * 1024);
+        requests += chunk.count('\n');
+    }
+    double seconds = double(now - reading.wallTimeMs) / 1000.0;
+    reading.offset = file.pos();
+    reading.wallTimeMs = now;
+    return seconds > 0 ? double(requests) / seconds : 0.0;
+}
+
+void ProcessStats::forget(qint64 processId) {
+    cpuReadings.remove(processId);
+}
+
+bool ProcessStats::readProcess(qint64 processId, qint64 &cpuTimeMs, qint64 &residentBytes) {
+#if defined(Q_OS_LINUX)
+    QFile statFile(QString("/proc/%1/stat").arg(processId));
+    if (!statFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray stat = statFile.readAll();
+    int commEnd = stat.lastIndexOf(')');
+    if (commEnd < 0) {
+        return false;
+    }
+    QList<QByteArray> fields = stat.mid(commEnd + 2).split(' ');
+    if (fields.size() < 22) {
+        return false;
+    }
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    qint64 ticks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+    cpuTimeMs = ticksPerSecond > 0 ? ticks * 1000 / ticksPerSecond : 0;
+    residentBytes = fields.at(21).toLongLong() * sysconf(_SC_PAGESIZE);
+    return true;
+#elif defined(Q_OS_WIN)
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(processId));
+    if (!process) {
+        return false;
+    }
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    PROCESS_MEMORY_COUNTERS counters;
+    bool ok = GetProcessTimes(process, &creationTime, &exitTime, &kernelTime, &userTime)
+              && GetProcessMemoryInfo(process, &counters, sizeof(counters));
+    CloseHandle(process);
+    if (!ok) {
+        return false;
+    }
+    ULARGE_INTEGER kernel;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+    ULARGE_INTEGER user;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    cpuTimeMs = qint64((kernel.QuadPart + user.QuadPart) / 10000);
+    residentBytes = qint64(counters.WorkingSetSize);
+    return true;
+#else
+    Q_UNUSED(processId);
+    Q_UNUSED(cpuTimeMs);
+    Q_UNUSED(residentBytes);
+    return false;
+#endif
+}
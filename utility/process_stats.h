@@ -0,0 +1,46 @@
+#ifndef PROCESS_STATS_H
+#define PROCESS_STATS_H
+
+#include "qglobal.h"
+#include <QString>
+#include <QHash>
+#include <QElapsedTimer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+class ProcessStats {
+public:
+    struct Sample {
+        bool valid = false;
+        double cpuPercent = 0.0;
+        qint64 residentBytes = 0;
+    };
+
+    ProcessStats();
+
+    Sample sampleProcess(qint64 processId);
+    double sampleRequestRate(const QString& accessLogPath);
+    void forget(qint64 processId);
+
+    static bool readProcess(qint64 processId, qint64& cpuTimeMs, qint64& residentBytes);
+
+private:
+    struct CpuReading {
+        qint64 cpuTimeMs = 0;
+        qint64 wallTimeMs = 0;
+    };
+
+    struct LogReading {
+        qint64 offset = -1;
+        qint64 wallTimeMs = 0;
+    };
+
+    QElapsedTimer clock;
+    QHash<qint64, CpuReading> cpuReadings;
+    QHash<QString, LogReading> logReadings;
+};
+
+#endif // PROCESS_STATS_H
@@ -0,0 +1,291 @@
+#include "snapshot_manager.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QRegularExpression>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+bool SnapshotManager::isValidSnapshotName(const QString &name) {
+    static const QRegularExpression nameRegex(R"(^[A-Za-z0-9][A-Za-z0-9_.-]{0,63}$)");
+    return nameRegex.match(name).hasMatch();
+}
+
+QStringList SnapshotManager::listSnapshots(const QString &snapshotsRoot) {
+    QDir root(snapshotsRoot);
+    if (!root.exists()) {
+        return QStringList();
+    }
+    QStringList snapshots;
+    const QStringList manifests = root.entryList(QStringList() << "*.json", QDir::Files, QDir::Time | QDir::Reversed);
+    for (const QString& manifest : manifests) {
+        QString name = QFileInfo(manifest).completeBaseName();
+        if (isValidSnapshotName(name) && root.exists(name)) {
+            snapshots.append(name);
+        }
+    }
+    return snapshots;
+}
+
+QJsonObject SnapshotManager::createSnapshot(const QString &sourceDir, const QString &snapshotsRoot, const QString &name) {
+    if (!isValidSnapshotName(name)) {
+        QString errMsg = "Failed to create snapshot: invalid snapshot name " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QDir source(sourceDir);
+    if (!source.exists()) {
+        QString errMsg = "Failed to create snapshot: data directory " + sourceDir + " does not exist.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QDir root(snapshotsRoot);
+    if (!root.exists() && !root.mkpath(".")) {
+        QString errMsg = "Failed to create snapshot: cannot create snapshot directory " + snapshotsRoot + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (root.exists(name) || root.exists(name + ".json")) {
+        QString errMsg = "Failed to create snapshot: snapshot " + name + " already exists.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QString previousName = latestSnapshot(snapshotsRoot);
+    QJsonObject previousFiles = previousName.isEmpty() ? QJsonObject() : readManifest(snapshotsRoot, previousName)["files"].toObject();
+    QString stagingPath = root.absoluteFilePath("." + name + ".partial");
+    QDir(stagingPath).removeRecursively();
+    if (!QDir().mkpath(stagingPath)) {
+        QString errMsg = "Failed to create snapshot: cannot create staging directory " + stagingPath + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QJsonObject files;
+    int reflinked = 0;
+    int hardlinked = 0;
+    int copied = 0;
+    qint64 totalBytes = 0;
+    try {
+        QDirIterator it(source.absolutePath(), QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            QFileInfo info = it.fileInfo();
+            QString relativePath = source.relativeFilePath(info.absoluteFilePath());
+            QString destination = QDir(stagingPath).filePath(relativePath);
+            if (info.isDir()) {
+                QDir().mkpath(destination);
+                continue;
+            }
+            QDir().mkpath(QFileInfo(destination).absolutePath());
+
+            qint64 modified = info.lastModified().toMSecsSinceEpoch();
+            QJsonObject previous = previousFiles[relativePath].toObject();
+            CloneMethod method;
+            if (reflinkFile(info.absoluteFilePath(), destination)) {
+                method = CloneMethod::Reflink;
+            } else if (!previous.isEmpty()
+                       && previous["size"].toDouble() == info.size()
+                       && previous["mtime"].toDouble() == modified
+                       && hardlinkFile(root.absoluteFilePath(previousName + "/" + relativePath), destination)) {
+                method = CloneMethod::Hardlink;
+            } else {
+                method = cloneFile(info.absoluteFilePath(), destination);
+            }
+
+            if (method == CloneMethod::Reflink) {
+                reflinked++;
+            } else if (method == CloneMethod::Hardlink) {
+                hardlinked++;
+            } else {
+                copied++;
+            }
+            totalBytes += info.size();
+
+            QJsonObject entry;
+            entry["size"] = info.size();
+            entry["mtime"] = modified;
+            files[relativePath] = entry;
+        }
+    } catch (const std::runtime_error&) {
+        QDir(stagingPath).removeRecursively();
+        throw;
+    }
+
+    if (!QDir().rename(stagingPath, root.absoluteFilePath(name))) {
+        QDir(stagingPath).removeRecursively();
+        QString errMsg = "Failed to create snapshot: cannot finalize snapshot " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    QJsonObject manifest;
+    manifest["name"] = name;
+    manifest["source"] = source.absolutePath();
+    manifest["created"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    manifest["reflinked"] = reflinked;
+    manifest["hardlinked"] = hardlinked;
+    manifest["copied"] = copied;
+    manifest["bytes"] = totalBytes;
+    manifest["files"] = files;
+
+    QFile manifestFile(root.absoluteFilePath(name + ".json"));
+    if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QDir(root.absoluteFilePath(name)).removeRecursively();
+        QString errMsg = "Failed to create snapshot: cannot write snapshot manifest " + manifestFile.fileName() + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    manifestFile.write(QJsonDocument(manifest).toJson());
+    manifestFile.close();
+
+    qDebug() << "Snapshot" << name << "created:" << reflinked << "reflinked," << hardlinked << "hardlinked," << copied << "copied.";
+    manifest.remove("files");
+    return manifest;
+}
+
+QJsonObject SnapshotManager::restoreSnapshot(const QString &snapshotsRoot, const QString &name, const QString &targetDir) {
+    QDir root(snapshotsRoot);
+    if (!isValidSnapshotName(name) || !root.exists(name)) {
+        QString errMsg = "Failed to restore snapshot: snapshot " + name + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QDir snapshot(root.absoluteFilePath(name));
+    QString target = QDir(targetDir).absolutePath();
+    QString stagingPath = target + ".restore";
+    QString oldPath = target + ".old";
+    QDir(stagingPath).removeRecursively();
+    QDir(oldPath).removeRecursively();
+    if (!QDir().mkpath(stagingPath)) {
+        QString errMsg = "Failed to restore snapshot: cannot create staging directory " + stagingPath + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+
+    int reflinked = 0;
+    int copied = 0;
+    try {
+        QDirIterator it(snapshot.absolutePath(), QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            QFileInfo info = it.fileInfo();
+            QString destination = QDir(stagingPath).filePath(snapshot.relativeFilePath(info.absoluteFilePath()));
+            if (info.isDir()) {
+                QDir().mkpath(destination);
+                continue;
+            }
+            QDir().mkpath(QFileInfo(destination).absolutePath());
+            if (cloneFile(info.absoluteFilePath(), destination) == CloneMethod::Reflink) {
+                reflinked++;
+            } else {
+                copied++;
+            }
+        }
+    } catch (const std::runtime_error&) {
+        QDir(stagingPath).removeRecursively();
+        throw;
+    }
+
+    bool hadTarget = QDir(target).exists();
+    if (hadTarget && !QDir().rename(target, oldPath)) {
+        QDir(stagingPath).removeRecursively();
+        QString errMsg = "Failed to restore snapshot: cannot move data directory " + target + " aside.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!QDir().rename(stagingPath, target)) {
+        if (hadTarget) {
+            QDir().rename(oldPath, target);
+        }
+        QDir(stagingPath).removeRecursively();
+        QString errMsg = "Failed to restore snapshot: cannot swap in restored data directory " + target + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QDir(oldPath).removeRecursively();
+
+    qDebug() << "Snapshot" << name << "restored:" << reflinked << "reflinked," << copied << "copied.";
+    QJsonObject result;
+    result["name"] = name;
+    result["reflinked"] = reflinked;
+    result["copied"] = copied;
+    return result;
+}
+
+void SnapshotManager::deleteSnapshot(const QString &snapshotsRoot, const QString &name) {
+    QDir root(snapshotsRoot);
+    if (!isValidSnapshotName(name) || !root.exists(name)) {
+        QString errMsg = "Failed to delete snapshot: snapshot " + name + " not found.";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    if (!QDir(root.absoluteFilePath(name)).removeRecursively()) {
+        QString errMsg = "Failed to delete snapshot: cannot remove snapshot directory for " + name + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    QFile::remove(root.absoluteFilePath(name + ".json"));
+}
+
+bool SnapshotManager::reflinkFile(const QString &source, const QString &destination) {
+#ifdef Q_OS_LINUX
+    int sourceFd = ::open(QFile::encodeName(source).constData(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        return false;
+    }
+    struct stat sourceStat;
+    if (::fstat(sourceFd, &sourceStat) != 0) {
+        ::close(sourceFd);
+        return false;
+    }
+    int destinationFd = ::open(QFile::encodeName(destination).constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, sourceStat.st_mode & 07777);
+    if (destinationFd < 0) {
+        ::close(sourceFd);
+        return false;
+    }
+    bool cloned = ::ioctl(destinationFd, FICLONE, sourceFd) == 0;
+    ::close(destinationFd);
+    ::close(sourceFd);
+    if (!cloned) {
+        ::unlink(QFile::encodeName(destination).constData());
+    }
+    return cloned;
+#else
+    Q_UNUSED(source);
+    Q_UNUSED(destination);
+    return false;
+#endif
+}
+
+bool SnapshotManager::hardlinkFile(const QString &source, const QString &destination) {
+#ifdef Q_OS_WIN
+    return CreateHardLinkW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(destination).utf16()),
+                           reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(source).utf16()), NULL) != 0;
+#else
+    return ::link(QFile::encodeName(source).constData(), QFile::encodeName(destination).constData()) == 0;
+#endif
+}
+
+SnapshotManager::CloneMethod SnapshotManager::cloneFile(const QString &source, const QString &destination) {
+    if (reflinkFile(source, destination)) {
+        return CloneMethod::Reflink;
+    }
+    if (!QFile::copy(source, destination)) {
+        QString errMsg = "Failed to copy " + source + " to " + destination + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+    return CloneMethod::Copy;
+}
+
+QJsonObject SnapshotManager::readManifest(const QString &snapshotsRoot, const QString &name) {
+    QFile manifestFile(QDir(snapshotsRoot).absoluteFilePath(name + ".json"));
+    if (!manifestFile.open(QIODevice::ReadOnly)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(manifestFile.readAll()).object();
+}
+
+QString SnapshotManager::latestSnapshot(const QString &snapshotsRoot) {
+    QStringList snapshots = listSnapshots(snapshotsRoot);
+    return snapshots.isEmpty() ? QString() : snapshots.last();
+}
@@ -0,0 +1,35 @@
+#ifndef SNAPSHOT_MANAGER_H
+#define SNAPSHOT_MANAGER_H
+
+#include "qglobal.h"
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+class SnapshotManager {
+public:
+    enum class CloneMethod {
+        Reflink,
+        Hardlink,
+        Copy
+    };
+
+    static QStringList listSnapshots(const QString& snapshotsRoot);
+    static QJsonObject createSnapshot(const QString& sourceDir, const QString& snapshotsRoot, const QString& name);
+    static QJsonObject restoreSnapshot(const QString& snapshotsRoot, const QString& name, const QString& targetDir);
+    static void deleteSnapshot(const QString& snapshotsRoot, const QString& name);
+    static bool isValidSnapshotName(const QString& name);
+
+private:
+    static bool reflinkFile(const QString& source, const QString& destination);
+    static bool hardlinkFile(const QString& source, const QString& destination);
+    static CloneMethod cloneFile(const QString& source, const QString& destination);
+    static QJsonObject readManifest(const QString& snapshotsRoot, const QString& name);
+    static QString latestSnapshot(const QString& snapshotsRoot);
+};
+
+#endif // SNAPSHOT_MANAGER_H
@@ -0,0 +1,62 @@
+#include "socket_transport.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocalSocket>
+
+QStringList SocketTransport::transports() {
+    return QStringList() << "tcp" << "unix";
+}
+
+void SocketTransport::validate(const QString &transport) {
+    if (!transports().contains(transport)) {
+        QString errMsg = "Invalid transport " + transport + ": expected " + transports().join(" or ") + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
+
+bool SocketTransport::isUnixSupported() {
+#ifdef Q_OS_WIN
+    return false;
+#else
+    return true;
+#endif
+}
+
+QString SocketTransport::effective(const QString &transport) {
+    if (transport == "unix" && !isUnixSupported()) {
+        return "tcp";
+    }
+    return transport;
+}
+
+QString SocketTransport::socketPath(const QString &name) {
+    QString runDir = QDir::currentPath() + "/run";
+    if ((runDir + "/" + name).size() > maxSocketPathLength) {
+        runDir = QDir::tempPath() + "/webdevtoolkit";
+    }
+    return runDir + "/" + name;
+}
+
+void SocketTransport::createSocketDirectory(const QString &socketPath) {
+    QString runDir = QFileInfo(socketPath).absolutePath();
+    if (!QDir().mkpath(runDir)) {
+        QString errMsg = "Failed to create the socket directory " + runDir + ".";
+        throw std::runtime_error(errMsg.toStdString());
+    }
+}
+
+bool SocketTransport::isSocketFree(const QString &socketPath) {
+    if (!QFileInfo::exists(socketPath)) {
+        return true;
+    }
+    QLocalSocket socket;
+    socket.connectToServer(socketPath);
+    if (socket.waitForConnected(100)) {
+        socket.disconnectFromServer();
+        return false;
+    }
+    qDebug() << "Removing stale socket" << socketPath;
+    return QFile::remove(socketPath);
+}
@@ -0,0 +1,21 @@
+#ifndef SOCKET_TRANSPORT_H
+#define SOCKET_TRANSPORT_H
+
+#include "qglobal.h"
+#include <QString>
+#include <QStringList>
+
+class SocketTransport {
+public:
+    static const int maxSocketPathLength = 100;
+
+    static QStringList transports();
+    static void validate(const QString& transport);
+    static bool isUnixSupported();
+    static QString effective(const QString& transport);
+    static QString socketPath(const QString& name);
+    static void createSocketDirectory(const QString& socketPath);
+    static bool isSocketFree(const QString& socketPath);
+};
+
+#endif // SOCKET_TRANSPORT_H
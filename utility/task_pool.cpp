@@ -0,0 +1,133 @@
+#include "task_pool.h"
+#include "trace.h"
+#include <QDebug>
+#include <QThread>
+#include <QMutexLocker>
+#include <QCoreApplication>
+#include <QEventLoop>
+
+TaskPool::TaskPool(int maxThreads) {
+    pool.setMaxThreadCount(maxThreads > 0 ? maxThreads : qMax(2, QThread::idealThreadCount() / 2));
+}
+
+TaskPool::~TaskPool() {
+    cancelPending();
+    // Running tasks may block on pullToCurrentThread(), which needs the main
+    // thread's event loop, so keep delivering events while they finish.
+    QCoreApplication* app = QCoreApplication::instance();
+    if (app && app->thread() == QThread::currentThread()) {
+        while (!pool.waitForDone(20)) {
+            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+        }
+        return;
+    }
+    pool.waitForDone();
+}
+
+QFuture<void> TaskPool::submit(const QString &strand, const QString &description, std::function<void()> task) {
+    PendingTask pending;
+    pending.description = description;
+    pending.task = std::move(task);
+    pending.promise = std::make_shared<QPromise<void>>();
+    QFuture<void> future = pending.promise->future();
+
+    QMutexLocker locker(&mutex);
+    Strand& target = strands[strand];
+    target.queue.enqueue(std::move(pending));
+    if (!target.running) {
+        target.running = true;
+        pool.start([this, strand]() {
+            runNext(strand);
+        });
+    }
+    return future;
+}
+
+void TaskPool::runNext(const QString &strand) {
+    PendingTask pending;
+    {
+        QMutexLocker locker(&mutex);
+        Strand& current = strands[strand];
+        if (current.queue.isEmpty()) {
+            current.running = false;
+            return;
+        }
+        pending = current.queue.dequeue();
+    }
+
+    pending.promise->start();
+    if (pending.promise->isCanceled()) {
+        qDebug() << "Skipping cancelled task" << pending.description << "for" << strand;
+    } else {
+        try {
+            TRACE_SCOPE_ARG("task", "TaskPool::runNext", "task", strand + ": " + pending.description);
+            pending.task();
+        } catch (...) {
+            qWarning() << "Task" << pending.description << "for" << strand << "failed.";
+            pending.promise->setException(std::current_exception());
+        }
+    }
+    pending.promise->finish();
+
+    QMutexLocker locker(&mutex);
+    Strand& current = strands[strand];
+    if (current.queue.isEmpty()) {
+        current.running = false;
+    } else {
+        pool.start([this, strand]() {
+            runNext(strand);
+        });
+    }
+}
+
+void TaskPool::cancelPending(const QString &strand) {
+    QMutexLocker locker(&mutex);
+    for (auto it = strands.begin(); it != strands.end(); ++it) {
+        if (!strand.isEmpty() && it.key() != strand) {
+            continue;
+        }
+        for (PendingTask& pending : it.value().queue) {
+            pending.promise->future().cancel();
+        }
+    }
+}
+
+bool TaskPool::waitForDone(int msecs) {
+    return pool.waitForDone(msecs);
+}
+
+int TaskPool::pendingCount(const QString &strand) const {
+    QMutexLocker locker(&mutex);
+    return strands.value(strand).queue.size();
+}
+
+int TaskPool::maxThreadCount() const {
+    return pool.maxThreadCount();
+}
+
+void TaskPool::releaseToMainThread(QObject *object) {
+    QThread* mainThread = QCoreApplication::instance() ? QCoreApplication::instance()->thread() : nullptr;
+    if (!object || !mainThread || object->thread() == mainThread) {
+        return;
+    }
+    if (object->thread() != QThread::currentThread()) {
+        qWarning() << "Cannot hand over" << object << "to the main thread: it is owned by another thread.";
+        return;
+    }
+    object->moveToThread(mainThread);
+}
+
+void TaskPool::pullToCurrentThread(QObject *object) {
+    QThread* currentThread = QThread::currentThread();
+    QThread* mainThread = QCoreApplication::instance() ? QCoreApplication::instance()->thread() : nullptr;
+    if (!object || object->thread() == currentThread) {
+        return;
+    }
+    if (object->thread() != mainThread) {
+        qWarning() << "Cannot take over" << object << ": it is owned by a thread without an event loop.";
+        return;
+    }
+    QMetaObject::invokeMethod(object, [object, currentThread]() {
+        object->moveToThread(currentThread);
+    }, Qt::BlockingQueuedConnection);
+}
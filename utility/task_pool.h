@@ -0,0 +1,47 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QQueue>
+#include <QMutex>
+#include <QFuture>
+#include <QPromise>
+#include <QThreadPool>
+#include <functional>
+#include <memory>
+
+class TaskPool {
+public:
+    explicit TaskPool(int maxThreads = 0);
+    ~TaskPool();
+
+    QFuture<void> submit(const QString& strand, const QString& description, std::function<void()> task);
+    void cancelPending(const QString& strand = QString());
+    bool waitForDone(int msecs = -1);
+    int pendingCount(const QString& strand) const;
+    int maxThreadCount() const;
+
+    static void releaseToMainThread(QObject* object);
+    static void pullToCurrentThread(QObject* object);
+
+private:
+    struct PendingTask {
+        QString description;
+        std::function<void()> task;
+        std::shared_ptr<QPromise<void>> promise;
+    };
+    struct Strand {
+        QQueue<PendingTask> queue;
+        bool running = false;
+    };
+
+    void runNext(const QString& strand);
+
+    QThreadPool pool;
+    mutable QMutex mutex;
+    QHash<QString, Strand> strands;
+};
+
+#endif // TASK_POOL_H
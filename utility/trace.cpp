@@ -0,0 +1,161 @@
+#include "trace.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <QDebug>
+
+std::atomic<bool> Trace::enabled{false};
+
+namespace {
+
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    char phase;
+    qint64 timestampUs;
+    qint64 durationUs;
+    int threadId;
+    const char* argName;
+    QString argValue;
+};
+
+QMutex traceMutex;
+QVector<TraceEvent> traceEvents;
+QHash<int, QString> threadNames;
+QElapsedTimer traceClock;
+std::atomic<int> nextThreadId{1};
+bool droppedWarningShown = false;
+
+int currentTraceThreadId() {
+    thread_local int threadId = 0;
+    if (threadId == 0) {
+        threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        QThread* thread = QThread::currentThread();
+        QString name = thread ? thread->objectName() : QString();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            name = "main";
+        } else if (name.isEmpty()) {
+            name = "thread-" + QString::number(threadId);
+        }
+        QMutexLocker locker(&traceMutex);
+        threadNames.insert(threadId, name);
+    }
+    return threadId;
+}
+
+void appendEvent(TraceEvent event) {
+    QMutexLocker locker(&traceMutex);
+    if (traceEvents.size() >= Trace::maxEvents) {
+        if (!droppedWarningShown) {
+            droppedWarningShown = true;
+            qWarning() << "Trace buffer is full, further events are dropped.";
+        }
+        return;
+    }
+    traceEvents.append(std::move(event));
+}
+
+}
+
+void Trace::setEnabled(bool enable) {
+    if (enable) {
+        QMutexLocker locker(&traceMutex);
+        if (!traceClock.isValid()) {
+            traceClock.start();
+        }
+    }
+    enabled.store(enable, std::memory_order_release);
+}
+
+qint64 Trace::now() {
+    return traceClock.isValid() ? traceClock.nsecsElapsed() / 1000 : 0;
+}
+
+void Trace::addCompleteEvent(const char *category, const char *name, qint64 startUs, qint64 durationUs, const char *argName, const QString &argValue) {
+    if (!isEnabled()) {
+        return;
+    }
+    appendEvent(TraceEvent{category, name, 'X', startUs, durationUs, currentTraceThreadId(), argName, argValue});
+}
+
+void Trace::addInstantEvent(const char *category, const char *name) {
+    if (!isEnabled()) {
+        return;
+    }
+    appendEvent(TraceEvent{category, name, 'i', now(), 0, currentTraceThreadId(), nullptr, QString()});
+}
+
+void Trace::setThreadName(const QString &name) {
+    int threadId = currentTraceThreadId();
+    QMutexLocker locker(&traceMutex);
+    threadNames.insert(threadId, name);
+}
+
+bool Trace::writeChromeTrace(const QString &filePath) {
+    qint64 processId = QCoreApplication::applicationPid();
+    QJsonArray events;
+    {
+        QMutexLocker locker(&traceMutex);
+        QJsonObject processName;
+        processName["name"] = "process_name";
+        processName["ph"] = "M";
+        processName["pid"] = processId;
+        processName["args"] = QJsonObject{{"name", QCoreApplication::applicationName()}};
+        events.append(processName);
+        for (auto it = threadNames.constBegin(); it != threadNames.constEnd(); ++it) {
+            QJsonObject threadName;
+            threadName["name"] = "thread_name";
+            threadName["ph"] = "M";
+            threadName["pid"] = processId;
+            threadName["tid"] = it.key();
+            threadName["args"] = QJsonObject{{"name", it.value()}};
+            events.append(threadName);
+        }
+        for (const TraceEvent& traceEvent : traceEvents) {
+            QJsonObject event;
+            event["cat"] = traceEvent.category;
+            event["name"] = traceEvent.name;
+            event["ph"] = QString(QChar(traceEvent.phase));
+            event["ts"] = traceEvent.timestampUs;
+            event["pid"] = processId;
+            event["tid"] = traceEvent.threadId;
+            if (traceEvent.phase == 'X') {
+                event["dur"] = traceEvent.durationUs;
+            } else {
+                event["s"] = "t";
+            }
+            if (traceEvent.argName) {
+                event["args"] = QJsonObject{{traceEvent.argName, traceEvent.argValue}};
+            }
+            events.append(event);
+        }
+    }
+
+    QJsonObject trace;
+    trace["displayTimeUnit"] = "ms";
+    trace["traceEvents"] = events;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write trace file" << filePath << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    file.close();
+    qDebug() << "Trace with" << events.size() << "events written to" << filePath;
+    return true;
+}
+
+void Trace::clear() {
+    QMutexLocker locker(&traceMutex);
+    traceEvents.clear();
+    droppedWarningShown = false;
+}
@@ -0,0 +1,78 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "qglobal.h"
+#include <QString>
+#include <atomic>
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(category, name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+#define TRACE_SCOPE_ARG(category, name, argName, argValue) \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name, argName, Trace::isEnabled() ? QString(argValue) : QString())
+
+class Trace {
+public:
+    static const int maxEvents = 1000000;
+
+    static bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enable);
+    static qint64 now();
+    static void addCompleteEvent(const char* category, const char* name, qint64 startUs, qint64 durationUs, const char* argName = nullptr, const QString& argValue = QString());
+    static void addInstantEvent(const char* category, const char* name);
+    static void setThreadName(const QString& name);
+    static bool writeChromeTrace(const QString& filePath);
+    static void clear();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name) : category(category), name(name) {
+        if (Trace::isEnabled()) {
+            startUs = Trace::now();
+        }
+    }
+
+    TraceScope(const char* category, const char* name, const char* argName, const QString& argValue) : TraceScope(category, name) {
+        if (isActive()) {
+            setArgument(argName, argValue);
+        }
+    }
+
+    ~TraceScope() {
+        end();
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    bool isActive() const {
+        return startUs >= 0;
+    }
+
+    void setArgument(const char* name, const QString& value) {
+        argName = name;
+        argValue = value;
+    }
+
+    void end() {
+        if (startUs >= 0) {
+            Trace::addCompleteEvent(category, name, startUs, Trace::now() - startUs, argName, argValue);
+            startUs = -1;
+        }
+    }
+
+private:
+    const char* category;
+    const char* name;
+    const char* argName = nullptr;
+    QString argValue;
+    qint64 startUs = -1;
+};
+
+#endif // TRACE_H